@@ -70,6 +70,7 @@ COMBINE_SIGN_JSON?=configs/boot_with_extended_boot.json
 # COUGH_MODEL
 # ALARM_MODEL
 # BABYCRY_MODEL
+# AUDIO_HUB_MODEL (cough, baby cry and alarm models on one microphone, GCC_ARM only)
 # DIRECTIONOFARRIVAL_MODEL
 # FALLDETECTION_MODEL
 # GESTURE_MODEL (For KIT_PSE84_AI only)
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+// Forwards the bulk stream of the CM55 (ipc_stream.h) off the board. The records are read in place and
+// sent as frames that shared/source/COMPONENT_HOST/ipc_stream_decode.c turns back into records on a PC.
+// The CM55 never waits for this: when the UART or the uplink is slower than the stream, the CM55 drops
+// records and the decoder reports the sequence gaps.
+
+#include "cybsp.h"
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "ipc_communication.h"
+#include "app_stream.h"
+
+#if APP_STREAM_OUTPUT == APP_STREAM_TELEMETRY
+#include "mbedtls/base64.h"
+#include "iotconnect.h"
+#endif
+
+#if APP_STREAM_OUTPUT == APP_STREAM_UART
+// Interval at which the task refills the UART TX FIFO. It never waits for the UART, so it only takes
+// the CPU to frame a record and to copy what fits in the FIFO.
+#define APP_STREAM_POLL_MS 5
+
+// Frame being sent, the record is released once it is framed
+static uint8_t stream_frame[IPC_STREAM_FRAME_OVERHEAD + IPC_STREAM_MAX_DATA];
+static uint32_t stream_frame_len = 0;
+static uint32_t stream_frame_sent = 0;
+
+// Writes the frames to the debug UART without the LF to CRLF conversion of retarget-io. Console text is
+// written to the same UART by the other tasks. The decoder skips text between two frames, text in the
+// middle of a frame costs that frame, which the decoder counts as a CRC error.
+static void app_stream_task(void *pvParameters) {
+    (void) pvParameters;
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(APP_STREAM_POLL_MS));
+        while (1) {
+            if (stream_frame_sent == stream_frame_len) {
+                const ipc_stream_record_t *record = cm33_ipc_stream_peek();
+                if (NULL == record) {
+                    break;
+                }
+                stream_frame_len = (uint32_t) ipc_stream_frame_encode(record, stream_frame, sizeof(stream_frame));
+                stream_frame_sent = 0;
+                cm33_ipc_stream_release();
+            }
+            uint32_t n = Cy_SCB_UART_PutArray(CYBSP_DEBUG_UART_HW, &stream_frame[stream_frame_sent],
+                                              stream_frame_len - stream_frame_sent);
+            stream_frame_sent += n;
+            if (stream_frame_sent < stream_frame_len) {
+                break; // FIFO full
+            }
+        }
+    }
+}
+#endif
+
+void app_stream_start(void) {
+#if APP_STREAM_OUTPUT == APP_STREAM_UART
+    if (pdPASS != xTaskCreate(app_stream_task, "Stream", APP_STREAM_TASK_STACK_SIZE, NULL,
+                              APP_STREAM_TASK_PRIORITY, NULL)) {
+        printf("ERROR: Failed to start the stream task\n");
+    }
+#endif
+}
+
+#if APP_STREAM_OUTPUT == APP_STREAM_TELEMETRY
+// Frame bytes sent per telemetry message, whole frames only so that every chunk decodes on its own.
+// Base64 encoding grows this by 4/3.
+#define APP_STREAM_CHUNK_SIZE 1536
+
+// Messages sent per report at most, the rest of the stream waits or is dropped by the CM55
+#define APP_STREAM_CHUNKS_PER_REPORT 4
+
+static uint8_t stream_chunk[APP_STREAM_CHUNK_SIZE];
+static char stream_chunk_b64[((APP_STREAM_CHUNK_SIZE + 2) / 3) * 4 + 1];
+static uint32_t stream_chunk_count = 0;
+#endif
+
+void app_stream_publish(void) {
+#if APP_STREAM_OUTPUT == APP_STREAM_TELEMETRY
+    for (int i = 0; i < APP_STREAM_CHUNKS_PER_REPORT && iotconnect_sdk_is_connected(); i++) {
+        const ipc_stream_record_t *record;
+        size_t len = 0;
+        size_t b64_len = 0;
+        ipc_stream_stats_t stats;
+
+        while (NULL != (record = cm33_ipc_stream_peek())) {
+            size_t n = ipc_stream_frame_encode(record, &stream_chunk[len], sizeof(stream_chunk) - len);
+            if (0 == n) {
+                break; // the chunk is full
+            }
+            len += n;
+            cm33_ipc_stream_release();
+        }
+        if (0 == len || !cm33_ipc_stream_get_stats(&stats)) {
+            return;
+        }
+        if (0 != mbedtls_base64_encode((unsigned char *) stream_chunk_b64, sizeof(stream_chunk_b64), &b64_len,
+                                       stream_chunk, len)) {
+            printf("ERROR: Failed to encode the stream\n");
+            return;
+        }
+
+        IotclMessageHandle msg = iotcl_telemetry_create();
+        iotcl_telemetry_set_number(msg, "stream_chunk", stream_chunk_count++);
+        iotcl_telemetry_set_number(msg, "stream_dropped", stats.dropped);
+        iotcl_telemetry_set_string(msg, "stream_data", stream_chunk_b64);
+        iotcl_mqtt_send_telemetry(msg, false);
+        iotcl_telemetry_destroy(msg);
+    }
+#endif
+}
+
+/* [] END OF FILE */
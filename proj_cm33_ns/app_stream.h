@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef APP_STREAM_H_
+#define APP_STREAM_H_
+
+// Where the bulk stream of the CM55 (ipc_stream.h) goes. The CM55 only fills the stream
+// when it is built with CM55_IPC_STREAM_ENABLE.
+#define APP_STREAM_OFF          0
+#define APP_STREAM_UART         1   // Binary frames on the debug UART, between the console lines
+#define APP_STREAM_TELEMETRY    2   // Base64 chunks of frames in telemetry messages
+
+#ifndef APP_STREAM_OUTPUT
+#define APP_STREAM_OUTPUT       APP_STREAM_OFF
+#endif
+
+#define APP_STREAM_TASK_PRIORITY    (1)
+#define APP_STREAM_TASK_STACK_SIZE  (1024)
+
+// Starts the task that drains the stream to the UART, if that is the output
+void app_stream_start(void);
+
+// Publishes what the stream holds in telemetry messages, if that is the output.
+// Called by the telemetry loop after its own message.
+void app_stream_publish(void);
+
+#endif // APP_STREAM_H_
@@ -4,14 +4,20 @@
  */
 
 #include "cybsp.h"
+#include <stdlib.h>
 #include <string.h>
 
 #include "cy_syslib.h" // for Cy_SysLib_GetUniqueId
 
 #include "FreeRTOS.h"
+#include "queue.h"
 
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
+#include "audio_clip.h"
+#include "timebase.h"
+
+#include "mbedtls/base64.h"
 
 #include "wifi_config.h"
 #include "wifi_app.h"
@@ -22,6 +28,7 @@
 #include "app_eeprom_data.h"
 
 #include "app_config.h"
+#include "app_stream.h"
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -35,6 +42,8 @@
 #define APP_VERSION ("A-" APP_VERSION_BASE)
 #elif defined(BABYCRY_MODEL)
 #define APP_VERSION ("B-" APP_VERSION_BASE)
+#elif defined(AUDIO_HUB_MODEL)
+#define APP_VERSION ("H-" APP_VERSION_BASE)
 #elif defined(DIRECTIONOFARRIVAL_MODEL)
 #define APP_VERSION ("D-" APP_VERSION_BASE)
 #elif defined(FALLDETECTION_MODEL)
@@ -57,6 +66,50 @@ static UserInputYnStatus user_input_status = APP_INPUT_NONE;
 static bool is_demo_mode = false;
 static int reporting_interval = 2000;
 
+// How long a command waits for the inference core to apply a parameter
+#define APP_CONTROL_TIMEOUT_MS 1000
+
+// set-inference commands waiting for this task, further ones fail
+#define APP_CONTROL_QUEUE_LENGTH 4
+
+// Longest inbound poll between two runs of the waiting set-inference commands
+#define APP_CONTROL_POLL_MS 100
+
+// Raw audio clip bytes sent per telemetry message. Base64 encoding grows this by 4/3.
+#define APP_CLIP_CHUNK_SIZE 1536
+
+// Clip messages sent per report at most, the upload goes on with the next report
+#define APP_CLIP_CHUNKS_PER_REPORT 4
+
+// How often the CM55 clock is mapped again, the core clocks drift apart
+#define APP_CLOCK_SYNC_INTERVAL_MS 60000
+
+// Set to 1 to add the p50 and p99 of every latency stage to the telemetry, in microseconds
+#ifndef APP_LATENCY_TELEMETRY
+#define APP_LATENCY_TELEMETRY 0
+#endif
+
+// A set-inference command handed over by on_command(). The arguments are cut to what
+// set_inference_parameter() parses.
+typedef struct AppControlCommand {
+    char args[96];
+    char ack_id[64];
+    bool has_ack_id;
+} AppControlCommand;
+
+static QueueHandle_t control_queue = NULL;
+
+static uint32_t clock_sync_ms = 0;
+static bool is_clock_synced = false;
+
+// Clip being uploaded and its next chunk
+static ipc_payload_t clip_payload;
+static bool is_clip_pending = false;
+static int clip_next_chunk = 0;
+
+static uint8_t clip_chunk[APP_CLIP_CHUNK_SIZE];
+static char clip_chunk_b64[((APP_CLIP_CHUNK_SIZE + 2) / 3) * 4 + 1];
+
 /////////////////////////////////////////////////////////////////////////////
 
 static void on_connection_status(IotConnectConnectionStatus status) {
@@ -118,10 +171,112 @@ static bool parse_on_off_command(const char* command, const char* name, bool *ar
     return false;
 }
 
+// Handles "set-inference <parameter> <value> [<model>] [<arg>...]" by sending a control request
+// to the inference core. Parameters are named as in ipc_control.c. Numeric arguments after the value
+// fill the further arguments of the parameter, a name selects the model (default is the first model).
+static bool set_inference_parameter(const char* args, const char** message) {
+    char buf[96];
+    char *save = NULL;
+    uint8_t extra[4] = {0};
+    int extra_count = 0;
+    int model_id = 0;
+
+    strncpy(buf, args, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    const char *param_name = strtok_r(buf, " ", &save);
+    const char *value_str = strtok_r(NULL, " ", &save);
+    int param = param_name ? ipc_control_param_from_name(param_name) : -1;
+    if (param < 0 || NULL == value_str) {
+        *message = "Expected a known parameter and a value";
+        return false;
+    }
+    // out of range values saturate beyond the int32_t range and are refused as well
+    char *value_end;
+    long long value = strtoll(value_str, &value_end, 10);
+    if (*value_end != '\0' || value < INT32_MIN || value > INT32_MAX) {
+        *message = "Argument parsing error";
+        return false;
+    }
+
+    for (const char *token = strtok_r(NULL, " ", &save); token; token = strtok_r(NULL, " ", &save)) {
+        char *end;
+        long number = strtol(token, &end, 10);
+        if (*end == '\0') {
+            if (extra_count >= (int) sizeof(extra) || number < 0 || number > UINT8_MAX) {
+                *message = "Argument parsing error";
+                return false;
+            }
+            extra[extra_count++] = (uint8_t) number;
+        } else {
+            model_id = cm33_ipc_find_model(token);
+            if (model_id < 0) {
+                *message = "Unknown model";
+                return false;
+            }
+        }
+    }
+
+    int32_t applied = 0;
+    ipc_control_status_t status = cm33_ipc_control((uint32_t) param, (uint32_t) model_id, (int32_t) value,
+                                                   extra, &applied, APP_CONTROL_TIMEOUT_MS);
+    if (status != IPC_CONTROL_STATUS_OK) {
+        printf("Setting %s failed: %s\n", param_name, ipc_control_status_name(status));
+        *message = ipc_control_status_name(status);
+        return false;
+    }
+    printf("Inference parameter %s of %s set to %ld\n", param_name, cm33_ipc_get_model_name((uint32_t) model_id),
+        (long) applied);
+    *message = "Inference parameter set";
+    return true;
+}
+
+static void send_command_ack(const char *ack_id, bool command_success, const char *message) {
+    // could be a command without ack, so ack ID can be null
+    // the user needs to enable acknowledgments in the template to get an ack ID
+    if (ack_id) {
+        iotcl_mqtt_send_cmd_ack(
+                ack_id,
+                command_success ? IOTCL_C2D_EVT_CMD_SUCCESS_WITH_ACK : IOTCL_C2D_EVT_CMD_FAILED,
+                message // allowed to be null, but should not be null if failed, we'd hope
+        );
+    } else {
+        // if we send an ack
+        printf("Message status is %s. Message: %s\n", command_success ? "SUCCESS" : "FAILED", message ? message : "<none>");
+    }
+}
+
+// Hands a set-inference command over to app_task, which sends the control request and acknowledges
+// the command once the inference core answered. The MQTT callback does not wait for the inference core.
+static bool queue_control_command(const char *args, const char *ack_id) {
+    AppControlCommand cmd;
+
+    if (ack_id && strlen(ack_id) >= sizeof(cmd.ack_id)) {
+        return false;
+    }
+    strncpy(cmd.args, args, sizeof(cmd.args) - 1);
+    cmd.args[sizeof(cmd.args) - 1] = '\0';
+    strcpy(cmd.ack_id, ack_id ? ack_id : "");
+    cmd.has_ack_id = (NULL != ack_id);
+    return (NULL != control_queue) && (pdTRUE == xQueueSend(control_queue, &cmd, 0));
+}
+
+// Runs the set-inference commands queued by on_command() and acknowledges them
+static void run_control_commands(void) {
+    AppControlCommand cmd;
+
+    while (pdTRUE == xQueueReceive(control_queue, &cmd, 0)) {
+        const char *message = NULL;
+        bool command_success = set_inference_parameter(cmd.args, &message);
+        send_command_ack(cmd.has_ack_id ? cmd.ack_id : NULL, command_success, message);
+    }
+}
+
 static void on_command(IotclC2dEventData data) {
     const char * const BOARD_STATUS_LED = "board-user-led";
     const char * const DEMO_MODE_CMD = "demo-mode";
     const char * const SET_REPORTING_INTERVAL = "set-reporting-interval "; // with a space
+    const char * const SET_INFERENCE = "set-inference "; // with a space
 
     bool command_success = false;
     const char * message = NULL;
@@ -155,6 +310,11 @@ static void on_command(IotclC2dEventData data) {
         		message = "Reporting interval set";
         		command_success =  true;
         	}
+        } else if (0 == strncmp(SET_INFERENCE, command, strlen(SET_INFERENCE))) {
+            if (queue_control_command(&command[strlen(SET_INFERENCE)], ack_id)) {
+                return; // acknowledged by app_task
+            }
+            message = "Inference command not queued, too many pending";
         } else {
             printf("Unknown command \"%s\"\n", command);
             message = "Unknown command";
@@ -164,37 +324,174 @@ static void on_command(IotclC2dEventData data) {
         message = "Parsing error";
     }
 
-    // could be a command without ack, so ack ID can be null
-    // the user needs to enable acknowledgments in the template to get an ack ID
-    if (ack_id) {
-        iotcl_mqtt_send_cmd_ack(
-                ack_id,
-                command_success ? IOTCL_C2D_EVT_CMD_SUCCESS_WITH_ACK : IOTCL_C2D_EVT_CMD_FAILED,
-                message // allowed to be null, but should not be null if failed, we'd hope
-        );
-    } else {
-        // if we send an ack
-        printf("Message status is %s. Message: %s\n", command_success ? "SUCCESS" : "FAILED", message ? message : "<none>");
+    send_command_ack(ack_id, command_success, message);
+}
+
+// Copies len bytes of the clip starting at offset, following the ring wrap
+static void copy_clip_bytes(const audio_clip_desc_t *clip, size_t offset, uint8_t *dst, size_t len) {
+    const uint8_t *ring = (const uint8_t *) clip->ring_addr;
+    while (len > 0) {
+        size_t block = offset / clip->block_bytes;
+        size_t block_offset = offset % clip->block_bytes;
+        size_t n = clip->block_bytes - block_offset;
+        if (n > len) {
+            n = len;
+        }
+        const uint8_t *src = &ring[((clip->first_block + block) % clip->ring_blocks) * clip->block_bytes];
+        memcpy(dst, &src[block_offset], n);
+        dst += n;
+        offset += n;
+        len -= n;
+    }
+}
+
+// Uploads the audio clip frozen by the CM55 around a detection, if there is one.
+// The clip is IMA-ADPCM (see audio_clip.h) and is sent as base64 chunks, one per message, at most
+// APP_CLIP_CHUNKS_PER_REPORT per report so that the telemetry keeps its interval.
+// The CM55 resumes recording once the clip is released after the last chunk.
+static void publish_audio_clip(void) {
+    if (!is_clip_pending) {
+        if (!cm33_ipc_safe_get_and_clear_audio_clip(&clip_payload) || 0 == clip_payload.data_addr) {
+            return;
+        }
+        is_clip_pending = true;
+        clip_next_chunk = 0;
+    }
+    audio_clip_desc_t *clip = (audio_clip_desc_t *) clip_payload.data_addr;
+    size_t clip_size = (size_t) clip->block_count * clip->block_bytes;
+    int chunk_count = (int) ((clip_size + APP_CLIP_CHUNK_SIZE - 1) / APP_CLIP_CHUNK_SIZE);
+
+    if (0 == clip_next_chunk) {
+        printf("Uploading %s audio clip %lu: %u bytes in %d chunks\n",
+            cm33_ipc_get_label(clip_payload.label_id), (unsigned long) clip->clip_id, (unsigned int) clip_size,
+            chunk_count);
+    }
+
+    for (int n = 0; n < APP_CLIP_CHUNKS_PER_REPORT && clip_next_chunk < chunk_count && iotconnect_sdk_is_connected(); n++) {
+        int i = clip_next_chunk;
+        size_t offset = (size_t) i * APP_CLIP_CHUNK_SIZE;
+        size_t len = clip_size - offset;
+        size_t b64_len = 0;
+        if (len > APP_CLIP_CHUNK_SIZE) {
+            len = APP_CLIP_CHUNK_SIZE;
+        }
+        copy_clip_bytes(clip, offset, clip_chunk, len);
+        if (0 != mbedtls_base64_encode((unsigned char *) clip_chunk_b64, sizeof(clip_chunk_b64), &b64_len, clip_chunk, len)) {
+            printf("ERROR: Failed to encode the audio clip\n");
+            clip_next_chunk = chunk_count; // give the clip up
+            break;
+        }
+
+        IotclMessageHandle msg = iotcl_telemetry_create();
+        iotcl_telemetry_set_number(msg, "clip_id", clip->clip_id);
+        iotcl_telemetry_set_number(msg, "clip_chunk", i);
+        iotcl_telemetry_set_number(msg, "clip_chunks", chunk_count);
+        if (0 == i) {
+            // Everything needed to decode the clip comes with the first chunk
+            iotcl_telemetry_set_number(msg, "class_id", clip_payload.label_id);
+            iotcl_telemetry_set_string(msg, "class", cm33_ipc_get_label(clip_payload.label_id));
+            iotcl_telemetry_set_string(msg, "clip_format", "ima-adpcm");
+            iotcl_telemetry_set_number(msg, "clip_sample_rate", clip->sample_rate);
+            iotcl_telemetry_set_number(msg, "clip_block_samples", clip->block_samples);
+            iotcl_telemetry_set_number(msg, "clip_trigger_block", clip->trigger_block);
+        }
+        iotcl_telemetry_set_string(msg, "clip_data", clip_chunk_b64);
+        iotcl_mqtt_send_telemetry(msg, false);
+        iotcl_telemetry_destroy(msg);
+        clip_next_chunk++;
+    }
+
+    if (clip_next_chunk >= chunk_count) {
+        clip->state = AUDIO_CLIP_STATE_FREE;
+        is_clip_pending = false;
     }
 }
 
+// Maps the CM55 clock for the latency stages that cross the cores, at first and then every APP_CLOCK_SYNC_INTERVAL_MS.
+// Runs in this task as it also sends the control requests.
+static void sync_clock(void) {
+    uint32_t now_ms = timebase_get_ms();
+    if (is_clock_synced && (now_ms - clock_sync_ms) < APP_CLOCK_SYNC_INTERVAL_MS) {
+        return;
+    }
+    clock_sync_ms = now_ms;
+    if (!cm33_ipc_sync_clock()) {
+        printf("CM55 clock sync failed. Latency stages across the cores keep the previous mapping.\n");
+        return;
+    }
+    is_clock_synced = true;
+}
+
+#if APP_LATENCY_TELEMETRY
+static void add_latency_telemetry(IotclMessageHandle msg) {
+    static ipc_latency_t latency;
+    char name[32];
+
+    cm33_ipc_get_latency(&latency);
+    for (uint32_t stage = 0; stage < IPC_LATENCY_STAGE_COUNT; stage++) {
+        if (latency.stages[stage].count == 0) {
+            continue;
+        }
+        snprintf(name, sizeof(name), "latency_%s_p50", ipc_latency_stage_name(stage));
+        iotcl_telemetry_set_number(msg, name, ipc_latency_percentile(&latency, (ipc_latency_stage_t) stage, 500));
+        snprintf(name, sizeof(name), "latency_%s_p99", ipc_latency_stage_name(stage));
+        iotcl_telemetry_set_number(msg, name, ipc_latency_percentile(&latency, (ipc_latency_stage_t) stage, 990));
+    }
+}
+#endif
+
 static cy_rslt_t publish_telemetry(void) {
     ipc_payload_t payload;
+    sync_clock();
     // useful fro debugging - making sure we have te latest data:
     // printf("Has IPC Data: %s\n", cm33_ipc_has_received_message() ? "true" : "false");
-    cm33_ipc_safe_get_and_clear_cached_detection(&payload);
+    bool is_detection = cm33_ipc_safe_get_and_clear_cached_detection(&payload);
     IotclMessageHandle msg = iotcl_telemetry_create();
     iotcl_telemetry_set_string(msg, "version", APP_VERSION);
     iotcl_telemetry_set_number(msg, "random", rand() % 100); // test some random numbers
     iotcl_telemetry_set_number(msg, "class_id", payload.label_id);
-    iotcl_telemetry_set_string(msg, "class", payload.label);
+    iotcl_telemetry_set_string(msg, "class", cm33_ipc_get_label(payload.label_id));
 	iotcl_telemetry_set_bool(msg, "event_detected", payload.label_id > 0);
+#if defined(GESTURE_MODEL)
+    ipc_payload_t radar_mode;
+    if (cm33_ipc_safe_get_radar_mode(&radar_mode)) {
+        iotcl_telemetry_set_string(msg, "radar_mode", cm33_ipc_get_mode_name(radar_mode.label_id));
+    }
+#endif
+#if APP_LATENCY_TELEMETRY
+    add_latency_telemetry(msg);
+#endif
 
+    // Only a detection is published as soon as it arrives, the other results are the latest state
+    uint32_t built_us = (uint32_t) timebase_get_us();
     iotcl_mqtt_send_telemetry(msg, false);
+    if (is_detection) {
+        cm33_ipc_latency_add_published(&payload, built_us, (uint32_t) timebase_get_us());
+    }
     iotcl_telemetry_destroy(msg);
+
+    publish_audio_clip();
+    app_stream_publish();
     return CY_RSLT_SUCCESS;
 }
 
+// Polls the inbound messages until the next report is due. The set-inference commands run
+// between two polls, so that their acknowledgement does not wait for the report.
+static void wait_for_next_report(void) {
+    uint32_t start_ms = timebase_get_ms();
+    uint32_t waited_ms = 0;
+
+    while (waited_ms < (uint32_t) reporting_interval) {
+        uint32_t poll_ms = (uint32_t) reporting_interval - waited_ms;
+        if (poll_ms > APP_CONTROL_POLL_MS) {
+            poll_ms = APP_CONTROL_POLL_MS;
+        }
+        iotconnect_sdk_poll_inbound_mq(poll_ms);
+        run_control_commands();
+        waited_ms = timebase_get_ms() - start_ms;
+    }
+}
+
 static void user_input_yn_task (void *pvParameters) {
 	TaskHandle_t *parent_task = pvParameters;
 
@@ -231,6 +528,13 @@ void app_task(void *pvParameters) {
         taskYIELD(); // wait for CM55
     }
     printf("\nApp Task: CM55 IPC is ready. Resuming the application...\n");
+    app_stream_start();
+
+    control_queue = xQueueCreate(APP_CONTROL_QUEUE_LENGTH, sizeof(AppControlCommand));
+    if (NULL == control_queue) {
+        printf("Failed to create the control command queue. Cannot continue.\n");
+        goto exit_cleanup;
+    }
 
     char iotc_duid[IOTCL_CONFIG_DUID_MAX_LEN] = IOTCONNECT_DUID;
     if (0 == strlen(iotc_duid)) {
@@ -331,7 +635,7 @@ void app_task(void *pvParameters) {
             if (result != CY_RSLT_SUCCESS) {
                 break;
                 }
-            iotconnect_sdk_poll_inbound_mq(reporting_interval);
+            wait_for_next_report();
         }
         iotconnect_sdk_disconnect();
     }
@@ -49,6 +49,7 @@
 #include "cy_time.h"
 #include "cycfg_peripherals.h"
 #include "ipc_communication.h"
+#include "timebase.h"
 
 /******************************************************************************
  * Macros
@@ -210,6 +211,9 @@ int main(void)
     /* Initialize the CLIB support library */
     mtb_clib_support_init(&obj);
     
+    /* Start the timebase of the IPC latency stamps */
+    timebase_init();
+
     /* Setup IPC communication for CM33 */
     cm33_ipc_communication_setup();
 
@@ -0,0 +1,261 @@
+/******************************************************************************
+* File Name:   postprocess_test.c
+*
+* Description: This file implements a host test of the post-inference
+*              smoothing engine (postprocess.c). Prediction streams are
+*              replayed through tables exercising k-of-n voting, the
+*              enter/exit hysteresis, the minimum hold, the cooldown and the
+*              tie rule, and the smoothed state after every prediction is
+*              compared with the expected one. The test also checks that
+*              every state change and only those are reported, and that
+*              postprocess_init() refuses tables the engine cannot hold.
+*
+*              Usage: postprocess_test [--verbose]
+*
+*              The exit code is 1 if a state or a report differs.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "postprocess.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_CLASSES                        (3u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* A stream of predictions, one digit per prediction, and the smoothed state
+ * expected after each of them */
+typedef struct
+{
+    const char                      *name;
+    uint8_t                         window;
+    postprocess_class_cfg_t         classes[TEST_CLASSES];
+    const char                      *predictions;
+    const char                      *states;
+} test_stream_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+#define TEST_CLASS(k, enter, exit, hold, cooldown) \
+    { .vote_k = (k), .enter_count = (enter), .exit_count = (exit), .hold_count = (hold), .cooldown_count = (cooldown) }
+
+static const test_stream_t streams[] =
+{
+    {
+        /* The first prediction only reports the initial background state,
+         * out of range classes (9) count as background */
+        .name = "initial state",
+        .window = 1u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(1, 1, 1, 0, 0) },
+        .predictions = "1100229",
+        .states      = "0100220",
+    },
+    {
+        /* 3 of 5 votes enter the class, dropping to 2 leaves it */
+        .name = "k-of-n voting",
+        .window = 5u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(3, 1, 1, 0, 0), TEST_CLASS(3, 1, 1, 0, 0) },
+        .predictions = "01010110000",
+        .states      = "00000111000",
+    },
+    {
+        /* Two consecutive predictions enter, three consecutive others leave */
+        .name = "hysteresis",
+        .window = 1u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(1, 2, 3, 0, 0), TEST_CLASS(1, 2, 3, 0, 0) },
+        .predictions = "01011010010000",
+        .states      = "00001111111100",
+    },
+    {
+        /* A class is held for 4 predictions after it was entered */
+        .name = "hold",
+        .window = 1u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(1, 1, 1, 4, 0), TEST_CLASS(1, 1, 1, 0, 0) },
+        .predictions = "0100000",
+        .states      = "0111100",
+    },
+    {
+        /* Class 1 is entered again 3 predictions after it was left, class 2
+         * has no cooldown */
+        .name = "cooldown",
+        .window = 1u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(1, 1, 1, 0, 3), TEST_CLASS(1, 1, 1, 0, 0) },
+        .predictions = "010111201",
+        .states      = "010001200",
+    },
+    {
+        /* The current state wins a tie of the votes */
+        .name = "tie",
+        .window = 4u,
+        .classes = { TEST_CLASS(1, 1, 1, 0, 0), TEST_CLASS(2, 1, 1, 0, 0), TEST_CLASS(2, 1, 1, 0, 0) },
+        .predictions = "112212",
+        .states      = "011112",
+    },
+};
+
+#define TEST_STREAM_COUNT                   (sizeof(streams) / sizeof(streams[0]))
+
+static bool verbose = false;
+
+/*******************************************************************************
+* Function Name: test_stream
+********************************************************************************
+* Summary:
+*  Replays one stream and compares the state and the report of every
+*  prediction.
+*
+*******************************************************************************/
+static bool test_stream(const test_stream_t *stream)
+{
+    postprocess_cfg_t cfg = { stream->window, TEST_CLASSES, stream->classes };
+    postprocess_ctx_t ctx;
+    uint32_t length = (uint32_t)strlen(stream->predictions);
+    uint32_t changes = 0;
+    int previous = -1;
+    bool ok = (length == strlen(stream->states)) && postprocess_init(&ctx, &cfg);
+
+    for (uint32_t i = 0; ok && (i < length); i++)
+    {
+        int prediction = stream->predictions[i] - '0';
+        int expected = stream->states[i] - '0';
+        int state;
+        bool reported = postprocess_update(&ctx, prediction, &state);
+
+        if (verbose)
+        {
+            printf("  %-14s %2u: prediction %d, state %d%s\n", stream->name, (unsigned)i, prediction, state,
+                   reported ? ", reported" : "");
+        }
+        if ((state != expected) || (reported != (state != previous)) || (postprocess_get_state(&ctx) != state))
+        {
+            printf("%s: prediction %u: state %d%s, expected %d%s\n", stream->name, (unsigned)i, state,
+                   reported ? " reported" : "", expected, (expected != previous) ? " reported" : "");
+            ok = false;
+        }
+        changes += (state != previous) ? 1u : 0u;
+        previous = state;
+    }
+
+    ok = ok && (ctx.stats.predictions == length) && (ctx.stats.reports == changes);
+    printf("%-14s %2u predictions, %u reports: %s\n", stream->name, (unsigned)length, (unsigned)changes,
+           ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: test_scores
+********************************************************************************
+* Summary:
+*  Checks the share of the window each class got: 3 of 5 votes for class 1,
+*  2 for the background.
+*
+*******************************************************************************/
+static bool test_scores(void)
+{
+    const test_stream_t *stream = &streams[1];
+    postprocess_cfg_t cfg = { stream->window, TEST_CLASSES, stream->classes };
+    postprocess_ctx_t ctx;
+    uint8_t scores[TEST_CLASSES + 1u];
+    bool ok = postprocess_init(&ctx, &cfg);
+
+    for (uint32_t i = 0; ok && (i < 6u); i++)
+    {
+        (void)postprocess_update(&ctx, stream->predictions[i] - '0', NULL);
+    }
+    ok = ok && (TEST_CLASSES == postprocess_get_scores(&ctx, scores, sizeof(scores))) &&
+         (102u == scores[0]) && (153u == scores[1]) && (0u == scores[2]) &&
+         (1u == postprocess_get_scores(&ctx, scores, 1u));
+    printf("scores         3 of 5 votes: %s\n", ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: test_init
+********************************************************************************
+* Summary:
+*  postprocess_init() accepts the largest table and refuses the ones the
+*  voting and cooldown arrays cannot hold.
+*
+*******************************************************************************/
+static bool test_init(void)
+{
+    static postprocess_class_cfg_t classes[POSTPROCESS_MAX_CLASSES + 1u];
+    postprocess_ctx_t ctx;
+    postprocess_cfg_t cfg;
+    bool ok = true;
+
+    for (uint32_t c = 0; c <= POSTPROCESS_MAX_CLASSES; c++)
+    {
+        classes[c] = (postprocess_class_cfg_t)TEST_CLASS(1, 1, 1, 0, 0);
+    }
+
+    cfg = (postprocess_cfg_t){ POSTPROCESS_MAX_WINDOW, POSTPROCESS_MAX_CLASSES, classes };
+    ok = ok && postprocess_init(&ctx, &cfg);
+    cfg.window = 0u;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.window = POSTPROCESS_MAX_WINDOW + 1u;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.window = 1u;
+    cfg.class_count = 0u;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.class_count = POSTPROCESS_MAX_CLASSES + 1u;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.class_count = 2u;
+    cfg.classes = NULL;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.classes = classes;
+    classes[1].vote_k = 2u;
+    ok = ok && !postprocess_init(&ctx, &cfg);
+    cfg.window = 2u;
+    ok = ok && postprocess_init(&ctx, &cfg);
+    ok = ok && !postprocess_init(&ctx, NULL);
+
+    printf("init           window 1..%u, up to %u classes: %s\n", (unsigned)POSTPROCESS_MAX_WINDOW,
+           (unsigned)POSTPROCESS_MAX_CLASSES, ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    bool ok = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "--verbose"))
+        {
+            verbose = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t s = 0; s < TEST_STREAM_COUNT; s++)
+    {
+        ok = test_stream(&streams[s]) && ok;
+    }
+    ok = test_scores() && ok;
+    ok = test_init() && ok;
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -1,8 +1,9 @@
 /****************************************************************************
 * File Name        : audio.c
 *
-* Description      : This file implements the interface with the PDM, as
-*                    well as the PDM ISR to feed the pre-processor.
+* Description      : This file implements the audio task which feeds the
+*                    blocks captured by the audio source to the audio core
+*                    and forwards the detections to the CM33.
 *
 * Related Document : See README.md
 *
@@ -46,10 +47,6 @@
 #include "cy_syslib.h"
 #include <time.h>
 
-#ifdef DIRECTIONOFARRIVAL_MODEL
-#include "ready_models/audio_data.h"
-#endif
-
 #ifdef COMPONENT_FREERTOS
 #include "FreeRTOS.h"
 #include "task.h"
@@ -58,15 +55,23 @@
 #endif
 
 #include "ipc_communication.h"
+#include "timebase.h"
+#include "audio/audio_source.h"
+#include "audio/audio_core.h"
+#include "audio/audio_clip_ring.h"
 
 /*****************************************************************************
  * Macros
  *****************************************************************************/
-#define SYSTICK_MAX_CNT                         (0xFFFFFF)
+/* Samples per captured frame. The audio task wakes once per frame, so
+ * smaller frames (e.g. 128 or 256) shorten the time from capture to model
+ * result at the cost of more task wakeups. Power of two, 128..1024. */
+#ifndef AUDIO_FRAME_SAMPLES
+#define AUDIO_FRAME_SAMPLES                     (1024u)
+#endif
 
-#define PDM_CHANNEL                             (3u)
 /* Define how many samples in a frame */
-#define FRAME_SIZE                              (1024)
+#define FRAME_SIZE                              AUDIO_FRAME_SAMPLES
 
 /* Desired sample rate. Typical values: 8/16/22.05/32/44.1/48kHz */
 #define SAMPLE_RATE_HZ                          16000u
@@ -74,18 +79,8 @@
 /* Decimation Rate of the PDM/PCM block. Typical value is 64 */
 #define DECIMATION_RATE                         64u
 
-#define DETECTCOUNT                             10
 #define LED_STOP_COUNT                          500
 
-/* PDM PCM hardware FIFO size */
-#define HW_FIFO_SIZE                            (64u)
-
-/* Rx FIFO trigger level/threshold configured by user */
-#define RX_FIFO_TRIG_LEVEL                      (HW_FIFO_SIZE/2)
-
-/* Total number of interrupts to get the FRAME_SIZE number of samples*/
-#define NUMBER_INTERRUPTS_FOR_FRAME             (FRAME_SIZE/RX_FIFO_TRIG_LEVEL)
-
 /* Multiplication factor of the input signal.
  * This should ideally be 1. Higher values will have a negative impact on
  * the sampling dynamic range. However, it can be used as a last resort
@@ -95,161 +90,583 @@
  * deployment of your own ML model set this to 1.0. */
 #define DIGITAL_BOOST_FACTOR                    1.0f
 
-/* Specifies the dynamic range in bits.
- * PCM word length, see the A/D specific documentation for valid ranges. */
- #define AUIDO_BITS_PER_SAMPLE                  16
+/* 1: convert the whole frame with CMSIS-DSP and poll the model only at hop
+ * boundaries. 0: legacy per-sample conversion with a dequeue poll after
+ * every sample, kept as a reference for cycle measurements. */
+#ifndef AUDIO_BLOCK_CONVERSION
+#define AUDIO_BLOCK_CONVERSION                  1
+#endif
 
-/* Converts given audio sample into range [-1,1] */
-#define SAMPLE_NORMALIZE(sample)                (((float) (sample)) / (float) (1 << (AUIDO_BITS_PER_SAMPLE - 1)))
+/* Number of samples between two model results. Polling more often than the
+ * model hop only returns IMAI_RET_NODATA. Must be a multiple of the model
+ * hop, a too large value is caught by IMAI_RET_NOMEM on enqueue. */
+#ifndef AUDIO_MODEL_HOP_SAMPLES
+#define AUDIO_MODEL_HOP_SAMPLES                 (256u)
+#endif
 
-/* PDM PCM interrupt configuration parameters */
-const cy_stc_sysint_t PDM_IRQ_cfg =
-{
-    .intrSrc = (IRQn_Type)CYBSP_PDM_CHANNEL_3_IRQ,
-    .intrPriority = 2
-};
+/* Number of capture blocks shared between the PDM ISR and audio_task. One
+ * block is always being filled, up to AUDIO_POOL_BLOCKS - 1 can be queued.
+ * The default buffers about 256 ms whatever the frame size. */
+#ifndef AUDIO_POOL_BLOCKS
+#define AUDIO_POOL_BLOCKS                       (((4096u / FRAME_SIZE) < AUDIO_POOL_MAX_BLOCKS) ? \
+                                                 (4096u / FRAME_SIZE) : AUDIO_POOL_MAX_BLOCKS)
+#endif
+
+/* A block processed later than one frame period after capture is late */
+#define AUDIO_FRAME_PERIOD_US                   ((FRAME_SIZE * 1000000u) / SAMPLE_RATE_HZ)
+
+/* Interval of the capture statistics print, 0 disables it */
+#ifndef AUDIO_POOL_REPORT_INTERVAL_MS
+#define AUDIO_POOL_REPORT_INTERVAL_MS           (60000u)
+#endif
+
+/* Prints the average and maximum processing cycles per frame every
+ * AUDIO_PROFILE_REPORT_FRAMES frames. 0 disables the measurement. */
+#ifndef AUDIO_PROFILE_REPORT_FRAMES
+#define AUDIO_PROFILE_REPORT_FRAMES             0
+#endif
+
+/* 1: skip the model on blocks the activity gate classifies as background.
+ * Only used with AUDIO_BLOCK_CONVERSION, needs frames of at least
+ * AUDIO_GATE_FFT_SIZE samples. */
+#ifndef AUDIO_GATE_ENABLE
+#define AUDIO_GATE_ENABLE                       (FRAME_SIZE >= AUDIO_GATE_FFT_SIZE)
+#endif
+
+/* Blocks replayed to the model when the gate opens, about 256 ms. The gate
+ * hold time is scaled from 1024-sample frames the same way. */
+#ifndef AUDIO_GATE_PREROLL_BLOCKS
+#define AUDIO_GATE_PREROLL_BLOCKS               (((4096u / FRAME_SIZE) < AUDIO_GATE_MAX_PREROLL) ? \
+                                                 (4096u / FRAME_SIZE) : AUDIO_GATE_MAX_PREROLL)
+#endif
+
+/* Normalized samples buffered for the models. A model falling further
+ * behind than this loses samples, counted as dropped in the hub. */
+#ifndef AUDIO_HUB_RING_SAMPLES
+#define AUDIO_HUB_RING_SAMPLES                  (2u * ((FRAME_SIZE > AUDIO_HUB_HOP_SAMPLES) ? \
+                                                       FRAME_SIZE : AUDIO_HUB_HOP_SAMPLES))
+#endif
+
+/* The legacy path polls every model after every sample */
+#if AUDIO_BLOCK_CONVERSION
+#define AUDIO_HUB_HOP_SAMPLES                   AUDIO_MODEL_HOP_SAMPLES
+#else
+#define AUDIO_HUB_HOP_SAMPLES                   (1u)
+#endif
+
+/* 1: keep the last seconds of audio as IMA-ADPCM and hand a clip around
+ * every detection to the CM33 for upload */
+#ifndef AUDIO_CLIP_ENABLE
+#define AUDIO_CLIP_ENABLE                       1
+#endif
+
+/* Audio kept before and recorded after a detection */
+#ifndef AUDIO_CLIP_PRE_MS
+#define AUDIO_CLIP_PRE_MS                       (3000u)
+#endif
+#ifndef AUDIO_CLIP_POST_MS
+#define AUDIO_CLIP_POST_MS                      (1000u)
+#endif
+
+#define AUDIO_CLIP_MS_TO_BLOCKS(ms)             ((((ms) * SAMPLE_RATE_HZ) / 1000u + FRAME_SIZE - 1u) / FRAME_SIZE)
+#define AUDIO_CLIP_POST_BLOCKS                  AUDIO_CLIP_MS_TO_BLOCKS(AUDIO_CLIP_POST_MS)
+#define AUDIO_CLIP_RING_BLOCKS                  (AUDIO_CLIP_MS_TO_BLOCKS(AUDIO_CLIP_PRE_MS) + AUDIO_CLIP_POST_BLOCKS)
+
+/* Bucket width of the capture-to-result latency histogram. The range is
+ * AUDIO_LATENCY_BUCKETS buckets, longer latencies only count for the max. */
+#ifndef AUDIO_LATENCY_BUCKET_US
+#define AUDIO_LATENCY_BUCKET_US                 (500u)
+#endif
 
 /* RTOS tasks */
 #define AUDIO_TASK_NAME                      "audio_task"
 #define AUDIO_TASK_STACK_SIZE                (configMINIMAL_STACK_SIZE * 10)
 #define AUDIO_TASK_PRIORITY                  (configMAX_PRIORITIES - 1)
 
-/*****************************************************************************
- * Function Prototypes
- *****************************************************************************/
-static void pdm_pcm_event_handler(void);
-
 /*******************************************************************************
 * Global Variables
 ********************************************************************************/
-volatile long tick1 = 0;
+/* Capture blocks, filled by the PDM source and processed by audio_task */
+static int16_t audio_pool_storage[AUDIO_POOL_BLOCKS * FRAME_SIZE];
+static audio_pool_t audio_pool;
+
+/* Models fed from the microphone. AUDIO_HUB_MODEL runs all of them on the
+ * same capture stream, otherwise MODEL_SELECTION picks one. */
+static const audio_model_t *const audio_models[] =
+{
+#if defined(COUGH_MODEL) || defined(AUDIO_HUB_MODEL)
+    &audio_model_cough,
+#endif
+#if defined(BABYCRY_MODEL) || defined(AUDIO_HUB_MODEL)
+    &audio_model_babycry,
+#endif
+#if defined(ALARM_MODEL) || defined(AUDIO_HUB_MODEL)
+    &audio_model_alarm,
+#endif
+};
+
+#define AUDIO_MODEL_COUNT                       (sizeof(audio_models) / sizeof(audio_models[0]))
 
-/* Set up one buffer for data collection and one for processing */
-int16_t audio_buffer0[FRAME_SIZE] = {0};
-int16_t audio_buffer1[FRAME_SIZE] = {0};
-int16_t* active_rx_buffer;
-int16_t* full_rx_buffer;
+/* Smoothing of the model outputs. A detection is reported once and the
+ * event is only cleared after AUDIO_PP_EXIT_COUNT predictions without it. */
+#define AUDIO_PP_EXIT_COUNT                     (3u)
 
-/* Model Output variable */
-int data_out[IMAI_DATA_OUT_COUNT] = {0};
-static const char* LABELS[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
+/* Detection pipeline shared with the host replay, see audio/audio_core.c */
+static audio_core_t audio_core;
+
+/* Model IDs in the IPC label table, by index in audio_models */
+static uint8_t audio_model_ids[AUDIO_MODEL_COUNT];
+static float audio_hub_ring[AUDIO_HUB_RING_SAMPLES];
+
+#if AUDIO_BLOCK_CONVERSION && AUDIO_GATE_ENABLE
+/* Activity gate in front of the models and its pre-roll */
+static audio_gate_t audio_gate;
+static float audio_gate_preroll[AUDIO_GATE_PREROLL_BLOCKS * FRAME_SIZE];
+#endif
+
+#if AUDIO_CLIP_ENABLE
+/* Compressed audio ring in socmem, read by the CM33 once a clip is frozen */
+CY_SECTION(".cy_socmem_data") CY_ALIGN(32)
+static uint8_t audio_clip_storage[AUDIO_CLIP_RING_BLOCKS * AUDIO_CLIP_BLOCK_BYTES(FRAME_SIZE)];
+CY_SECTION_SHAREDMEM static audio_clip_desc_t audio_clip_desc;
+static audio_clip_ring_t audio_clip;
+#endif
+
+/* LED variables */
+static int led_off = 0;
+static int led_on = 0;
+static unsigned long led_start_t = 0;
 
 /* Task handler */
 static TaskHandle_t audio_task_handler;
 
 /*******************************************************************************
-* Function Name: systick_isr1
+* Function Name: audio_get_time_us
 ********************************************************************************
-* Summary: This increments every time the SysTick counter decrements to 0.
+* Summary: Returns the time in microseconds used to stamp the captured blocks
+*          and to measure the latency. Called from the PDM ISR and the audio
+*          task. Wraps after 71 minutes, the latencies are differences.
 *
-* Parameters:
-*   None
+*******************************************************************************/
+static uint32_t audio_get_time_us(void)
+{
+    return (uint32_t)timebase_get_us();
+}
+
+/*******************************************************************************
+* Function Name: audio_get_cycles
+********************************************************************************
+* Summary: Returns the CM55 cycle counter, used for the per-model CPU share.
 *
-* Return:
-*   None
+*******************************************************************************/
+static uint32_t audio_get_cycles(void)
+{
+    return timebase_get_cycles32();
+}
+
+/*******************************************************************************
+* Function Name: audio_block_ready
+********************************************************************************
+* Summary: Called from the PDM ISR when a block was captured. Notifies the
+*          audio task.
 *
+* Parameters:
+*   cb_ctx : unused
 *
 *******************************************************************************/
-void systick_isr1(void)
+static void audio_block_ready(void *cb_ctx)
 {
-    tick1++;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)cb_ctx;
+
+    /* Send a task notification to the task */
+    vTaskNotifyGiveFromISR(audio_task_handler, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /*******************************************************************************
-* Function Name: get_time_from_millisec_audio
+* Function Name: audio_init
 ********************************************************************************
-* Summary: This function prints the time when a output class is detected.
+* Summary:
+*    A function used to initialize the capture block pool and start the
+*    audio source. The source signals every captured block to the task.
 *
 * Parameters:
-*   milliseconds : time when a output class is detected.
-*   timeString   : time of detected class in hr:m:s format.
+*   None
 *
 * Return:
-*   None
+*     The status of the initialization.
 *
 *
 *******************************************************************************/
-void get_time_from_millisec_audio(unsigned long milliseconds, char* timeString) {
-  unsigned int seconds = (milliseconds / 1000) % 60;
-  unsigned int minutes = (milliseconds / (1000 * 60)) % 60;
-  unsigned int hours = (milliseconds / (1000 * 60 * 60));
-  sprintf(timeString, "%02u:%02u:%02u", hours, minutes, seconds);
+cy_rslt_t audio_init(void)
+{
+    audio_source_config_t source_config =
+    {
+        .pool = &audio_pool,
+        .block_ready = audio_block_ready,
+        .cb_ctx = NULL,
+        .get_time = audio_get_time_us
+    };
+
+    /* Set up the capture block pool. The PDM ISR fills one block while the
+     * task processes the ones already captured. */
+    memset(audio_pool_storage, 0, sizeof(audio_pool_storage));
+    if (!audio_pool_init(&audio_pool, audio_pool_storage, AUDIO_POOL_BLOCKS, FRAME_SIZE, AUDIO_FRAME_PERIOD_US))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* Initialize the PDM/PCM block and start capturing */
+    if (!audio_source_start(&source_config))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return 0;
 }
 
 
 /*******************************************************************************
-* Function Name: audio_init
+* Function Name: audio_event
 ********************************************************************************
 * Summary:
-*    A function used to initialize and configure the PDM based on the shield
-*    selected in the Makefile. Starts an asynchronous read which triggers an
-*    interrupt when completed.
+*  Called by the audio core for every change of the smoothed state of a
+*  model. Forwards it to the CM33 and starts a clip on a detection.
 *
 * Parameters:
-*   None
+*  event : smoothed state change, the label ID is unique across the models
+*  ctx   : unused
 *
 * Return:
-*     The status of the initialization.
-*
+*  None
 *
 *******************************************************************************/
-cy_rslt_t audio_init(void)
+static void audio_event(const audio_core_event_t *event, void *ctx)
 {
-    cy_rslt_t result;
+    uint32_t inference_time = audio_get_time_us();
+    uint8_t scores[IPC_MAX_SCORES];
+    uint32_t score_count;
 
-    /* Set up pointers to two buffers to implement a ping-pong buffer system.
-     * One gets filled by the PDM while the other can be processed. */
-    memset(audio_buffer0, 0, FRAME_SIZE*sizeof(int16_t));
-    memset(audio_buffer1, 0, FRAME_SIZE*sizeof(int16_t));
-    active_rx_buffer = audio_buffer0;
-    full_rx_buffer = audio_buffer1;
+    (void)ctx;
+
+    if (event->class_id != 0)
+    {
+        /* New line when LED from off to on */
+        if ((led_off - CYBSP_LED_STATE_ON) > 0)
+        {
+            printf("\r\n");
+        }
 
-    /* Initialize PDM PCM block */
-    result = Cy_PDM_PCM_Init(CYBSP_PDM_HW, &CYBSP_PDM_config);
-    if(CY_PDM_PCM_SUCCESS != result)
+        /* Print triggered class and the triggered time since IMAI init.*/
+        unsigned long t = timebase_get_ms() - led_start_t;
+        char timeString[TIMEBASE_HMS_SIZE];
+        timebase_format_hms(t, timeString, sizeof(timeString));
+        printf("%s %s (%lu us after capture)\r\n",event->label,timeString,
+               (unsigned long)(inference_time - event->capture_time));
+#if AUDIO_CLIP_ENABLE
+        (void)audio_clip_ring_trigger(&audio_clip, event->label_id);
+#endif
+        // Do not control the LED:
+        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
+        led_off = 0;
+        led_on = timebase_get_ms();
+    }
+    else
     {
-        return result;
+        /* Turn off LED after the LED is on for 500ms */
+        if((timebase_get_ms() - led_on) > LED_STOP_COUNT)
+        {
+            // Do not control the LED:
+            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
+        }
+        led_off = 1;
     }
 
-    Cy_PDM_PCM_Channel_Enable(CYBSP_PDM_HW, PDM_CHANNEL);
-    /* Initialize and enable PDM PCM channel 3 -Right */
-    Cy_PDM_PCM_Channel_Init(CYBSP_PDM_HW, &channel_3_config, PDM_CHANNEL);
+    score_count = postprocess_get_scores(&audio_core.pp[event->model], scores, IPC_MAX_SCORES);
+    cm55_ipc_send_result(audio_model_ids[event->model], event->label_id, scores, score_count,
+                         event->capture_time, inference_time);
+}
 
-    /* Set the gain as per the model. */
-    #ifdef ALARM_MODEL
-    Cy_PDM_PCM_SetGain(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_SEL_GAIN_23DB);
-    #else
-    Cy_PDM_PCM_SetGain(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_SEL_GAIN_5DB);
-    #endif
+/*******************************************************************************
+* Function Name: audio_model_status
+********************************************************************************
+* Summary:
+*  Called by the audio core when a model fails or its evaluation period ends.
+*
+* Parameters:
+*  model  : index in audio_models
+*  status : AUDIO_MODEL_RET_NOMEM or AUDIO_MODEL_RET_TIMEDOUT
+*  ctx    : unused
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void audio_model_status(uint32_t model, int status, void *ctx)
+{
+    (void)ctx;
+
+    if (AUDIO_MODEL_RET_NOMEM == status)
+    {
+        /* Something went wrong, stop the program */
+        printf("Unable to perform inference (%s). Internal memory error.\r\n", audio_models[model]->name);
+    }
+    else
+    {
+        printf("The evaluation period of the %s model has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n",
+               audio_models[model]->name);
+    }
+}
 
-    /* An interrupt is registered for right channel, clear and set masks for it. */
-    Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
-    Cy_PDM_PCM_Channel_SetInterruptMask(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
+/*******************************************************************************
+* Function Name: audio_control
+********************************************************************************
+* Summary:
+*  Applies a control request from the CM33. Called by audio_task between two
+*  frames through cm55_ipc_poll_control().
+*
+* Parameters:
+*  request : control request, label_id is the ipc_control_param_t
+*  value   : requested value, receives the value applied
+*  ctx     : unused
+*
+* Return:
+*  ipc_control_status_t of the request
+*
+*******************************************************************************/
+static ipc_control_status_t audio_control(const ipc_payload_t *request, int32_t *value, void *ctx)
+{
+    (void)ctx;
 
-    /* Register the IRQ handler */
-    result = Cy_SysInt_Init(&PDM_IRQ_cfg, &pdm_pcm_event_handler);
-    if(CY_SYSINT_SUCCESS != result)
+    switch (request->label_id)
     {
-        return result;
+        case IPC_CONTROL_SENSITIVITY:
+        {
+            for (uint32_t m = 0; m < AUDIO_MODEL_COUNT; m++)
+            {
+                const uint8_t *args = request->control.args;
+
+                if ((audio_model_ids[m] != request->model_id) || (NULL == audio_models[m]->sensitivity))
+                {
+                    continue;
+                }
+                if (0 == *value)
+                {
+                    return (AUDIO_MODEL_RET_SUCCESS == audio_models[m]->sensitivity(NULL)) ?
+                           IPC_CONTROL_STATUS_OK : IPC_CONTROL_STATUS_FAILED;
+                }
+                if ((*value < 0) || (*value > 100) || (0u == args[0]) || (0u == args[1]) ||
+                    (0u == args[2]) || (args[3] > args[2]))
+                {
+                    return IPC_CONTROL_STATUS_INVALID;
+                }
+
+                audio_model_sensitivity_t sensitivity =
+                {
+                    .confidence = (float)*value / 100.0f,
+                    .average = args[0],
+                    .subsequent = args[1],
+                    .pool = args[2],
+                    .pool_selection = args[3]
+                };
+                return (AUDIO_MODEL_RET_SUCCESS == audio_models[m]->sensitivity(&sensitivity)) ?
+                       IPC_CONTROL_STATUS_OK : IPC_CONTROL_STATUS_FAILED;
+            }
+            return IPC_CONTROL_STATUS_UNSUPPORTED;
+        }
+
+#if AUDIO_BLOCK_CONVERSION && AUDIO_GATE_ENABLE
+        case IPC_CONTROL_GATE:
+        {
+            audio_gate_cfg_t gate_cfg = audio_gate.cfg;
+
+            if ((*value != 0) && (*value != 1))
+            {
+                return IPC_CONTROL_STATUS_INVALID;
+            }
+            /* Start again from an empty pre-roll and a new noise floor */
+            if ((0 != *value) && (NULL == audio_core.cfg.gate) &&
+                !audio_gate_init(&audio_gate, &gate_cfg, audio_gate_preroll, FRAME_SIZE))
+            {
+                return IPC_CONTROL_STATUS_FAILED;
+            }
+            audio_core.cfg.gate = (0 != *value) ? &audio_gate : NULL;
+            return IPC_CONTROL_STATUS_OK;
+        }
+
+        case IPC_CONTROL_GATE_OPEN_RATIO:
+            if (*value <= 100)
+            {
+                return IPC_CONTROL_STATUS_INVALID;
+            }
+            audio_gate.cfg.open_ratio = (float)*value / 100.0f;
+            return IPC_CONTROL_STATUS_OK;
+#endif
+
+        case IPC_CONTROL_PREPROCESSING:
+            if ((*value != 0) && (*value != 1))
+            {
+                return IPC_CONTROL_STATUS_INVALID;
+            }
+            audio_core.cfg.per_sample = (0 != *value);
+            return IPC_CONTROL_STATUS_OK;
+
+        default:
+            return IPC_CONTROL_STATUS_UNSUPPORTED;
     }
-    NVIC_ClearPendingIRQ(PDM_IRQ_cfg.intrSrc);
-    NVIC_EnableIRQ(PDM_IRQ_cfg.intrSrc);
+}
 
-    /* Set up pointers to two buffers to implement a ping-pong buffer system.
-    * One gets filled by the PDM while the other can be processed. */
-    active_rx_buffer = audio_buffer0;
-    full_rx_buffer = audio_buffer1;
+#if AUDIO_CLIP_ENABLE
+/*******************************************************************************
+* Function Name: audio_clip_record
+********************************************************************************
+* Summary:
+*  Adds a captured frame to the clip ring. Once the audio after a detection
+*  is recorded, the clip is written back from the data cache and announced
+*  to the CM33, which releases it after the upload.
+*
+* Parameters:
+*  frame : FRAME_SIZE PCM samples
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void audio_clip_record(const int16_t *frame)
+{
+    if (!audio_clip_ring_push(&audio_clip, frame))
+    {
+        return;
+    }
 
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    SCB_CleanDCache_by_Addr((void*)audio_clip_storage, (int32_t)sizeof(audio_clip_storage));
+#endif
+    cm55_ipc_send_audio_clip(audio_clip_desc.label_id, &audio_clip_desc);
+}
+#endif
 
-    Cy_PDM_PCM_Activate_Channel(CYBSP_PDM_HW, PDM_CHANNEL);
+#if AUDIO_PROFILE_REPORT_FRAMES > 0
+/*******************************************************************************
+* Function Name: audio_profile_frame
+********************************************************************************
+* Summary:
+*  Accumulates the cycles spent on one frame and prints the average and
+*  maximum every AUDIO_PROFILE_REPORT_FRAMES frames.
+*
+* Parameters:
+*  cycles : DWT cycles spent in audio_core_process
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void audio_profile_frame(uint32_t cycles)
+{
+    static uint64_t total_cycles = 0;
+    static uint32_t max_cycles = 0;
+    static uint32_t frames = 0;
 
-    /*timer set up*/
-    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_IMO , (8000000/1000)-1);
-    Cy_SysTick_SetCallback(0, systick_isr1);        /* point to SysTick ISR to increment the 1ms count */
+    total_cycles += cycles;
+    if (cycles > max_cycles)
+    {
+        max_cycles = cycles;
+    }
 
-    return 0;
+    if (++frames >= AUDIO_PROFILE_REPORT_FRAMES)
+    {
+        printf("audio: %s path, %lu cycles/frame avg, %lu max\r\n",
+               AUDIO_BLOCK_CONVERSION ? "block" : "sample",
+               (unsigned long)(total_cycles / frames), (unsigned long)max_cycles);
+        total_cycles = 0;
+        max_cycles = 0;
+        frames = 0;
+    }
 }
+#endif
+
+#if AUDIO_POOL_REPORT_INTERVAL_MS > 0
+/*******************************************************************************
+* Function Name: audio_pool_report
+********************************************************************************
+* Summary:
+*  Prints the capture block statistics every AUDIO_POOL_REPORT_INTERVAL_MS.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void audio_pool_report(void)
+{
+    static uint32_t last_report = 0;
+    uint32_t now = timebase_get_ms();
+    audio_pool_stats_t stats;
+    audio_source_stats_t source_stats;
 
+    if ((now - last_report) < AUDIO_POOL_REPORT_INTERVAL_MS)
+    {
+        return;
+    }
+    last_report = now;
+
+    audio_pool_get_stats(&audio_pool, &stats);
+    audio_source_get_stats(&source_stats);
+    printf("audio: %lu blocks, %lu overruns, %lu gaps, %lu late, depth max %lu, latency avg %lu us max %lu us\r\n",
+           (unsigned long)stats.consumed, (unsigned long)stats.overruns, (unsigned long)stats.gaps,
+           (unsigned long)stats.late,
+           (unsigned long)stats.depth_max,
+           (unsigned long)((0u == stats.consumed) ? 0u : (stats.latency_sum / stats.consumed)),
+           (unsigned long)stats.latency_max);
+    printf("audio: %lu interrupts for %lu captured blocks, %lu FIFO overflows\r\n",
+           (unsigned long)source_stats.interrupts, (unsigned long)source_stats.blocks,
+           (unsigned long)source_stats.hw_overflows);
+    audio_latency_summary_t latency;
+    audio_latency_summarize(&audio_core.latency, &latency);
+    printf("audio: %lu-sample frames, %lu results, capture to result p50 %lu us, p90 %lu us, p99 %lu us, max %lu us\r\n",
+           (unsigned long)FRAME_SIZE, (unsigned long)latency.count, (unsigned long)latency.p50_us,
+           (unsigned long)latency.p90_us, (unsigned long)latency.p99_us, (unsigned long)latency.max_us);
+    audio_latency_reset(&audio_core.latency);
+#if AUDIO_CLIP_ENABLE
+    audio_clip_ring_stats_t clip_stats;
+    audio_clip_ring_get_stats(&audio_clip, &clip_stats);
+    printf("audio: %lu clips, %lu triggers while busy, %lu blocks not recorded during upload\r\n",
+           (unsigned long)clip_stats.clips, (unsigned long)clip_stats.busy_triggers,
+           (unsigned long)clip_stats.paused_blocks);
+#endif
+#if AUDIO_BLOCK_CONVERSION && AUDIO_GATE_ENABLE
+    audio_gate_stats_t gate_stats;
+    audio_gate_get_stats(&audio_gate, &gate_stats);
+    printf("audio: gate skipped %lu of %lu blocks (%lu s), %lu opens\r\n",
+           (unsigned long)gate_stats.gated_blocks, (unsigned long)gate_stats.blocks,
+           (unsigned long)(((uint64_t)gate_stats.gated_blocks * FRAME_SIZE) / SAMPLE_RATE_HZ),
+           (unsigned long)gate_stats.opens);
+#endif
+
+    /* CPU share of every model since the previous report */
+    static uint64_t last_cycles[AUDIO_HUB_MAX_MODELS];
+    static uint32_t last_results[AUDIO_HUB_MAX_MODELS];
+    uint64_t elapsed_cycles = (uint64_t)AUDIO_POOL_REPORT_INTERVAL_MS * (SystemCoreClock / 1000u);
+    for (uint32_t m = 0; m < AUDIO_MODEL_COUNT; m++)
+    {
+        audio_hub_model_stats_t model_stats;
+        audio_hub_get_stats(&audio_core.hub, m, &model_stats);
+        uint64_t cycles = model_stats.cycles - last_cycles[m];
+        printf("audio: %s model %lu.%lu%% CPU, %lu results, %lu samples dropped\r\n",
+               audio_models[m]->name,
+               (unsigned long)((cycles * 100u) / elapsed_cycles),
+               (unsigned long)(((cycles * 1000u) / elapsed_cycles) % 10u),
+               (unsigned long)(model_stats.results - last_results[m]),
+               (unsigned long)model_stats.dropped);
+        last_cycles[m] = model_stats.cycles;
+        last_results[m] = model_stats.results;
+    }
+}
+#endif
 
 /*******************************************************************************
 * Function Name: audio_task
@@ -269,116 +686,106 @@ cy_rslt_t audio_init(void)
 void audio_task(void *pvParameters)
 {
     cy_rslt_t result;
-    /* LED variables */
-    static int led_off = 0;
-    static int led_on = 0;
-    int label_scores[IMAI_DATA_OUT_COUNT];
-    static int prediction_count = 0;
-    static int16_t success_flag = 0;
-    
-    /* Initialize DEEPCRAFT pre-processing library */
-    IMAI_AED_init();
-    
+
+    audio_core_cfg_t core_cfg =
+    {
+        .models = audio_models,
+        .model_count = AUDIO_MODEL_COUNT,
+        .frame_samples = FRAME_SIZE,
+        .sample_rate = SAMPLE_RATE_HZ,
+        .time_scale = 1000000u,
+        .boost = DIGITAL_BOOST_FACTOR,
+        .capture_gain_db = AUDIO_SOURCE_GAIN_DB,
+        .per_sample = !AUDIO_BLOCK_CONVERSION,
+        .hub_ring = audio_hub_ring,
+        .hub_ring_samples = AUDIO_HUB_RING_SAMPLES,
+        .hop_samples = AUDIO_HUB_HOP_SAMPLES,
+        .gate = NULL,
+        .exit_count = AUDIO_PP_EXIT_COUNT,
+        .latency_bucket = AUDIO_LATENCY_BUCKET_US,
+        .event_cb = audio_event,
+        .status_cb = audio_model_status,
+        .cb_ctx = NULL,
+        .get_time = audio_get_time_us,
+        .get_cycles = audio_get_cycles
+    };
+
+#if AUDIO_CLIP_ENABLE
+    if (!audio_clip_ring_init(&audio_clip, &audio_clip_desc, audio_clip_storage, AUDIO_CLIP_RING_BLOCKS,
+                              FRAME_SIZE, SAMPLE_RATE_HZ, AUDIO_CLIP_POST_BLOCKS))
+    {
+        CY_ASSERT(0);
+    }
+#endif
+#if AUDIO_BLOCK_CONVERSION && AUDIO_GATE_ENABLE
+    audio_gate_cfg_t gate_cfg;
+    audio_gate_default_config(&gate_cfg);
+    gate_cfg.preroll_blocks = AUDIO_GATE_PREROLL_BLOCKS;
+    gate_cfg.hold_blocks = (uint16_t)((gate_cfg.hold_blocks * 1024u) / FRAME_SIZE);
+    gate_cfg.warmup_blocks = (uint16_t)((gate_cfg.warmup_blocks * 1024u) / FRAME_SIZE);
+    if (!audio_gate_init(&audio_gate, &gate_cfg, audio_gate_preroll, FRAME_SIZE))
+    {
+        CY_ASSERT(0);
+    }
+    core_cfg.gate = &audio_gate;
+#endif
+
+    /* Initialize the DEEPCRAFT pre-processing libraries */
+    if (!audio_core_init(&audio_core, &core_cfg))
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Publish the class names once, the results only carry the IDs */
+    for (uint32_t m = 0; m < AUDIO_MODEL_COUNT; m++)
+    {
+        int model_id = cm55_ipc_add_model(audio_models[m]->name, audio_models[m]->labels,
+                                          audio_models[m]->class_count);
+        if (model_id < 0)
+        {
+            CY_ASSERT(0);
+        }
+        audio_model_ids[m] = (uint8_t)model_id;
+    }
+    cm55_ipc_publish_labels();
+    cm55_ipc_set_control_handler(audio_control, NULL);
+
     result = audio_init();
     if(result != 0)
     {
         CY_ASSERT(0);
     }
 
-    unsigned long led_start_t = tick1;
+    led_start_t = timebase_get_ms();
 
     for(;;)
     {
         /* Wait here until ISR notifies us */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        
-        for (uint32_t index = 0; index < FRAME_SIZE; index++)
-        {
-
-            int16_t val_temp = full_rx_buffer[index];
 
-            /*convert int to float*/
-            float data_in = SAMPLE_NORMALIZE(val_temp) * DIGITAL_BOOST_FACTOR;
-
-            if (data_in > 1.0)
-            {
-                data_in = 1.0f;
-            }
-            else if (data_in < -1.0)
-            {
-               data_in = -1.0f;
-            }
+        /* Process every captured block, the ISR may have queued several */
+        const audio_pool_block_t *block;
+        while (NULL != (block = audio_source_get_block(audio_get_time_us())))
+        {
+#if AUDIO_CLIP_ENABLE
+            audio_clip_record(block->data);
+#endif
+#if AUDIO_PROFILE_REPORT_FRAMES > 0
+            uint32_t frame_start = timebase_get_cycles32();
+            audio_core_process(&audio_core, block->data, block->timestamp);
+            audio_profile_frame(timebase_get_cycles32() - frame_start);
+#else
+            audio_core_process(&audio_core, block->data, block->timestamp);
+#endif
+            audio_source_release_block();
+        }
 
-            /*pass audio sample for enqueue*/
-            result = IMAI_AED_enqueue(&data_in);
+        /* Parameters only change between two frames */
+        cm55_ipc_poll_control();
 
-            switch(IMAI_AED_dequeue(label_scores))
-            {
-                case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-
-                    success_flag = 1;
-                    prediction_count += 1;
-                    if (label_scores[1] == 1)
-                    {
-                        payload->label_id = 1;
-                        strcpy(payload->label, LABELS[1]);
-
-                        /* New line when LED from off to on */
-                        if ((led_off - CYBSP_LED_STATE_ON) > 0)
-                        {
-                            printf("\r\n");
-                        }
-
-                        /* Print triggered class and the triggered time since IMAI init.*/
-                        unsigned long t = tick1 - led_start_t;
-                        char timeString[9];
-                        get_time_from_millisec_audio(t, timeString);
-                        printf("%s %s\r\n",LABELS[1],timeString);
-                        // Do not control the LED:
-                        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
-                        led_off = 0;
-                        led_on = tick1;
-                    }
-                    else
-                    {
-                        payload->label_id = 0;
-                        strcpy(payload->label, LABELS[0]);
-
-                        /* Only print non-label class very 10 predictions */
-                        if (prediction_count>DETECTCOUNT)
-                        {
-                            //printf(".");
-                            // fflush( stdout );
-                            prediction_count = 0;
-                        }
-                        /* Turn off LED after the LED is on for 500ms */
-                        if((tick1 - led_on) > LED_STOP_COUNT)
-                        {
-                            // Do not control the LED:
-                            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
-                        }
-                        led_off = 1;
-                    }
-
-                    cm55_ipc_send_to_cm33();
-                    
-                    break;
-                    
-                    case IMAI_RET_NOMEM:
-                        /* Something went wrong, stop the program */
-                        printf("Unable to perform inference. Internal memory error.\r\n");
-                        break;
-                    case IMAI_RET_TIMEDOUT:
-                         if (success_flag == 1)
-                         {
-                              printf("The evaluation period has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n");
-                         }
-                         success_flag = 0;
-                         break;
-
-            }
-        }
+#if AUDIO_POOL_REPORT_INTERVAL_MS > 0
+        audio_pool_report();
+#endif
     }
 }
 
@@ -402,7 +809,10 @@ cy_rslt_t create_audio_task(void)
     BaseType_t status;
 
     #ifdef CM55_ENABLE_STARTUP_PRINTS
-    printf("****************** DEEPCRAFT Ready Model: %s ****************** \r\n\n", LABELS[1]);
+    for (uint32_t m = 0; m < AUDIO_MODEL_COUNT; m++)
+    {
+        printf("****************** DEEPCRAFT Ready Model: %s ****************** \r\n\n", audio_models[m]->labels[1]);
+    }
     #endif
 
     /* Create the RTOS task */
@@ -413,61 +823,4 @@ cy_rslt_t create_audio_task(void)
 }
 
 
-/*******************************************************************************
-* Function Name: pdm_pcm_event_handler
-********************************************************************************
-* Summary:
-*  PDM/PCM ISR handler. A flag is set when the interrupt is generated.
-*
-* Parameters:
-*  arg: not used
-*  event: event that occurred
-*
-*******************************************************************************/
-static void pdm_pcm_event_handler(void)
-{
-    /* Used to track how full the buffer is */
-    static uint16_t frame_counter = 0;
-    
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-
-    /* Check the interrupt status */
-    uint32_t intr_status = Cy_PDM_PCM_Channel_GetInterruptStatusMasked(CYBSP_PDM_HW, PDM_CHANNEL);
-    if(CY_PDM_PCM_INTR_RX_TRIGGER & intr_status)
-    {
-        /* Move data from the PDM fifo and place it in a buffer */
-        for(uint32_t index=0; index < RX_FIFO_TRIG_LEVEL; index++)
-        {
-            int32_t data = (int32_t)Cy_PDM_PCM_Channel_ReadFifo(CYBSP_PDM_HW, PDM_CHANNEL);
-            active_rx_buffer[frame_counter * RX_FIFO_TRIG_LEVEL + index] = (int16_t)(data);
-        }
-        Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_RX_TRIGGER);
-        frame_counter++;
-    }
-
-    /* Check if the buffer is full */
-    if((NUMBER_INTERRUPTS_FOR_FRAME) <= frame_counter)
-    {
-        /* Flip the active and the next rx buffers */
-        int16_t* temp = active_rx_buffer;
-        active_rx_buffer = full_rx_buffer;
-        full_rx_buffer = temp;
-
-        /* Send a task notification to the task */
-        vTaskNotifyGiveFromISR(audio_task_handler, &xHigherPriorityTaskWoken);
-        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
-        frame_counter = 0;
-
-    }
-
-    /* Clear the remaining interrupts */
-    if((CY_PDM_PCM_INTR_RX_FIR_OVERFLOW | CY_PDM_PCM_INTR_RX_OVERFLOW |
-            CY_PDM_PCM_INTR_RX_IF_OVERFLOW | CY_PDM_PCM_INTR_RX_UNDERFLOW) & intr_status)
-    {
-        Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
-    }
-
-}
-
-
 /* [] END OF FILE */
@@ -42,15 +42,6 @@
 #include <stdlib.h>
 #include "cybsp.h"
 #include "cy_result.h"
-#ifdef COUGH_MODEL
-#include "ready_models/cough_lib.h"
-#endif
-#ifdef ALARM_MODEL
-#include "alarm_siren_lib.h"
-#endif
-#ifdef BABYCRY_MODEL
-#include "ready_models/babycry_lib.h"
-#endif
 
 #include "stdio.h"
 
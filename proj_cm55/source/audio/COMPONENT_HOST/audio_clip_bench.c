@@ -0,0 +1,338 @@
+/******************************************************************************
+* File Name:   audio_clip_bench.c
+*
+* Description: This file implements a host benchmark and round-trip check of
+*              the IMA-ADPCM coder and the pre-trigger clip recorder. The
+*              coder throughput is measured on a WAV file or on a generated
+*              test signal, the decoded audio is compared with the input,
+*              and clips frozen by the recorder are decoded block by block
+*              and compared with the audio they were recorded from.
+*
+*              Usage: audio_clip_bench [file.wav] [--min-snr DB]
+*
+*              The exit code is 1 if a round-trip check failed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "audio_adpcm.h"
+#include "audio_clip_ring.h"
+#include "wav_reader.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same block size and sample rate as audio_task */
+#define BENCH_BLOCK_SAMPLES                 (1024u)
+#define BENCH_SAMPLE_RATE                   (16000u)
+#define BENCH_MAX_CHANNELS                  (8u)
+
+/* Generated test signal: chirp with noise */
+#define BENCH_SIGNAL_SECONDS                (30u)
+
+#define BENCH_RING_BLOCKS                   (48u)
+#define BENCH_POST_BLOCKS                   (16u)
+#define BENCH_REPEAT                        (10u)
+
+#define BENCH_DEFAULT_MIN_SNR_DB            (15.0)
+
+#define BENCH_TWO_PI                        (6.283185307179586)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t ring_storage[BENCH_RING_BLOCKS * AUDIO_CLIP_BLOCK_BYTES(BENCH_BLOCK_SAMPLES)];
+static audio_clip_desc_t clip_desc;
+
+/*******************************************************************************
+* Function Name: bench_now_s
+*******************************************************************************/
+static double bench_now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+* Function Name: bench_snr_db
+*******************************************************************************/
+static double bench_snr_db(const int16_t *ref, const int16_t *test, uint32_t count)
+{
+    double signal = 0.0;
+    double noise = 0.0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        double d = (double)ref[i] - (double)test[i];
+        signal += (double)ref[i] * (double)ref[i];
+        noise += d * d;
+    }
+
+    return (noise <= 0.0) ? 200.0 : 10.0 * log10(signal / noise);
+}
+
+/*******************************************************************************
+* Function Name: bench_load
+********************************************************************************
+* Summary:
+*  Loads the first channel of a WAV file, or generates the test signal if
+*  no file is given. The length is rounded down to whole blocks.
+*
+*******************************************************************************/
+static int16_t* bench_load(const char *path, uint32_t *count)
+{
+    int16_t *pcm;
+
+    if (NULL == path)
+    {
+        uint32_t n = BENCH_SIGNAL_SECONDS * BENCH_SAMPLE_RATE;
+        double phase = 0.0;
+
+        pcm = malloc(n * sizeof(int16_t));
+        if (NULL == pcm)
+        {
+            return NULL;
+        }
+        srand(1);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            double t = (double)i / BENCH_SAMPLE_RATE;
+            double f = 100.0 + (2000.0 * t) / BENCH_SIGNAL_SECONDS;
+            double noise = ((double)rand() / RAND_MAX - 0.5) * 1000.0;
+
+            phase += BENCH_TWO_PI * f / BENCH_SAMPLE_RATE;
+            pcm[i] = (int16_t)(8000.0 * sin(phase) + noise);
+        }
+        *count = n;
+        return pcm;
+    }
+
+    wav_reader_t wav;
+    int16_t frames[BENCH_BLOCK_SAMPLES * BENCH_MAX_CHANNELS];
+
+    if (!wav_reader_open(&wav, path) || (wav.channels > BENCH_MAX_CHANNELS))
+    {
+        return NULL;
+    }
+    pcm = malloc(((wav.frames > 0u) ? wav.frames : 1u) * sizeof(int16_t));
+    *count = 0;
+    while (NULL != pcm)
+    {
+        uint32_t n = wav_reader_read(&wav, frames, BENCH_BLOCK_SAMPLES);
+
+        if (BENCH_BLOCK_SAMPLES != n)
+        {
+            break;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            pcm[*count + i] = frames[i * wav.channels];
+        }
+        *count += n;
+    }
+    wav_reader_close(&wav);
+
+    return pcm;
+}
+
+/*******************************************************************************
+* Function Name: bench_coder
+********************************************************************************
+* Summary:
+*  Measures the encode and decode throughput and the round-trip SNR.
+*
+*******************************************************************************/
+static bool bench_coder(const int16_t *pcm, uint32_t count, double min_snr)
+{
+    uint8_t *adpcm = malloc(count / 2u);
+    int16_t *decoded = malloc(count * sizeof(int16_t));
+    audio_adpcm_state_t state;
+    double start;
+    double encode_s;
+    double decode_s;
+    double snr;
+
+    if ((NULL == adpcm) || (NULL == decoded))
+    {
+        return false;
+    }
+
+    start = bench_now_s();
+    for (uint32_t r = 0; r < BENCH_REPEAT; r++)
+    {
+        audio_adpcm_reset(&state);
+        audio_adpcm_encode(&state, pcm, count, adpcm);
+    }
+    encode_s = (bench_now_s() - start) / BENCH_REPEAT;
+
+    start = bench_now_s();
+    for (uint32_t r = 0; r < BENCH_REPEAT; r++)
+    {
+        audio_adpcm_reset(&state);
+        audio_adpcm_decode(&state, adpcm, count, decoded);
+    }
+    decode_s = (bench_now_s() - start) / BENCH_REPEAT;
+
+    snr = bench_snr_db(pcm, decoded, count);
+    printf("coder: %lu samples, encode %.1f Msamples/s (%.0fx realtime), decode %.1f Msamples/s\n",
+           (unsigned long)count, count / encode_s * 1e-6, (count / encode_s) / BENCH_SAMPLE_RATE,
+           count / decode_s * 1e-6);
+    printf("coder: %lu -> %lu bytes, SNR %.1f dB\n",
+           (unsigned long)(count * sizeof(int16_t)), (unsigned long)(count / 2u), snr);
+
+    free(adpcm);
+    free(decoded);
+
+    return snr >= min_snr;
+}
+
+/*******************************************************************************
+* Function Name: bench_check_clip
+********************************************************************************
+* Summary:
+*  Decodes a frozen clip block by block from the block headers and compares
+*  it with the input it was recorded from.
+*
+*******************************************************************************/
+static bool bench_check_clip(const int16_t *pcm, uint32_t trigger_block, double min_snr)
+{
+    int16_t decoded[BENCH_BLOCK_SAMPLES];
+    uint32_t first = trigger_block + BENCH_POST_BLOCKS + 1u - clip_desc.block_count;
+    double worst = 200.0;
+
+    if (clip_desc.trigger_block != (trigger_block - first))
+    {
+        printf("clip %lu: trigger at block %lu, expected %lu\n", (unsigned long)clip_desc.clip_id,
+               (unsigned long)clip_desc.trigger_block, (unsigned long)(trigger_block - first));
+        return false;
+    }
+
+    for (uint32_t b = 0; b < clip_desc.block_count; b++)
+    {
+        const uint8_t *block = audio_clip_ring_block(&clip_desc, ring_storage, b);
+        audio_clip_block_header_t header;
+        audio_adpcm_state_t state;
+        double snr;
+
+        memcpy(&header, block, sizeof(header));
+        state.predictor = header.predictor;
+        state.step_index = header.step_index;
+        audio_adpcm_decode(&state, block + sizeof(header), BENCH_BLOCK_SAMPLES, decoded);
+
+        snr = bench_snr_db(&pcm[(first + b) * BENCH_BLOCK_SAMPLES], decoded, BENCH_BLOCK_SAMPLES);
+        if (snr < worst)
+        {
+            worst = snr;
+        }
+    }
+
+    printf("clip %lu: %lu blocks, trigger block %lu, worst block SNR %.1f dB\n",
+           (unsigned long)clip_desc.clip_id, (unsigned long)clip_desc.block_count,
+           (unsigned long)clip_desc.trigger_block, worst);
+
+    return worst >= min_snr;
+}
+
+/*******************************************************************************
+* Function Name: bench_clip_ring
+********************************************************************************
+* Summary:
+*  Records the input with a trigger every ring length, releasing every clip
+*  after a few blocks like the uploader would, and checks every clip.
+*
+*******************************************************************************/
+static bool bench_clip_ring(const int16_t *pcm, uint32_t count, double min_snr)
+{
+    audio_clip_ring_t clip;
+    audio_clip_ring_stats_t stats;
+    uint32_t blocks = count / BENCH_BLOCK_SAMPLES;
+    uint32_t trigger_block = 0;
+    uint32_t release_at = 0;
+    bool ok = true;
+    double start;
+
+    if (!audio_clip_ring_init(&clip, &clip_desc, ring_storage, BENCH_RING_BLOCKS, BENCH_BLOCK_SAMPLES,
+                              BENCH_SAMPLE_RATE, BENCH_POST_BLOCKS))
+    {
+        return false;
+    }
+
+    start = bench_now_s();
+    for (uint32_t b = 0; b < blocks; b++)
+    {
+        if ((AUDIO_CLIP_STATE_READY == clip_desc.state) && (b >= release_at))
+        {
+            clip_desc.state = AUDIO_CLIP_STATE_FREE;
+        }
+        if (audio_clip_ring_push(&clip, &pcm[b * BENCH_BLOCK_SAMPLES]))
+        {
+            ok = bench_check_clip(pcm, trigger_block, min_snr) && ok;
+            release_at = b + 4u;
+        }
+        if (0u == ((b + 1u) % BENCH_RING_BLOCKS))
+        {
+            if (audio_clip_ring_trigger(&clip, 1u))
+            {
+                trigger_block = b;
+            }
+        }
+    }
+
+    audio_clip_ring_get_stats(&clip, &stats);
+    printf("ring: %lu blocks in %.3f s, %lu clips, %lu busy triggers, %lu paused blocks\n",
+           (unsigned long)stats.blocks, bench_now_s() - start, (unsigned long)stats.clips,
+           (unsigned long)stats.busy_triggers, (unsigned long)stats.paused_blocks);
+
+    return ok && (stats.clips > 0u);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    double min_snr = BENCH_DEFAULT_MIN_SNR_DB;
+    uint32_t count = 0;
+    int16_t *pcm;
+    bool ok;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--min-snr")) && ((i + 1) < argc))
+        {
+            min_snr = atof(argv[++i]);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    pcm = bench_load(path, &count);
+    if ((NULL == pcm) || (count < (BENCH_RING_BLOCKS * BENCH_BLOCK_SAMPLES)))
+    {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file or too short\n", (NULL != path) ? path : "signal");
+        return 2;
+    }
+
+    ok = bench_coder(pcm, count, min_snr);
+    ok = bench_clip_ring(pcm, count, min_snr) && ok;
+    free(pcm);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name:   audio_gate_replay.c
+*
+* Description: This file implements a host replay of labelled recordings
+*              through the audio activity gate. It reports how much audio the
+*              gate withholds from the model and checks that the start of
+*              every labelled event reaches the model.
+*
+*              Usage: audio_gate_replay <file.wav> <labels.csv> [--coverage S]
+*
+*              The labels file has one "start_s,end_s[,label]" event per
+*              line, lines starting with '#' are ignored. The exit code is
+*              1 if an event was missed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio_gate.h"
+#include "wav_reader.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same block size as audio_task */
+#define REPLAY_BLOCK_SAMPLES                (1024u)
+#define REPLAY_MAX_CHANNELS                 (8u)
+#define REPLAY_MAX_EVENTS                   (1024u)
+
+/* Seconds from the start of an event which must reach the model */
+#define REPLAY_DEFAULT_COVERAGE_S           (1.0)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    double  start_s;
+    double  end_s;
+    char    label[32];
+} replay_event_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static replay_event_t events[REPLAY_MAX_EVENTS];
+static float preroll[AUDIO_GATE_MAX_PREROLL * REPLAY_BLOCK_SAMPLES];
+static float block_f32[REPLAY_BLOCK_SAMPLES];
+static int16_t frames[REPLAY_BLOCK_SAMPLES * REPLAY_MAX_CHANNELS];
+
+/*******************************************************************************
+* Function Name: replay_load_events
+*******************************************************************************/
+static uint32_t replay_load_events(const char *path)
+{
+    char line[256];
+    uint32_t count = 0;
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        return 0;
+    }
+
+    while ((count < REPLAY_MAX_EVENTS) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        replay_event_t *e = &events[count];
+
+        if ('#' == line[0])
+        {
+            continue;
+        }
+        e->label[0] = '\0';
+        if (sscanf(line, "%lf,%lf,%31[^\r\n]", &e->start_s, &e->end_s, e->label) >= 2)
+        {
+            count++;
+        }
+    }
+    fclose(file);
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: replay_emit
+*******************************************************************************/
+static void replay_emit(const float *block, uint32_t tag, void *ctx)
+{
+    (void)block;
+    (void)tag;
+    (*(uint32_t*)ctx)++;
+}
+
+int main(int argc, char *argv[])
+{
+    wav_reader_t wav;
+    audio_gate_t gate;
+    audio_gate_stats_t stats;
+    double coverage_s = REPLAY_DEFAULT_COVERAGE_S;
+    uint8_t *emitted;
+    uint32_t event_count;
+    uint32_t block_count;
+    uint32_t emitted_blocks = 0;
+    uint32_t missed = 0;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <file.wav> <labels.csv> [--coverage S]\n", argv[0]);
+        return 2;
+    }
+    if ((argc >= 5) && (0 == strcmp(argv[3], "--coverage")))
+    {
+        coverage_s = atof(argv[4]);
+    }
+
+    if (!wav_reader_open(&wav, argv[1]) || (wav.channels > REPLAY_MAX_CHANNELS))
+    {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", argv[1]);
+        return 2;
+    }
+    event_count = replay_load_events(argv[2]);
+
+    block_count = wav.frames / REPLAY_BLOCK_SAMPLES;
+    emitted = calloc((block_count > 0u) ? block_count : 1u, 1u);
+    if ((NULL == emitted) || !audio_gate_init(&gate, NULL, preroll, REPLAY_BLOCK_SAMPLES))
+    {
+        return 2;
+    }
+
+    for (uint32_t b = 0; b < block_count; b++)
+    {
+        uint32_t replayed = gate.stats.preroll_blocks;
+
+        if (REPLAY_BLOCK_SAMPLES != wav_reader_read(&wav, frames, REPLAY_BLOCK_SAMPLES))
+        {
+            block_count = b;
+            break;
+        }
+        for (uint32_t i = 0; i < REPLAY_BLOCK_SAMPLES; i++)
+        {
+            block_f32[i] = (float)frames[i * wav.channels] * (1.0f / 32768.0f);
+        }
+
+        bool open = audio_gate_process(&gate, block_f32, b, replay_emit, &emitted_blocks);
+
+        /* Pre-roll blocks are the ones right before the current block */
+        replayed = gate.stats.preroll_blocks - replayed;
+        for (uint32_t r = 1; (r <= replayed) && (r <= b); r++)
+        {
+            emitted[b - r] = 1u;
+        }
+        emitted[b] = open ? 1u : 0u;
+    }
+
+    for (uint32_t e = 0; e < event_count; e++)
+    {
+        double end_s = events[e].end_s;
+        uint32_t first;
+        uint32_t last;
+        bool passed = true;
+
+        if ((events[e].start_s + coverage_s) < end_s)
+        {
+            end_s = events[e].start_s + coverage_s;
+        }
+        first = (uint32_t)((events[e].start_s * wav.sample_rate) / REPLAY_BLOCK_SAMPLES);
+        last = (uint32_t)((end_s * wav.sample_rate) / REPLAY_BLOCK_SAMPLES);
+
+        for (uint32_t b = first; (b <= last) && (b < block_count); b++)
+        {
+            passed = passed && (0u != emitted[b]);
+        }
+        if (!passed)
+        {
+            missed++;
+            printf("missed %s event at %.2f s\n", ('\0' != events[e].label[0]) ? events[e].label : "labelled", events[e].start_s);
+        }
+    }
+
+    audio_gate_get_stats(&gate, &stats);
+    printf("%s: %u blocks, %u gated (%.1f%%, %.1f s), %u opens, %u pre-roll blocks\n", argv[1],
+           (unsigned)stats.blocks, (unsigned)stats.gated_blocks,
+           (0u == stats.blocks) ? 0.0 : (100.0 * stats.gated_blocks) / stats.blocks,
+           ((double)stats.gated_blocks * REPLAY_BLOCK_SAMPLES) / wav.sample_rate,
+           (unsigned)stats.opens, (unsigned)stats.preroll_blocks);
+    printf("%u of %u events reached the model\n", (unsigned)(event_count - missed), (unsigned)event_count);
+
+    free(emitted);
+    wav_reader_close(&wav);
+
+    return (0u == missed) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,378 @@
+/******************************************************************************
+* File Name:   audio_pool_test.c
+*
+* Description: This file implements a host check of the audio capture block
+*              pool (audio_pool.c). A producer thread stands in for the
+*              capture ISR: it fills the block it owns with samples derived
+*              from the sequence number and commits it without ever waiting,
+*              so the pool drops blocks when the consumer falls behind. A
+*              consumer thread stands in for the audio task, which is woken
+*              after every committed block and drains the pool. The consumer
+*              checks that the sequence numbers increase, that every sample
+*              of a block it holds still matches its sequence number, and
+*              keeps its own count of the sequence gaps, latencies and late
+*              blocks, which must equal the pool statistics. A scripted run
+*              on one thread checks the overrun path and the depth and
+*              latency counters with known values first.
+*
+*              Usage: audio_pool_test [--blocks N] [--pool-blocks N]
+*                                     [--block-samples N] [--late-us N]
+*                                     [--producer-period-us N]
+*                                     [--consumer-delay-us N]
+*
+*              The exit code is 1 if a block or a statistic does not match.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "audio_pool.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_DEFAULT_BLOCKS                 (200000u)
+#define TEST_DEFAULT_POOL_BLOCKS            (4u)
+#define TEST_DEFAULT_BLOCK_SAMPLES          (256u)
+#define TEST_DEFAULT_LATE_US                (100u)
+#define TEST_MAX_BLOCK_SAMPLES              (4096u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static audio_pool_t pool;
+static int16_t storage[AUDIO_POOL_MAX_BLOCKS * TEST_MAX_BLOCK_SAMPLES];
+static sem_t block_ready;
+static _Atomic bool producer_done;
+
+static uint32_t blocks = TEST_DEFAULT_BLOCKS;
+static uint32_t pool_blocks = TEST_DEFAULT_POOL_BLOCKS;
+static uint32_t block_samples = TEST_DEFAULT_BLOCK_SAMPLES;
+static uint32_t late_us = TEST_DEFAULT_LATE_US;
+static uint32_t producer_period_us;
+static uint32_t consumer_delay_us;
+
+/* Producer: sequence number of the last block handed over */
+static uint32_t last_committed;
+
+/* Consumer results */
+static uint32_t received;
+static uint32_t mismatches;
+static uint32_t out_of_order;
+static uint32_t gaps;
+static uint32_t late;
+static uint32_t latency_max;
+static uint64_t latency_sum;
+
+/*******************************************************************************
+* Function Name: test_now_us
+*******************************************************************************/
+static uint32_t test_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u);
+}
+
+/*******************************************************************************
+* Function Name: test_sleep_us
+*******************************************************************************/
+static void test_sleep_us(uint32_t us)
+{
+    struct timespec delay = { .tv_sec = us / 1000000u, .tv_nsec = (long)(us % 1000000u) * 1000 };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+* Function Name: test_sample
+********************************************************************************
+* Summary:
+*  Returns sample i of the block with sequence number seq.
+*
+*******************************************************************************/
+static int16_t test_sample(uint32_t seq, uint32_t i)
+{
+    return (int16_t)(seq * 31u + i * 7u);
+}
+
+/*******************************************************************************
+* Function Name: test_fill
+*******************************************************************************/
+static void test_fill(int16_t *data, uint32_t seq)
+{
+    for (uint32_t i = 0; i < block_samples; i++)
+    {
+        data[i] = test_sample(seq, i);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_check
+*******************************************************************************/
+static bool test_check(const audio_pool_block_t *block)
+{
+    for (uint32_t i = 0; i < block_samples; i++)
+    {
+        if (block->data[i] != test_sample(block->seq, i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: test_scripted
+********************************************************************************
+* Summary:
+*  Fills a pool of 4 blocks on one thread: the fourth commit finds no free
+*  block and is dropped, so the consumer sees sequence 0, 1, 2 and 4 with one
+*  gap, the depth reaches 3 and the latencies are the differences of the
+*  given times.
+*
+* Return:
+*  true if the blocks and the statistics are the expected ones.
+*
+*******************************************************************************/
+static bool test_scripted(void)
+{
+    static const uint32_t expected_seq[] = { 0u, 1u, 2u, 4u };
+    const audio_pool_block_t *block;
+    audio_pool_stats_t stats;
+    uint32_t count = 0;
+    bool ok = audio_pool_init(&pool, storage, 4u, block_samples, 30u) &&
+              !audio_pool_init(&pool, storage, 1u, block_samples, 0u) &&
+              !audio_pool_init(&pool, storage, AUDIO_POOL_MAX_BLOCKS + 1u, block_samples, 0u) &&
+              audio_pool_init(&pool, storage, 4u, block_samples, 30u);
+
+    for (uint32_t seq = 0; ok && (seq < 4u); seq++)
+    {
+        test_fill(audio_pool_producer_block(&pool), seq);
+        ok = (audio_pool_producer_commit(&pool, seq * 10u) == (seq < 3u));
+    }
+
+    /* Sequence 0 is taken 20 after its capture, then 1 and 2 after 5 more */
+    ok = ok && (3u == audio_pool_depth(&pool));
+    block = ok ? audio_pool_consumer_get(&pool, 20u) : NULL;
+    ok = ok && (NULL != block) && (audio_pool_consumer_get(&pool, 99u) == block) && (0u == block->seq) &&
+         test_check(block);
+    audio_pool_consumer_release(&pool);
+    count++;
+    test_fill(audio_pool_producer_block(&pool), 4u);
+    ok = ok && audio_pool_producer_commit(&pool, 40u);
+
+    while (ok && (NULL != (block = audio_pool_consumer_get(&pool, 45u))))
+    {
+        ok = (count < 4u) && (block->seq == expected_seq[count]) && test_check(block);
+        audio_pool_consumer_release(&pool);
+        count++;
+    }
+
+    audio_pool_get_stats(&pool, &stats);
+    /* Latencies 20, 35, 25 and 5: the one of 35 is late */
+    ok = ok && (4u == count) && (4u == stats.committed) && (4u == stats.consumed) && (1u == stats.overruns) &&
+         (1u == stats.gaps) && (3u == stats.depth_max) && (35u == stats.latency_max) &&
+         (85u == stats.latency_sum) && (1u == stats.late) && (0u == audio_pool_depth(&pool));
+    printf("scripted: %u blocks, 1 overrun, sequence 0 1 2 4: %s\n", (unsigned)count, ok ? "ok" : "FAIL");
+
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: test_producer
+********************************************************************************
+* Summary:
+*  Captures the blocks like the PDM ISR: the block is filled and committed,
+*  and a dropped block is refilled with the next sequence number.
+*
+*******************************************************************************/
+static void* test_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t seq = 0; seq < blocks; seq++)
+    {
+        if (0u != producer_period_us)
+        {
+            test_sleep_us(producer_period_us);
+        }
+        test_fill(audio_pool_producer_block(&pool), seq);
+        if (audio_pool_producer_commit(&pool, test_now_us()))
+        {
+            last_committed = seq;
+            sem_post(&block_ready);
+        }
+    }
+    atomic_store(&producer_done, true);
+    sem_post(&block_ready);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_consumer
+********************************************************************************
+* Summary:
+*  Drains the pool after every wake-up, like audio_task. The time is read
+*  once a block is waiting, so it is never before the capture time.
+*
+*******************************************************************************/
+static void* test_consumer(void *arg)
+{
+    uint32_t next_seq = 0;
+
+    (void)arg;
+    for (;;)
+    {
+        bool done;
+
+        sem_wait(&block_ready);
+        done = atomic_load(&producer_done);
+        while (0u != audio_pool_depth(&pool))
+        {
+            uint32_t now = test_now_us();
+            const audio_pool_block_t *block = audio_pool_consumer_get(&pool, now);
+            uint32_t latency = now - block->timestamp;
+
+            if (block->seq < next_seq)
+            {
+                out_of_order++;
+            }
+            else
+            {
+                gaps += block->seq - next_seq;
+                next_seq = block->seq + 1u;
+            }
+            latency_sum += latency;
+            latency_max = (latency > latency_max) ? latency : latency_max;
+            late += (latency > late_us) ? 1u : 0u;
+
+            if (0u != consumer_delay_us)
+            {
+                test_sleep_us(consumer_delay_us);
+            }
+            /* Checked after the delay, a block the producer wrote to meanwhile does not match */
+            if (!test_check(block))
+            {
+                mismatches++;
+            }
+            received++;
+            audio_pool_consumer_release(&pool);
+        }
+        if (done)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t producer;
+    pthread_t consumer;
+    audio_pool_stats_t stats;
+    struct timespec start;
+    struct timespec end;
+    double elapsed_s;
+    bool ok;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--blocks")) && ((i + 1) < argc))
+        {
+            blocks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--pool-blocks")) && ((i + 1) < argc))
+        {
+            pool_blocks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--block-samples")) && ((i + 1) < argc))
+        {
+            block_samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--late-us")) && ((i + 1) < argc))
+        {
+            late_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--producer-period-us")) && ((i + 1) < argc))
+        {
+            producer_period_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--consumer-delay-us")) && ((i + 1) < argc))
+        {
+            consumer_delay_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--blocks N] [--pool-blocks N] [--block-samples N] [--late-us N] "
+                    "[--producer-period-us N] [--consumer-delay-us N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((0u == block_samples) || (block_samples > TEST_MAX_BLOCK_SAMPLES) || (0u == late_us) ||
+        (pool_blocks < 2u) || (pool_blocks > AUDIO_POOL_MAX_BLOCKS))
+    {
+        fprintf(stderr, "--block-samples must be 1..%u, --pool-blocks 2..%u and --late-us above 0\n",
+                (unsigned)TEST_MAX_BLOCK_SAMPLES, (unsigned)AUDIO_POOL_MAX_BLOCKS);
+        return 2;
+    }
+
+    ok = test_scripted();
+
+    (void)audio_pool_init(&pool, storage, pool_blocks, block_samples, late_us);
+    sem_init(&block_ready, 0, 0);
+    atomic_init(&producer_done, false);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer, NULL, test_consumer, NULL);
+    pthread_create(&producer, NULL, test_producer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed_s = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    audio_pool_get_stats(&pool, &stats);
+    printf("%u blocks of %u samples captured in %.3f s, %u-block pool\n",
+           (unsigned)blocks, (unsigned)block_samples, elapsed_s, (unsigned)pool_blocks);
+    printf("committed %u, overruns %u (%u after the last block), consumed %u, gaps %u (consumer %u), "
+           "out of order %u, mismatches %u\n",
+           (unsigned)stats.committed, (unsigned)stats.overruns, (unsigned)(blocks - 1u - last_committed),
+           (unsigned)stats.consumed, (unsigned)stats.gaps, (unsigned)gaps, (unsigned)out_of_order,
+           (unsigned)mismatches);
+    printf("depth max %u, latency avg %u us max %u us, %u late above %u us\n",
+           (unsigned)stats.depth_max,
+           (unsigned)((0u == stats.consumed) ? 0u : (stats.latency_sum / stats.consumed)),
+           (unsigned)stats.latency_max, (unsigned)stats.late, (unsigned)late_us);
+
+    /* Every block is either consumed or dropped, and every drop before the
+     * last block handed over is a gap. A drop finds the pool full, which the
+     * consumer sees one block later at the latest. */
+    ok = ok && (0u == mismatches) && (0u == out_of_order) && (0u == audio_pool_depth(&pool)) &&
+         ((stats.committed + stats.overruns) == blocks) && (stats.consumed == stats.committed) &&
+         (received == stats.consumed) && ((stats.gaps + (blocks - 1u - last_committed)) == stats.overruns) && (gaps == stats.gaps) &&
+         (stats.depth_max <= (pool_blocks - 1u)) && ((0u == stats.consumed) || (stats.depth_max >= 1u)) &&
+         ((0u == stats.overruns) || ((stats.depth_max + 2u) >= pool_blocks)) &&
+         (stats.latency_sum == latency_sum) && (stats.latency_max == latency_max) && (stats.late == late);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    sem_destroy(&block_ready);
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
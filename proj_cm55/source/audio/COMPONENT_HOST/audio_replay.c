@@ -0,0 +1,571 @@
+/******************************************************************************
+* File Name:   audio_replay.c
+*
+* Description: This file implements a host replay of WAV datasets through
+*              the audio detection pipeline of audio_task (audio_core.c).
+*              The model is the Ready Model selected with -DCOUGH_MODEL,
+*              -DBABYCRY_MODEL or -DALARM_MODEL, linked either from a host
+*              build of the library or from imai_aed_mock.c. It prints every
+*              detection with its time in the file, the per-class counts,
+*              the throughput and the cost per frame.
+*
+*              Usage: audio_replay <file.wav>... [--frame N] [--hop N]
+*                                  [--gate] [--compare] [--tolerance S]
+*                                  [--boost F] [--events out.csv]
+*
+*              With several files the model and the smoothing restart at
+*              the beginning of every file, the counts are totals.
+*
+*              --compare runs every file without and with the gate and
+*              lists the detections of the ungated run that the gated run
+*              has no detection of the same label for within --tolerance
+*              seconds (default 0.5). The exit code is 1 if one was lost
+*              or if a run never reported the initial state of a model,
+*              which the CM33 waits for at startup.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "audio_core.h"
+#include "wav_reader.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define REPLAY_CYCLE_UNIT                   "TSC cycles"
+#else
+#define REPLAY_CYCLE_UNIT                   "ns"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same defaults as audio_task */
+#define REPLAY_DEFAULT_FRAME                (1024u)
+#define REPLAY_DEFAULT_HOP                  (256u)
+#define REPLAY_EXIT_COUNT                   (3u)
+#define REPLAY_MAX_CHANNELS                 (8u)
+
+/* Detections of one file kept for --compare */
+#define REPLAY_MAX_DETECTIONS               (4096u)
+
+/* Seconds a gated detection may be off the ungated one */
+#define REPLAY_DEFAULT_TOLERANCE_S          (0.5)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t    frame;
+    uint32_t    hop;
+    float       boost;
+} replay_options_t;
+
+typedef struct
+{
+    double      time_s;
+    uint32_t    label_id;
+    const char  *label;
+} replay_detection_t;
+
+typedef struct
+{
+    const char          *path;
+    uint32_t            sample_rate;
+    FILE                *events;
+    bool                quiet;          /* Detections are not printed */
+    replay_detection_t  *detections;    /* NULL does not keep the detections */
+    uint32_t            detection_count;
+} replay_ctx_t;
+
+typedef struct
+{
+    audio_core_stats_t  core;
+    audio_gate_stats_t  gate;
+    uint64_t            samples;
+    uint64_t            frame_cycles;
+    uint32_t            frame_cycles_max;
+    double              elapsed_s;
+    uint32_t            silent_files;   /* Files without a reported state */
+} replay_totals_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const audio_model_t *const replay_models[] =
+{
+#if defined(COUGH_MODEL)
+    &audio_model_cough,
+#elif defined(BABYCRY_MODEL)
+    &audio_model_babycry,
+#elif defined(ALARM_MODEL)
+    &audio_model_alarm,
+#else
+#error "Select the model with -DCOUGH_MODEL, -DBABYCRY_MODEL or -DALARM_MODEL"
+#endif
+};
+
+#define REPLAY_MODEL_COUNT                  (sizeof(replay_models) / sizeof(replay_models[0]))
+
+static audio_core_t core;
+static audio_gate_t gate;
+static float gate_preroll[AUDIO_GATE_MAX_PREROLL * AUDIO_CORE_MAX_FRAME];
+static float hub_ring[4u * AUDIO_CORE_MAX_FRAME];
+static int16_t frames[AUDIO_CORE_MAX_FRAME * REPLAY_MAX_CHANNELS];
+static int16_t mono[AUDIO_CORE_MAX_FRAME];
+static replay_detection_t reference[REPLAY_MAX_DETECTIONS];
+static replay_detection_t gated[REPLAY_MAX_DETECTIONS];
+
+/*******************************************************************************
+* Function Name: replay_cycles
+********************************************************************************
+* Summary:
+*  Host stand-in for the DWT cycle counter.
+*
+*******************************************************************************/
+static uint32_t replay_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: replay_now_s
+*******************************************************************************/
+static double replay_now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*******************************************************************************
+* Function Name: replay_event
+********************************************************************************
+* Summary:
+*  Prints a detection with the time of the sample that completed it. The
+*  capture times are sample indices within the file.
+*
+*******************************************************************************/
+static void replay_event(const audio_core_event_t *event, void *ctx)
+{
+    replay_ctx_t *replay = (replay_ctx_t*)ctx;
+    double time_s = (double)event->capture_time / replay->sample_rate;
+
+    if (0 == event->class_id)
+    {
+        return;
+    }
+    if ((NULL != replay->detections) && (replay->detection_count < REPLAY_MAX_DETECTIONS))
+    {
+        replay_detection_t *detection = &replay->detections[replay->detection_count++];
+
+        detection->time_s = time_s;
+        detection->label_id = event->label_id;
+        detection->label = event->label;
+    }
+    if (!replay->quiet)
+    {
+        printf("%9.3f s  %s (label_id %u)\n", time_s, event->label, (unsigned)event->label_id);
+    }
+    if (NULL != replay->events)
+    {
+        fprintf(replay->events, "%s,%.3f,%s,%u\n", replay->path, time_s, event->label, (unsigned)event->label_id);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_status
+*******************************************************************************/
+static void replay_status(uint32_t model, int status, void *ctx)
+{
+    (void)ctx;
+    fprintf(stderr, "%s model returned %d\n", replay_models[model]->name, status);
+}
+
+/*******************************************************************************
+* Function Name: replay_option_values
+********************************************************************************
+* Summary:
+*  Returns the number of values following an option, -1 for a file name.
+*
+*******************************************************************************/
+static int replay_option_values(const char *arg)
+{
+    if ((0 == strcmp(arg, "--frame")) || (0 == strcmp(arg, "--hop")) || (0 == strcmp(arg, "--boost")) ||
+        (0 == strcmp(arg, "--events")) || (0 == strcmp(arg, "--tolerance")))
+    {
+        return 1;
+    }
+    if ((0 == strcmp(arg, "--gate")) || (0 == strcmp(arg, "--compare")))
+    {
+        return 0;
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+* Function Name: replay_file
+********************************************************************************
+* Summary:
+*  Streams one file through a freshly initialized pipeline and adds its
+*  statistics to the totals.
+*
+* Return:
+*  0 on success, 1 if the file cannot be read, 2 if the pipeline cannot be
+*  initialized.
+*
+*******************************************************************************/
+static int replay_file(const char *path, const replay_options_t *options, bool use_gate,
+                       replay_ctx_t *replay, replay_totals_t *totals)
+{
+    wav_reader_t wav;
+    audio_core_stats_t stats;
+    uint32_t frame = options->frame;
+
+    if (!wav_reader_open(&wav, path) || (wav.channels > REPLAY_MAX_CHANNELS))
+    {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", path);
+        return 1;
+    }
+
+    replay->path = path;
+    replay->sample_rate = wav.sample_rate;
+    replay->detection_count = 0;
+
+    audio_core_cfg_t cfg =
+    {
+        .models = replay_models,
+        .model_count = REPLAY_MODEL_COUNT,
+        .frame_samples = frame,
+        .sample_rate = wav.sample_rate,
+        .time_scale = wav.sample_rate,
+        .boost = options->boost,
+        .per_sample = false,
+        .hub_ring = hub_ring,
+        .hub_ring_samples = 2u * ((frame > options->hop) ? frame : options->hop),
+        .hop_samples = options->hop,
+        .gate = NULL,
+        .exit_count = REPLAY_EXIT_COUNT,
+        .latency_bucket = 1u,
+        .event_cb = replay_event,
+        .status_cb = replay_status,
+        .cb_ctx = replay,
+        .get_time = NULL,
+        .get_cycles = replay_cycles
+    };
+
+    if (use_gate)
+    {
+        audio_gate_cfg_t gate_cfg;
+
+        /* Same pre-roll, hold and warm-up time as audio_task */
+        audio_gate_default_config(&gate_cfg);
+        gate_cfg.preroll_blocks = (uint8_t)(((4096u / frame) < AUDIO_GATE_MAX_PREROLL) ?
+                                            (4096u / frame) : AUDIO_GATE_MAX_PREROLL);
+        gate_cfg.hold_blocks = (uint16_t)((gate_cfg.hold_blocks * 1024u) / frame);
+        gate_cfg.warmup_blocks = (uint16_t)((gate_cfg.warmup_blocks * 1024u) / frame);
+        if (!audio_gate_init(&gate, &gate_cfg, gate_preroll, frame))
+        {
+            wav_reader_close(&wav);
+            return 2;
+        }
+        cfg.gate = &gate;
+    }
+    if (!audio_core_init(&core, &cfg))
+    {
+        fprintf(stderr, "unable to initialize the audio core\n");
+        wav_reader_close(&wav);
+        return 2;
+    }
+
+    if (!replay->quiet)
+    {
+        printf("%s%s:\n", path, use_gate ? " (gate)" : "");
+    }
+    double start_s = replay_now_s();
+    uint32_t position = 0;
+    while (frame == wav_reader_read(&wav, frames, frame))
+    {
+        for (uint32_t s = 0; s < frame; s++)
+        {
+            mono[s] = frames[s * wav.channels];
+        }
+        position += frame;
+
+        uint32_t cycles = replay_cycles();
+        audio_core_process(&core, mono, position - 1u);
+        cycles = replay_cycles() - cycles;
+
+        totals->frame_cycles += cycles;
+        if (cycles > totals->frame_cycles_max)
+        {
+            totals->frame_cycles_max = cycles;
+        }
+    }
+    totals->elapsed_s += replay_now_s() - start_s;
+    totals->samples += position;
+    wav_reader_close(&wav);
+
+    audio_core_get_stats(&core, &stats);
+    totals->core.frames += stats.frames;
+    totals->core.results += stats.results;
+    totals->core.events += stats.events;
+    if (stats.events < REPLAY_MODEL_COUNT)
+    {
+        printf("%s%s: the initial state was not reported\n", path, use_gate ? " (gate)" : "");
+        totals->silent_files++;
+    }
+    for (uint32_t m = 0; m < REPLAY_MODEL_COUNT; m++)
+    {
+        for (uint32_t c = 0; c < AUDIO_HUB_MAX_CLASSES; c++)
+        {
+            totals->core.detections[m][c] += stats.detections[m][c];
+        }
+    }
+    if (use_gate)
+    {
+        audio_gate_stats_t gate_stats;
+
+        audio_gate_get_stats(&gate, &gate_stats);
+        totals->gate.blocks += gate_stats.blocks;
+        totals->gate.gated_blocks += gate_stats.gated_blocks;
+        totals->gate.opens += gate_stats.opens;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: replay_print_totals
+*******************************************************************************/
+static void replay_print_totals(const replay_totals_t *totals, uint32_t file_count, uint32_t frame, bool use_gate)
+{
+    printf("%u files, %llu samples in %.3f s (%.0f samples/s), %u frames of %u samples\n",
+           (unsigned)file_count, (unsigned long long)totals->samples, totals->elapsed_s,
+           (totals->elapsed_s > 0.0) ? (double)totals->samples / totals->elapsed_s : 0.0,
+           (unsigned)totals->core.frames, (unsigned)frame);
+    printf("%llu %s/frame avg, %u max, %u model results\n",
+           (unsigned long long)((0u == totals->core.frames) ? 0u : (totals->frame_cycles / totals->core.frames)),
+           REPLAY_CYCLE_UNIT, (unsigned)totals->frame_cycles_max, (unsigned)totals->core.results);
+    if (use_gate)
+    {
+        printf("gate skipped %u of %u frames, %u opens\n", (unsigned)totals->gate.gated_blocks,
+               (unsigned)totals->gate.blocks, (unsigned)totals->gate.opens);
+    }
+    printf("%u state changes, %u files without the initial state\n", (unsigned)totals->core.events,
+           (unsigned)totals->silent_files);
+    for (uint32_t m = 0; m < REPLAY_MODEL_COUNT; m++)
+    {
+        for (uint32_t c = 1; c < replay_models[m]->class_count; c++)
+        {
+            printf("%s: %u detections\n", replay_models[m]->labels[c], (unsigned)totals->core.detections[m][c]);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_compare
+********************************************************************************
+* Summary:
+*  Prints the detections of the ungated run without a gated detection of the
+*  same label within tolerance_s.
+*
+* Return:
+*  Number of such lost detections.
+*
+*******************************************************************************/
+static uint32_t replay_compare(const char *path, const replay_detection_t *ref, uint32_t ref_count,
+                               const replay_detection_t *test, uint32_t test_count, double tolerance_s)
+{
+    uint32_t lost = 0;
+
+    for (uint32_t r = 0; r < ref_count; r++)
+    {
+        bool found = false;
+
+        for (uint32_t t = 0; (t < test_count) && !found; t++)
+        {
+            found = (test[t].label_id == ref[r].label_id) && (fabs(test[t].time_s - ref[r].time_s) <= tolerance_s);
+        }
+        if (!found)
+        {
+            printf("%s: lost %s detection at %.3f s\n", path, ref[r].label, ref[r].time_s);
+            lost++;
+        }
+    }
+
+    return lost;
+}
+
+int main(int argc, char *argv[])
+{
+    replay_ctx_t replay = { NULL, 0, NULL, false, NULL, 0 };
+    replay_options_t options = { REPLAY_DEFAULT_FRAME, REPLAY_DEFAULT_HOP, 1.0f };
+    replay_totals_t totals[2];
+    const char *events_path = NULL;
+    double tolerance_s = REPLAY_DEFAULT_TOLERANCE_S;
+    bool use_gate = false;
+    bool compare = false;
+    uint32_t file_count = 0;
+    uint32_t reference_total = 0;
+    uint32_t lost = 0;
+    int status = 0;
+
+    memset(totals, 0, sizeof(totals));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--frame")) && ((i + 1) < argc))
+        {
+            options.frame = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--hop")) && ((i + 1) < argc))
+        {
+            options.hop = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (0 == strcmp(argv[i], "--gate"))
+        {
+            use_gate = true;
+        }
+        else if (0 == strcmp(argv[i], "--compare"))
+        {
+            compare = true;
+        }
+        else if ((0 == strcmp(argv[i], "--tolerance")) && ((i + 1) < argc))
+        {
+            tolerance_s = strtod(argv[++i], NULL);
+        }
+        else if ((0 == strcmp(argv[i], "--boost")) && ((i + 1) < argc))
+        {
+            options.boost = strtof(argv[++i], NULL);
+        }
+        else if ((0 == strcmp(argv[i], "--events")) && ((i + 1) < argc))
+        {
+            events_path = argv[++i];
+        }
+        else if (replay_option_values(argv[i]) < 0)
+        {
+            file_count++;
+        }
+        else
+        {
+            file_count = 0;
+            break;
+        }
+    }
+
+    if (0u == file_count)
+    {
+        fprintf(stderr, "usage: %s <file.wav>... [--frame N] [--hop N] [--gate] [--compare] [--tolerance S] "
+                "[--boost F] [--events out.csv]\n", argv[0]);
+        return 2;
+    }
+    if ((0u == options.frame) || (options.frame > AUDIO_CORE_MAX_FRAME) ||
+        (0u == options.hop) || (options.hop > (2u * AUDIO_CORE_MAX_FRAME)))
+    {
+        fprintf(stderr, "--frame must be between 1 and %u, --hop between 1 and %u\n",
+                (unsigned)AUDIO_CORE_MAX_FRAME, (unsigned)(2u * AUDIO_CORE_MAX_FRAME));
+        return 2;
+    }
+    if ((use_gate || compare) && (options.frame < AUDIO_GATE_FFT_SIZE))
+    {
+        fprintf(stderr, "--gate needs frames of at least %u samples\n", (unsigned)AUDIO_GATE_FFT_SIZE);
+        return 2;
+    }
+    if (NULL != events_path)
+    {
+        replay.events = fopen(events_path, "w");
+        if (NULL == replay.events)
+        {
+            fprintf(stderr, "%s: cannot create\n", events_path);
+            return 1;
+        }
+        fprintf(replay.events, "file,time_s,label,label_id\n");
+    }
+
+    for (int i = 1; (i < argc) && (0 == status); i++)
+    {
+        int values = replay_option_values(argv[i]);
+
+        if (values >= 0)
+        {
+            i += values;
+            continue;
+        }
+        if (!compare)
+        {
+            status = replay_file(argv[i], &options, use_gate, &replay, &totals[0]);
+            continue;
+        }
+
+        /* Reference run without the gate, then the gated run of audio_task */
+        FILE *events = replay.events;
+        uint32_t reference_count;
+
+        replay.quiet = true;
+        replay.events = NULL;
+        replay.detections = reference;
+        status = replay_file(argv[i], &options, false, &replay, &totals[0]);
+        reference_count = replay.detection_count;
+        replay.quiet = false;
+        replay.events = events;
+        replay.detections = gated;
+        if (0 == status)
+        {
+            status = replay_file(argv[i], &options, true, &replay, &totals[1]);
+        }
+        if (0 == status)
+        {
+            reference_total += reference_count;
+            lost += replay_compare(argv[i], reference, reference_count, gated, replay.detection_count, tolerance_s);
+        }
+    }
+
+    if (NULL != replay.events)
+    {
+        fclose(replay.events);
+    }
+    if (0 != status)
+    {
+        return status;
+    }
+
+    if (!compare)
+    {
+        replay_print_totals(&totals[0], file_count, options.frame, use_gate);
+        return 0;
+    }
+
+    printf("without gate:\n");
+    replay_print_totals(&totals[0], file_count, options.frame, false);
+    printf("with gate:\n");
+    replay_print_totals(&totals[1], file_count, options.frame, true);
+    printf("gate kept %u of %u detections within %.3f s, %u lost\n", (unsigned)(reference_total - lost),
+           (unsigned)reference_total, tolerance_s, (unsigned)lost);
+    bool ok = (0u == lost) && (0u == totals[0].silent_files) && (0u == totals[1].silent_files);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
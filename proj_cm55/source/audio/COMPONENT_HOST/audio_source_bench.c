@@ -0,0 +1,310 @@
+/******************************************************************************
+* File Name:   audio_source_bench.c
+*
+* Description: This file implements a host benchmark of the audio capture
+*              path. A WAV file is streamed through the audio source and the
+*              capture pool, every block is converted to float like in
+*              audio_task and pushed to the audio hub with a stub model that
+*              reports a result every hop. The capture statistics and the
+*              capture-to-result latency percentiles are printed at the end.
+*
+*              Usage: audio_source_bench <file.wav> [--realtime] [--blocks N]
+*                                        [--block-samples N] [--hop N]
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "audio_source_wav.h"
+#include "../audio_hub.h"
+#include "../audio_latency.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same defaults as audio_task */
+#define BENCH_MAX_BLOCK_SAMPLES             (1024u)
+#define BENCH_DEFAULT_BLOCKS                (4u)
+#define BENCH_DEFAULT_HOP                   (256u)
+#define BENCH_LATENCY_BUCKET_US             (500u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static sem_t block_sem;
+static struct timespec start_time;
+static int16_t pool_storage[AUDIO_POOL_MAX_BLOCKS * BENCH_MAX_BLOCK_SAMPLES];
+static float block_f32[BENCH_MAX_BLOCK_SAMPLES];
+static float hub_ring[2u * BENCH_MAX_BLOCK_SAMPLES];
+static audio_latency_t latency;
+static uint32_t model_hop;
+static uint32_t model_queued;
+static const char *const bench_labels[] = { "unlabelled", "stub" };
+
+/*******************************************************************************
+* Function Name: bench_time_us
+*******************************************************************************/
+static uint32_t bench_time_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - start_time.tv_sec) * 1000000 + (now.tv_nsec - start_time.tv_nsec) / 1000);
+}
+
+/*******************************************************************************
+* Function Name: bench_elapsed_us
+*******************************************************************************/
+static double bench_elapsed_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start_time.tv_sec) * 1e6 + (double)(now.tv_nsec - start_time.tv_nsec) / 1e3;
+}
+
+/*******************************************************************************
+* Function Name: bench_block_ready
+*******************************************************************************/
+static void bench_block_ready(void *cb_ctx)
+{
+    (void)cb_ctx;
+    sem_post(&block_sem);
+}
+
+/*******************************************************************************
+* Function Name: bench_model_init
+*******************************************************************************/
+static void bench_model_init(void)
+{
+}
+
+/*******************************************************************************
+* Function Name: bench_model_enqueue
+*******************************************************************************/
+static int bench_model_enqueue(const float *sample)
+{
+    (void)sample;
+    model_queued++;
+    return AUDIO_MODEL_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: bench_model_dequeue
+********************************************************************************
+* Summary:
+*  Stand-in for a model with no inference cost, one result per hop of
+*  enqueued samples.
+*
+*******************************************************************************/
+static int bench_model_dequeue(int *flags)
+{
+    if (model_queued < model_hop)
+    {
+        return AUDIO_MODEL_RET_NODATA;
+    }
+    model_queued -= model_hop;
+    flags[0] = 1;
+    flags[1] = 0;
+    return AUDIO_MODEL_RET_SUCCESS;
+}
+
+static const audio_model_t bench_model =
+{
+    .name = "stub",
+    .class_count = 2,
+    .labels = bench_labels,
+    .init = bench_model_init,
+    .enqueue = bench_model_enqueue,
+    .dequeue = bench_model_dequeue
+};
+
+/*******************************************************************************
+* Function Name: bench_result
+*******************************************************************************/
+static void bench_result(uint32_t model, int status, const int *flags, uint32_t capture_time, void *ctx)
+{
+    (void)model;
+    (void)flags;
+    (void)ctx;
+
+    if (AUDIO_MODEL_RET_SUCCESS == status)
+    {
+        audio_latency_add(&latency, bench_time_us() - capture_time);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_process_block
+********************************************************************************
+* Summary:
+*  Stand-in for the model input stage: q15 to float conversion.
+*
+*******************************************************************************/
+static float bench_process_block(const int16_t *block, uint32_t samples)
+{
+    float energy = 0.0f;
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        block_f32[i] = (float)block[i] * (1.0f / 32768.0f);
+        energy += block_f32[i] * block_f32[i];
+    }
+
+    return energy;
+}
+
+int main(int argc, char *argv[])
+{
+    const audio_model_t *const models[] = { &bench_model };
+    audio_pool_t pool;
+    audio_pool_stats_t pool_stats;
+    audio_source_stats_t source_stats;
+    audio_hub_t hub;
+    audio_latency_summary_t summary;
+    const char *path = NULL;
+    bool realtime = false;
+    uint32_t blocks = BENCH_DEFAULT_BLOCKS;
+    uint32_t block_samples = BENCH_MAX_BLOCK_SAMPLES;
+    uint32_t hop = BENCH_DEFAULT_HOP;
+    uint32_t late_us;
+    double elapsed_us;
+    double energy = 0.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "--realtime"))
+        {
+            realtime = true;
+        }
+        else if ((0 == strcmp(argv[i], "--blocks")) && ((i + 1) < argc))
+        {
+            blocks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--block-samples")) && ((i + 1) < argc))
+        {
+            block_samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--hop")) && ((i + 1) < argc))
+        {
+            hop = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (NULL == path)
+    {
+        fprintf(stderr, "usage: %s <file.wav> [--realtime] [--blocks N] [--block-samples N] [--hop N]\n", argv[0]);
+        return 2;
+    }
+    if ((0u == block_samples) || (block_samples > BENCH_MAX_BLOCK_SAMPLES) ||
+        (0u == hop) || (hop > (2u * BENCH_MAX_BLOCK_SAMPLES)))
+    {
+        fprintf(stderr, "--block-samples must be between 1 and %u, --hop between 1 and %u\n",
+                (unsigned)BENCH_MAX_BLOCK_SAMPLES, (unsigned)(2u * BENCH_MAX_BLOCK_SAMPLES));
+        return 2;
+    }
+    if (!audio_source_wav_open(path, realtime))
+    {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", path);
+        return 1;
+    }
+
+    /* Same late threshold as audio_task: one block period */
+    late_us = (uint32_t)(((uint64_t)block_samples * 1000000u) / audio_source_wav_sample_rate());
+    if (!audio_pool_init(&pool, pool_storage, blocks, block_samples, late_us))
+    {
+        fprintf(stderr, "--blocks must be between 2 and %u\n", (unsigned)AUDIO_POOL_MAX_BLOCKS);
+        return 2;
+    }
+
+    audio_hub_cfg_t hub_cfg =
+    {
+        .ring = hub_ring,
+        .ring_samples = 2u * ((block_samples > hop) ? block_samples : hop),
+        .hop_samples = hop,
+        .sample_rate = audio_source_wav_sample_rate(),
+        .time_scale = 1000000u,
+        .result_cb = bench_result,
+        .cb_ctx = NULL,
+        .get_cycles = NULL
+    };
+    model_hop = hop;
+    audio_latency_init(&latency, BENCH_LATENCY_BUCKET_US);
+    if (!audio_hub_init(&hub, &hub_cfg, models, 1u))
+    {
+        fprintf(stderr, "unable to initialize the audio hub\n");
+        return 1;
+    }
+
+    audio_source_config_t config =
+    {
+        .pool = &pool,
+        .block_ready = bench_block_ready,
+        .cb_ctx = NULL,
+        .get_time = bench_time_us
+    };
+
+    sem_init(&block_sem, 0, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    if (!audio_source_start(&config))
+    {
+        fprintf(stderr, "unable to start the audio source\n");
+        return 1;
+    }
+
+    for (;;)
+    {
+        const audio_pool_block_t *block;
+
+        sem_wait(&block_sem);
+        while (NULL != (block = audio_source_get_block(bench_time_us())))
+        {
+            energy += bench_process_block(block->data, block_samples);
+            audio_hub_push(&hub, block_f32, block_samples, block->timestamp);
+            audio_hub_run(&hub);
+            audio_source_release_block();
+        }
+        if (audio_source_wav_finished() && (0u == audio_pool_depth(&pool)))
+        {
+            break;
+        }
+    }
+
+    elapsed_us = bench_elapsed_us();
+    audio_source_stop();
+
+    audio_pool_get_stats(&pool, &pool_stats);
+    audio_source_get_stats(&source_stats);
+    audio_latency_summarize(&latency, &summary);
+    printf("%s: %u blocks of %u samples in %.0f us (%.1fx real time), %s mode\n", path,
+           (unsigned)pool_stats.consumed, (unsigned)block_samples, elapsed_us,
+           (double)source_stats.blocks * block_samples * 1e6 / audio_source_wav_sample_rate() / elapsed_us,
+           realtime ? "real-time" : "maximum speed");
+    printf("overruns %u, gaps %u, late %u, depth max %u, latency avg %u us max %u us, energy %.3f\n",
+           (unsigned)pool_stats.overruns, (unsigned)pool_stats.gaps, (unsigned)pool_stats.late,
+           (unsigned)pool_stats.depth_max,
+           (unsigned)((0u == pool_stats.consumed) ? 0u : (pool_stats.latency_sum / pool_stats.consumed)),
+           (unsigned)pool_stats.latency_max, energy);
+    printf("%u results every %u samples, capture to result p50 %u us, p90 %u us, p99 %u us, max %u us\n",
+           (unsigned)summary.count, (unsigned)hop, (unsigned)summary.p50_us, (unsigned)summary.p90_us,
+           (unsigned)summary.p99_us, (unsigned)summary.max_us);
+
+    sem_destroy(&block_sem);
+    return 0;
+}
+
+/* [] END OF FILE */
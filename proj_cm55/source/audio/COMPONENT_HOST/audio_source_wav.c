@@ -0,0 +1,250 @@
+/******************************************************************************
+* File Name:   audio_source_wav.c
+*
+* Description: This file implements the audio source on a host. A producer
+*              thread streams the first channels of a 16-bit PCM WAV file
+*              into the capture pool, interleaved like the PDM channels,
+*              either paced at the file sample rate or as fast as the
+*              consumer releases blocks.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+#include "audio_source_wav.h"
+#include "wav_reader.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define WAV_READ_FRAMES                     (256u)
+#define WAV_MAX_CHANNELS                    (8u)
+
+/* Poll interval while waiting for a free block in maximum speed mode */
+#define WAV_WAIT_NS                         (50000L)
+
+#define NS_PER_SEC                          (1000000000LL)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static wav_reader_t wav;
+static bool wav_realtime;
+static audio_source_config_t source_cfg;
+static uint32_t source_channels;
+static audio_source_stats_t source_stats;
+static pthread_t wav_thread;
+static bool wav_started;
+static atomic_bool wav_running;
+static atomic_bool wav_finished;
+
+/*******************************************************************************
+* Function Name: wav_fill_block
+********************************************************************************
+* Summary:
+*  Fills a block with the first source_channels channels of the file, zero
+*  padding the last block.
+*
+* Return:
+*  Number of samples taken from the file.
+*
+*******************************************************************************/
+static uint32_t wav_fill_block(int16_t *block, uint32_t samples)
+{
+    int16_t frames[WAV_READ_FRAMES * WAV_MAX_CHANNELS];
+    uint32_t filled = 0;
+
+    while (filled < samples)
+    {
+        uint32_t want = (samples - filled) / source_channels;
+        uint32_t got = wav_reader_read(&wav, frames, (want < WAV_READ_FRAMES) ? want : WAV_READ_FRAMES);
+
+        source_stats.interrupts++;
+        if (0u == got)
+        {
+            break;
+        }
+        for (uint32_t i = 0; i < got; i++)
+        {
+            for (uint32_t c = 0; c < source_channels; c++)
+            {
+                block[filled++] = frames[i * wav.channels + c];
+            }
+        }
+    }
+
+    if (filled < samples)
+    {
+        memset(&block[filled], 0, (samples - filled) * sizeof(int16_t));
+    }
+
+    return filled;
+}
+
+/*******************************************************************************
+* Function Name: wav_producer
+********************************************************************************
+* Summary:
+*  Producer thread, the host counterpart of the PDM ISR.
+*
+*******************************************************************************/
+static void* wav_producer(void *arg)
+{
+    audio_pool_t *pool = source_cfg.pool;
+    int64_t period_ns = ((int64_t)(pool->block_samples / source_channels) * NS_PER_SEC) / wav.sample_rate;
+    struct timespec next;
+
+    (void)arg;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (atomic_load(&wav_running))
+    {
+        if (wav_realtime)
+        {
+            /* A block is complete one block period after the previous one */
+            int64_t ns = next.tv_nsec + period_ns;
+            next.tv_sec += (time_t)(ns / NS_PER_SEC);
+            next.tv_nsec = (long)(ns % NS_PER_SEC);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        }
+        else
+        {
+            /* Back-pressure instead of overruns when benchmarking */
+            while (atomic_load(&wav_running) && ((audio_pool_depth(pool) + 1u) >= pool->block_count))
+            {
+                struct timespec wait = { 0, WAV_WAIT_NS };
+                nanosleep(&wait, NULL);
+            }
+        }
+
+        if (0u == wav_fill_block(audio_pool_producer_block(pool), pool->block_samples))
+        {
+            break;
+        }
+
+        source_stats.blocks++;
+        if (audio_pool_producer_commit(pool, (NULL != source_cfg.get_time) ? source_cfg.get_time() : 0u) &&
+            (NULL != source_cfg.block_ready))
+        {
+            source_cfg.block_ready(source_cfg.cb_ctx);
+        }
+    }
+
+    atomic_store(&wav_finished, true);
+    /* Wake the consumer so it can notice the end of the stream */
+    if (NULL != source_cfg.block_ready)
+    {
+        source_cfg.block_ready(source_cfg.cb_ctx);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: audio_source_wav_open
+*******************************************************************************/
+bool audio_source_wav_open(const char *path, bool realtime)
+{
+    wav_reader_close(&wav);
+    wav_realtime = realtime;
+
+    return wav_reader_open(&wav, path) && (wav.channels <= WAV_MAX_CHANNELS) && (0u != wav.sample_rate);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_wav_finished
+********************************************************************************
+* Summary:
+*  Returns true once the whole file was streamed.
+*
+*******************************************************************************/
+bool audio_source_wav_finished(void)
+{
+    return atomic_load(&wav_finished);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_wav_sample_rate
+*******************************************************************************/
+uint32_t audio_source_wav_sample_rate(void)
+{
+    return wav.sample_rate;
+}
+
+/*******************************************************************************
+* Function Name: audio_source_start
+********************************************************************************
+* Summary:
+*  Starts streaming the file selected by audio_source_wav_open(). The file
+*  needs at least config->channels channels.
+*
+*******************************************************************************/
+bool audio_source_start(const audio_source_config_t *config)
+{
+    uint32_t channels = (0u == config->channels) ? 1u : config->channels;
+
+    if ((NULL == wav.file) || (channels > wav.channels) || (channels > AUDIO_SOURCE_MAX_CHANNELS) ||
+        (0u != (config->pool->block_samples % channels)))
+    {
+        return false;
+    }
+
+    source_cfg = *config;
+    source_channels = channels;
+    memset(&source_stats, 0, sizeof(source_stats));
+    atomic_store(&wav_finished, false);
+    atomic_store(&wav_running, true);
+
+    wav_started = (0 == pthread_create(&wav_thread, NULL, wav_producer, NULL));
+
+    return wav_started;
+}
+
+/*******************************************************************************
+* Function Name: audio_source_stop
+*******************************************************************************/
+void audio_source_stop(void)
+{
+    atomic_store(&wav_running, false);
+    if (wav_started)
+    {
+        pthread_join(wav_thread, NULL);
+        wav_started = false;
+    }
+    wav_reader_close(&wav);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_get_block
+*******************************************************************************/
+const audio_pool_block_t* audio_source_get_block(uint32_t now)
+{
+    return audio_pool_consumer_get(source_cfg.pool, now);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_release_block
+*******************************************************************************/
+void audio_source_release_block(void)
+{
+    audio_pool_consumer_release(source_cfg.pool);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_get_stats
+*******************************************************************************/
+void audio_source_get_stats(audio_source_stats_t *stats)
+{
+    *stats = source_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,34 @@
+/******************************************************************************
+* File Name:   audio_source_wav.h
+*
+* Description: This file contains the host specific functions of the WAV
+*              file audio source implemented in audio_source_wav.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_SOURCE_WAV_H_
+#define AUDIO_SOURCE_WAV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_source.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Selects the file streamed by the next audio_source_start(). Real-time mode
+ * paces blocks at the file sample rate and drops blocks like the PDM ISR
+ * when the consumer falls behind. Otherwise blocks are produced as fast as
+ * the consumer releases them. */
+bool audio_source_wav_open(const char *path, bool realtime);
+bool audio_source_wav_finished(void);
+uint32_t audio_source_wav_sample_rate(void);
+
+#endif /* AUDIO_SOURCE_WAV_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name:   imai_aed_mock.c
+*
+* Description: This file implements a host stand-in for the IMAI queue API
+*              of the audio Ready Model libraries, which are only available
+*              for the CM55. It flags the last class of the model selected
+*              with -DCOUGH_MODEL, -DBABYCRY_MODEL or -DALARM_MODEL whenever
+*              the RMS level of a hop exceeds a threshold. The detections
+*              are not meaningful, the mock exercises the pipeline with the
+*              queue behaviour and class layout of the real library.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <string.h>
+
+#if defined(COUGH_MODEL)
+#include "cough_lib.h"
+#elif defined(BABYCRY_MODEL)
+#include "babycry_lib.h"
+#elif defined(ALARM_MODEL)
+#include "alarm_siren_lib.h"
+#else
+#error "Select the mocked model with -DCOUGH_MODEL, -DBABYCRY_MODEL or -DALARM_MODEL"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Samples per result, same as the hop of the audio Ready Models */
+#ifndef IMAI_MOCK_HOP_SAMPLES
+#define IMAI_MOCK_HOP_SAMPLES               (256u)
+#endif
+
+/* RMS level of a hop above which the last class is flagged */
+#ifndef IMAI_MOCK_THRESHOLD
+#define IMAI_MOCK_THRESHOLD                 (0.1f)
+#endif
+
+/* Results the library holds before enqueue returns IMAI_RET_NOMEM */
+#define IMAI_MOCK_QUEUE_DEPTH               (4u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static float mock_energy;
+static uint32_t mock_samples;
+static int mock_queue[IMAI_MOCK_QUEUE_DEPTH];
+static uint32_t mock_head;
+static uint32_t mock_count;
+
+/*******************************************************************************
+* Function Name: IMAI_AED_init
+*******************************************************************************/
+void IMAI_AED_init(void)
+{
+    mock_energy = 0.0f;
+    mock_samples = 0;
+    mock_head = 0;
+    mock_count = 0;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_AED_enqueue
+*******************************************************************************/
+int IMAI_AED_enqueue(const float *restrict data_in)
+{
+    if ((IMAI_MOCK_HOP_SAMPLES - 1u == mock_samples) && (IMAI_MOCK_QUEUE_DEPTH == mock_count))
+    {
+        return IMAI_RET_NOMEM;
+    }
+
+    mock_energy += data_in[0] * data_in[0];
+    if (++mock_samples == IMAI_MOCK_HOP_SAMPLES)
+    {
+        float rms = sqrtf(mock_energy / (float)IMAI_MOCK_HOP_SAMPLES);
+
+        mock_queue[(mock_head + mock_count) % IMAI_MOCK_QUEUE_DEPTH] = (rms > IMAI_MOCK_THRESHOLD) ? 1 : 0;
+        mock_count++;
+        mock_energy = 0.0f;
+        mock_samples = 0;
+    }
+
+    return IMAI_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_AED_dequeue
+*******************************************************************************/
+int IMAI_AED_dequeue(int *restrict data_out)
+{
+    if (0u == mock_count)
+    {
+        return IMAI_RET_NODATA;
+    }
+
+    memset(data_out, 0, IMAI_DATA_OUT_COUNT * sizeof(int));
+    data_out[IMAI_DATA_OUT_COUNT - 1] = mock_queue[mock_head];
+    mock_head = (mock_head + 1u) % IMAI_MOCK_QUEUE_DEPTH;
+    mock_count--;
+
+    return IMAI_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_AED_sensitivity
+*******************************************************************************/
+int IMAI_AED_sensitivity(PP_config_t postprocessing)
+{
+    (void)postprocessing;
+    return IMAI_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_AED_sensitivity_reset
+*******************************************************************************/
+void IMAI_AED_sensitivity_reset(void)
+{
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,153 @@
+/******************************************************************************
+* File Name:   wav_reader.c
+*
+* Description: This file implements a minimal reader for 16-bit PCM WAV
+*              files, used by the host stand-ins of the capture sources.
+*              Samples are read as is, so the host must be little-endian.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "wav_reader.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define WAV_FORMAT_PCM                      (1u)
+#define WAV_FORMAT_EXTENSIBLE               (0xFFFEu)
+#define WAV_BITS_PER_SAMPLE                 (16u)
+
+/*******************************************************************************
+* Function Name: wav_le16 / wav_le32
+*******************************************************************************/
+static uint16_t wav_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t wav_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+* Function Name: wav_reader_open
+********************************************************************************
+* Summary:
+*  Opens a RIFF/WAVE file and positions it at the start of the samples. Only
+*  16-bit PCM is supported.
+*
+* Return:
+*  false if the file cannot be opened or is not 16-bit PCM.
+*
+*******************************************************************************/
+bool wav_reader_open(wav_reader_t *wav, const char *path)
+{
+    uint8_t header[12];
+    uint8_t chunk[8];
+    bool have_format = false;
+
+    memset(wav, 0, sizeof(*wav));
+    wav->file = fopen(path, "rb");
+    if (NULL == wav->file)
+    {
+        return false;
+    }
+
+    if ((1u != fread(header, sizeof(header), 1u, wav->file)) ||
+        (0 != memcmp(header, "RIFF", 4)) || (0 != memcmp(&header[8], "WAVE", 4)))
+    {
+        wav_reader_close(wav);
+        return false;
+    }
+
+    while (1u == fread(chunk, sizeof(chunk), 1u, wav->file))
+    {
+        uint32_t size = wav_le32(&chunk[4]);
+
+        if (0 == memcmp(chunk, "fmt ", 4))
+        {
+            uint8_t fmt[16];
+            uint16_t format;
+
+            if ((size < sizeof(fmt)) || (1u != fread(fmt, sizeof(fmt), 1u, wav->file)))
+            {
+                break;
+            }
+            format = wav_le16(&fmt[0]);
+            wav->channels = wav_le16(&fmt[2]);
+            wav->sample_rate = wav_le32(&fmt[4]);
+            have_format = ((WAV_FORMAT_PCM == format) || (WAV_FORMAT_EXTENSIBLE == format)) &&
+                          (WAV_BITS_PER_SAMPLE == wav_le16(&fmt[14])) && (0u != wav->channels);
+            size -= sizeof(fmt);
+        }
+        else if (0 == memcmp(chunk, "data", 4))
+        {
+            if (!have_format)
+            {
+                break;
+            }
+            wav->frames = size / (wav->channels * sizeof(int16_t));
+            wav->data_offset = ftell(wav->file);
+            return true;
+        }
+
+        /* Skip the rest of the chunk, chunks are padded to even sizes */
+        if (0 != fseek(wav->file, (long)(size + (size & 1u)), SEEK_CUR))
+        {
+            break;
+        }
+    }
+
+    wav_reader_close(wav);
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: wav_reader_read
+********************************************************************************
+* Summary:
+*  Reads up to max_frames interleaved frames.
+*
+* Return:
+*  Number of frames read, 0 at the end of the data.
+*
+*******************************************************************************/
+uint32_t wav_reader_read(wav_reader_t *wav, int16_t *frames, uint32_t max_frames)
+{
+    uint32_t left = wav->frames - wav->frames_read;
+    uint32_t count = (max_frames < left) ? max_frames : left;
+
+    count = (uint32_t)fread(frames, wav->channels * sizeof(int16_t), count, wav->file);
+    wav->frames_read += count;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: wav_reader_rewind
+*******************************************************************************/
+bool wav_reader_rewind(wav_reader_t *wav)
+{
+    wav->frames_read = 0;
+    return (0 == fseek(wav->file, wav->data_offset, SEEK_SET));
+}
+
+/*******************************************************************************
+* Function Name: wav_reader_close
+*******************************************************************************/
+void wav_reader_close(wav_reader_t *wav)
+{
+    if (NULL != wav->file)
+    {
+        fclose(wav->file);
+        wav->file = NULL;
+    }
+}
+
+/* [] END OF FILE */
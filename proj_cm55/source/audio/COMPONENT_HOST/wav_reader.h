@@ -0,0 +1,44 @@
+/******************************************************************************
+* File Name:   wav_reader.h
+*
+* Description: This file contains the types and function prototypes of the
+*              host WAV file reader implemented in wav_reader.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef WAV_READER_H_
+#define WAV_READER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    FILE        *file;
+    uint32_t    sample_rate;
+    uint16_t    channels;
+    uint32_t    frames;         /* Frames (samples per channel) in the data chunk */
+    uint32_t    frames_read;
+    long        data_offset;    /* File offset of the first sample */
+} wav_reader_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool wav_reader_open(wav_reader_t *wav, const char *path);
+uint32_t wav_reader_read(wav_reader_t *wav, int16_t *frames, uint32_t max_frames);
+bool wav_reader_rewind(wav_reader_t *wav);
+void wav_reader_close(wav_reader_t *wav);
+
+#endif /* WAV_READER_H_ */
+
+/* [] END OF FILE */
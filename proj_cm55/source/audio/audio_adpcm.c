@@ -0,0 +1,184 @@
+/******************************************************************************
+* File Name:   audio_adpcm.c
+*
+* Description: This file implements an IMA-ADPCM coder. Every 16-bit sample
+*              is coded as a 4-bit step relative to a predictor, which
+*              compresses PCM audio 4:1. Two codes are packed per byte, low
+*              nibble first. The coder has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include "audio_adpcm.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define ADPCM_STEP_INDEX_MAX                (88)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const int16_t adpcm_step_table[ADPCM_STEP_INDEX_MAX + 1] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t adpcm_index_table[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/*******************************************************************************
+* Function Name: adpcm_update
+********************************************************************************
+* Summary:
+*  Applies one 4-bit code to the coder state, identical for the encoder and
+*  the decoder so both track the same predictor.
+*
+*******************************************************************************/
+static inline void adpcm_update(audio_adpcm_state_t *state, uint8_t code)
+{
+    int32_t step = adpcm_step_table[state->step_index];
+    int32_t diff = step >> 3;
+
+    if (code & 4u)
+    {
+        diff += step;
+    }
+    if (code & 2u)
+    {
+        diff += step >> 1;
+    }
+    if (code & 1u)
+    {
+        diff += step >> 2;
+    }
+
+    state->predictor += (code & 8u) ? -diff : diff;
+    if (state->predictor > INT16_MAX)
+    {
+        state->predictor = INT16_MAX;
+    }
+    else if (state->predictor < INT16_MIN)
+    {
+        state->predictor = INT16_MIN;
+    }
+
+    state->step_index += adpcm_index_table[code];
+    if (state->step_index < 0)
+    {
+        state->step_index = 0;
+    }
+    else if (state->step_index > ADPCM_STEP_INDEX_MAX)
+    {
+        state->step_index = ADPCM_STEP_INDEX_MAX;
+    }
+}
+
+/*******************************************************************************
+* Function Name: adpcm_encode_sample
+*******************************************************************************/
+static inline uint8_t adpcm_encode_sample(audio_adpcm_state_t *state, int16_t sample)
+{
+    int32_t step = adpcm_step_table[state->step_index];
+    int32_t diff = (int32_t)sample - state->predictor;
+    uint8_t code = 0;
+
+    if (diff < 0)
+    {
+        code = 8u;
+        diff = -diff;
+    }
+    if (diff >= step)
+    {
+        code |= 4u;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        code |= 2u;
+        diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        code |= 1u;
+    }
+
+    adpcm_update(state, code);
+
+    return code;
+}
+
+/*******************************************************************************
+* Function Name: audio_adpcm_reset
+*******************************************************************************/
+void audio_adpcm_reset(audio_adpcm_state_t *state)
+{
+    state->predictor = 0;
+    state->step_index = 0;
+}
+
+/*******************************************************************************
+* Function Name: audio_adpcm_encode
+********************************************************************************
+* Summary:
+*  Encodes PCM samples, continuing from the given state.
+*
+* Parameters:
+*  state : coder state, updated
+*  pcm   : input samples
+*  count : number of samples, must be even
+*  out   : receives count / 2 bytes
+*
+*******************************************************************************/
+void audio_adpcm_encode(audio_adpcm_state_t *state, const int16_t *pcm, uint32_t count, uint8_t *out)
+{
+    for (uint32_t i = 0; i < count; i += 2u)
+    {
+        uint8_t low = adpcm_encode_sample(state, pcm[i]);
+        uint8_t high = adpcm_encode_sample(state, pcm[i + 1u]);
+
+        *out++ = (uint8_t)(low | (high << 4));
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_adpcm_decode
+********************************************************************************
+* Summary:
+*  Decodes ADPCM data, continuing from the given state.
+*
+* Parameters:
+*  state : coder state, updated
+*  in    : count / 2 bytes of codes
+*  count : number of samples, must be even
+*  pcm   : receives the samples
+*
+*******************************************************************************/
+void audio_adpcm_decode(audio_adpcm_state_t *state, const uint8_t *in, uint32_t count, int16_t *pcm)
+{
+    for (uint32_t i = 0; i < count; i += 2u)
+    {
+        uint8_t codes = *in++;
+
+        adpcm_update(state, codes & 0x0Fu);
+        pcm[i] = (int16_t)state->predictor;
+        adpcm_update(state, codes >> 4);
+        pcm[i + 1u] = (int16_t)state->predictor;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,37 @@
+/******************************************************************************
+* File Name:   audio_adpcm.h
+*
+* Description: This file contains the function prototypes of the IMA-ADPCM
+*              coder implemented in audio_adpcm.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_ADPCM_H_
+#define AUDIO_ADPCM_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    int32_t     predictor;
+    int32_t     step_index;
+} audio_adpcm_state_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void audio_adpcm_reset(audio_adpcm_state_t *state);
+void audio_adpcm_encode(audio_adpcm_state_t *state, const int16_t *pcm, uint32_t count, uint8_t *out);
+void audio_adpcm_decode(audio_adpcm_state_t *state, const uint8_t *in, uint32_t count, int16_t *pcm);
+
+#endif /* AUDIO_ADPCM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,199 @@
+/******************************************************************************
+* File Name:   audio_clip_ring.c
+*
+* Description: This file implements the pre-trigger audio clip recorder.
+*              Captured blocks are compressed with IMA-ADPCM into a ring
+*              holding the last seconds of audio. A trigger records a
+*              number of post-trigger blocks and then freezes the ring and
+*              describes the clip in an audio_clip_desc_t. Recording resumes
+*              once the reader sets the descriptor back to
+*              AUDIO_CLIP_STATE_FREE. The recorder has no hardware
+*              dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "audio_clip_ring.h"
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_freeze
+********************************************************************************
+* Summary:
+*  Describes the recorded blocks in the descriptor and hands it to the
+*  reader. The state is written last.
+*
+*******************************************************************************/
+static void audio_clip_ring_freeze(audio_clip_ring_t *clip)
+{
+    audio_clip_desc_t *desc = clip->desc;
+
+    desc->clip_id++;
+    desc->first_block = (clip->write_block + clip->ring_blocks - clip->filled) % clip->ring_blocks;
+    desc->block_count = clip->filled;
+    desc->trigger_block = (clip->filled > clip->post_blocks) ? (clip->filled - clip->post_blocks - 1u) : 0u;
+
+    clip->triggered = false;
+    clip->frozen = true;
+    clip->stats.clips++;
+
+    desc->state = AUDIO_CLIP_STATE_READY;
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_init
+********************************************************************************
+* Summary:
+*  Initializes the recorder.
+*
+* Parameters:
+*  clip          : recorder context
+*  desc          : clip descriptor shared with the reader
+*  storage       : ring_blocks * AUDIO_CLIP_BLOCK_BYTES(block_samples) bytes
+*  ring_blocks   : blocks in the ring, the longest clip
+*  block_samples : samples per block, even
+*  sample_rate   : sample rate reported in the descriptor
+*  post_blocks   : blocks recorded after the trigger, 1..ring_blocks - 1
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool audio_clip_ring_init(audio_clip_ring_t *clip, audio_clip_desc_t *desc, uint8_t *storage,
+                          uint32_t ring_blocks, uint32_t block_samples, uint32_t sample_rate,
+                          uint32_t post_blocks)
+{
+    if ((NULL == desc) || (NULL == storage) || (0u == block_samples) || (0u != (block_samples % 2u)) ||
+        (0u == post_blocks) || (post_blocks >= ring_blocks))
+    {
+        return false;
+    }
+
+    memset(clip, 0, sizeof(*clip));
+    clip->desc = desc;
+    clip->ring = storage;
+    clip->ring_blocks = ring_blocks;
+    clip->block_samples = block_samples;
+    clip->block_bytes = AUDIO_CLIP_BLOCK_BYTES(block_samples);
+    clip->post_blocks = post_blocks;
+    audio_adpcm_reset(&clip->coder);
+
+    memset(desc, 0, sizeof(*desc));
+    desc->sample_rate = sample_rate;
+    desc->block_samples = block_samples;
+    desc->block_bytes = clip->block_bytes;
+    desc->ring_addr = (uint32_t)(uintptr_t)storage;
+    desc->ring_blocks = ring_blocks;
+    desc->state = AUDIO_CLIP_STATE_FREE;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_push
+********************************************************************************
+* Summary:
+*  Compresses one block into the ring. While a frozen clip is held by the
+*  reader the block is not recorded.
+*
+* Parameters:
+*  clip : recorder context
+*  pcm  : block_samples PCM samples
+*
+* Return:
+*  true if this block completed a clip, the descriptor is then ready to be
+*  sent to the reader.
+*
+*******************************************************************************/
+bool audio_clip_ring_push(audio_clip_ring_t *clip, const int16_t *pcm)
+{
+    if (clip->frozen)
+    {
+        if (AUDIO_CLIP_STATE_FREE != clip->desc->state)
+        {
+            clip->stats.paused_blocks++;
+            return false;
+        }
+        /* Released by the reader, start a new recording */
+        clip->frozen = false;
+        clip->filled = 0;
+    }
+
+    uint8_t *block = &clip->ring[clip->write_block * clip->block_bytes];
+    audio_clip_block_header_t header =
+    {
+        .predictor = (int16_t)clip->coder.predictor,
+        .step_index = (uint8_t)clip->coder.step_index,
+        .reserved = 0
+    };
+
+    memcpy(block, &header, sizeof(header));
+    audio_adpcm_encode(&clip->coder, pcm, clip->block_samples, block + sizeof(header));
+
+    clip->write_block = (clip->write_block + 1u) % clip->ring_blocks;
+    if (clip->filled < clip->ring_blocks)
+    {
+        clip->filled++;
+    }
+    clip->stats.blocks++;
+
+    if (clip->triggered && (0u == --clip->post_remaining))
+    {
+        audio_clip_ring_freeze(clip);
+        return true;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_trigger
+********************************************************************************
+* Summary:
+*  Marks the last pushed block as the event. The clip is frozen after
+*  post_blocks more blocks.
+*
+* Return:
+*  false if a clip is already being completed or held by the reader.
+*
+*******************************************************************************/
+bool audio_clip_ring_trigger(audio_clip_ring_t *clip, uint32_t label_id)
+{
+    if (clip->triggered || clip->frozen || (0u == clip->filled))
+    {
+        clip->stats.busy_triggers++;
+        return false;
+    }
+
+    clip->triggered = true;
+    clip->post_remaining = clip->post_blocks;
+    clip->desc->label_id = label_id;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_block
+********************************************************************************
+* Summary:
+*  Returns block index (0 is the oldest) of a frozen clip, for the reader.
+*
+*******************************************************************************/
+const uint8_t* audio_clip_ring_block(const audio_clip_desc_t *desc, const uint8_t *ring, uint32_t index)
+{
+    return &ring[((desc->first_block + index) % desc->ring_blocks) * desc->block_bytes];
+}
+
+/*******************************************************************************
+* Function Name: audio_clip_ring_get_stats
+*******************************************************************************/
+void audio_clip_ring_get_stats(const audio_clip_ring_t *clip, audio_clip_ring_stats_t *stats)
+{
+    *stats = clip->stats;
+}
+
+/* [] END OF FILE */
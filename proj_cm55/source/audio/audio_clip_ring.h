@@ -0,0 +1,70 @@
+/******************************************************************************
+* File Name:   audio_clip_ring.h
+*
+* Description: This file contains the types and function prototypes of the
+*              pre-trigger audio clip recorder implemented in
+*              audio_clip_ring.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_CLIP_RING_H_
+#define AUDIO_CLIP_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_clip.h"
+#include "audio_adpcm.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Bytes of one ADPCM block in the ring */
+#define AUDIO_CLIP_BLOCK_BYTES(samples)     (sizeof(audio_clip_block_header_t) + ((samples) / 2u))
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t    blocks;             /* Blocks encoded */
+    uint32_t    clips;              /* Clips frozen */
+    uint32_t    busy_triggers;      /* Triggers ignored while a clip was pending */
+    uint32_t    paused_blocks;      /* Blocks not recorded while the CM33 held the clip */
+} audio_clip_ring_stats_t;
+
+typedef struct
+{
+    audio_clip_desc_t       *desc;
+    uint8_t                 *ring;
+    uint32_t                ring_blocks;
+    uint32_t                block_samples;
+    uint32_t                block_bytes;
+    uint32_t                post_blocks;
+    uint32_t                write_block;    /* Ring index of the next block */
+    uint32_t                filled;         /* Blocks recorded since recording (re)started */
+    uint32_t                post_remaining;
+    bool                    triggered;
+    bool                    frozen;
+    audio_adpcm_state_t     coder;
+    audio_clip_ring_stats_t stats;
+} audio_clip_ring_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool audio_clip_ring_init(audio_clip_ring_t *clip, audio_clip_desc_t *desc, uint8_t *storage,
+                          uint32_t ring_blocks, uint32_t block_samples, uint32_t sample_rate,
+                          uint32_t post_blocks);
+bool audio_clip_ring_push(audio_clip_ring_t *clip, const int16_t *pcm);
+bool audio_clip_ring_trigger(audio_clip_ring_t *clip, uint32_t label_id);
+const uint8_t* audio_clip_ring_block(const audio_clip_desc_t *desc, const uint8_t *ring, uint32_t index);
+void audio_clip_ring_get_stats(const audio_clip_ring_t *clip, audio_clip_ring_stats_t *stats);
+
+#endif /* AUDIO_CLIP_RING_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,303 @@
+/******************************************************************************
+* File Name:   audio_core.c
+*
+* Description: This file implements the per-frame audio detection pipeline
+*              shared by audio_task and the host replay: PCM normalization
+*              and clamping, the activity gate, feeding the models through
+*              the audio hub, smoothing of the model results and mapping of
+*              the classes to unique label IDs. It has no hardware
+*              dependencies, the caller forwards the reported events.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "audio_core.h"
+
+#if defined(ARM_MATH_HELIUM) || defined(ARM_MATH_DSP)
+#define AUDIO_CORE_USE_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Converts a q15 sample into the range [-1, 1) */
+#define AUDIO_CORE_Q15_SCALE                (1.0f / 32768.0f)
+
+/*******************************************************************************
+* Function Name: audio_core_convert
+********************************************************************************
+* Summary:
+*  Converts a PCM frame to normalized float samples in core->block. The gain
+*  is applied before clamping to [-1, 1].
+*
+*******************************************************************************/
+static void audio_core_convert(audio_core_t *core, const int16_t *frame)
+{
+    uint32_t count = core->cfg.frame_samples;
+    float boost = core->cfg.boost;
+
+#ifdef AUDIO_CORE_USE_CMSIS_DSP
+    if (!core->cfg.per_sample)
+    {
+        /* q15 to float scales by 1/32768 */
+        arm_q15_to_float((const q15_t*)frame, core->block, count);
+        if (1.0f != boost)
+        {
+            arm_scale_f32(core->block, boost, core->block, count);
+            arm_clip_f32(core->block, core->block, -1.0f, 1.0f, count);
+        }
+        return;
+    }
+#endif
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float sample = (float)frame[i] * AUDIO_CORE_Q15_SCALE * boost;
+
+        if (sample > 1.0f)
+        {
+            sample = 1.0f;
+        }
+        else if (sample < -1.0f)
+        {
+            sample = -1.0f;
+        }
+        core->block[i] = sample;
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_core_handle_result
+********************************************************************************
+* Summary:
+*  Smooths one model result and reports changes of the smoothed state.
+*
+* Parameters:
+*  core         : core context
+*  model        : index in cfg.models
+*  flags        : trigger flags returned by the model dequeue
+*  capture_time : capture time of the sample that completed the result
+*
+*******************************************************************************/
+static void audio_core_handle_result(audio_core_t *core, uint32_t model, const int *flags, uint32_t capture_time)
+{
+    const audio_model_t *desc = core->cfg.models[model];
+    audio_core_event_t event;
+    int state;
+
+    if (!postprocess_update(&core->pp[model], postprocess_flags_to_class(flags, desc->class_count), &state))
+    {
+        return;
+    }
+
+    if (state != POSTPROCESS_BACKGROUND_CLASS)
+    {
+        core->stats.detections[model][state]++;
+    }
+    core->stats.events++;
+
+    event.model = model;
+    event.class_id = state;
+    event.label_id = audio_hub_class_id(&core->hub, model, state);
+    event.label = desc->labels[state];
+    event.capture_time = capture_time;
+    core->cfg.event_cb(&event, core->cfg.cb_ctx);
+}
+
+/*******************************************************************************
+* Function Name: audio_core_hub_result
+********************************************************************************
+* Summary:
+*  Called by the hub for every result of a model.
+*
+*******************************************************************************/
+static void audio_core_hub_result(uint32_t model, int status, const int *flags, uint32_t capture_time, void *ctx)
+{
+    audio_core_t *core = (audio_core_t*)ctx;
+    bool report = false;
+
+    switch (status)
+    {
+        case AUDIO_MODEL_RET_SUCCESS:
+            core->success[model] = true;
+            core->stats.results++;
+            if (NULL != core->cfg.get_time)
+            {
+                audio_latency_add(&core->latency, core->cfg.get_time() - capture_time);
+            }
+            audio_core_handle_result(core, model, flags, capture_time);
+            break;
+        case AUDIO_MODEL_RET_NOMEM:
+            report = true;
+            break;
+        case AUDIO_MODEL_RET_TIMEDOUT:
+            report = core->success[model];
+            core->success[model] = false;
+            break;
+        default:
+            break;
+    }
+
+    if (report && (NULL != core->cfg.status_cb))
+    {
+        core->cfg.status_cb(model, status, core->cfg.cb_ctx);
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_core_feed
+********************************************************************************
+* Summary:
+*  Passes a block of normalized samples to all models. Also used as the
+*  emit callback of the gate.
+*
+*******************************************************************************/
+static void audio_core_feed(const float *block, uint32_t capture_time, void *ctx)
+{
+    audio_core_t *core = (audio_core_t*)ctx;
+
+    audio_hub_push(&core->hub, block, core->cfg.frame_samples, capture_time);
+    audio_hub_run(&core->hub);
+}
+
+/*******************************************************************************
+* Function Name: audio_core_gate_closed
+********************************************************************************
+* Summary:
+*  The models get no more results once the gate closes. Feeds background
+*  results so an event still reported is cleared like with running models,
+*  and the initial background state is reported if the models never ran.
+*
+*******************************************************************************/
+static void audio_core_gate_closed(audio_core_t *core, uint32_t capture_time)
+{
+    static const int background[AUDIO_HUB_MAX_CLASSES] = {0};
+
+    for (uint32_t m = 0; m < core->cfg.model_count; m++)
+    {
+        for (uint32_t i = 0; i < core->cfg.exit_count; i++)
+        {
+            audio_core_handle_result(core, m, background, capture_time);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_core_init
+********************************************************************************
+* Summary:
+*  Initializes the hub, the models and the smoothing of every model. The
+*  smoothing reports a detection once and ends the event after
+*  cfg.exit_count results without it.
+*
+* Parameters:
+*  core : core context
+*  cfg  : configuration, copied. The models, ring and gate must stay valid.
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool audio_core_init(audio_core_t *core, const audio_core_cfg_t *cfg)
+{
+    audio_hub_cfg_t hub_cfg =
+    {
+        .ring = cfg->hub_ring,
+        .ring_samples = cfg->hub_ring_samples,
+        .hop_samples = cfg->hop_samples,
+        .sample_rate = cfg->sample_rate,
+        .time_scale = cfg->time_scale,
+        .result_cb = audio_core_hub_result,
+        .cb_ctx = core,
+        .get_cycles = cfg->get_cycles,
+        .capture_gain_db = cfg->capture_gain_db
+    };
+
+    if ((0u == cfg->frame_samples) || (cfg->frame_samples > AUDIO_CORE_MAX_FRAME) ||
+        (NULL == cfg->event_cb))
+    {
+        return false;
+    }
+
+    memset(core, 0, sizeof(*core));
+    core->cfg = *cfg;
+    if (!audio_hub_init(&core->hub, &hub_cfg, cfg->models, cfg->model_count))
+    {
+        return false;
+    }
+    audio_latency_init(&core->latency, cfg->latency_bucket);
+
+    /* The tables are filled at run time as the class count differs between the models */
+    for (uint32_t m = 0; m < cfg->model_count; m++)
+    {
+        core->pp_classes[m][0].vote_k = 1u;
+        for (uint32_t c = 1; c < cfg->models[m]->class_count; c++)
+        {
+            core->pp_classes[m][c].vote_k = 1u;
+            core->pp_classes[m][c].enter_count = 1u;
+            core->pp_classes[m][c].exit_count = cfg->exit_count;
+        }
+        core->pp_cfg[m].window = 1u;
+        core->pp_cfg[m].class_count = cfg->models[m]->class_count;
+        core->pp_cfg[m].classes = core->pp_classes[m];
+        if (!postprocess_init(&core->pp[m], &core->pp_cfg[m]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_core_process
+********************************************************************************
+* Summary:
+*  Runs one captured frame through the pipeline. Events are reported through
+*  cfg.event_cb before the function returns.
+*
+* Parameters:
+*  core         : core context
+*  frame        : cfg.frame_samples PCM samples
+*  capture_time : capture time of the last sample of the frame
+*
+*******************************************************************************/
+void audio_core_process(audio_core_t *core, const int16_t *frame, uint32_t capture_time)
+{
+    audio_gate_t *gate = core->cfg.gate;
+
+    core->stats.frames++;
+    audio_core_convert(core, frame);
+
+    if (NULL == gate)
+    {
+        audio_core_feed(core->block, capture_time, core);
+    }
+    else
+    {
+        bool was_open = audio_gate_is_open(gate);
+
+        /* A gate closed from the first frame on never lets the models report the initial state */
+        if (!audio_gate_process(gate, core->block, capture_time, audio_core_feed, core) &&
+            (was_open || (1u == core->stats.frames)))
+        {
+            audio_core_gate_closed(core, capture_time);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_core_get_stats
+*******************************************************************************/
+void audio_core_get_stats(const audio_core_t *core, audio_core_stats_t *stats)
+{
+    *stats = core->stats;
+}
+
+/* [] END OF FILE */
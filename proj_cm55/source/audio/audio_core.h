@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   audio_core.h
+*
+* Description: This file contains the types and function prototypes of the
+*              hardware-free audio detection pipeline implemented in
+*              audio_core.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_CORE_H_
+#define AUDIO_CORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "postprocess.h"
+#include "audio_hub.h"
+#include "audio_gate.h"
+#include "audio_latency.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_CORE_MAX_FRAME                (1024u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Change of the smoothed state of a model */
+typedef struct
+{
+    uint32_t    model;          /* Index in cfg.models */
+    int         class_id;       /* Class of the model, 0 when the event ended */
+    uint32_t    label_id;       /* Class ID unique across the models, see audio_hub_class_id() */
+    const char  *label;
+    uint32_t    capture_time;   /* Capture time of the sample that completed the result */
+} audio_core_event_t;
+
+typedef void (*audio_core_event_cb_t)(const audio_core_event_t *event, void *ctx);
+
+/* Invoked for AUDIO_MODEL_RET_NOMEM and when a model times out after it
+ * returned results, i.e. at the end of the evaluation period */
+typedef void (*audio_core_status_cb_t)(uint32_t model, int status, void *ctx);
+
+typedef uint32_t (*audio_core_time_fn_t)(void);
+
+typedef struct
+{
+    const audio_model_t *const  *models;
+    uint32_t                    model_count;
+    uint32_t                    frame_samples;  /* Up to AUDIO_CORE_MAX_FRAME */
+    uint32_t                    sample_rate;
+    uint32_t                    time_scale;     /* Units per second of the capture times */
+    float                       boost;          /* Gain applied before clamping to [-1, 1] */
+    uint8_t                     capture_gain_db;    /* Microphone gain, 0 if unknown, see audio_hub_cfg_t */
+    bool                        per_sample;     /* Scalar reference conversion instead of CMSIS-DSP */
+    float                       *hub_ring;
+    uint32_t                    hub_ring_samples;
+    uint32_t                    hop_samples;
+    audio_gate_t                *gate;          /* Initialized gate, NULL feeds every frame */
+    uint8_t                     exit_count;     /* Results without a detection to end an event */
+    uint32_t                    latency_bucket;
+    audio_core_event_cb_t       event_cb;
+    audio_core_status_cb_t      status_cb;      /* May be NULL */
+    void                        *cb_ctx;
+    audio_core_time_fn_t        get_time;       /* Same units as the capture times, NULL disables the latency */
+    audio_hub_cycles_fn_t       get_cycles;     /* May be NULL */
+} audio_core_cfg_t;
+
+typedef struct
+{
+    uint32_t    frames;
+    uint32_t    results;        /* Successful model dequeues */
+    uint32_t    events;         /* Smoothed state changes reported */
+    uint32_t    detections[AUDIO_HUB_MAX_MODELS][AUDIO_HUB_MAX_CLASSES];
+} audio_core_stats_t;
+
+typedef struct
+{
+    audio_core_cfg_t        cfg;
+    audio_hub_t             hub;
+    postprocess_class_cfg_t pp_classes[AUDIO_HUB_MAX_MODELS][AUDIO_HUB_MAX_CLASSES];
+    postprocess_cfg_t       pp_cfg[AUDIO_HUB_MAX_MODELS];
+    postprocess_ctx_t       pp[AUDIO_HUB_MAX_MODELS];
+    bool                    success[AUDIO_HUB_MAX_MODELS];
+    audio_latency_t         latency;        /* Capture to model result */
+    audio_core_stats_t      stats;
+    float                   block[AUDIO_CORE_MAX_FRAME];
+} audio_core_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool audio_core_init(audio_core_t *core, const audio_core_cfg_t *cfg);
+void audio_core_process(audio_core_t *core, const int16_t *frame, uint32_t capture_time);
+void audio_core_get_stats(const audio_core_t *core, audio_core_stats_t *stats);
+
+#endif /* AUDIO_CORE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,440 @@
+/******************************************************************************
+* File Name:   audio_gate.c
+*
+* Description: This file implements an activity gate in front of the audio
+*              models. Each block is scored with its energy, zero crossing
+*              rate and spectral flux against an adaptive noise floor. While
+*              the gate is closed the blocks are kept in a short pre-roll
+*              which is replayed when the gate opens, so the model still
+*              sees the onset of an event. CMSIS-DSP is used when available,
+*              plain C otherwise.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include <math.h>
+#include "audio_gate.h"
+
+#if defined(ARM_MATH_HELIUM) || defined(ARM_MATH_DSP)
+#define AUDIO_GATE_USE_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_GATE_BINS                     (AUDIO_GATE_FFT_SIZE / 2u)
+
+/* Activity with a high zero crossing rate is only rejected below this
+ * multiple of the open level */
+#define AUDIO_GATE_HISS_MARGIN              (4.0f)
+
+#define AUDIO_GATE_MIN_FLOOR                (1e-10f)
+#define AUDIO_GATE_EPSILON                  (1e-12f)
+
+#define AUDIO_GATE_PI                       (3.14159265358979f)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Scratch buffers of the spectral flux, shared by all gates */
+static float gate_window[AUDIO_GATE_FFT_SIZE];
+static float gate_fft_in[AUDIO_GATE_FFT_SIZE];
+static float gate_mag[AUDIO_GATE_BINS];
+static bool gate_tables_ready = false;
+
+#ifdef AUDIO_GATE_USE_CMSIS_DSP
+static arm_rfft_fast_instance_f32 gate_rfft;
+static float gate_fft_out[AUDIO_GATE_FFT_SIZE];
+#else
+static float gate_cos[AUDIO_GATE_FFT_SIZE];
+static float gate_sin[AUDIO_GATE_FFT_SIZE];
+#endif
+
+/*******************************************************************************
+* Function Name: audio_gate_init_tables
+********************************************************************************
+* Summary:
+*  Prepares the analysis window and the transform on first use.
+*
+*******************************************************************************/
+static void audio_gate_init_tables(void)
+{
+    if (gate_tables_ready)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < AUDIO_GATE_FFT_SIZE; i++)
+    {
+        gate_window[i] = 0.5f - 0.5f * cosf((2.0f * AUDIO_GATE_PI * (float)i) / (float)AUDIO_GATE_FFT_SIZE);
+#ifndef AUDIO_GATE_USE_CMSIS_DSP
+        gate_cos[i] = cosf((2.0f * AUDIO_GATE_PI * (float)i) / (float)AUDIO_GATE_FFT_SIZE);
+        gate_sin[i] = sinf((2.0f * AUDIO_GATE_PI * (float)i) / (float)AUDIO_GATE_FFT_SIZE);
+#endif
+    }
+#ifdef AUDIO_GATE_USE_CMSIS_DSP
+    arm_rfft_fast_init_f32(&gate_rfft, AUDIO_GATE_FFT_SIZE);
+#endif
+
+    gate_tables_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_energy
+********************************************************************************
+* Summary:
+*  Returns the mean square of the block.
+*
+*******************************************************************************/
+static float audio_gate_energy(const float *block, uint32_t count)
+{
+    float power;
+
+#ifdef AUDIO_GATE_USE_CMSIS_DSP
+    arm_power_f32(block, count, &power);
+#else
+    power = 0.0f;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        power += block[i] * block[i];
+    }
+#endif
+
+    return power / (float)count;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_zcr
+********************************************************************************
+* Summary:
+*  Returns the zero crossings per sample, including the crossing from the
+*  last sample of the previous block.
+*
+*******************************************************************************/
+static float audio_gate_zcr(audio_gate_t *gate, const float *block, uint32_t count)
+{
+    uint32_t crossings = ((gate->last_sample < 0.0f) != (block[0] < 0.0f)) ? 1u : 0u;
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        crossings += ((block[i - 1] < 0.0f) != (block[i] < 0.0f)) ? 1u : 0u;
+    }
+    gate->last_sample = block[count - 1u];
+
+    return (float)crossings / (float)count;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_magnitude
+********************************************************************************
+* Summary:
+*  Computes the magnitude spectrum of the windowed gate_fft_in into gate_mag.
+*  The Nyquist bin is not used.
+*
+*******************************************************************************/
+static void audio_gate_magnitude(void)
+{
+#ifdef AUDIO_GATE_USE_CMSIS_DSP
+    arm_mult_f32(gate_fft_in, gate_window, gate_fft_in, AUDIO_GATE_FFT_SIZE);
+    /* Modifies the input buffer, gate_fft_in is a scratch copy */
+    arm_rfft_fast_f32(&gate_rfft, gate_fft_in, gate_fft_out, 0);
+    /* Bin 0 carries DC and Nyquist packed together, DC is not of interest */
+    gate_fft_out[1] = 0.0f;
+    arm_cmplx_mag_f32(gate_fft_out, gate_mag, AUDIO_GATE_BINS);
+#else
+    for (uint32_t i = 0; i < AUDIO_GATE_FFT_SIZE; i++)
+    {
+        gate_fft_in[i] *= gate_window[i];
+    }
+    for (uint32_t k = 0; k < AUDIO_GATE_BINS; k++)
+    {
+        float re = 0.0f;
+        float im = 0.0f;
+
+        for (uint32_t n = 0; n < AUDIO_GATE_FFT_SIZE; n++)
+        {
+            uint32_t idx = (k * n) % AUDIO_GATE_FFT_SIZE;
+            re += gate_fft_in[n] * gate_cos[idx];
+            im -= gate_fft_in[n] * gate_sin[idx];
+        }
+        gate_mag[k] = sqrtf((re * re) + (im * im));
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_flux
+********************************************************************************
+* Summary:
+*  Returns the positive spectral change of the end of the block against the
+*  previous block, relative to the spectrum magnitude.
+*
+*******************************************************************************/
+static float audio_gate_flux(audio_gate_t *gate, const float *block, uint32_t count)
+{
+    float rise = 0.0f;
+    float total = 0.0f;
+
+    memcpy(gate_fft_in, &block[count - AUDIO_GATE_FFT_SIZE], sizeof(gate_fft_in));
+    audio_gate_magnitude();
+
+    /* DC is ignored */
+    for (uint32_t k = 1; k < AUDIO_GATE_BINS; k++)
+    {
+        float diff = gate_mag[k] - gate->spectrum[k];
+
+        if (diff > 0.0f)
+        {
+            rise += diff;
+        }
+        total += gate_mag[k];
+        gate->spectrum[k] = gate_mag[k];
+    }
+
+    return rise / (total + AUDIO_GATE_EPSILON);
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_store_preroll
+*******************************************************************************/
+static void audio_gate_store_preroll(audio_gate_t *gate, const float *block, uint32_t tag)
+{
+    uint8_t blocks = gate->cfg.preroll_blocks;
+
+    if (0u == blocks)
+    {
+        return;
+    }
+
+    memcpy(&gate->preroll[gate->preroll_pos * gate->block_samples], block, gate->block_samples * sizeof(float));
+    gate->preroll_tags[gate->preroll_pos] = tag;
+    gate->preroll_pos = (uint8_t)((gate->preroll_pos + 1u) % blocks);
+    if (gate->preroll_len < blocks)
+    {
+        gate->preroll_len++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_replay_preroll
+*******************************************************************************/
+static void audio_gate_replay_preroll(audio_gate_t *gate, audio_gate_emit_fn_t emit, void *ctx)
+{
+    uint8_t blocks = gate->cfg.preroll_blocks;
+
+    for (uint8_t i = 0; i < gate->preroll_len; i++)
+    {
+        uint32_t slot = (gate->preroll_pos + blocks - gate->preroll_len + i) % blocks;
+        emit(&gate->preroll[slot * gate->block_samples], gate->preroll_tags[slot], ctx);
+    }
+    gate->stats.preroll_blocks += gate->preroll_len;
+    gate->preroll_len = 0;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_default_config
+********************************************************************************
+* Summary:
+*  Returns conservative defaults: the gate opens 6 dB above the noise floor
+*  and stays open for about a second at 1024 samples per block and 16 kHz,
+*  also after init.
+*
+*******************************************************************************/
+void audio_gate_default_config(audio_gate_cfg_t *cfg)
+{
+    cfg->open_ratio = 4.0f;
+    cfg->flux_ratio = 2.0f;
+    cfg->flux_threshold = 0.5f;
+    cfg->zcr_max = 0.5f;
+    cfg->min_energy = 1e-7f;        /* -70 dBFS */
+    cfg->floor_rise = 0.005f;
+    cfg->floor_rise_open = 0.0005f;
+    cfg->floor_fall = 0.5f;
+    cfg->hold_blocks = 16u;
+    cfg->warmup_blocks = 16u;
+    cfg->preroll_blocks = 4u;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_init
+********************************************************************************
+* Summary:
+*  Initializes the gate. It is open for the first cfg->warmup_blocks blocks
+*  so the models run until they report their first result, also in a quiet
+*  room, and closed afterwards until activity.
+*
+* Parameters:
+*  gate            : gate context
+*  cfg             : configuration, NULL selects the defaults
+*  preroll_storage : cfg->preroll_blocks * block_samples floats, may be NULL
+*                    without pre-roll
+*  block_samples   : samples per block, at least AUDIO_GATE_FFT_SIZE
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool audio_gate_init(audio_gate_t *gate, const audio_gate_cfg_t *cfg,
+                     float *preroll_storage, uint32_t block_samples)
+{
+    memset(gate, 0, sizeof(*gate));
+    if (NULL != cfg)
+    {
+        gate->cfg = *cfg;
+    }
+    else
+    {
+        audio_gate_default_config(&gate->cfg);
+    }
+
+    if ((block_samples < AUDIO_GATE_FFT_SIZE) || (gate->cfg.preroll_blocks > AUDIO_GATE_MAX_PREROLL) ||
+        ((0u != gate->cfg.preroll_blocks) && (NULL == preroll_storage)))
+    {
+        return false;
+    }
+
+    gate->block_samples = block_samples;
+    gate->preroll = preroll_storage;
+    gate->warmup = gate->cfg.warmup_blocks;
+    gate->open = (gate->warmup > 0u);
+    audio_gate_init_tables();
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_process
+********************************************************************************
+* Summary:
+*  Scores one block and passes the blocks the model has to see to emit. When
+*  the gate opens the pre-roll is emitted before the block.
+*
+* Parameters:
+*  gate  : gate context
+*  block : block_samples normalized samples
+*  tag   : passed to emit with the block, also when replayed from the pre-roll
+*  emit  : receives the blocks to process
+*  ctx   : passed to emit
+*
+* Return:
+*  true if the gate is open after the block.
+*
+*******************************************************************************/
+bool audio_gate_process(audio_gate_t *gate, const float *block, uint32_t tag,
+                        audio_gate_emit_fn_t emit, void *ctx)
+{
+    const audio_gate_cfg_t *cfg = &gate->cfg;
+    audio_gate_features_t *f = &gate->features;
+    bool active;
+
+    f->energy = audio_gate_energy(block, gate->block_samples);
+    f->zcr = audio_gate_zcr(gate, block, gate->block_samples);
+    f->flux = audio_gate_flux(gate, block, gate->block_samples);
+
+    if (!gate->floor_valid)
+    {
+        gate->noise_floor = (f->energy > cfg->min_energy) ? f->energy : cfg->min_energy;
+        gate->floor_valid = true;
+    }
+
+    active = (f->energy >= cfg->min_energy) &&
+             ((f->energy > (gate->noise_floor * cfg->open_ratio)) ||
+              ((f->flux > cfg->flux_threshold) && (f->energy > (gate->noise_floor * cfg->flux_ratio))));
+    if (active && (f->zcr > cfg->zcr_max) &&
+        (f->energy < (gate->noise_floor * cfg->open_ratio * AUDIO_GATE_HISS_MARGIN)))
+    {
+        active = false;
+    }
+
+    /* Track the background: fast down, slow up, slower while open on activity */
+    if (f->energy < gate->noise_floor)
+    {
+        gate->noise_floor += cfg->floor_fall * (f->energy - gate->noise_floor);
+    }
+    else
+    {
+        gate->noise_floor += ((gate->open && (0u == gate->warmup)) ? cfg->floor_rise_open : cfg->floor_rise) *
+                             (f->energy - gate->noise_floor);
+    }
+    if (gate->noise_floor < AUDIO_GATE_MIN_FLOOR)
+    {
+        gate->noise_floor = AUDIO_GATE_MIN_FLOOR;
+    }
+    f->noise_floor = gate->noise_floor;
+
+    gate->stats.blocks++;
+
+    if (active)
+    {
+        gate->hold = cfg->hold_blocks;
+        if (!gate->open)
+        {
+            gate->open = true;
+            gate->stats.opens++;
+            audio_gate_replay_preroll(gate, emit, ctx);
+        }
+    }
+    else if (gate->open)
+    {
+        if (gate->hold > 0u)
+        {
+            gate->hold--;
+        }
+        else if (0u == gate->warmup)
+        {
+            gate->open = false;
+        }
+    }
+    if (gate->warmup > 0u)
+    {
+        gate->warmup--;
+    }
+
+    if (gate->open)
+    {
+        emit(block, tag, ctx);
+    }
+    else
+    {
+        gate->stats.gated_blocks++;
+        audio_gate_store_preroll(gate, block, tag);
+    }
+
+    return gate->open;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_is_open
+*******************************************************************************/
+bool audio_gate_is_open(const audio_gate_t *gate)
+{
+    return gate->open;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_get_features
+********************************************************************************
+* Summary:
+*  Returns the features of the last processed block.
+*
+*******************************************************************************/
+const audio_gate_features_t* audio_gate_get_features(const audio_gate_t *gate)
+{
+    return &gate->features;
+}
+
+/*******************************************************************************
+* Function Name: audio_gate_get_stats
+*******************************************************************************/
+void audio_gate_get_stats(const audio_gate_t *gate, audio_gate_stats_t *stats)
+{
+    *stats = gate->stats;
+}
+
+/* [] END OF FILE */
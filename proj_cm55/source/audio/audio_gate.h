@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name:   audio_gate.h
+*
+* Description: This file contains the types and function prototypes of the
+*              audio activity gate implemented in audio_gate.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_GATE_H_
+#define AUDIO_GATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Samples of each block used for the spectral flux, taken from its end */
+#define AUDIO_GATE_FFT_SIZE                 (256u)
+
+#define AUDIO_GATE_MAX_PREROLL              (16u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    float       open_ratio;     /* Energy above noise floor * open_ratio opens the gate */
+    float       flux_ratio;     /* Energy above noise floor * flux_ratio opens on a spectral onset */
+    float       flux_threshold; /* Normalized spectral flux of an onset, 0..1 */
+    float       zcr_max;        /* Zero crossing rate above which weak activity is taken as hiss, 1 disables */
+    float       min_energy;     /* Mean square energy below which the gate stays closed */
+    float       floor_rise;     /* Noise floor rise per block while closed */
+    float       floor_rise_open;/* Noise floor rise per block while open */
+    float       floor_fall;     /* Noise floor fall per block */
+    uint16_t    hold_blocks;    /* Blocks the gate stays open after the last active block */
+    uint16_t    warmup_blocks;  /* Blocks the gate stays open after init, so the models report their first result */
+    uint8_t     preroll_blocks; /* Blocks replayed when the gate opens, up to AUDIO_GATE_MAX_PREROLL */
+} audio_gate_cfg_t;
+
+typedef struct
+{
+    float       energy;         /* Mean square of the block */
+    float       zcr;            /* Zero crossings per sample */
+    float       flux;           /* Positive spectral change relative to the spectrum magnitude */
+    float       noise_floor;    /* Noise floor energy estimate */
+} audio_gate_features_t;
+
+typedef struct
+{
+    uint32_t    blocks;         /* Blocks presented to the gate */
+    uint32_t    gated_blocks;   /* Blocks withheld from the model */
+    uint32_t    opens;          /* Times the gate opened */
+    uint32_t    preroll_blocks; /* Blocks replayed from the pre-roll */
+} audio_gate_stats_t;
+
+/* Receives the blocks to run the model on, in capture order, with the tag
+ * passed to audio_gate_process() for the block, e.g. its capture time */
+typedef void (*audio_gate_emit_fn_t)(const float *block, uint32_t tag, void *ctx);
+
+typedef struct
+{
+    audio_gate_cfg_t        cfg;
+    uint32_t                block_samples;
+    float                   *preroll;           /* preroll_blocks * block_samples */
+    uint32_t                preroll_tags[AUDIO_GATE_MAX_PREROLL];
+    uint8_t                 preroll_pos;
+    uint8_t                 preroll_len;
+    bool                    open;
+    bool                    floor_valid;
+    uint16_t                hold;
+    uint16_t                warmup;
+    float                   noise_floor;
+    float                   last_sample;
+    float                   spectrum[AUDIO_GATE_FFT_SIZE / 2];
+    audio_gate_features_t   features;
+    audio_gate_stats_t      stats;
+} audio_gate_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void audio_gate_default_config(audio_gate_cfg_t *cfg);
+bool audio_gate_init(audio_gate_t *gate, const audio_gate_cfg_t *cfg,
+                     float *preroll_storage, uint32_t block_samples);
+bool audio_gate_process(audio_gate_t *gate, const float *block, uint32_t tag,
+                        audio_gate_emit_fn_t emit, void *ctx);
+bool audio_gate_is_open(const audio_gate_t *gate);
+const audio_gate_features_t* audio_gate_get_features(const audio_gate_t *gate);
+void audio_gate_get_stats(const audio_gate_t *gate, audio_gate_stats_t *stats);
+
+#endif /* AUDIO_GATE_H_ */
+
+/* [] END OF FILE */
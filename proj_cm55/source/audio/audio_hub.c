@@ -0,0 +1,289 @@
+/******************************************************************************
+* File Name:   audio_hub.c
+*
+* Description: This file implements the audio model hub. One stream of
+*              normalized samples is written to a shared ring and every
+*              model reads it with its own cursor. The models are scheduled
+*              round-robin one hop at a time, so a slow model does not hold
+*              back the results of the others, and the cycles spent in each
+*              model are accounted separately. A model trained with another
+*              microphone gain than the capture gets its samples scaled to
+*              that gain. The hub has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <string.h>
+#include "audio_hub.h"
+
+/*******************************************************************************
+* Function Name: audio_hub_cycles
+*******************************************************************************/
+static uint32_t audio_hub_cycles(const audio_hub_t *hub)
+{
+    return (NULL != hub->cfg.get_cycles) ? hub->cfg.get_cycles() : 0u;
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_sample_time
+********************************************************************************
+* Summary:
+*  Returns the capture time of the sample before pos. The models read the
+*  ring up to write_pos after every push, so pos is within the last push.
+*
+*******************************************************************************/
+static uint32_t audio_hub_sample_time(const audio_hub_t *hub, uint32_t pos)
+{
+    uint64_t behind = hub->write_pos - pos;
+
+    return hub->push_time - (uint32_t)((behind * hub->cfg.time_scale) / hub->cfg.sample_rate);
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_poll
+********************************************************************************
+* Summary:
+*  Dequeues the results of a model until it has no more data.
+*
+*******************************************************************************/
+static void audio_hub_poll(audio_hub_t *hub, uint32_t model)
+{
+    audio_hub_slot_t *slot = &hub->slots[model];
+    int flags[AUDIO_HUB_MAX_CLASSES];
+    int status;
+
+    while (AUDIO_MODEL_RET_NODATA != (status = slot->model->dequeue(flags)))
+    {
+        if (AUDIO_MODEL_RET_SUCCESS == status)
+        {
+            slot->stats.results++;
+        }
+        if (NULL != hub->cfg.result_cb)
+        {
+            hub->cfg.result_cb(model, status, flags, audio_hub_sample_time(hub, slot->read_pos), hub->cfg.cb_ctx);
+        }
+        if (AUDIO_MODEL_RET_SUCCESS != status)
+        {
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_feed
+********************************************************************************
+* Summary:
+*  Passes up to one hop of pending samples to a model.
+*
+* Return:
+*  false if the model had no pending samples.
+*
+*******************************************************************************/
+static bool audio_hub_feed(audio_hub_t *hub, uint32_t model)
+{
+    audio_hub_slot_t *slot = &hub->slots[model];
+    uint32_t pending = hub->write_pos - slot->read_pos;
+    uint32_t count = hub->cfg.hop_samples - slot->hop_count;
+    uint32_t start;
+
+    if (0u == pending)
+    {
+        return false;
+    }
+    if (count > pending)
+    {
+        count = pending;
+    }
+
+    start = audio_hub_cycles(hub);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float *sample = &hub->cfg.ring[(slot->read_pos + i) % hub->cfg.ring_samples];
+        float scaled;
+
+        if (1.0f != slot->gain)
+        {
+            /* Clamped like the capture saturates at the gain of the model */
+            scaled = *sample * slot->gain;
+            scaled = (scaled > 1.0f) ? 1.0f : ((scaled < -1.0f) ? -1.0f : scaled);
+            sample = &scaled;
+        }
+
+        if (AUDIO_MODEL_RET_NOMEM == slot->model->enqueue(sample))
+        {
+            /* The model queue is full, make room and try again. A model that
+             * still has no room loses the sample like an overwritten one. */
+            audio_hub_poll(hub, model);
+            if (AUDIO_MODEL_RET_SUCCESS != slot->model->enqueue(sample))
+            {
+                slot->stats.dropped++;
+            }
+        }
+    }
+    slot->read_pos += count;
+    slot->stats.samples += count;
+    slot->hop_count += count;
+
+    if (slot->hop_count >= hub->cfg.hop_samples)
+    {
+        slot->hop_count = 0;
+        audio_hub_poll(hub, model);
+    }
+    slot->stats.cycles += (uint32_t)(audio_hub_cycles(hub) - start);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_init
+********************************************************************************
+* Summary:
+*  Initializes the hub and the models.
+*
+* Parameters:
+*  hub         : hub context
+*  cfg         : configuration, copied
+*  models      : models fed by the hub, the index is the model number
+*  model_count : number of models, up to AUDIO_HUB_MAX_MODELS
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool audio_hub_init(audio_hub_t *hub, const audio_hub_cfg_t *cfg,
+                    const audio_model_t *const *models, uint32_t model_count)
+{
+    if ((0u == model_count) || (model_count > AUDIO_HUB_MAX_MODELS) ||
+        (NULL == cfg->ring) || (0u == cfg->ring_samples) || (0u == cfg->hop_samples) ||
+        (0u == cfg->sample_rate))
+    {
+        return false;
+    }
+
+    memset(hub, 0, sizeof(*hub));
+    hub->cfg = *cfg;
+    hub->model_count = model_count;
+
+    for (uint32_t m = 0; m < model_count; m++)
+    {
+        if (models[m]->class_count > AUDIO_HUB_MAX_CLASSES)
+        {
+            return false;
+        }
+        hub->slots[m].model = models[m];
+        hub->slots[m].gain = 1.0f;
+        if ((0u != cfg->capture_gain_db) && (0u != models[m]->capture_gain_db) &&
+            (cfg->capture_gain_db != models[m]->capture_gain_db))
+        {
+            hub->slots[m].gain = powf(10.0f, ((float)models[m]->capture_gain_db - (float)cfg->capture_gain_db) / 20.0f);
+        }
+        models[m]->init();
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_push
+********************************************************************************
+* Summary:
+*  Writes samples to the shared ring. Samples a model has not read yet are
+*  overwritten and counted as dropped for that model.
+*
+* Parameters:
+*  hub          : hub context
+*  samples      : normalized samples
+*  count        : number of samples
+*  capture_time : capture time of the last sample, in cfg.time_scale units
+*
+*******************************************************************************/
+void audio_hub_push(audio_hub_t *hub, const float *samples, uint32_t count, uint32_t capture_time)
+{
+    uint32_t size = hub->cfg.ring_samples;
+
+    while (count > 0u)
+    {
+        uint32_t pos = hub->write_pos % size;
+        uint32_t chunk = ((size - pos) < count) ? (size - pos) : count;
+
+        memcpy(&hub->cfg.ring[pos], samples, chunk * sizeof(float));
+        hub->write_pos += chunk;
+        samples += chunk;
+        count -= chunk;
+    }
+    hub->push_time = capture_time;
+
+    for (uint32_t m = 0; m < hub->model_count; m++)
+    {
+        audio_hub_slot_t *slot = &hub->slots[m];
+        uint32_t pending = hub->write_pos - slot->read_pos;
+
+        if (pending > size)
+        {
+            slot->stats.dropped += pending - size;
+            slot->read_pos = hub->write_pos - size;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_run
+********************************************************************************
+* Summary:
+*  Feeds the pending samples to all models, one hop per model in turn,
+*  until every model has caught up with the ring.
+*
+*******************************************************************************/
+void audio_hub_run(audio_hub_t *hub)
+{
+    bool progressed;
+
+    do
+    {
+        progressed = false;
+        for (uint32_t m = 0; m < hub->model_count; m++)
+        {
+            progressed = audio_hub_feed(hub, m) || progressed;
+        }
+    } while (progressed);
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_class_id
+********************************************************************************
+* Summary:
+*  Maps a class of a model to a class ID unique across all models of the
+*  hub. The background class of every model maps to 0, the other classes
+*  are numbered consecutively in model order.
+*
+*******************************************************************************/
+uint32_t audio_hub_class_id(const audio_hub_t *hub, uint32_t model, int class_id)
+{
+    uint32_t base = 0;
+
+    if (class_id <= 0)
+    {
+        return 0u;
+    }
+    for (uint32_t m = 0; m < model; m++)
+    {
+        base += hub->slots[m].model->class_count - 1u;
+    }
+
+    return base + (uint32_t)class_id;
+}
+
+/*******************************************************************************
+* Function Name: audio_hub_get_stats
+*******************************************************************************/
+void audio_hub_get_stats(const audio_hub_t *hub, uint32_t model, audio_hub_model_stats_t *stats)
+{
+    *stats = hub->slots[model].stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name:   audio_hub.h
+*
+* Description: This file contains the types and function prototypes of the
+*              audio model hub implemented in audio_hub.c, and the model
+*              descriptors of the Ready Model wrappers (audio_model_*.c).
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_HUB_H_
+#define AUDIO_HUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_HUB_MAX_MODELS                (4u)
+#define AUDIO_HUB_MAX_CLASSES               (8u)
+
+/* Return codes of the model functions, identical to the IMAI_RET_* values */
+#define AUDIO_MODEL_RET_SUCCESS             (0)
+#define AUDIO_MODEL_RET_NODATA              (-1)
+#define AUDIO_MODEL_RET_NOMEM               (-2)
+#define AUDIO_MODEL_RET_TIMEDOUT            (-3)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Post-processing inside the model library, same fields as PP_config_t */
+typedef struct
+{
+    float       confidence;     /* Threshold the model outputs are compared against */
+    uint8_t     average;        /* Outputs averaged before the comparison */
+    uint8_t     subsequent;     /* Consecutive outputs above the threshold for a detection */
+    uint8_t     pool;           /* Outputs in the pool */
+    uint8_t     pool_selection; /* Outputs of the pool above the threshold for a detection */
+} audio_model_sensitivity_t;
+
+/* Entry points of one audio event detection model */
+typedef struct
+{
+    const char          *name;
+    uint8_t             class_count;    /* Including the background class 0 */
+    const char *const   *labels;
+    void                (*init)(void);
+    int                 (*enqueue)(const float *sample);
+    int                 (*dequeue)(int *flags);
+    int                 (*sensitivity)(const audio_model_sensitivity_t *sensitivity);  /* NULL restores the defaults */
+    uint8_t             capture_gain_db;    /* Microphone gain the model was trained with, 0 if unknown */
+} audio_model_t;
+
+/* Invoked for every dequeue result other than AUDIO_MODEL_RET_NODATA.
+ * capture_time is the capture time of the last sample the model was given,
+ * derived from the time passed to audio_hub_push(). */
+typedef void (*audio_hub_result_cb_t)(uint32_t model, int status, const int *flags,
+                                      uint32_t capture_time, void *ctx);
+
+/* Returns a free running cycle counter, used for the per-model CPU share */
+typedef uint32_t (*audio_hub_cycles_fn_t)(void);
+
+typedef struct
+{
+    float                   *ring;          /* Shared sample ring, ring_samples floats */
+    uint32_t                ring_samples;
+    uint32_t                hop_samples;    /* Samples between two result polls of a model */
+    uint32_t                sample_rate;    /* Used to time the samples within a push */
+    uint32_t                time_scale;     /* Time units per second, e.g. 1000000 for microseconds */
+    audio_hub_result_cb_t   result_cb;
+    void                    *cb_ctx;
+    audio_hub_cycles_fn_t   get_cycles;     /* May be NULL */
+    uint8_t                 capture_gain_db;    /* Microphone gain of the pushed samples, 0 if unknown */
+} audio_hub_cfg_t;
+
+typedef struct
+{
+    uint32_t    samples;        /* Samples passed to the model */
+    uint32_t    results;        /* Successful dequeues */
+    uint32_t    dropped;        /* Samples overwritten in the ring before the model got them
+                                 * or refused by a full model queue */
+    uint64_t    cycles;         /* Cycles spent in the model */
+} audio_hub_model_stats_t;
+
+typedef struct
+{
+    const audio_model_t     *model;
+    uint32_t                read_pos;
+    uint32_t                hop_count;
+    float                   gain;           /* Brings the capture to the gain of the model */
+    audio_hub_model_stats_t stats;
+} audio_hub_slot_t;
+
+typedef struct
+{
+    audio_hub_cfg_t         cfg;
+    audio_hub_slot_t        slots[AUDIO_HUB_MAX_MODELS];
+    uint32_t                model_count;
+    uint32_t                write_pos;
+    uint32_t                push_time;      /* Capture time of the sample before write_pos */
+} audio_hub_t;
+
+/*******************************************************************************
+* Model descriptors, only the ones of the models in the build are defined
+*******************************************************************************/
+extern const audio_model_t audio_model_cough;
+extern const audio_model_t audio_model_babycry;
+extern const audio_model_t audio_model_alarm;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool audio_hub_init(audio_hub_t *hub, const audio_hub_cfg_t *cfg,
+                    const audio_model_t *const *models, uint32_t model_count);
+void audio_hub_push(audio_hub_t *hub, const float *samples, uint32_t count, uint32_t capture_time);
+void audio_hub_run(audio_hub_t *hub);
+uint32_t audio_hub_class_id(const audio_hub_t *hub, uint32_t model, int class_id);
+void audio_hub_get_stats(const audio_hub_t *hub, uint32_t model, audio_hub_model_stats_t *stats);
+
+#endif /* AUDIO_HUB_H_ */
+
+/* [] END OF FILE */
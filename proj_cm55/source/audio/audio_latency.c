@@ -0,0 +1,123 @@
+/******************************************************************************
+* File Name:   audio_latency.c
+*
+* Description: This file implements a fixed-bucket latency histogram used to
+*              report the capture-to-result latency percentiles of the audio
+*              pipeline. Adding a sample is constant time so it can be done
+*              for every model result. The histogram has no hardware
+*              dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "audio_latency.h"
+
+/*******************************************************************************
+* Function Name: audio_latency_init
+********************************************************************************
+* Summary:
+*  Initializes an empty histogram.
+*
+* Parameters:
+*  lat       : histogram
+*  bucket_us : bucket width in microseconds, 0 is taken as 1
+*
+*******************************************************************************/
+void audio_latency_init(audio_latency_t *lat, uint32_t bucket_us)
+{
+    memset(lat, 0, sizeof(*lat));
+    lat->bucket_us = (0u == bucket_us) ? 1u : bucket_us;
+}
+
+/*******************************************************************************
+* Function Name: audio_latency_reset
+*******************************************************************************/
+void audio_latency_reset(audio_latency_t *lat)
+{
+    audio_latency_init(lat, lat->bucket_us);
+}
+
+/*******************************************************************************
+* Function Name: audio_latency_add
+*******************************************************************************/
+void audio_latency_add(audio_latency_t *lat, uint32_t latency_us)
+{
+    uint32_t bucket = latency_us / lat->bucket_us;
+
+    if (bucket < AUDIO_LATENCY_BUCKETS)
+    {
+        lat->counts[bucket]++;
+    }
+    else
+    {
+        lat->overflow++;
+    }
+    if (latency_us > lat->max_us)
+    {
+        lat->max_us = latency_us;
+    }
+    lat->sum_us += latency_us;
+    lat->count++;
+}
+
+/*******************************************************************************
+* Function Name: audio_latency_percentile
+********************************************************************************
+* Summary:
+*  Returns the latency below which the given share of the samples fall.
+*
+* Parameters:
+*  lat     : histogram
+*  permille: share in 1/1000, e.g. 990 for the 99th percentile
+*
+* Return:
+*  Upper edge of the bucket holding the percentile, capped to the maximum
+*  seen. 0 if the histogram is empty.
+*
+*******************************************************************************/
+uint32_t audio_latency_percentile(const audio_latency_t *lat, uint32_t permille)
+{
+    uint64_t target = ((uint64_t)lat->count * permille + 999u) / 1000u;
+    uint64_t seen = 0;
+
+    if (0u == lat->count)
+    {
+        return 0u;
+    }
+    if (0u == target)
+    {
+        target = 1u;
+    }
+
+    for (uint32_t i = 0; i < AUDIO_LATENCY_BUCKETS; i++)
+    {
+        seen += lat->counts[i];
+        if (seen >= target)
+        {
+            uint32_t edge = (i + 1u) * lat->bucket_us;
+            return (edge < lat->max_us) ? edge : lat->max_us;
+        }
+    }
+
+    return lat->max_us;
+}
+
+/*******************************************************************************
+* Function Name: audio_latency_summarize
+*******************************************************************************/
+void audio_latency_summarize(const audio_latency_t *lat, audio_latency_summary_t *summary)
+{
+    summary->count = lat->count;
+    summary->avg_us = (0u == lat->count) ? 0u : (uint32_t)(lat->sum_us / lat->count);
+    summary->p50_us = audio_latency_percentile(lat, 500u);
+    summary->p90_us = audio_latency_percentile(lat, 900u);
+    summary->p99_us = audio_latency_percentile(lat, 990u);
+    summary->max_us = lat->max_us;
+}
+
+/* [] END OF FILE */
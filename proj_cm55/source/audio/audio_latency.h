@@ -0,0 +1,59 @@
+/******************************************************************************
+* File Name:   audio_latency.h
+*
+* Description: This file contains the types and function prototypes of the
+*              latency histogram implemented in audio_latency.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_LATENCY_H_
+#define AUDIO_LATENCY_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_LATENCY_BUCKETS               (256u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t    bucket_us;      /* Width of a bucket, the range is AUDIO_LATENCY_BUCKETS * bucket_us */
+    uint32_t    counts[AUDIO_LATENCY_BUCKETS];
+    uint32_t    overflow;       /* Samples above the range */
+    uint32_t    count;
+    uint32_t    max_us;
+    uint64_t    sum_us;
+} audio_latency_t;
+
+/* Percentiles in microseconds, the upper edge of the bucket they fall in */
+typedef struct
+{
+    uint32_t    count;
+    uint32_t    avg_us;
+    uint32_t    p50_us;
+    uint32_t    p90_us;
+    uint32_t    p99_us;
+    uint32_t    max_us;
+} audio_latency_summary_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void audio_latency_init(audio_latency_t *lat, uint32_t bucket_us);
+void audio_latency_reset(audio_latency_t *lat);
+void audio_latency_add(audio_latency_t *lat, uint32_t latency_us);
+uint32_t audio_latency_percentile(const audio_latency_t *lat, uint32_t permille);
+void audio_latency_summarize(const audio_latency_t *lat, audio_latency_summary_t *summary);
+
+#endif /* AUDIO_LATENCY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/******************************************************************************
+* File Name:   audio_model_alarm.c
+*
+* Description: This file wraps the Alarm/Siren Ready Model library in an
+*              audio_model_t. With AUDIO_HUB_MODEL the library is linked as
+*              a copy with all global symbols prefixed by "alarm_siren_", see
+*              proj_cm55/Makefile, and the prefixed entry points are used.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#if defined(ALARM_MODEL) || defined(AUDIO_HUB_MODEL)
+
+#ifdef AUDIO_HUB_MODEL
+#define IMAI_AED_init                       alarm_siren_IMAI_AED_init
+#define IMAI_AED_enqueue                    alarm_siren_IMAI_AED_enqueue
+#define IMAI_AED_dequeue                    alarm_siren_IMAI_AED_dequeue
+#define IMAI_AED_sensitivity                alarm_siren_IMAI_AED_sensitivity
+#define IMAI_AED_sensitivity_reset          alarm_siren_IMAI_AED_sensitivity_reset
+#endif
+
+#include <stddef.h>
+#include "alarm_siren_lib.h"
+#include "audio_hub.h"
+
+_Static_assert((IMAI_RET_SUCCESS == AUDIO_MODEL_RET_SUCCESS) && (IMAI_RET_NODATA == AUDIO_MODEL_RET_NODATA) &&
+               (IMAI_RET_NOMEM == AUDIO_MODEL_RET_NOMEM) && (IMAI_RET_TIMEDOUT == AUDIO_MODEL_RET_TIMEDOUT),
+               "IMAI return codes changed");
+_Static_assert(IMAI_DATA_OUT_COUNT <= AUDIO_HUB_MAX_CLASSES, "Too many classes");
+
+static const char *const alarm_labels[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
+
+/*******************************************************************************
+* Function Name: alarm_sensitivity
+********************************************************************************
+* Summary:
+*  Sets the post-processing of the library, NULL restores its defaults.
+*
+*******************************************************************************/
+static int alarm_sensitivity(const audio_model_sensitivity_t *sensitivity)
+{
+    if (NULL == sensitivity)
+    {
+        IMAI_AED_sensitivity_reset();
+        return IMAI_RET_SUCCESS;
+    }
+
+    PP_config_t config =
+    {
+        .confidence = sensitivity->confidence,
+        .average = sensitivity->average,
+        .subsequent = sensitivity->subsequent,
+        .pool = sensitivity->pool,
+        .pool_selection = sensitivity->pool_selection
+    };
+
+    return IMAI_AED_sensitivity(config);
+}
+
+const audio_model_t audio_model_alarm =
+{
+    .name = "alarm",
+    .class_count = IMAI_DATA_OUT_COUNT,
+    .labels = alarm_labels,
+    .init = IMAI_AED_init,
+    .enqueue = IMAI_AED_enqueue,
+    .dequeue = IMAI_AED_dequeue,
+    .sensitivity = alarm_sensitivity,
+    .capture_gain_db = 23u
+};
+
+#endif /* ALARM_MODEL || AUDIO_HUB_MODEL */
+
+/* [] END OF FILE */
@@ -0,0 +1,223 @@
+/******************************************************************************
+* File Name:   audio_pool.c
+*
+* Description: This file implements a pool of audio capture blocks shared
+*              between the capture ISR and the processing task. Ownership of
+*              each block is explicit, every block is stamped with a capture
+*              time and a sequence number, and blocks that cannot be handed
+*              over because the consumer fell behind are counted as overruns
+*              instead of being overwritten silently. The pool has no
+*              hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "audio_pool.h"
+
+/*******************************************************************************
+* Function Name: audio_pool_init
+********************************************************************************
+* Summary:
+*  Initializes the pool on caller provided storage.
+*
+* Parameters:
+*  pool           : pool context
+*  storage        : block_count * block_samples samples
+*  block_count    : number of blocks, 2..AUDIO_POOL_MAX_BLOCKS
+*  block_samples  : samples per block
+*  late_threshold : capture to consumer latency above which a block is late,
+*                   in the time unit of the timestamps. 0 disables the check.
+*
+* Return:
+*  false if the block count is out of range.
+*
+*******************************************************************************/
+bool audio_pool_init(audio_pool_t *pool, int16_t *storage, uint32_t block_count,
+                     uint32_t block_samples, uint32_t late_threshold)
+{
+    if ((block_count < 2u) || (block_count > AUDIO_POOL_MAX_BLOCKS))
+    {
+        return false;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+    for (uint32_t i = 0; i < block_count; i++)
+    {
+        pool->blocks[i].data = &storage[i * block_samples];
+    }
+    pool->block_count = block_count;
+    pool->block_samples = block_samples;
+    pool->late_threshold = late_threshold;
+    atomic_init(&pool->head, 0u);
+    atomic_init(&pool->tail, 0u);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_producer_block
+********************************************************************************
+* Summary:
+*  Returns the block the producer currently fills. The producer always owns
+*  exactly one block, so this never fails.
+*
+*******************************************************************************/
+int16_t* audio_pool_producer_block(audio_pool_t *pool)
+{
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+
+    return pool->blocks[head % pool->block_count].data;
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_producer_commit
+********************************************************************************
+* Summary:
+*  Hands the filled block to the consumer and moves the producer to the next
+*  free block. If no block is free the captured data is dropped, the overrun
+*  is counted and the producer refills the same block. The sequence number
+*  advances in both cases so the consumer sees the gap.
+*
+* Parameters:
+*  pool      : pool context
+*  timestamp : capture completion time
+*
+* Return:
+*  true if the block was handed to the consumer.
+*
+*******************************************************************************/
+bool audio_pool_producer_commit(audio_pool_t *pool, uint32_t timestamp)
+{
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&pool->tail, memory_order_acquire);
+    audio_pool_block_t *block = &pool->blocks[head % pool->block_count];
+    uint32_t seq = pool->next_seq++;
+
+    /* The next block must be free to keep one block for the producer */
+    if ((head + 1u - tail) >= pool->block_count)
+    {
+        pool->stats.overruns++;
+        return false;
+    }
+
+    block->seq = seq;
+    block->timestamp = timestamp;
+    pool->stats.committed++;
+    atomic_store_explicit(&pool->head, head + 1u, memory_order_release);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_consumer_get
+********************************************************************************
+* Summary:
+*  Returns the oldest block handed over by the producer. The block stays
+*  owned by the consumer until audio_pool_consumer_release() is called;
+*  calling this again before that returns the same block. A jump in the
+*  sequence numbers is counted as gaps, which catch up with the overruns
+*  once the consumer took the next block after them.
+*
+* Parameters:
+*  pool : pool context
+*  now  : current time, used for the latency statistics
+*
+* Return:
+*  The block, NULL if no block is waiting.
+*
+*******************************************************************************/
+const audio_pool_block_t* audio_pool_consumer_get(audio_pool_t *pool, uint32_t now)
+{
+    uint32_t tail = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    const audio_pool_block_t *block;
+    uint32_t latency;
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+
+    block = &pool->blocks[tail % pool->block_count];
+    if (pool->consumer_busy)
+    {
+        return block;
+    }
+
+    pool->consumer_busy = true;
+    pool->stats.consumed++;
+    pool->stats.gaps += block->seq - pool->consumer_seq;
+    pool->consumer_seq = block->seq + 1u;
+    if ((head - tail) > pool->stats.depth_max)
+    {
+        pool->stats.depth_max = head - tail;
+    }
+
+    latency = now - block->timestamp;
+    pool->stats.latency_sum += latency;
+    if (latency > pool->stats.latency_max)
+    {
+        pool->stats.latency_max = latency;
+    }
+    if ((0u != pool->late_threshold) && (latency > pool->late_threshold))
+    {
+        pool->stats.late++;
+    }
+
+    return block;
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_consumer_release
+********************************************************************************
+* Summary:
+*  Returns the block obtained by audio_pool_consumer_get() to the producer.
+*
+*******************************************************************************/
+void audio_pool_consumer_release(audio_pool_t *pool)
+{
+    uint32_t tail = atomic_load_explicit(&pool->tail, memory_order_relaxed);
+
+    if (!pool->consumer_busy)
+    {
+        return;
+    }
+
+    pool->consumer_busy = false;
+    atomic_store_explicit(&pool->tail, tail + 1u, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_depth
+********************************************************************************
+* Summary:
+*  Returns the number of blocks waiting for, or held by, the consumer.
+*
+*******************************************************************************/
+uint32_t audio_pool_depth(const audio_pool_t *pool)
+{
+    uint32_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&pool->tail, memory_order_acquire);
+
+    return head - tail;
+}
+
+/*******************************************************************************
+* Function Name: audio_pool_get_stats
+********************************************************************************
+* Summary:
+*  Returns a copy of the statistics. Counters updated by the producer may be
+*  one block ahead of the ones updated by the consumer.
+*
+*******************************************************************************/
+void audio_pool_get_stats(const audio_pool_t *pool, audio_pool_stats_t *stats)
+{
+    *stats = pool->stats;
+}
+
+/* [] END OF FILE */
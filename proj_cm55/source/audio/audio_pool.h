@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name:   audio_pool.h
+*
+* Description: This file contains the types and function prototypes of the
+*              audio capture block pool implemented in audio_pool.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_POOL_H_
+#define AUDIO_POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_POOL_MAX_BLOCKS               (16u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    int16_t     *data;          /* block_samples PCM samples */
+    uint32_t    seq;            /* Capture sequence number, gaps indicate overruns */
+    uint32_t    timestamp;      /* Capture completion time, in the caller's time unit */
+} audio_pool_block_t;
+
+typedef struct
+{
+    uint32_t    committed;      /* Blocks handed to the consumer */
+    uint32_t    consumed;       /* Blocks taken by the consumer */
+    uint32_t    overruns;       /* Captured blocks dropped because no free block was left */
+    uint32_t    gaps;           /* Blocks missing from the sequence the consumer took */
+    uint32_t    late;           /* Blocks taken later than late_threshold after capture */
+    uint32_t    depth_max;      /* Maximum number of blocks waiting for the consumer */
+    uint32_t    latency_max;    /* Maximum capture to consumer latency */
+    uint64_t    latency_sum;    /* Sum of capture to consumer latencies */
+} audio_pool_stats_t;
+
+/* Single producer (capture ISR), single consumer (processing task) pool.
+ * Blocks tail..head-1 are owned by the consumer, block head is being filled
+ * by the producer, all others are free. */
+typedef struct
+{
+    audio_pool_block_t  blocks[AUDIO_POOL_MAX_BLOCKS];
+    uint32_t            block_count;
+    uint32_t            block_samples;
+    uint32_t            late_threshold;
+    uint32_t            next_seq;
+    uint32_t            consumer_seq;   /* Sequence number the consumer expects next */
+    _Atomic uint32_t    head;
+    _Atomic uint32_t    tail;
+    bool                consumer_busy;
+    audio_pool_stats_t  stats;
+} audio_pool_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool audio_pool_init(audio_pool_t *pool, int16_t *storage, uint32_t block_count,
+                     uint32_t block_samples, uint32_t late_threshold);
+
+/* Producer side */
+int16_t* audio_pool_producer_block(audio_pool_t *pool);
+bool audio_pool_producer_commit(audio_pool_t *pool, uint32_t timestamp);
+
+/* Consumer side */
+const audio_pool_block_t* audio_pool_consumer_get(audio_pool_t *pool, uint32_t now);
+void audio_pool_consumer_release(audio_pool_t *pool);
+
+uint32_t audio_pool_depth(const audio_pool_t *pool);
+void audio_pool_get_stats(const audio_pool_t *pool, audio_pool_stats_t *stats);
+
+#endif /* AUDIO_POOL_H_ */
+
+/* [] END OF FILE */
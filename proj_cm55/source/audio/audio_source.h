@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   audio_source.h
+*
+* Description: This file contains the interface of the audio capture source.
+*              A source fills the blocks of an audio_pool_t and signals each
+*              captured block. audio_source_pdm.c implements it with the PDM
+*              microphone, COMPONENT_HOST/audio_source_wav.c streams a WAV
+*              file on a host.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_SOURCE_H_
+#define AUDIO_SOURCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_pool.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define AUDIO_SOURCE_MAX_CHANNELS           (4u)
+
+/* Microphone gain of the capture. The alarm model was trained with 23 dB and
+ * the others with 5 dB. AUDIO_HUB_MODEL captures with 5 dB and the hub scales
+ * the samples of the alarm model up to its gain, see audio_model_t. */
+#if defined(ALARM_MODEL)
+#define AUDIO_SOURCE_GAIN_DB                (23u)
+#else
+#define AUDIO_SOURCE_GAIN_DB                (5u)
+#endif
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Invoked after a block was queued in the pool. On the target this is
+ * called from the capture interrupt. */
+typedef void (*audio_source_block_ready_cb_t)(void *cb_ctx);
+
+/* Returns the time used to stamp captured blocks */
+typedef uint32_t (*audio_source_time_fn_t)(void);
+
+typedef struct
+{
+    audio_pool_t                    *pool;          /* Initialized pool receiving the captured blocks */
+    audio_source_block_ready_cb_t   block_ready;    /* May be NULL */
+    void                            *cb_ctx;
+    audio_source_time_fn_t          get_time;       /* May be NULL, blocks are then stamped with 0 */
+    uint8_t                         channels;       /* Interleaved channels per frame, 0 for mono. The
+                                                     * pool block size must be a multiple of it. */
+} audio_source_config_t;
+
+typedef struct
+{
+    uint32_t    interrupts;     /* Capture interrupts on the target, reads on the host */
+    uint32_t    blocks;         /* Blocks captured, including the ones dropped by the pool */
+    uint32_t    hw_overflows;   /* Hardware FIFO overflow events */
+} audio_source_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool audio_source_start(const audio_source_config_t *config);
+void audio_source_stop(void);
+const audio_pool_block_t* audio_source_get_block(uint32_t now);
+void audio_source_release_block(void);
+void audio_source_get_stats(audio_source_stats_t *stats);
+
+#endif /* AUDIO_SOURCE_H_ */
+
+/* [] END OF FILE */
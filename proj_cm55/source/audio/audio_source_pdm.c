@@ -0,0 +1,274 @@
+/******************************************************************************
+* File Name:   audio_source_pdm.c
+*
+* Description: This file implements the audio source with the PDM/PCM block.
+*              The PDM ISR moves FIFO data straight into the capture block
+*              being filled and hands full blocks to the pool. The FIFO
+*              trigger level is raised from the half-FIFO default to reduce
+*              the number of interrupts per block. Several consecutive PDM
+*              channels can be captured, their samples are interleaved
+*              frame by frame.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "audio_source.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Captured PDM channels AUDIO_PDM_FIRST_CHANNEL onwards, interleaved in
+ * channel order. Every channel is configured like channel 3 of the BSP,
+ * which must route each of them to a microphone. The last channel raises
+ * the interrupt, AUDIO_PDM_IRQ must be its interrupt. */
+#ifndef AUDIO_PDM_FIRST_CHANNEL
+#define AUDIO_PDM_FIRST_CHANNEL                 (3u)
+#endif
+
+#ifndef AUDIO_PDM_CHANNELS
+#define AUDIO_PDM_CHANNELS                      (1u)
+#endif
+
+#ifndef AUDIO_PDM_IRQ
+#define AUDIO_PDM_IRQ                           CYBSP_PDM_CHANNEL_3_IRQ
+#endif
+
+#if (AUDIO_PDM_CHANNELS == 0u) || (AUDIO_PDM_CHANNELS > AUDIO_SOURCE_MAX_CHANNELS)
+#error "AUDIO_PDM_CHANNELS must be between 1 and AUDIO_SOURCE_MAX_CHANNELS"
+#endif
+
+#define PDM_CHANNEL                             (AUDIO_PDM_FIRST_CHANNEL + AUDIO_PDM_CHANNELS - 1u)
+
+/* PDM PCM hardware FIFO size */
+#define HW_FIFO_SIZE                            (64u)
+
+/* Samples read per RX trigger interrupt. The remaining FIFO space is the
+ * ISR latency margin: 16 samples (1 ms at 16 kHz) with the default. The
+ * block size does not need to be a multiple of this value. */
+#ifndef AUDIO_PDM_FIFO_TRIG_LEVEL
+#define AUDIO_PDM_FIFO_TRIG_LEVEL               (48u)
+#endif
+
+#if (AUDIO_PDM_FIFO_TRIG_LEVEL == 0u) || (AUDIO_PDM_FIFO_TRIG_LEVEL >= HW_FIFO_SIZE)
+#error "AUDIO_PDM_FIFO_TRIG_LEVEL must be between 1 and HW_FIFO_SIZE - 1"
+#endif
+
+#if (AUDIO_SOURCE_GAIN_DB == 23u)
+#define AUDIO_PDM_GAIN                          CY_PDM_PCM_SEL_GAIN_23DB
+#elif (AUDIO_SOURCE_GAIN_DB == 5u)
+#define AUDIO_PDM_GAIN                          CY_PDM_PCM_SEL_GAIN_5DB
+#else
+#error "AUDIO_SOURCE_GAIN_DB has no PDM gain setting"
+#endif
+
+#define PDM_OVERFLOW_INTR_MASK                  (CY_PDM_PCM_INTR_RX_FIR_OVERFLOW | CY_PDM_PCM_INTR_RX_OVERFLOW | \
+                                                 CY_PDM_PCM_INTR_RX_IF_OVERFLOW | CY_PDM_PCM_INTR_RX_UNDERFLOW)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void pdm_pcm_event_handler(void);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* PDM PCM interrupt configuration parameters */
+static const cy_stc_sysint_t PDM_IRQ_cfg =
+{
+    .intrSrc = (IRQn_Type)AUDIO_PDM_IRQ,
+    .intrPriority = 2
+};
+
+static audio_source_config_t source_cfg;
+static volatile audio_source_stats_t source_stats;
+
+/* Samples already written to the block being filled */
+static uint32_t block_fill = 0;
+
+/*******************************************************************************
+* Function Name: audio_source_start
+********************************************************************************
+* Summary:
+*  Initializes the PDM/PCM block and starts capturing into the pool.
+*
+* Parameters:
+*  config : source configuration, copied. The number of channels must be
+*           AUDIO_PDM_CHANNELS.
+*
+* Return:
+*  true on success.
+*
+*******************************************************************************/
+bool audio_source_start(const audio_source_config_t *config)
+{
+    cy_stc_pdm_pcm_channel_config_t channel_config = channel_3_config;
+
+    uint32_t channels = (0u == config->channels) ? 1u : config->channels;
+
+    if ((AUDIO_PDM_CHANNELS != channels) || (0u != (config->pool->block_samples % channels)))
+    {
+        return false;
+    }
+
+    source_cfg = *config;
+    block_fill = 0;
+
+    /* Initialize PDM PCM block */
+    if(CY_PDM_PCM_SUCCESS != Cy_PDM_PCM_Init(CYBSP_PDM_HW, &CYBSP_PDM_config))
+    {
+        return false;
+    }
+
+    /* The trigger fires when the FIFO holds more entries than the level */
+    channel_config.rxFifoTriggerLevel = AUDIO_PDM_FIFO_TRIG_LEVEL - 1u;
+
+    for (uint32_t channel = AUDIO_PDM_FIRST_CHANNEL; channel <= PDM_CHANNEL; channel++)
+    {
+        Cy_PDM_PCM_Channel_Enable(CYBSP_PDM_HW, channel);
+        /* Initialize and enable the PDM PCM channel, 3 is the right microphone */
+        Cy_PDM_PCM_Channel_Init(CYBSP_PDM_HW, &channel_config, channel);
+
+        /* Set the gain the models were trained with, see AUDIO_SOURCE_GAIN_DB */
+        Cy_PDM_PCM_SetGain(CYBSP_PDM_HW, channel, AUDIO_PDM_GAIN);
+    }
+
+    /* An interrupt is registered for right channel, clear and set masks for it. */
+    Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
+    Cy_PDM_PCM_Channel_SetInterruptMask(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
+
+    /* Register the IRQ handler */
+    if(CY_SYSINT_SUCCESS != Cy_SysInt_Init(&PDM_IRQ_cfg, &pdm_pcm_event_handler))
+    {
+        return false;
+    }
+    NVIC_ClearPendingIRQ(PDM_IRQ_cfg.intrSrc);
+    NVIC_EnableIRQ(PDM_IRQ_cfg.intrSrc);
+
+    /* The interrupt channel starts last, the others have at least as many
+     * samples in their FIFO when it triggers */
+    for (uint32_t channel = AUDIO_PDM_FIRST_CHANNEL; channel <= PDM_CHANNEL; channel++)
+    {
+        Cy_PDM_PCM_Activate_Channel(CYBSP_PDM_HW, channel);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: audio_source_stop
+*******************************************************************************/
+void audio_source_stop(void)
+{
+    for (uint32_t channel = AUDIO_PDM_FIRST_CHANNEL; channel <= PDM_CHANNEL; channel++)
+    {
+        Cy_PDM_PCM_DeActivate_Channel(CYBSP_PDM_HW, channel);
+    }
+    NVIC_DisableIRQ(PDM_IRQ_cfg.intrSrc);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_get_block
+********************************************************************************
+* Summary:
+*  Returns the oldest captured block, NULL if none is waiting. The block must
+*  be returned with audio_source_release_block().
+*
+*******************************************************************************/
+const audio_pool_block_t* audio_source_get_block(uint32_t now)
+{
+    return audio_pool_consumer_get(source_cfg.pool, now);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_release_block
+*******************************************************************************/
+void audio_source_release_block(void)
+{
+    audio_pool_consumer_release(source_cfg.pool);
+}
+
+/*******************************************************************************
+* Function Name: audio_source_get_stats
+*******************************************************************************/
+void audio_source_get_stats(audio_source_stats_t *stats)
+{
+    stats->interrupts = source_stats.interrupts;
+    stats->blocks = source_stats.blocks;
+    stats->hw_overflows = source_stats.hw_overflows;
+}
+
+/*******************************************************************************
+* Function Name: pdm_pcm_event_handler
+********************************************************************************
+* Summary:
+*  PDM/PCM ISR handler. Moves the FIFO content into the block being filled
+*  and commits the block to the pool once it is full. With several channels
+*  one sample of each channel is taken per frame.
+*
+*******************************************************************************/
+static void pdm_pcm_event_handler(void)
+{
+    audio_pool_t *pool = source_cfg.pool;
+
+    /* Check the interrupt status */
+    uint32_t intr_status = Cy_PDM_PCM_Channel_GetInterruptStatusMasked(CYBSP_PDM_HW, PDM_CHANNEL);
+    if(CY_PDM_PCM_INTR_RX_TRIGGER & intr_status)
+    {
+        /* Move data from the PDM fifo and place it in the block being filled */
+        int16_t* rx_block = audio_pool_producer_block(pool);
+        for(uint32_t index=0; index < AUDIO_PDM_FIFO_TRIG_LEVEL; index++)
+        {
+#if (AUDIO_PDM_CHANNELS > 1u)
+            for (uint32_t channel = AUDIO_PDM_FIRST_CHANNEL; channel < PDM_CHANNEL; channel++)
+            {
+                rx_block[block_fill++] = (int16_t)Cy_PDM_PCM_Channel_ReadFifo(CYBSP_PDM_HW, channel);
+            }
+#endif
+            rx_block[block_fill++] = (int16_t)Cy_PDM_PCM_Channel_ReadFifo(CYBSP_PDM_HW, PDM_CHANNEL);
+
+            /* Check if the block is full */
+            if (block_fill >= pool->block_samples)
+            {
+                uint32_t timestamp = (NULL != source_cfg.get_time) ? source_cfg.get_time() : 0u;
+
+                source_stats.blocks++;
+                /* Blocks dropped by the pool are counted there as overruns */
+                if (audio_pool_producer_commit(pool, timestamp) && (NULL != source_cfg.block_ready))
+                {
+                    source_cfg.block_ready(source_cfg.cb_ctx);
+                }
+                rx_block = audio_pool_producer_block(pool);
+                block_fill = 0;
+            }
+        }
+        Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_RX_TRIGGER);
+        source_stats.interrupts++;
+    }
+
+    /* Count and clear the remaining interrupts */
+    if(PDM_OVERFLOW_INTR_MASK & intr_status)
+    {
+        source_stats.hw_overflows++;
+        Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, PDM_CHANNEL, CY_PDM_PCM_INTR_MASK);
+    }
+
+#if (AUDIO_PDM_CHANNELS > 1u)
+    /* The other channels do not interrupt, poll their overflow flags */
+    for (uint32_t channel = AUDIO_PDM_FIRST_CHANNEL; channel < PDM_CHANNEL; channel++)
+    {
+        if (PDM_OVERFLOW_INTR_MASK & Cy_PDM_PCM_Channel_GetInterruptStatus(CYBSP_PDM_HW, channel))
+        {
+            source_stats.hw_overflows++;
+            Cy_PDM_PCM_Channel_ClearInterrupt(CYBSP_PDM_HW, channel, CY_PDM_PCM_INTR_MASK);
+        }
+    }
+#endif
+}
+
+/* [] END OF FILE */
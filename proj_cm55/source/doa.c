@@ -7,7 +7,9 @@
  * Direction of Arrival model requires PDM data from four different mics pointing
  * to four different directions. Since the PSOC Edge AI kit hardware does not 
  * support this, the sample audio data is being passed to model for detecting
- * the direction of sound source. 
+ * the direction of sound source, paced at its sample rate or as fast as
+ * possible for benchmarking (DOA_REPLAY_MODE). On a board with a microphone
+ * array the four PDM channels can be captured instead (DOA_SOURCE).
  *
  * The sample audio data shows the sound coming from "South" direction. 
  *
@@ -48,104 +50,328 @@
 * Header Files
 *******************************************************************************/
 #include "doa.h"
-#include "audio_data.h"
 #include "cy_result.h"
 #include "retarget_io_init.h"
 
 #include "ipc_communication.h"
+#include "timebase.h"
+#include "doa/doa_core.h"
+#include "doa/doa_vector.h"
+#include "audio/audio_source.h"
+#include "timers.h"
 
-/*******************************************************************************
- * Global Variables
- ********************************************************************************/
+/******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* DOA_SOURCE_VECTOR plays the recorded test vector. DOA_SOURCE_PDM captures
+ * four microphones on PDM channels 0 to 3, interleaved by the audio source,
+ * which needs a board with a microphone array. */
+#define DOA_SOURCE_VECTOR     (0)
+#define DOA_SOURCE_PDM        (1)
 
-volatile long tick1 = 0;
+#ifndef DOA_SOURCE
+#define DOA_SOURCE            DOA_SOURCE_VECTOR
+#endif
 
-/* DOA task handle */
-static TaskHandle_t doa_task_handle;
+/* DOA_REPLAY_PACED plays the test vector at its sample rate: a timer releases
+ * one block every DOA_BLOCK_FRAMES sample periods, so the CPU load and the
+ * IPC rate are the ones of a live microphone array. DOA_REPLAY_BENCHMARK feeds
+ * the vector as fast as possible, without IPC, and prints the throughput. */
+#define DOA_REPLAY_PACED      (0)
+#define DOA_REPLAY_BENCHMARK  (1)
 
+#ifndef DOA_REPLAY_MODE
+#define DOA_REPLAY_MODE       DOA_REPLAY_PACED
+#endif
 
-/******************************************************************************
- * Macros
- ******************************************************************************/
-#define DELAY_MS              (200)
-/* Task priority and stack size for the DOA task */
+#define DOA_VECTOR_PACED      ((DOA_SOURCE == DOA_SOURCE_VECTOR) && (DOA_REPLAY_MODE == DOA_REPLAY_PACED))
+#define DOA_BENCHMARK         ((DOA_SOURCE == DOA_SOURCE_VECTOR) && (DOA_REPLAY_MODE == DOA_REPLAY_BENCHMARK))
+
+/* Interval of the throughput and load print, 0 disables it */
+#ifndef DOA_REPORT_INTERVAL_MS
+#define DOA_REPORT_INTERVAL_MS (10000u)
+#endif
+
+/* Task priority and stack size for the DOA task. The benchmark runs below
+ * the other tasks so they are not starved. */
+#if DOA_BENCHMARK
+#define TASK_DOA_PRIORITY     (tskIDLE_PRIORITY + 1)
+#else
 #define TASK_DOA_PRIORITY     (configMAX_PRIORITIES - 1)
+#endif
 #define TASK_DOA_STACK_SIZE   (1024U)
-/* I2C Clock frequency in Hz */
-#define I2C_CLK_FREQ_HZ       (400000U)
 
-#define DETECTCOUNT           10
 #define LED_STOP_COUNT        500
 
+/* Frames converted and fed to the model at a time, 16 ms at 16 kHz */
+#define DOA_BLOCK_FRAMES      (256u)
+
+/* Captured blocks, model units per PCM LSB and the capture sample period */
+#define DOA_POOL_BLOCKS       (4u)
+#ifndef DOA_CAPTURE_SCALE
+#define DOA_CAPTURE_SCALE     (1.0f / 32768.0f)
+#endif
+#define DOA_CAPTURE_RATE_HZ   (16000u)
+#define DOA_BLOCK_PERIOD_US   ((DOA_BLOCK_FRAMES * 1000000u) / DOA_CAPTURE_RATE_HZ)
+
+/* Smoothing of the model output as recommended for the DOA model: a
+ * direction is reported when it wins the majority of the last
+ * DOA_PP_WINDOW predictions. */
+#define DOA_PP_WINDOW         (3u)
+#define DOA_PP_VOTES          (2u)
+
 /*******************************************************************************
-* Function Name: systick_isr1
-********************************************************************************
-* Summary: This increments every time the SysTick counter decrements to 0.
-*
-* Parameters:
-*   None
-*
-* Return:
-*   None
-*
-*
-*******************************************************************************/
-void systick_isr1(void)
+ * Function Prototypes
+ ********************************************************************************/
+static void doa_event(const doa_core_event_t *event, void *ctx);
+static void doa_model_status(int status, void *ctx);
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* DOA task handle */
+static TaskHandle_t doa_task_handle;
+
+static const char *const doa_labels[IMAI_DATAOUT_COUNT] = IMAI_DATAOUT_SYMBOLS;
+
+static const doa_model_t doa_model =
 {
-    tick1++;
-}
+    .name = "doa",
+    .channels = IMAI_DATAIN_COUNT,
+    .class_count = IMAI_DATAOUT_COUNT,
+    .labels = doa_labels,
+    .enqueue = IMAI_DOA_enqueue,
+    .dequeue = IMAI_DOA_dequeue
+};
+
+static const doa_core_cfg_t doa_core_cfg =
+{
+    .model = &doa_model,
+    .window = DOA_PP_WINDOW,
+    .votes = DOA_PP_VOTES,
+    .event_cb = doa_event,
+    .status_cb = doa_model_status,
+    .cb_ctx = NULL,
+    .get_cycles = timebase_get_cycles32
+};
+
+static doa_core_t doa_core;
+
+/* Model ID in the IPC label table */
+static int doa_model_id;
+static float doa_block[DOA_BLOCK_FRAMES * IMAI_DATAIN_COUNT];
+/* Capture time of doa_block, the read time for the test vector */
+static uint32_t doa_block_time;
+
+#if (DOA_SOURCE == DOA_SOURCE_PDM)
+static int16_t doa_pool_storage[DOA_POOL_BLOCKS * DOA_BLOCK_FRAMES * IMAI_DATAIN_COUNT];
+static audio_pool_t doa_pool;
+#else
+static doa_vector_t doa_vector;
+#endif
 
+#if DOA_VECTOR_PACED
+static TimerHandle_t doa_pace_timer;
+#endif
+
+/* LED variables */
+static int led_off = 0;
+static int led_on = 0;
 
 /*******************************************************************************
-* Function Name: get_time_from_millisec_audio
-********************************************************************************
-* Summary: This function prints the time when a output class is detected.
-*
-* Parameters:
-*   milliseconds : time when a output class is detected.
-*   timeString   : time of detected class in hr:m:s format.
-*
-* Return:
-*   None
-*
-*
-*******************************************************************************/
-void get_time_from_millisec_audio(unsigned long milliseconds, char* timeString) {
-  unsigned int seconds = (milliseconds / 1000) % 60;
-  unsigned int minutes = (milliseconds / (1000 * 60)) % 60;
-  unsigned int hours = (milliseconds / (1000 * 60 * 60));
-  sprintf(timeString, "%02u:%02u:%02u", hours, minutes, seconds);
+ * Function Name: doa_event
+ ********************************************************************************
+ * Summary:
+ *  Called by the core when the smoothed direction changes. The direction is
+ *  forwarded to the CM33 unless the task runs the benchmark.
+ *
+ *******************************************************************************/
+static void doa_event(const doa_core_event_t *event, void *ctx)
+{
+    int state = event->class_id;
+
+    (void)ctx;
+
+#if !DOA_BENCHMARK
+    uint8_t scores[IPC_MAX_SCORES];
+    uint32_t score_count = postprocess_get_scores(&doa_core.pp, scores, IPC_MAX_SCORES);
+    cm55_ipc_send_result((uint32_t)doa_model_id, (uint32_t)state, scores, score_count,
+                         doa_block_time, (uint32_t)timebase_get_us());
+#endif
+
+    if (state != 0)
+    {
+        if ((led_off - CYBSP_LED_STATE_ON) > 0)
+        {
+            printf("\r\n");
+        }
+        /* print triggered class and the triggered time since IMAI Initial. */
+        printf("%s\n", event->label);
+        // Do not control the LED:
+        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
+        led_off = 0;
+        led_on = timebase_get_ms();
+    }
+    else
+    {
+        /* turn off LED after the LED is on for 500ms */
+        if((timebase_get_ms() - led_on) > LED_STOP_COUNT)
+        {
+            /* turn on green LED */
+            // Do not control the LED:
+            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
+        }
+        led_off = 1;
+    }
 }
 
 /*******************************************************************************
- * Function Name: doa_init
+ * Function Name: doa_model_status
  ********************************************************************************
  * Summary:
- *  Function that configures the Systick timer for time keeping.
+ *  Called by the core when the model stops returning results.
  *
- * Parameters:
- *  None
+ *******************************************************************************/
+static void doa_model_status(int status, void *ctx)
+{
+    (void)ctx;
+
+    if (IMAI_RET_TIMEDOUT == status)
+    {
+        printf("The evaluation period has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n");
+    }
+    else if (IMAI_RET_NOMEM == status)
+    {
+        /* Something went wrong, stop the program */
+        printf("Unable to perform inference. Internal memory error.\n");
+    }
+}
+
+#if (DOA_REPORT_INTERVAL_MS > 0)
+/*******************************************************************************
+ * Function Name: doa_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the throughput of the model and the CPU share it took since the
+ *  last print every DOA_REPORT_INTERVAL_MS, and the capture losses.
  *
- * Return:
- *  None
+ *******************************************************************************/
+static void doa_report(void)
+{
+    static uint64_t last_cycles = 0;
+    static doa_core_stats_t last;
+    uint64_t now = timebase_get_cycles();
+    uint64_t elapsed = now - last_cycles;
+    uint64_t elapsed_us;
+    doa_core_stats_t stats;
+    uint32_t frames;
+    uint32_t results;
+    uint64_t model_cycles;
+
+    if (elapsed < ((uint64_t)DOA_REPORT_INTERVAL_MS * 1000u * timebase_get_cycles_per_us()))
+    {
+        return;
+    }
+    last_cycles = now;
+
+    doa_core_get_stats(&doa_core, &stats);
+    frames = stats.frames - last.frames;
+    results = stats.results - last.results;
+    model_cycles = stats.model_cycles - last.model_cycles;
+    last = stats;
+
+    elapsed_us = elapsed / timebase_get_cycles_per_us();
+    printf("doa: %lu samples/s, %lu inferences/s, %lu cycles/inference, %lu max per frame, %lu%% CPU\r\n",
+           (unsigned long)(((uint64_t)frames * IMAI_DATAIN_COUNT * 1000000u) / elapsed_us),
+           (unsigned long)(((uint64_t)results * 1000000u) / elapsed_us),
+           (unsigned long)((0u == results) ? 0u : (model_cycles / results)),
+           (unsigned long)stats.max_frame_cycles,
+           (unsigned long)((model_cycles * 100u) / elapsed));
+
+#if (DOA_SOURCE == DOA_SOURCE_PDM)
+    audio_pool_stats_t pool_stats;
+    audio_source_stats_t source_stats;
+
+    audio_pool_get_stats(&doa_pool, &pool_stats);
+    audio_source_get_stats(&source_stats);
+    printf("doa: %lu blocks captured, %lu overruns, %lu hardware overflows\r\n",
+           (unsigned long)source_stats.blocks, (unsigned long)pool_stats.overruns,
+           (unsigned long)source_stats.hw_overflows);
+#endif
+}
+#endif
+
+#if DOA_VECTOR_PACED
+/*******************************************************************************
+ * Function Name: doa_pace_callback
+ ********************************************************************************
+ * Summary:
+ *  Releases the next block of the test vector.
  *
  *******************************************************************************/
-static void doa_init(void)
+static void doa_pace_callback(TimerHandle_t timer)
 {
-    /* timer set up */
-    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_IMO , (8000000/1000)-1);
-    Cy_SysTick_SetCallback(0, systick_isr1);        /* point to SysTick ISR to increment the 1ms count */
+    (void)timer;
+    xTaskNotifyGive(doa_task_handle);
+}
+#endif
 
-    /* Initialize DEEPCRAFT pre-processing library */
-    IMAI_DOA_init();
+#if (DOA_SOURCE == DOA_SOURCE_PDM)
+/*******************************************************************************
+ * Function Name: doa_block_ready
+ ********************************************************************************
+ * Summary:
+ *  Called from the PDM ISR when a block was captured. Notifies the DOA task.
+ *
+ *******************************************************************************/
+static void doa_block_ready(void *cb_ctx)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    (void)cb_ctx;
+
+    vTaskNotifyGiveFromISR(doa_task_handle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+/*******************************************************************************
+ * Function Name: doa_get_time_us
+ *******************************************************************************/
+static uint32_t doa_get_time_us(void)
+{
+    return (uint32_t)timebase_get_us();
+}
+
+/*******************************************************************************
+ * Function Name: doa_capture_start
+ ********************************************************************************
+ * Summary:
+ *  Starts capturing interleaved 4-channel blocks of DOA_BLOCK_FRAMES frames.
+ *
+ *******************************************************************************/
+static bool doa_capture_start(void)
+{
+    audio_source_config_t source_config =
+    {
+        .pool = &doa_pool,
+        .block_ready = doa_block_ready,
+        .cb_ctx = NULL,
+        .get_time = doa_get_time_us,
+        .channels = IMAI_DATAIN_COUNT
+    };
+
+    return audio_pool_init(&doa_pool, doa_pool_storage, DOA_POOL_BLOCKS,
+                           DOA_BLOCK_FRAMES * IMAI_DATAIN_COUNT, DOA_BLOCK_PERIOD_US) &&
+           audio_source_start(&source_config);
+}
+#endif
 
 /*******************************************************************************
  * Function Name: doa_task
  ********************************************************************************
  * Summary:
- *  Task that processes the sample PDM data to detect the direction of sound.
+ *  Task that feeds the DOA test vector or the captured microphones to the
+ *  model to detect the direction of sound.
  *
  * Parameters:
  *  void *pvParameters : Task parameter defined during task creation (unused)
@@ -156,106 +382,92 @@ static void doa_init(void)
  *******************************************************************************/
 static void doa_task(void* pvParameters)
 {
-    cy_rslt_t result;
-    /* LED variables */
-    static int led_off = 0;
-    static int led_on = 0;
-    static int send_data = 0;
-    int label_scores[IMAI_DATAOUT_COUNT];
-    static int prediction_count = 0;
+    (void)pvParameters;
 
-    /* Initialize SysTick timer */
-    doa_init();
+    /* Initialize DEEPCRAFT pre-processing library */
+    IMAI_DOA_init();
+    if (!doa_core_init(&doa_core, &doa_core_cfg))
+    {
+        CY_ASSERT(0);
+    }
 
-    unsigned long start_t = tick1;
-    const char* class_map[] = IMAI_DATAOUT_SYMBOLS;
+    /* Publish the direction names once, the results only carry the IDs */
+    doa_model_id = cm55_ipc_add_model(doa_model.name, doa_model.labels, doa_model.class_count);
+    if (doa_model_id < 0)
+    {
+        CY_ASSERT(0);
+    }
+    cm55_ipc_publish_labels();
+
+#if (DOA_SOURCE == DOA_SOURCE_PDM)
+    if (!doa_capture_start())
+    {
+        printf(" Error : DOA capture initialization failed !!\r\n");
+        handle_app_error();
+    }
+#else
+    if (!doa_vector_open(&doa_vector, doa_vector_blob, (size_t)(doa_vector_blob_end - doa_vector_blob)) ||
+        (IMAI_DATAIN_COUNT != doa_vector.header->channels))
+    {
+        printf(" Error : invalid DOA test vector !!\r\n");
+        handle_app_error();
+    }
+#endif
+
+#if DOA_VECTOR_PACED
+    /* One block every DOA_BLOCK_FRAMES sample periods */
+    doa_pace_timer = xTimerCreate("DOA pace",
+            pdMS_TO_TICKS((DOA_BLOCK_FRAMES * 1000u) / doa_vector.header->sample_rate),
+            pdTRUE, NULL, doa_pace_callback);
+    if ((NULL == doa_pace_timer) || (pdPASS != xTimerStart(doa_pace_timer, 0)))
+    {
+        CY_ASSERT(0);
+    }
+#endif
 
     for (;;)
     {
-        int num_rows = sizeof(audio_data) / sizeof(audio_data[0]);
-        int row_size = sizeof(audio_data[0]) / sizeof(audio_data[0][0]);
-        uint8 pred_idx =  0;
-        
-        for (int i = 0; i < num_rows; i++)
+#if (DOA_SOURCE == DOA_SOURCE_PDM)
+        const audio_pool_block_t *block;
+
+        /* Wait here until the PDM ISR notifies us */
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /* Process every captured block, the ISR may have queued several */
+        while (NULL != (block = audio_source_get_block((uint32_t)timebase_get_us())))
         {
-            float data_in[4];
-            for (int j = 0; j < row_size; j++)
-            {
-                data_in[j] = (float)audio_data[i][j];
-            }
-            result = IMAI_DOA_enqueue(data_in);
-
-            switch (IMAI_DOA_dequeue(label_scores))
-            {
-                static uint8_t success_flag;
-                case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-
-                    success_flag = 1;
-                    prediction_count += 1;
-
-                    for (uint8_t i = 0; i < IMAI_DATAOUT_COUNT; i++)
-                    {
-                        if (label_scores[i] == 1)
-                        {
-                            pred_idx = i;
-                        }
-                    }
-                    
-                    payload->label_id = pred_idx;
-                    strcpy(payload->label, class_map[pred_idx]);
-                    cm55_ipc_send_to_cm33();
-
-                    if (pred_idx != 0)
-                    {
-                        if ((led_off - CYBSP_LED_STATE_ON) > 0)
-                        {
-                            printf("\r\n");
-                        }
-                        /* print triggered class and the triggered time since IMAI Initial. */
-                        printf("%s\n", class_map[pred_idx]);
-                        // Do not control the LED:
-                        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
-                        led_off = 0;
-                        led_on = tick1;
-                    }
-                    else
-                    {
-                        /* only print non-label class very 10 predictions */
-                        if (prediction_count>9)
-                        {
-                            // printf(".");
-                            // fflush( stdout );
-                            prediction_count = 0;
-                        }
-                        /* turn off LED after the LED is on for 500ms */
-                        if((tick1 - led_on) > 500)
-                        {
-                            /* turn on green LED */
-                            // Do not control the LED:
-                            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
-                        }
-                        led_off = 1;
-                    }
-
-                    break;
-
-                case IMAI_RET_NOMEM:
-                    /* Something went wrong, stop the program */
-                    printf("Unable to perform inference. Internal memory error.\n");
-                    break;
-                case IMAI_RET_TIMEDOUT:
-                    if (success_flag == 1)
-                        {
-                        printf("The evaluation period has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n");
-                        }
-                        success_flag = 0;
-                    break;
-
-            }
+            doa_vector_to_float(block->data, doa_block, DOA_BLOCK_FRAMES * IMAI_DATAIN_COUNT, DOA_CAPTURE_SCALE);
+            doa_block_time = block->timestamp;
+            audio_source_release_block();
+            doa_core_process(&doa_core, doa_block, DOA_BLOCK_FRAMES);
         }
-    }
+#else
+        uint32_t frames;
 
+#if DOA_VECTOR_PACED
+        /* Blocks released while the model was busy are caught up */
+        (void)ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+#endif
+
+        doa_block_time = (uint32_t)timebase_get_us();
+        frames = doa_vector_read(&doa_vector, doa_block, DOA_BLOCK_FRAMES);
+        if (0u == frames)
+        {
+            /* Play the test vector in a loop */
+            doa_vector_rewind(&doa_vector);
+            frames = doa_vector_read(&doa_vector, doa_block, DOA_BLOCK_FRAMES);
+        }
+
+        doa_core_process(&doa_core, doa_block, frames);
+#endif
+#if !DOA_BENCHMARK
+        /* Parameters only change between two blocks */
+        cm55_ipc_poll_control();
+#endif
+#if (DOA_REPORT_INTERVAL_MS > 0)
+        doa_report();
+#endif
+    }
 }
 
 /*******************************************************************************
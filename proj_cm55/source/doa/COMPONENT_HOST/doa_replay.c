@@ -0,0 +1,458 @@
+/******************************************************************************
+* File Name:   doa_replay.c
+*
+* Description: This file implements a host replay of the DOA test vector
+*              through the direction of arrival pipeline of the DOA task
+*              (doa_core.c). Like the task, it plays the vector paced at its
+*              sample rate with --realtime, or as fast as possible for a
+*              benchmark. The tool prints every direction change with its
+*              time in the vector, the samples/s, the inferences/s, the
+*              cost per inference and the share of the elapsed time spent
+*              in the model.
+*
+*              Usage: doa_replay <vector.bin|capture.wav> [--realtime]
+*                                [--loops N] [--block N] [--events out.csv]
+*
+*              The vector is generated by doa_vector_gen. A multichannel WAV
+*              file is played once through the live capture path instead:
+*              the WAV stand-in of the audio source fills the block pool with
+*              interleaved frames and the blocks are converted and processed
+*              as in the DOA task with DOA_SOURCE=DOA_SOURCE_PDM. Costs are
+*              counted in timebase cycles, nanoseconds on the host. The exit
+*              code is 1 if the model returned no result.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <semaphore.h>
+#include "doa_lib.h"
+#include "doa_core.h"
+#include "doa_vector.h"
+#include "audio_pool.h"
+#include "audio_source.h"
+#include "audio_source_wav.h"
+#include "timebase.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same block and smoothing as the DOA task */
+#define REPLAY_DEFAULT_BLOCK                (256u)
+#define REPLAY_PP_WINDOW                    (3u)
+#define REPLAY_PP_VOTES                     (2u)
+
+/* Capture pool of the WAV input, as DOA_POOL_BLOCKS of the task */
+#define REPLAY_POOL_BLOCKS                  (4u)
+#define REPLAY_MAX_BLOCK                    (1024u)
+#define REPLAY_CAPTURE_SCALE                (1.0f / 32768.0f)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    FILE        *events;
+    uint32_t    sample_rate;
+    uint32_t    loop_frames;    /* Frames of the vector played before the current loop */
+} replay_ctx_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const replay_labels[IMAI_DATAOUT_COUNT] = IMAI_DATAOUT_SYMBOLS;
+
+static const doa_model_t replay_model =
+{
+    .name = "doa",
+    .channels = IMAI_DATAIN_COUNT,
+    .class_count = IMAI_DATAOUT_COUNT,
+    .labels = replay_labels,
+    .enqueue = IMAI_DOA_enqueue,
+    .dequeue = IMAI_DOA_dequeue
+};
+
+static replay_ctx_t replay;
+static doa_core_t core;
+static doa_vector_t vector;
+static sem_t replay_block_sem;
+static int16_t replay_pool_storage[REPLAY_POOL_BLOCKS * REPLAY_MAX_BLOCK * IMAI_DATAIN_COUNT];
+
+/*******************************************************************************
+* Function Name: replay_sleep_until
+*******************************************************************************/
+static void replay_sleep_until(uint64_t t_us)
+{
+    uint64_t now_us = timebase_get_us();
+
+    if (t_us > now_us)
+    {
+        struct timespec delay =
+        {
+            .tv_sec = (time_t)((t_us - now_us) / 1000000u),
+            .tv_nsec = (long)(((t_us - now_us) % 1000000u) * 1000u)
+        };
+        nanosleep(&delay, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_load
+********************************************************************************
+* Summary:
+*  Reads the whole vector file into memory, 4-byte aligned as in flash.
+*
+*******************************************************************************/
+static void* replay_load(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    void *blob = NULL;
+    long length;
+
+    if (NULL == file)
+    {
+        return NULL;
+    }
+    if ((0 == fseek(file, 0, SEEK_END)) && ((length = ftell(file)) > 0) && (0 == fseek(file, 0, SEEK_SET)))
+    {
+        blob = malloc((size_t)length);
+        if ((NULL != blob) && ((size_t)length != fread(blob, 1u, (size_t)length, file)))
+        {
+            free(blob);
+            blob = NULL;
+        }
+        *size = (size_t)length;
+    }
+    fclose(file);
+
+    return blob;
+}
+
+/*******************************************************************************
+* Function Name: replay_event
+********************************************************************************
+* Summary:
+*  Prints a direction change with the time of the last frame fed before it
+*  within the current loop of the vector.
+*
+*******************************************************************************/
+static void replay_event(const doa_core_event_t *event, void *ctx)
+{
+    replay_ctx_t *r = (replay_ctx_t*)ctx;
+    double time_s = (double)(event->frame - r->loop_frames) / r->sample_rate;
+
+    printf("%9.3f s  %s\n", time_s, event->label);
+    if (NULL != r->events)
+    {
+        fprintf(r->events, "%.3f,%s\n", time_s, event->label);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_status
+*******************************************************************************/
+static void replay_status(int status, void *ctx)
+{
+    (void)ctx;
+    fprintf(stderr, "%s model returned %d\n", replay_model.name, status);
+}
+
+/*******************************************************************************
+* Function Name: replay_is_wav
+*******************************************************************************/
+static bool replay_is_wav(const char *path)
+{
+    size_t length = strlen(path);
+
+    return (length > 4u) && (0 == strcmp(&path[length - 4u], ".wav"));
+}
+
+/*******************************************************************************
+* Function Name: replay_time_us
+*******************************************************************************/
+static uint32_t replay_time_us(void)
+{
+    return (uint32_t)timebase_get_us();
+}
+
+/*******************************************************************************
+* Function Name: replay_block_ready
+*******************************************************************************/
+static void replay_block_ready(void *cb_ctx)
+{
+    (void)cb_ctx;
+    sem_post(&replay_block_sem);
+}
+
+/*******************************************************************************
+* Function Name: replay_vector
+********************************************************************************
+* Summary:
+*  Plays the test vector loops times, paced at its sample rate in real-time
+*  mode.
+*
+*******************************************************************************/
+static void replay_vector(float *frames, uint32_t block, uint32_t loops, bool realtime)
+{
+    uint64_t start_us = timebase_get_us();
+    uint64_t played = 0;
+
+    for (uint32_t loop = 0; loop < loops; loop++)
+    {
+        uint32_t count;
+
+        replay.loop_frames = (uint32_t)played;
+        doa_vector_rewind(&vector);
+        while (0u != (count = doa_vector_read(&vector, frames, block)))
+        {
+            played += count;
+            if (realtime)
+            {
+                /* The block is complete once its last frame was captured */
+                replay_sleep_until(start_us + (played * 1000000u) / replay.sample_rate);
+            }
+            doa_core_process(&core, frames, count);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_capture
+********************************************************************************
+* Summary:
+*  Streams the WAV file through the audio source and the block pool, the way
+*  the DOA task consumes the PDM capture.
+*
+* Return:
+*  false if the capture could not be started.
+*
+*******************************************************************************/
+static bool replay_capture(float *frames, uint32_t block)
+{
+    audio_pool_t pool;
+    audio_pool_stats_t pool_stats;
+    audio_source_stats_t source_stats;
+    uint32_t block_samples = block * IMAI_DATAIN_COUNT;
+
+    /* Late after one block period */
+    if (!audio_pool_init(&pool, replay_pool_storage, REPLAY_POOL_BLOCKS, block_samples,
+                         (uint32_t)(((uint64_t)block * 1000000u) / replay.sample_rate)))
+    {
+        return false;
+    }
+
+    audio_source_config_t config =
+    {
+        .pool = &pool,
+        .block_ready = replay_block_ready,
+        .cb_ctx = NULL,
+        .get_time = replay_time_us,
+        .channels = IMAI_DATAIN_COUNT
+    };
+
+    sem_init(&replay_block_sem, 0, 0);
+    if (!audio_source_start(&config))
+    {
+        sem_destroy(&replay_block_sem);
+        return false;
+    }
+
+    for (;;)
+    {
+        const audio_pool_block_t *pool_block;
+
+        sem_wait(&replay_block_sem);
+        while (NULL != (pool_block = audio_source_get_block(replay_time_us())))
+        {
+            doa_vector_to_float(pool_block->data, frames, block_samples, REPLAY_CAPTURE_SCALE);
+            audio_source_release_block();
+            doa_core_process(&core, frames, block);
+        }
+        if (audio_source_wav_finished() && (0u == audio_pool_depth(&pool)))
+        {
+            break;
+        }
+    }
+    audio_source_stop();
+    sem_destroy(&replay_block_sem);
+
+    audio_pool_get_stats(&pool, &pool_stats);
+    audio_source_get_stats(&source_stats);
+    printf("%u blocks captured, %u overruns, %u late, %u max depth\n",
+           (unsigned)source_stats.blocks, (unsigned)pool_stats.overruns,
+           (unsigned)pool_stats.late, (unsigned)pool_stats.depth_max);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    doa_core_stats_t stats;
+    const char *events_path = NULL;
+    bool realtime = false;
+    bool capture;
+    uint32_t loops = 1;
+    uint32_t block = REPLAY_DEFAULT_BLOCK;
+    uint64_t start_cycles;
+    uint64_t elapsed_cycles;
+    double elapsed_s;
+    float *frames;
+    size_t size = 0;
+    void *blob = NULL;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "--realtime"))
+        {
+            realtime = true;
+        }
+        else if ((0 == strcmp(argv[i], "--loops")) && ((i + 1) < argc))
+        {
+            loops = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--block")) && ((i + 1) < argc))
+        {
+            block = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--events")) && ((i + 1) < argc))
+        {
+            events_path = argv[++i];
+        }
+    }
+
+    if ((argc < 2) || (0u == block) || (0u == loops))
+    {
+        fprintf(stderr, "usage: %s <vector.bin|capture.wav> [--realtime] [--loops N] [--block N] [--events out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    capture = replay_is_wav(argv[1]);
+    if (capture)
+    {
+        if (block > REPLAY_MAX_BLOCK)
+        {
+            fprintf(stderr, "--block must be at most %u for a WAV file\n", (unsigned)REPLAY_MAX_BLOCK);
+            return 2;
+        }
+        if (!audio_source_wav_open(argv[1], realtime) || (0u == audio_source_wav_sample_rate()))
+        {
+            fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", argv[1]);
+            return 2;
+        }
+        replay.sample_rate = audio_source_wav_sample_rate();
+        loops = 1;
+    }
+    else
+    {
+        blob = replay_load(argv[1], &size);
+        if ((NULL == blob) || !doa_vector_open(&vector, blob, size) ||
+            (IMAI_DATAIN_COUNT != vector.header->channels) || (0u == vector.header->sample_rate))
+        {
+            fprintf(stderr, "%s: not a %u channel test vector\n", argv[1], (unsigned)IMAI_DATAIN_COUNT);
+            return 2;
+        }
+        replay.sample_rate = vector.header->sample_rate;
+    }
+    frames = malloc((size_t)block * IMAI_DATAIN_COUNT * sizeof(float));
+    if (NULL == frames)
+    {
+        return 2;
+    }
+
+    if (NULL != events_path)
+    {
+        replay.events = fopen(events_path, "w");
+        if (NULL == replay.events)
+        {
+            fprintf(stderr, "%s: cannot create\n", events_path);
+            return 1;
+        }
+        fprintf(replay.events, "time_s,label\n");
+    }
+
+    doa_core_cfg_t cfg =
+    {
+        .model = &replay_model,
+        .window = REPLAY_PP_WINDOW,
+        .votes = REPLAY_PP_VOTES,
+        .event_cb = replay_event,
+        .status_cb = replay_status,
+        .cb_ctx = &replay,
+        .get_cycles = timebase_get_cycles32
+    };
+
+    timebase_init();
+    IMAI_DOA_init();
+    if (!doa_core_init(&core, &cfg))
+    {
+        fprintf(stderr, "unable to initialize the DOA core\n");
+        return 2;
+    }
+
+    if (capture)
+    {
+        printf("%s: %u channels at %u Hz, capture, %s\n", argv[1], (unsigned)IMAI_DATAIN_COUNT,
+               (unsigned)replay.sample_rate, realtime ? "paced" : "benchmark");
+    }
+    else
+    {
+        printf("%s: %u frames of %u channels at %u Hz, %u loops, %s\n", argv[1],
+               (unsigned)vector.header->frames, (unsigned)vector.header->channels,
+               (unsigned)vector.header->sample_rate, (unsigned)loops, realtime ? "paced" : "benchmark");
+    }
+
+    start_cycles = timebase_get_cycles();
+    if (capture)
+    {
+        if (!replay_capture(frames, block))
+        {
+            fprintf(stderr, "%s: unable to capture %u channels of %u frames\n", argv[1],
+                    (unsigned)IMAI_DATAIN_COUNT, (unsigned)block);
+            return 2;
+        }
+    }
+    else
+    {
+        replay_vector(frames, block, loops, realtime);
+    }
+    elapsed_cycles = timebase_get_cycles() - start_cycles;
+    elapsed_s = (double)elapsed_cycles / (timebase_get_cycles_per_us() * 1e6);
+
+    doa_core_get_stats(&core, &stats);
+    printf("%u frames (%.1f s) in %.3f s, %.0f samples/s (%.1fx real time), %u inferences (%.1f inferences/s)\n",
+           (unsigned)stats.frames, (double)stats.frames / replay.sample_rate, elapsed_s,
+           (elapsed_s > 0.0) ? ((double)stats.frames * IMAI_DATAIN_COUNT) / elapsed_s : 0.0,
+           (elapsed_s > 0.0) ? ((double)stats.frames / replay.sample_rate) / elapsed_s : 0.0,
+           (unsigned)stats.results, (elapsed_s > 0.0) ? stats.results / elapsed_s : 0.0);
+    printf("%.0f cycles/inference, %u max per frame, %.1f%% of the time in the model\n",
+           (0u == stats.results) ? 0.0 : (double)stats.model_cycles / stats.results,
+           (unsigned)stats.max_frame_cycles,
+           (0u == elapsed_cycles) ? 0.0 : (100.0 * stats.model_cycles) / elapsed_cycles);
+    for (uint32_t c = 1; c < IMAI_DATAOUT_COUNT; c++)
+    {
+        if (0u != stats.detections[c])
+        {
+            printf("%s: %u detections\n", replay_labels[c], (unsigned)stats.detections[c]);
+        }
+    }
+
+    if (NULL != replay.events)
+    {
+        fclose(replay.events);
+    }
+    free(frames);
+    free(blob);
+
+    return (0u != stats.results) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,375 @@
+/******************************************************************************
+* File Name:   doa_vector_gen.c
+*
+* Description: This file implements a host tool that generates the DOA test
+*              vector blob embedded by doa_vector_blob.c. The input is a
+*              multichannel 16-bit PCM WAV file, or a text file with one
+*              frame of comma separated float samples per line. Braces are
+*              ignored, so a C table of frames can be converted as is.
+*
+*              Usage: doa_vector_gen <input.wav|input.csv> <output.bin>
+*                                    [--scale S] [--rate HZ]
+*
+*              WAV samples are stored as is, --scale sets the model units
+*              per LSB (default 1/32768). Text samples are quantized to
+*              16 bits with the smallest scale that fits the largest value
+*              unless --scale is given. The blob is read back with
+*              doa_vector.c and compared with the input, the exit code is
+*              1 if a sample is off by more than half a step.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "doa_vector.h"
+#include "wav_reader.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define GEN_DEFAULT_RATE_HZ                 (16000u)
+#define GEN_WAV_SCALE                       (1.0f / 32768.0f)
+#define GEN_LINE_SIZE                       (1024u)
+#define GEN_READ_FRAMES                     (256u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    float       *values;        /* Input samples in model units, interleaved */
+    uint32_t    frames;
+    uint32_t    capacity;       /* In frames */
+    uint16_t    channels;
+    uint32_t    sample_rate;    /* 0 if the input has none */
+    float       scale;          /* Model units per LSB, 0 to derive from the samples */
+} gen_input_t;
+
+/*******************************************************************************
+* Function Name: gen_append
+*******************************************************************************/
+static bool gen_append(gen_input_t *input, const float *frame)
+{
+    if (input->frames == input->capacity)
+    {
+        uint32_t capacity = (0u == input->capacity) ? 4096u : (2u * input->capacity);
+        float *values = realloc(input->values, (size_t)capacity * input->channels * sizeof(float));
+
+        if (NULL == values)
+        {
+            return false;
+        }
+        input->values = values;
+        input->capacity = capacity;
+    }
+
+    memcpy(&input->values[(size_t)input->frames * input->channels], frame, input->channels * sizeof(float));
+    input->frames++;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: gen_parse_line
+********************************************************************************
+* Summary:
+*  Parses one frame of a text input. Lines which do not start with a number
+*  after blanks and braces are not frames.
+*
+* Return:
+*  Number of samples, 0 if the line is not a frame.
+*
+*******************************************************************************/
+static uint32_t gen_parse_line(const char *line, float *frame)
+{
+    const char *p = line;
+    uint32_t count = 0;
+
+    while ((' ' == *p) || ('\t' == *p) || ('{' == *p))
+    {
+        p++;
+    }
+    if ((NULL == strchr("0123456789+-.", *p)) || ('\0' == *p))
+    {
+        return 0;
+    }
+
+    while (count < DOA_VECTOR_MAX_CHANNELS)
+    {
+        char *end;
+        float value = strtof(p, &end);
+
+        if (end == p)
+        {
+            break;
+        }
+        frame[count++] = value;
+        p = end;
+        while ((' ' == *p) || ('\t' == *p) || (',' == *p) || ('}' == *p))
+        {
+            p++;
+        }
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: gen_load_text
+*******************************************************************************/
+static bool gen_load_text(gen_input_t *input, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[GEN_LINE_SIZE];
+    float frame[DOA_VECTOR_MAX_CHANNELS];
+    uint32_t line_no = 0;
+
+    if (NULL == file)
+    {
+        return false;
+    }
+
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        uint32_t count = gen_parse_line(line, frame);
+
+        line_no++;
+        if (0u == count)
+        {
+            continue;
+        }
+        if (0u == input->channels)
+        {
+            input->channels = (uint16_t)count;
+        }
+        if ((count != input->channels) || !gen_append(input, frame))
+        {
+            fprintf(stderr, "%s:%u: expected %u samples\n", path, (unsigned)line_no, (unsigned)input->channels);
+            fclose(file);
+            return false;
+        }
+    }
+
+    fclose(file);
+    return (input->frames > 0u);
+}
+
+/*******************************************************************************
+* Function Name: gen_load_wav
+*******************************************************************************/
+static bool gen_load_wav(gen_input_t *input, const char *path)
+{
+    wav_reader_t wav;
+    int16_t pcm[GEN_READ_FRAMES * DOA_VECTOR_MAX_CHANNELS];
+    float frame[DOA_VECTOR_MAX_CHANNELS];
+    uint32_t count;
+
+    if (!wav_reader_open(&wav, path))
+    {
+        return false;
+    }
+    if (wav.channels > DOA_VECTOR_MAX_CHANNELS)
+    {
+        fprintf(stderr, "%s: %u channels, at most %u are supported\n", path,
+                (unsigned)wav.channels, (unsigned)DOA_VECTOR_MAX_CHANNELS);
+        wav_reader_close(&wav);
+        return false;
+    }
+    input->channels = wav.channels;
+    input->sample_rate = wav.sample_rate;
+    if (0.0f == input->scale)
+    {
+        input->scale = GEN_WAV_SCALE;
+    }
+
+    while (0u != (count = wav_reader_read(&wav, pcm, GEN_READ_FRAMES)))
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            for (uint32_t c = 0; c < input->channels; c++)
+            {
+                frame[c] = (float)pcm[i * input->channels + c] * input->scale;
+            }
+            if (!gen_append(input, frame))
+            {
+                wav_reader_close(&wav);
+                return false;
+            }
+        }
+    }
+
+    wav_reader_close(&wav);
+    return (input->frames > 0u);
+}
+
+/*******************************************************************************
+* Function Name: gen_quantize
+*******************************************************************************/
+static int16_t gen_quantize(float value, float scale, uint32_t *clipped)
+{
+    float raw = roundf(value / scale);
+
+    if (raw > 32767.0f)
+    {
+        (*clipped)++;
+        return 32767;
+    }
+    if (raw < -32768.0f)
+    {
+        (*clipped)++;
+        return -32768;
+    }
+    return (int16_t)raw;
+}
+
+/*******************************************************************************
+* Function Name: gen_has_suffix
+*******************************************************************************/
+static bool gen_has_suffix(const char *path, const char *suffix)
+{
+    size_t length = strlen(path);
+    size_t suffix_length = strlen(suffix);
+
+    return (length >= suffix_length) && (0 == strcmp(&path[length - suffix_length], suffix));
+}
+
+int main(int argc, char *argv[])
+{
+    gen_input_t input = { .values = NULL };
+    doa_vector_header_t *header;
+    doa_vector_t vector;
+    uint32_t rate = 0;
+    uint32_t samples;
+    uint32_t clipped = 0;
+    uint32_t mismatches = 0;
+    size_t size;
+    uint8_t *blob;
+    int16_t *pcm;
+    float *check;
+    double signal = 0.0;
+    double noise = 0.0;
+    double max_error = 0.0;
+    FILE *file;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <input.wav|input.csv> <output.bin> [--scale S] [--rate HZ]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 3; (i + 1) < argc; i += 2)
+    {
+        if (0 == strcmp(argv[i], "--scale"))
+        {
+            input.scale = strtof(argv[i + 1], NULL);
+        }
+        else if (0 == strcmp(argv[i], "--rate"))
+        {
+            rate = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        }
+    }
+    if (input.scale < 0.0f)
+    {
+        fprintf(stderr, "the scale must be positive\n");
+        return 2;
+    }
+
+    if (!(gen_has_suffix(argv[1], ".wav") ? gen_load_wav(&input, argv[1]) : gen_load_text(&input, argv[1])))
+    {
+        fprintf(stderr, "%s: cannot read the input\n", argv[1]);
+        return 2;
+    }
+    samples = input.frames * input.channels;
+
+    if (0.0f == input.scale)
+    {
+        float peak = 0.0f;
+
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            peak = fmaxf(peak, fabsf(input.values[i]));
+        }
+        input.scale = (peak > 0.0f) ? (peak / 32767.0f) : GEN_WAV_SCALE;
+    }
+    if (0u == rate)
+    {
+        rate = (0u != input.sample_rate) ? input.sample_rate : GEN_DEFAULT_RATE_HZ;
+    }
+
+    size = sizeof(*header) + (size_t)samples * sizeof(int16_t);
+    blob = calloc(1u, size);
+    check = malloc((size_t)GEN_READ_FRAMES * input.channels * sizeof(float));
+    if ((NULL == blob) || (NULL == check))
+    {
+        return 2;
+    }
+
+    header = (doa_vector_header_t*)blob;
+    header->magic = DOA_VECTOR_MAGIC;
+    header->version = DOA_VECTOR_VERSION;
+    header->format = DOA_VECTOR_FORMAT_Q15;
+    header->channels = input.channels;
+    header->sample_rate = rate;
+    header->frames = input.frames;
+    header->scale = input.scale;
+
+    pcm = (int16_t*)(header + 1);
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        pcm[i] = gen_quantize(input.values[i], input.scale, &clipped);
+    }
+
+    /* Read the blob back the way the target does */
+    if (!doa_vector_open(&vector, blob, size))
+    {
+        fprintf(stderr, "the generated blob is invalid\n");
+        return 1;
+    }
+    for (uint32_t frame = 0, count; 0u != (count = doa_vector_read(&vector, check, GEN_READ_FRAMES)); frame += count)
+    {
+        for (uint32_t i = 0; i < count * input.channels; i++)
+        {
+            double value = input.values[(size_t)frame * input.channels + i];
+            double error = fabs((double)check[i] - value);
+
+            signal += value * value;
+            noise += error * error;
+            if (error > max_error)
+            {
+                max_error = error;
+            }
+            if (error > (0.5 * input.scale * 1.001))
+            {
+                mismatches++;
+            }
+        }
+    }
+
+    file = fopen(argv[2], "wb");
+    if ((NULL == file) || (size != fwrite(blob, 1u, size, file)) || (0 != fclose(file)))
+    {
+        fprintf(stderr, "%s: cannot write the blob\n", argv[2]);
+        return 2;
+    }
+
+    printf("%s: %u frames of %u channels at %u Hz, scale %.9g\n", argv[2], (unsigned)input.frames,
+           (unsigned)input.channels, (unsigned)rate, (double)input.scale);
+    printf("%u bytes, %.1f%% of float samples\n", (unsigned)size,
+           (100.0 * size) / ((double)samples * sizeof(float)));
+    printf("max error %.3g, SNR %.1f dB, %u clipped, %u mismatches\n", max_error,
+           (noise > 0.0) ? (10.0 * log10(signal / noise)) : INFINITY, (unsigned)clipped, (unsigned)mismatches);
+
+    free(check);
+    free(blob);
+    free(input.values);
+
+    return (0u == mismatches) ? 0 : 1;
+}
+
+/* [] END OF FILE */
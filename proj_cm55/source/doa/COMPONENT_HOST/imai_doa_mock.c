@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name:   imai_doa_mock.c
+*
+* Description: This file implements a host stand-in for the IMAI queue API
+*              of the direction of arrival Ready Model library, which is only
+*              available for the CM55. Every IMAI_MOCK_HOP_FRAMES frames it
+*              flags the direction of the loudest microphone, or no direction
+*              for silence. The directions are not meaningful, the mock
+*              exercises the pipeline with the queue behaviour and class
+*              layout of the real library.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "doa_lib.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Frames per result, 32 ms at 16 kHz */
+#ifndef IMAI_MOCK_HOP_FRAMES
+#define IMAI_MOCK_HOP_FRAMES                (512u)
+#endif
+
+/* Mean square below which no direction is flagged */
+#ifndef IMAI_MOCK_SILENCE
+#define IMAI_MOCK_SILENCE                   (1e-6f)
+#endif
+
+/* Results the library holds before enqueue returns IMAI_RET_NOMEM */
+#define IMAI_MOCK_QUEUE_DEPTH               (4u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static float mock_energy[IMAI_DATAIN_COUNT];
+static uint32_t mock_frames;
+static int mock_queue[IMAI_MOCK_QUEUE_DEPTH];
+static uint32_t mock_head;
+static uint32_t mock_count;
+
+/*******************************************************************************
+* Function Name: IMAI_DOA_init
+*******************************************************************************/
+void IMAI_DOA_init(void)
+{
+    memset(mock_energy, 0, sizeof(mock_energy));
+    mock_frames = 0;
+    mock_head = 0;
+    mock_count = 0;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_DOA_enqueue
+********************************************************************************
+* Summary:
+*  Takes one frame of IMAI_DATAIN_COUNT microphones and queues a result
+*  every IMAI_MOCK_HOP_FRAMES frames.
+*
+*******************************************************************************/
+int IMAI_DOA_enqueue(const float *restrict data_in)
+{
+    uint32_t loudest = 0;
+
+    if (IMAI_MOCK_QUEUE_DEPTH == mock_count)
+    {
+        return IMAI_RET_NOMEM;
+    }
+
+    for (uint32_t c = 0; c < IMAI_DATAIN_COUNT; c++)
+    {
+        mock_energy[c] += data_in[c] * data_in[c];
+    }
+    if (++mock_frames < IMAI_MOCK_HOP_FRAMES)
+    {
+        return IMAI_RET_SUCCESS;
+    }
+
+    for (uint32_t c = 1; c < IMAI_DATAIN_COUNT; c++)
+    {
+        if (mock_energy[c] > mock_energy[loudest])
+        {
+            loudest = c;
+        }
+    }
+
+    /* Microphone c points to direction c + 1, class 0 is no direction */
+    mock_queue[(mock_head + mock_count) % IMAI_MOCK_QUEUE_DEPTH] =
+        ((mock_energy[loudest] / IMAI_MOCK_HOP_FRAMES) < IMAI_MOCK_SILENCE) ? 0 : (int)(loudest + 1u);
+    mock_count++;
+
+    memset(mock_energy, 0, sizeof(mock_energy));
+    mock_frames = 0;
+
+    return IMAI_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_DOA_dequeue
+********************************************************************************
+* Summary:
+*  Returns the oldest result as one flag per class.
+*
+*******************************************************************************/
+int IMAI_DOA_dequeue(int *restrict data_out)
+{
+    if (0u == mock_count)
+    {
+        return IMAI_RET_NODATA;
+    }
+
+    for (uint32_t c = 0; c < IMAI_DATAOUT_COUNT; c++)
+    {
+        data_out[c] = (mock_queue[mock_head] == (int)c) ? 1 : 0;
+    }
+    mock_head = (mock_head + 1u) % IMAI_MOCK_QUEUE_DEPTH;
+    mock_count--;
+
+    return IMAI_RET_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,203 @@
+/******************************************************************************
+* File Name:   doa_core.c
+*
+* Description: This file implements the direction of arrival pipeline
+*              without hardware dependencies: interleaved multichannel
+*              frames are fed to the model, the results are smoothed by a
+*              majority vote and changes of the direction are reported. The
+*              cycles spent in the model are counted for the benchmark.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "doa_core.h"
+
+/*******************************************************************************
+* Function Name: doa_core_cycles
+*******************************************************************************/
+static uint32_t doa_core_cycles(const doa_core_t *core)
+{
+    return (NULL != core->cfg.get_cycles) ? core->cfg.get_cycles() : 0u;
+}
+
+/*******************************************************************************
+* Function Name: doa_core_handle_result
+********************************************************************************
+* Summary:
+*  Smooths one model result and reports changes of the smoothed direction.
+*
+*******************************************************************************/
+static void doa_core_handle_result(doa_core_t *core, const int *flags)
+{
+    const doa_model_t *model = core->cfg.model;
+    doa_core_event_t event;
+    int state;
+
+    if (!postprocess_update(&core->pp, postprocess_flags_to_class(flags, model->class_count), &state))
+    {
+        return;
+    }
+
+    if (state != POSTPROCESS_BACKGROUND_CLASS)
+    {
+        core->stats.detections[state]++;
+    }
+    core->stats.events++;
+
+    event.class_id = state;
+    event.label = model->labels[state];
+    event.frame = core->stats.frames;
+    core->cfg.event_cb(&event, core->cfg.cb_ctx);
+}
+
+/*******************************************************************************
+* Function Name: doa_core_drain
+********************************************************************************
+* Summary:
+*  Dequeues the model results until it has no more data.
+*
+* Return:
+*  Cycles spent in the model, without the callbacks.
+*
+*******************************************************************************/
+static uint32_t doa_core_drain(doa_core_t *core)
+{
+    int data_out[DOA_CORE_MAX_CLASSES];
+    uint32_t cycles = 0;
+
+    for (;;)
+    {
+        uint32_t start = doa_core_cycles(core);
+        int status = core->cfg.model->dequeue(data_out);
+
+        cycles += doa_core_cycles(core) - start;
+        if (DOA_MODEL_RET_NODATA == status)
+        {
+            break;
+        }
+        if (DOA_MODEL_RET_SUCCESS == status)
+        {
+            core->success = true;
+            core->stats.results++;
+            doa_core_handle_result(core, data_out);
+            continue;
+        }
+
+        if ((NULL != core->cfg.status_cb) && ((DOA_MODEL_RET_TIMEDOUT != status) || core->success))
+        {
+            core->cfg.status_cb(status, core->cfg.cb_ctx);
+        }
+        core->success = false;
+        break;
+    }
+
+    return cycles;
+}
+
+/*******************************************************************************
+* Function Name: doa_core_init
+********************************************************************************
+* Summary:
+*  Initializes the smoothing of the model. A direction is reported once it
+*  wins cfg.votes of the last cfg.window results.
+*
+* Parameters:
+*  core : core context
+*  cfg  : configuration, copied. The model must stay valid.
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool doa_core_init(doa_core_t *core, const doa_core_cfg_t *cfg)
+{
+    if ((NULL == cfg->model) || (cfg->model->class_count > DOA_CORE_MAX_CLASSES) ||
+        (0u == cfg->model->channels) || (cfg->model->channels > DOA_CORE_MAX_CHANNELS) ||
+        (0u == cfg->window) || (cfg->window > POSTPROCESS_MAX_WINDOW) || (cfg->votes > cfg->window) ||
+        (NULL == cfg->event_cb))
+    {
+        return false;
+    }
+
+    memset(core, 0, sizeof(*core));
+    core->cfg = *cfg;
+
+    core->pp_classes[0].vote_k = 1u;
+    for (uint32_t c = 1; c < cfg->model->class_count; c++)
+    {
+        core->pp_classes[c].vote_k = cfg->votes;
+        core->pp_classes[c].enter_count = 1u;
+        core->pp_classes[c].exit_count = 1u;
+    }
+    core->pp_cfg.window = cfg->window;
+    core->pp_cfg.class_count = cfg->model->class_count;
+    core->pp_cfg.classes = core->pp_classes;
+    if (!postprocess_init(&core->pp, &core->pp_cfg))
+    {
+        return false;
+    }
+
+    /* The first time out is reported even without a result before it */
+    core->success = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: doa_core_process
+********************************************************************************
+* Summary:
+*  Feeds a block of frames to the model. Events are reported through
+*  cfg.event_cb before the function returns.
+*
+* Parameters:
+*  core   : core context
+*  frames : interleaved frames of cfg.model->channels samples
+*  count  : number of frames
+*
+*******************************************************************************/
+void doa_core_process(doa_core_t *core, const float *frames, uint32_t count)
+{
+    const doa_model_t *model = core->cfg.model;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float *frame = &frames[i * model->channels];
+        uint32_t start = doa_core_cycles(core);
+        uint32_t cycles;
+        int status = model->enqueue(frame);
+
+        cycles = doa_core_cycles(core) - start;
+        if (DOA_MODEL_RET_NOMEM == status)
+        {
+            /* The model queue is full, make room and try again */
+            cycles += doa_core_drain(core);
+            start = doa_core_cycles(core);
+            (void)model->enqueue(frame);
+            cycles += doa_core_cycles(core) - start;
+        }
+        core->stats.frames++;
+        cycles += doa_core_drain(core);
+
+        core->stats.model_cycles += cycles;
+        if (cycles > core->stats.max_frame_cycles)
+        {
+            core->stats.max_frame_cycles = cycles;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: doa_core_get_stats
+*******************************************************************************/
+void doa_core_get_stats(const doa_core_t *core, doa_core_stats_t *stats)
+{
+    *stats = core->stats;
+}
+
+/* [] END OF FILE */
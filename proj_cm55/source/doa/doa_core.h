@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name:   doa_core.h
+*
+* Description: This file contains the types and function prototypes of the
+*              direction of arrival pipeline implemented in doa_core.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef DOA_CORE_H_
+#define DOA_CORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "postprocess.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DOA_CORE_MAX_CLASSES                (16u)
+#define DOA_CORE_MAX_CHANNELS               (8u)
+
+/* Return codes of the model functions, identical to the IMAI_RET_* values */
+#define DOA_MODEL_RET_SUCCESS               (0)
+#define DOA_MODEL_RET_NODATA                (-1)
+#define DOA_MODEL_RET_NOMEM                 (-2)
+#define DOA_MODEL_RET_TIMEDOUT              (-3)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Model fed with interleaved multichannel frames, IMAI queue API */
+typedef struct
+{
+    const char          *name;
+    uint8_t             channels;       /* Samples per frame, up to DOA_CORE_MAX_CHANNELS */
+    uint8_t             class_count;    /* Including the background class 0, up to DOA_CORE_MAX_CLASSES */
+    const char *const   *labels;
+    int                 (*enqueue)(const float *data_in);
+    int                 (*dequeue)(int *data_out);
+} doa_model_t;
+
+/* Change of the smoothed direction */
+typedef struct
+{
+    int         class_id;       /* 0 when no direction is detected */
+    const char  *label;
+    uint32_t    frame;          /* Frames presented before the result, the time in sample periods */
+} doa_core_event_t;
+
+typedef void (*doa_core_event_cb_t)(const doa_core_event_t *event, void *ctx);
+
+/* Invoked for DOA_MODEL_RET_NOMEM and when the model times out after it
+ * returned results, i.e. at the end of the evaluation period */
+typedef void (*doa_core_status_cb_t)(int status, void *ctx);
+
+typedef uint32_t (*doa_core_cycles_fn_t)(void);
+
+typedef struct
+{
+    const doa_model_t       *model;
+    uint8_t                 window;         /* Results in the majority vote */
+    uint8_t                 votes;          /* Votes a direction needs in the window */
+    doa_core_event_cb_t     event_cb;
+    doa_core_status_cb_t    status_cb;      /* May be NULL */
+    void                    *cb_ctx;
+    doa_core_cycles_fn_t    get_cycles;     /* May be NULL */
+} doa_core_cfg_t;
+
+typedef struct
+{
+    uint32_t    frames;         /* Frames enqueued */
+    uint32_t    results;        /* Successful model dequeues, the inferences */
+    uint32_t    events;         /* Smoothed state changes reported */
+    uint64_t    model_cycles;   /* Cycles spent in enqueue and dequeue, without the callbacks */
+    uint32_t    max_frame_cycles;   /* Most cycles spent on one frame */
+    uint32_t    detections[DOA_CORE_MAX_CLASSES];
+} doa_core_stats_t;
+
+typedef struct
+{
+    doa_core_cfg_t          cfg;
+    postprocess_class_cfg_t pp_classes[DOA_CORE_MAX_CLASSES];
+    postprocess_cfg_t       pp_cfg;
+    postprocess_ctx_t       pp;
+    bool                    success;
+    doa_core_stats_t        stats;
+} doa_core_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool doa_core_init(doa_core_t *core, const doa_core_cfg_t *cfg);
+void doa_core_process(doa_core_t *core, const float *frames, uint32_t count);
+void doa_core_get_stats(const doa_core_t *core, doa_core_stats_t *stats);
+
+#endif /* DOA_CORE_H_ */
+
+/* [] END OF FILE */
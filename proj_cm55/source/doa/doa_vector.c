@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name:   doa_vector.c
+*
+* Description: This file implements the reader of the DOA test vector. The
+*              vector is kept as 16-bit samples with a common scale and read
+*              in place, a block of frames at a time is converted to the
+*              float frames the model takes. The conversion is shared with
+*              the live capture.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "doa_vector.h"
+
+#if defined(ARM_MATH_HELIUM) || defined(ARM_MATH_DSP)
+#define DOA_VECTOR_USE_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/*******************************************************************************
+* Function Name: doa_vector_to_float
+********************************************************************************
+* Summary:
+*  Converts 16-bit samples to float. Interleaved frames stay interleaved, so
+*  captured multichannel blocks are converted the same way.
+*
+* Parameters:
+*  samples : 16-bit samples
+*  out     : receives count samples
+*  count   : number of samples
+*  scale   : model units per LSB
+*
+*******************************************************************************/
+void doa_vector_to_float(const int16_t *samples, float *out, uint32_t count, float scale)
+{
+#ifdef DOA_VECTOR_USE_CMSIS_DSP
+    /* q15 to float scales by 1/32768 */
+    arm_q15_to_float((const q15_t*)samples, out, count);
+    arm_scale_f32(out, scale * 32768.0f, out, count);
+#else
+    for (uint32_t i = 0; i < count; i++)
+    {
+        out[i] = (float)samples[i] * scale;
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: doa_vector_open
+********************************************************************************
+* Summary:
+*  Checks the blob header and starts reading at the first frame. The blob is
+*  not copied and has to stay valid while the reader is used.
+*
+* Parameters:
+*  vector : reader context
+*  blob   : blob starting with doa_vector_header_t, 4-byte aligned
+*  size   : size of the blob in bytes
+*
+* Return:
+*  false if the blob is not a valid test vector.
+*
+*******************************************************************************/
+bool doa_vector_open(doa_vector_t *vector, const void *blob, size_t size)
+{
+    const doa_vector_header_t *header = (const doa_vector_header_t*)blob;
+
+    memset(vector, 0, sizeof(*vector));
+
+    if ((NULL == blob) || (0u != ((uintptr_t)blob & 3u)) || (size < sizeof(*header)))
+    {
+        return false;
+    }
+    if ((DOA_VECTOR_MAGIC != header->magic) || (DOA_VECTOR_VERSION != header->version) ||
+        (DOA_VECTOR_FORMAT_Q15 != header->format) ||
+        (0u == header->channels) || (header->channels > DOA_VECTOR_MAX_CHANNELS) ||
+        (!(header->scale > 0.0f)))
+    {
+        return false;
+    }
+    if (((size - sizeof(*header)) / sizeof(int16_t) / header->channels) < header->frames)
+    {
+        return false;
+    }
+
+    vector->header = header;
+    vector->samples = (const int16_t*)(header + 1);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: doa_vector_read
+********************************************************************************
+* Summary:
+*  Converts the next frames to float. The reader stops at the end of the
+*  vector, see doa_vector_rewind().
+*
+* Parameters:
+*  vector     : reader context
+*  out        : receives max_frames * channels interleaved samples
+*  max_frames : capacity of out in frames
+*
+* Return:
+*  Number of frames written, 0 at the end of the vector.
+*
+*******************************************************************************/
+uint32_t doa_vector_read(doa_vector_t *vector, float *out, uint32_t max_frames)
+{
+    uint32_t frames = vector->header->frames - vector->pos;
+    const int16_t *samples;
+    uint32_t count;
+
+    if (frames > max_frames)
+    {
+        frames = max_frames;
+    }
+    samples = &vector->samples[vector->pos * vector->header->channels];
+    count = frames * vector->header->channels;
+
+    doa_vector_to_float(samples, out, count, vector->header->scale);
+    vector->pos += frames;
+
+    return frames;
+}
+
+/*******************************************************************************
+* Function Name: doa_vector_rewind
+*******************************************************************************/
+void doa_vector_rewind(doa_vector_t *vector)
+{
+    vector->pos = 0;
+}
+
+/* [] END OF FILE */
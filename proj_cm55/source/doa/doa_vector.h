@@ -0,0 +1,73 @@
+/******************************************************************************
+* File Name:   doa_vector.h
+*
+* Description: This file contains the blob layout, types and function
+*              prototypes of the DOA test vector reader implemented in
+*              doa_vector.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef DOA_VECTOR_H_
+#define DOA_VECTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DOA_VECTOR_MAGIC                    (0x56414F44u)   /* "DOAV" */
+#define DOA_VECTOR_VERSION                  (1u)
+
+/* Interleaved little endian int16 samples, value = sample * scale */
+#define DOA_VECTOR_FORMAT_Q15               (0u)
+
+#define DOA_VECTOR_MAX_CHANNELS             (8u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Start of the blob, followed by frames * channels samples */
+typedef struct
+{
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    format;
+    uint16_t    channels;
+    uint16_t    reserved;
+    uint32_t    sample_rate;
+    uint32_t    frames;
+    float       scale;          /* Model units per LSB */
+} doa_vector_header_t;
+
+typedef struct
+{
+    const doa_vector_header_t   *header;
+    const int16_t               *samples;
+    uint32_t                    pos;        /* Next frame */
+} doa_vector_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Blob embedded in flash by doa_vector_blob.c */
+extern const uint8_t doa_vector_blob[];
+extern const uint8_t doa_vector_blob_end[];
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool doa_vector_open(doa_vector_t *vector, const void *blob, size_t size);
+uint32_t doa_vector_read(doa_vector_t *vector, float *out, uint32_t max_frames);
+void doa_vector_rewind(doa_vector_t *vector);
+void doa_vector_to_float(const int16_t *samples, float *out, uint32_t count, float scale);
+
+#endif /* DOA_VECTOR_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,41 @@
+/******************************************************************************
+* File Name:   doa_vector_blob.c
+*
+* Description: This file embeds the DOA test vector generated by
+*              doa_vector_gen into read-only data, which the CM55 reads in
+*              place from flash.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include "doa_vector.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Relative to the directory the build runs in */
+#ifndef DOA_VECTOR_PATH
+#define DOA_VECTOR_PATH                     "ready_models/doa_vector.bin"
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+__asm__(
+    "   .section .rodata.doa_vector_blob, \"a\", %progbits\n"
+    "   .balign 4\n"
+    "   .global doa_vector_blob\n"
+    "   .type doa_vector_blob, %object\n"
+    "doa_vector_blob:\n"
+    "   .incbin \"" DOA_VECTOR_PATH "\"\n"
+    "   .global doa_vector_blob_end\n"
+    "doa_vector_blob_end:\n"
+    "   .size doa_vector_blob, doa_vector_blob_end - doa_vector_blob\n"
+    "   .previous\n"
+);
+
+/* [] END OF FILE */
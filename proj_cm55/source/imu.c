@@ -52,19 +52,62 @@
 #endif
 
 #include "ipc_communication.h"
+#include "timebase.h"
+#include "imu/imu_core.h"
 
 /******************************************************************************
  * Macros
  ******************************************************************************/
- /* Required data rate is 50 Hz. So, data sample to be sent once in 20 msec */
- #define IMU_SAMPLES_RATE               20
+/* Required data rate is 50 Hz. The samples are buffered in the BMI270 FIFO
+ * and read in bursts. */
+#define IMU_SAMPLE_RATE_HZ              (50u)
+
+/* Accelerometer frames buffered before the FIFO watermark interrupt */
+#ifndef IMU_FIFO_WATERMARK_FRAMES
+#define IMU_FIFO_WATERMARK_FRAMES       (16u)
+#endif
+
+/* Header and x, y, z of the accelerometer */
+#define IMU_FIFO_ACC_FRAME_BYTES        (1u + IMU_FIFO_AXES_BYTES)
+
+/* Burst read buffer, room for twice the watermark and a few control frames */
+#define IMU_FIFO_READ_BYTES             (2u * IMU_FIFO_WATERMARK_FRAMES * IMU_FIFO_ACC_FRAME_BYTES + 32u)
+#define IMU_FIFO_MAX_SAMPLES            (IMU_FIFO_READ_BYTES / IMU_FIFO_ACC_FRAME_BYTES)
+
+/* The samples are parsed straight into IPC_STREAM_IMU records */
+_Static_assert(sizeof(imu_fifo_sample_t) == IPC_STREAM_IMU_SAMPLE_SIZE, "IMU stream sample layout");
+
+/* The task waits for the watermark interrupt at most one watermark period.
+ * Without IMU_FIFO_INT_PORT it reads the FIFO at this period. */
+#define IMU_FIFO_POLL_MS                ((IMU_FIFO_WATERMARK_FRAMES * 1000u) / IMU_SAMPLE_RATE_HZ)
+
+/* GPIO wired to the BMI270 INT1 pin, signalling the FIFO watermark */
+#if !defined(IMU_FIFO_INT_PORT) && defined(CYBSP_IMU_INT1_PORT)
+#define IMU_FIFO_INT_PORT               CYBSP_IMU_INT1_PORT
+#define IMU_FIFO_INT_PIN                CYBSP_IMU_INT1_PIN
+#define IMU_FIFO_INT_IRQ                CYBSP_IMU_INT1_IRQ
+#endif
+#define IMU_FIFO_INT_PRIORITY           (3U)
+
+/* Accelerometer LSB per g in the 8 g range */
+#define IMU_ACC_LSB_PER_G               (4096.0f)
+
+/* 1: feed the model only while the wearer moves, see imu_gate.c */
+#ifndef IMU_GATE_ENABLE
+#define IMU_GATE_ENABLE                 1
+#endif
+
+/* Interval of the motion gate statistics print, 0 disables it */
+#ifndef IMU_GATE_REPORT_INTERVAL_MS
+#define IMU_GATE_REPORT_INTERVAL_MS     (60000u)
+#endif
+
 /* Task priority and stack size for the Motion sensor task */
 #define TASK_MOTION_SENSOR_PRIORITY     (configMAX_PRIORITIES - 1)
 #define TASK_MOTION_SENSOR_STACK_SIZE   (1024U)
 /* I2C Clock frequency in Hz */
 #define I2C_CLK_FREQ_HZ                 (400000U)
 
-#define DETECTCOUNT                     10
 #define LED_STOP_COUNT                  10000
 
 #define TIMER_INT_PRIORITY              (3U)
@@ -78,72 +121,75 @@
 static mtb_hal_i2c_t CYBSP_I2C_CONTROLLER_hal_obj;
 cy_stc_scb_i2c_context_t CYBSP_I2C_CONTROLLER_context;
 
-volatile long tick1 = 0;
+/* Burst read from the FIFO and the samples parsed from it */
+static uint8_t imu_fifo_buffer[IMU_FIFO_READ_BYTES];
+static imu_fifo_sample_t imu_fifo_samples[IMU_FIFO_MAX_SAMPLES];
+static imu_fifo_parser_t imu_fifo_parser;
+/* Time of the last FIFO read, the capture time of the results of its batch
+ * to within one watermark period */
+static uint32_t imu_fifo_read_time;
+
+#if IMU_GATE_ENABLE
+static imu_gate_t imu_gate;
+#endif
 
-uint8_t send_data = 0;
-uint8_t IMU_FLAG = 0;
+/* LED variables */
+static int led_off = 0;
+static int led_on = 0;
+static unsigned long start_t = 0;
 
 /* Motion sensor task handle */
 static TaskHandle_t motion_sensor_task_handle;
 
 /* Instance of BMI270 sensor structure */
-mtb_bmi270_data_t bmi270_data;
 mtb_bmi270_t bmi270;
 
 static const char* LABELS[IMAI_DATA_OUT_COUNT] = IMAI_SYMBOL_MAP;
 
+static const imu_model_t imu_model =
+{
+    .name = "fall",
+    .class_count = IMAI_DATA_OUT_COUNT,
+    .labels = LABELS,
+    .enqueue = IMAI_FED_enqueue,
+    .dequeue = IMAI_FED_dequeue
+};
+
+/* Smoothing of the model output. A fall is reported once, cleared after
+ * IMU_PP_EXIT_COUNT predictions without it and not reported again for
+ * IMU_PP_COOLDOWN_COUNT predictions (1 s at 50 Hz). */
+#define IMU_PP_EXIT_COUNT               (3u)
+#define IMU_PP_COOLDOWN_COUNT           (50u)
+
+/* Gate, conversion, model and smoothing */
+static imu_core_t imu_core;
+
+/* Model ID in the IPC label table */
+static int imu_model_id;
+
 cy_stc_sysint_t timer_irq_cfg =
 {
     .intrSrc = CYBSP_GENERAL_PURPOSE_TIMER_IRQ,
     .intrPriority = TIMER_INT_PRIORITY
 };
 
+#if defined(IMU_FIFO_INT_PORT)
 /*******************************************************************************
-* Function Name: systick_isr1
+* Function Name: imu_fifo_isr
 ********************************************************************************
-* Summary: This increments every time the SysTick counter decrements to 0.
-*
-* Parameters:
-*   None
-*
-* Return:
-*   None
-*
+* Summary: Called when the FIFO fill level reaches the watermark. Notifies the
+*          motion sensor task.
 *
 *******************************************************************************/
-void systick_isr1(void)
+static void imu_fifo_isr(void)
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    tick1++;
-    send_data++;
-    
-    if (send_data == IMU_SAMPLES_RATE)
-    {
-        send_data = 0;
-        IMU_FLAG = 1;
-    }
-}
 
-/*******************************************************************************
-* Function Name: get_time_from_millisec
-********************************************************************************
-* Summary: This function prints the time when a output class is detected.
-*
-* Parameters:
-*   milliseconds : time when a output class is detected.
-*   timeString   : time of detected class in hr:m:s format.
-*
-* Return:
-*   None
-*
-*
-*******************************************************************************/
-void get_time_from_millisec(unsigned long milliseconds, char* timeString) {
-  unsigned int seconds = (milliseconds / 1000) % 60;
-  unsigned int minutes = (milliseconds / (1000 * 60)) % 60;
-  unsigned int hours = (milliseconds / (1000 * 60 * 60));
-  sprintf(timeString, "%02u:%02u:%02u", hours, minutes, seconds);
+    Cy_GPIO_ClearInterrupt(IMU_FIFO_INT_PORT, IMU_FIFO_INT_PIN);
+    vTaskNotifyGiveFromISR(motion_sensor_task_handle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
+#endif
 
 /*******************************************************************************
  * Function Name: motion_sensor_init
@@ -212,10 +258,10 @@ static cy_rslt_t motion_sensor_init(void)
      mtb_bmi270_sensor_disable(sens_list, 1, &bmi270);
 
     /* Set the output data rate and range of the accelerometer *
-     * Fall detection model requires IMU data at 50 Hz data rate *
-     * IMU data rate = ODR / Sampling average (Bandwidth parameter) */
+     * Fall detection model requires IMU data at 50 Hz data rate, *
+     * every sample at the ODR is stored in the FIFO */
     config.sensor_config.type = BMI2_ACCEL;
-    config.sensor_config.cfg.acc.odr = BMI2_ACC_ODR_100HZ;
+    config.sensor_config.cfg.acc.odr = BMI2_ACC_ODR_50HZ;
     config.sensor_config.cfg.acc.range = BMI2_ACC_RANGE_8G;
     config.sensor_config.cfg.acc.bwp = BMI2_ACC_OSR2_AVG2;
     config.sensor_config.cfg.acc.filter_perf = BMI2_POWER_OPT_MODE;
@@ -237,14 +283,219 @@ static cy_rslt_t motion_sensor_init(void)
         CY_ASSERT(0);
     }
 
-   
-    /*timer set up*/
-    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_IMO , (8000000/1000)-1);
-    Cy_SysTick_SetCallback(0, systick_isr1);        /* point to SysTick ISR to increment the 1ms count */
-    
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: motion_sensor_fifo_init
+ ********************************************************************************
+ * Summary:
+ *  Configures the BMI270 FIFO in header mode with accelerometer frames only
+ *  and the watermark interrupt on INT1. Once full, the FIFO drops the
+ *  oldest frames and reports them with a skip frame.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  result
+ *
+ *******************************************************************************/
+static cy_rslt_t motion_sensor_fifo_init(void)
+{
+    struct bmi2_dev *dev = &bmi270.sensor;
+    struct bmi2_int_pin_config pin_cfg;
+
+    imu_fifo_parser_init(&imu_fifo_parser);
+
+    if ((BMI2_OK != bmi2_set_fifo_config(BMI2_FIFO_ALL_EN, BMI2_DISABLE, dev)) ||
+        (BMI2_OK != bmi2_set_fifo_config(BMI2_FIFO_ACC_EN | BMI2_FIFO_HEADER_EN, BMI2_ENABLE, dev)) ||
+        (BMI2_OK != bmi2_set_fifo_wm(IMU_FIFO_WATERMARK_FRAMES * IMU_FIFO_ACC_FRAME_BYTES, dev)))
+    {
+        printf(" Error : IMU FIFO config failed !!\r\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (BMI2_OK != bmi2_get_int_pin_config(&pin_cfg, dev))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    pin_cfg.pin_type = BMI2_INT1;
+    pin_cfg.pin_cfg[0].output_en = BMI2_INT_OUTPUT_ENABLE;
+    pin_cfg.pin_cfg[0].lvl = BMI2_INT_ACTIVE_HIGH;
+    pin_cfg.pin_cfg[0].od = BMI2_INT_PUSH_PULL;
+    pin_cfg.int_latch = BMI2_INT_NON_LATCH;
+    if ((BMI2_OK != bmi2_set_int_pin_config(&pin_cfg, dev)) ||
+        (BMI2_OK != bmi2_map_data_int(BMI2_FWM_INT, BMI2_INT1, dev)))
+    {
+        printf(" Error : IMU FIFO interrupt config failed !!\r\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+#if defined(IMU_FIFO_INT_PORT)
+    cy_stc_sysint_t fifo_irq_cfg =
+    {
+        .intrSrc = IMU_FIFO_INT_IRQ,
+        .intrPriority = IMU_FIFO_INT_PRIORITY
+    };
+
+    Cy_GPIO_SetInterruptEdge(IMU_FIFO_INT_PORT, IMU_FIFO_INT_PIN, CY_GPIO_INTR_RISING);
+    Cy_GPIO_ClearInterrupt(IMU_FIFO_INT_PORT, IMU_FIFO_INT_PIN);
+    Cy_GPIO_SetInterruptMask(IMU_FIFO_INT_PORT, IMU_FIFO_INT_PIN, 1u);
+    if (CY_SYSINT_SUCCESS != Cy_SysInt_Init(&fifo_irq_cfg, imu_fifo_isr))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    NVIC_ClearPendingIRQ(fifo_irq_cfg.intrSrc);
+    NVIC_EnableIRQ(fifo_irq_cfg.intrSrc);
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: motion_sensor_read_fifo
+ ********************************************************************************
+ * Summary:
+ *  Reads everything buffered in the FIFO in one I2C transaction and parses
+ *  it.
+ *
+ * Parameters:
+ *  samples : receives up to IMU_FIFO_MAX_SAMPLES samples
+ *
+ * Return:
+ *  Number of samples parsed.
+ *
+ *******************************************************************************/
+static uint32_t motion_sensor_read_fifo(imu_fifo_sample_t *samples)
+{
+    struct bmi2_dev *dev = &bmi270.sensor;
+    struct bmi2_fifo_frame fifo = {0};
+    uint16_t length = 0;
+
+    if ((BMI2_OK != bmi2_get_fifo_length(&length, dev)) || (0u == length))
+    {
+        return 0;
+    }
+
+    /* A frame cut off here stays in the FIFO and is read next time */
+    fifo.data = imu_fifo_buffer;
+    fifo.length = (length < IMU_FIFO_READ_BYTES) ? length : IMU_FIFO_READ_BYTES;
+    if (BMI2_OK != bmi2_read_fifo_data(&fifo, dev))
+    {
+        return 0;
+    }
+
+    return imu_fifo_parse(&imu_fifo_parser, imu_fifo_buffer, fifo.length,
+                          samples, IMU_FIFO_MAX_SAMPLES);
+}
+
+/*******************************************************************************
+ * Function Name: imu_event
+ ********************************************************************************
+ * Summary:
+ *  Called by the core when the smoothed state of the model changes. Forwards
+ *  the state to the CM33 and prints falls.
+ *
+ * Parameters:
+ *  event : new state
+ *  ctx   : unused
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void imu_event(const imu_core_event_t *event, void *ctx)
+{
+    int state = event->class_id;
+    uint8_t scores[IPC_MAX_SCORES];
+    uint32_t score_count;
+
+    (void)ctx;
+
+    if (state != 0)
+    {
+        /* New line when LED from off to on */
+        if ((led_off - CYBSP_LED_STATE_ON) > 0)
+        {
+            printf("\r\n");
+        }
+
+        /* Print triggered class and the triggered time since IMAI init.*/
+        unsigned long t = timebase_get_ms() - start_t;
+        char timeString[TIMEBASE_HMS_SIZE];
+        timebase_format_hms(t, timeString, sizeof(timeString));
+        printf("%s %s\r\n", event->label, timeString);
+
+        // Do not control the LED:
+        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
+        led_off = 0;
+        led_on = timebase_get_ms();
+    }
+    else
+    {
+        /* Turn off LED after the LED is on for 10 secs */
+        if((timebase_get_ms() - led_on) > LED_STOP_COUNT)
+        {
+            // Do not control the LED:
+            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
+        }
+        led_off = 1;
+    }
+
+    score_count = postprocess_get_scores(&imu_core.pp, scores, IPC_MAX_SCORES);
+    cm55_ipc_send_result((uint32_t)imu_model_id, (uint32_t)state, scores, score_count,
+                         imu_fifo_read_time, (uint32_t)timebase_get_us());
+}
+
+/*******************************************************************************
+ * Function Name: imu_model_status
+ ********************************************************************************
+ * Summary:
+ *  Called by the core when the model stops returning results.
+ *
+ *******************************************************************************/
+static void imu_model_status(int status, void *ctx)
+{
+    (void)ctx;
+
+    if (IMAI_RET_TIMEDOUT == status)
+    {
+        printf("The evaluation period has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n");
+    }
+}
+
+#if IMU_GATE_ENABLE && (IMU_GATE_REPORT_INTERVAL_MS > 0)
+/*******************************************************************************
+ * Function Name: imu_gate_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the share of samples the motion gate withheld from the model every
+ *  IMU_GATE_REPORT_INTERVAL_MS.
+ *
+ *******************************************************************************/
+static void imu_gate_report(void)
+{
+    static uint32_t last_report = 0;
+    uint32_t now = timebase_get_ms();
+    imu_gate_stats_t stats;
+    imu_core_stats_t core_stats;
+
+    if ((now - last_report) < IMU_GATE_REPORT_INTERVAL_MS)
+    {
+        return;
+    }
+    last_report = now;
+
+    imu_gate_get_stats(&imu_gate, &stats);
+    imu_core_get_stats(&imu_core, &core_stats);
+    printf("imu: gate skipped %lu of %lu samples (%lu%% model duty cycle), %lu opens, %lu pre-roll samples\r\n",
+           (unsigned long)stats.gated_samples, (unsigned long)stats.samples,
+           (unsigned long)((0u == core_stats.samples) ? 0u : ((uint64_t)core_stats.fed * 100u) / core_stats.samples),
+           (unsigned long)stats.opens, (unsigned long)stats.preroll_samples);
+}
+#endif
+
 /*******************************************************************************
  * Function Name: task_motion
  ********************************************************************************
@@ -262,15 +513,37 @@ static cy_rslt_t motion_sensor_init(void)
 static void task_motion(void* pvParameters)
 {
     cy_rslt_t result;
-    /* LED variables */
-    static int led_off = 0;
-    static int led_on = 0;
-    
-    int label_scores[IMAI_DATA_OUT_COUNT];
-    static int prediction_count = 0;
+
+    imu_core_cfg_t core_cfg =
+    {
+        .model = &imu_model,
+        .lsb_per_g = IMU_ACC_LSB_PER_G,
+        .gate = NULL,
+        .exit_count = IMU_PP_EXIT_COUNT,
+        .cooldown_count = IMU_PP_COOLDOWN_COUNT,
+        .event_cb = imu_event,
+        .status_cb = imu_model_status,
+        .cb_ctx = NULL
+    };
 
     /* Initialize DEEPCRAFT pre-processing library */
     IMAI_FED_init();
+#if IMU_GATE_ENABLE
+    (void)imu_gate_init(&imu_gate, NULL);
+    core_cfg.gate = &imu_gate;
+#endif
+    if (!imu_core_init(&imu_core, &core_cfg))
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Publish the class names once, the results only carry the IDs */
+    imu_model_id = cm55_ipc_add_model(imu_model.name, imu_model.labels, imu_model.class_count);
+    if (imu_model_id < 0)
+    {
+        CY_ASSERT(0);
+    }
+    cm55_ipc_publish_labels();
 
     /* Initialize BMI270 motion sensor and suspend the task upon failure */
     result = motion_sensor_init();
@@ -278,106 +551,47 @@ static void task_motion(void* pvParameters)
     {
         CY_ASSERT(0);
     }
+    result = motion_sensor_fifo_init();
+    if(CY_RSLT_SUCCESS != result)
+    {
+        CY_ASSERT(0);
+    }
 
-    unsigned long start_t = tick1;
+    start_t = timebase_get_ms();
 
     for(;;)
     {
-        while (IMU_FLAG == 0)
+        /* Sleep until the FIFO reaches the watermark, or for one watermark
+         * period if the interrupt is not wired */
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_FIFO_POLL_MS));
+
+        /* Read the whole FIFO in one transaction and feed it as a batch. The
+         * samples are parsed straight into a bulk stream record when the IMU
+         * samples are streamed. */
+        imu_fifo_read_time = (uint32_t)timebase_get_us();
+        imu_fifo_sample_t *samples = (imu_fifo_sample_t *)cm55_ipc_stream_reserve(IPC_STREAM_IMU,
+                                                                                  (uint32_t)imu_model_id,
+                                                                                  sizeof(imu_fifo_samples));
+        bool samples_streamed = (NULL != samples);
+        if (!samples_streamed)
         {
-            
+            samples = imu_fifo_samples;
         }
-        
-        IMU_FLAG = 0;
-        /* Get IMU data */        
-        /* Read x, y, z components of acceleration */
-        result =  mtb_bmi270_read(&bmi270, &bmi270_data);
-        if (CY_RSLT_SUCCESS != result)
+        uint32_t count = motion_sensor_read_fifo(samples);
+        if (samples_streamed && (0u != count))
         {
-             CY_ASSERT(0);
+            cm55_ipc_stream_commit(count * sizeof(imu_fifo_sample_t));
         }
+        imu_core_process(&imu_core, samples, count);
 
-        if ((result == BMI2_OK) && (bmi270_data.sensor_data.status & BMI2_DRDY_ACC))
-        {
-            float data_in[IMAI_DATA_IN_COUNT] =
-            {
-                (float) (bmi270_data.sensor_data.acc.y / 4096.0f),
-                (float) (bmi270_data.sensor_data.acc.x / 4096.0f),
-                (float) (-bmi270_data.sensor_data.acc.z / 4096.0f),
-            };
-
-            /* pass IMU data to model's enqueue function */
-            result = IMAI_FED_enqueue(data_in);
-
-            /* Check model predictions using dequeue function */
-            switch(IMAI_FED_dequeue(label_scores))
-            {
-                case IMAI_RET_SUCCESS:
-                    ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-
-                    static int16_t success_flag = 1;
-                    prediction_count += 1;
-                    if (label_scores[1] == 1)
-                    {
-                        payload->label_id = 1;
-                        strcpy(payload->label, LABELS[1]);
-
-                        /* New line when LED from off to on */
-                        if ((led_off - CYBSP_LED_STATE_ON) > 0)
-                        {
-                            printf("\r\n");
-                        }
-
-                        /* Print triggered class and the triggered time since IMAI init.*/
-                        unsigned long t = tick1 - start_t;
-                        char timeString[9];
-                        get_time_from_millisec(t, timeString);
-                        printf("%s %s\r\n",LABELS[1],timeString);                        
-
-                        // Do not control the LED:
-                        // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
-                        led_off = 0;
-                        led_on = tick1;
-                    }
-                    else
-                    {
-                        payload->label_id = 0;
-                        strcpy(payload->label, LABELS[0]);
-
-                        /* Only print non-label class very 10 predictions */
-                        if (prediction_count>DETECTCOUNT)
-                        {
-                            // printf(".");
-                            // fflush( stdout );
-                            prediction_count = 0;
-                        }
-
-
-                                                
-                        /* Turn off LED after the LED is on for 10 secs */
-                        if((tick1 - led_on) > LED_STOP_COUNT)
-                        {
-                            // Do not control the LED:
-                            // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_OFF);
-                        }
-                        led_off = 1;
-                    }
-
-                    cm55_ipc_send_to_cm33();
-                    
-                    break;
-
-                case IMAI_RET_TIMEDOUT:
-                    if (success_flag == 1)
-                    {
-                        printf("The evaluation period has ended. Please rerun the evaluation or purchase a license for the ready model.\r\n");
-                    }
-                    success_flag = 0;
-                    break;
-            }
-        }
+        /* Parameters only change between two batches */
+        cm55_ipc_poll_control();
+#if IMU_GATE_ENABLE && (IMU_GATE_REPORT_INTERVAL_MS > 0)
+        imu_gate_report();
+#endif
     }
 }
+
 /*******************************************************************************
  * Function Name: create_motion_sensor_task
  ********************************************************************************
@@ -0,0 +1,125 @@
+/******************************************************************************
+* File Name:   imai_fed_mock.c
+*
+* Description: This file implements a host stand-in for the IMAI queue API
+*              of the fall detection Ready Model library, which is only
+*              available for the CM55. It flags a fall when an impact
+*              follows a free fall within half a second. The detections are
+*              not meaningful, the mock exercises the pipeline with the
+*              queue behaviour and class layout of the real library.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <string.h>
+#include "fall_lib.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Magnitude in g below which the wearer is in free fall */
+#ifndef IMAI_MOCK_FREE_FALL_G
+#define IMAI_MOCK_FREE_FALL_G               (0.5f)
+#endif
+
+/* Magnitude in g of an impact */
+#ifndef IMAI_MOCK_IMPACT_G
+#define IMAI_MOCK_IMPACT_G                  (2.0f)
+#endif
+
+/* Free fall samples needed, and samples an impact may follow them, at 50 Hz */
+#define IMAI_MOCK_FREE_FALL_SAMPLES         (4u)
+#define IMAI_MOCK_IMPACT_WINDOW             (25u)
+
+/* Results the library holds before enqueue returns IMAI_RET_NOMEM */
+#define IMAI_MOCK_QUEUE_DEPTH               (4u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t mock_free_fall;
+static uint32_t mock_window;
+static int mock_queue[IMAI_MOCK_QUEUE_DEPTH];
+static uint32_t mock_head;
+static uint32_t mock_count;
+
+/*******************************************************************************
+* Function Name: IMAI_FED_init
+*******************************************************************************/
+void IMAI_FED_init(void)
+{
+    mock_free_fall = 0;
+    mock_window = 0;
+    mock_head = 0;
+    mock_count = 0;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_FED_enqueue
+********************************************************************************
+* Summary:
+*  Takes one sample in g and queues one result per sample.
+*
+*******************************************************************************/
+int IMAI_FED_enqueue(const float *restrict data_in)
+{
+    float magnitude;
+    int fall = 0;
+
+    if (IMAI_MOCK_QUEUE_DEPTH == mock_count)
+    {
+        return IMAI_RET_NOMEM;
+    }
+
+    magnitude = sqrtf((data_in[0] * data_in[0]) + (data_in[1] * data_in[1]) + (data_in[2] * data_in[2]));
+    if (magnitude < IMAI_MOCK_FREE_FALL_G)
+    {
+        if (++mock_free_fall >= IMAI_MOCK_FREE_FALL_SAMPLES)
+        {
+            mock_window = IMAI_MOCK_IMPACT_WINDOW;
+        }
+    }
+    else
+    {
+        mock_free_fall = 0;
+        if ((mock_window > 0u) && (magnitude > IMAI_MOCK_IMPACT_G))
+        {
+            fall = 1;
+            mock_window = 0;
+        }
+        else if (mock_window > 0u)
+        {
+            mock_window--;
+        }
+    }
+
+    mock_queue[(mock_head + mock_count) % IMAI_MOCK_QUEUE_DEPTH] = fall;
+    mock_count++;
+
+    return IMAI_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: IMAI_FED_dequeue
+*******************************************************************************/
+int IMAI_FED_dequeue(int *restrict data_out)
+{
+    if (0u == mock_count)
+    {
+        return IMAI_RET_NODATA;
+    }
+
+    memset(data_out, 0, IMAI_DATA_OUT_COUNT * sizeof(int));
+    data_out[IMAI_DATA_OUT_COUNT - 1] = mock_queue[mock_head];
+    mock_head = (mock_head + 1u) % IMAI_MOCK_QUEUE_DEPTH;
+    mock_count--;
+
+    return IMAI_RET_SUCCESS;
+}
+
+/* [] END OF FILE */
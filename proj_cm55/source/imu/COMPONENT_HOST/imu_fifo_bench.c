@@ -0,0 +1,407 @@
+/******************************************************************************
+* File Name:   imu_fifo_bench.c
+*
+* Description: This file implements a host check and benchmark of the BMI270
+*              FIFO parser and of the batched model feed. A synthetic FIFO
+*              byte stream with accelerometer, gyroscope, auxiliary, skip,
+*              sensortime and input configuration frames is read back in
+*              bursts of random size, some of them ending in the middle of a
+*              frame, which the sensor returns again on the next read. Every
+*              parsed sample is compared with the generated one and the
+*              samples are fed to a stub model that reports NOMEM when its
+*              result queue is full.
+*
+*              Usage: imu_fifo_bench [--frames N] [--seed N]
+*
+*              The exit code is 1 if a sample or a statistic does not match.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "imu_fifo.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define BENCH_DEFAULT_FRAMES                (200000u)
+#define BENCH_MAX_READ_FRAMES               (40u)
+
+/* Same burst size as task_motion with a 16 frame watermark */
+#define BENCH_READ_BYTES                    (2u * 16u * 7u + 32u)
+#define BENCH_MAX_SAMPLES                   (BENCH_READ_BYTES / 7u)
+
+/* Stub model: one result every BENCH_MODEL_HOP samples, at most
+ * BENCH_MODEL_QUEUE results held */
+#define BENCH_MODEL_HOP                     (10u)
+#define BENCH_MODEL_QUEUE                   (2u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    uint32_t    offset;         /* Position in the stream */
+    uint8_t     bytes;
+} bench_frame_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t rng_state;
+
+static uint8_t *stream;
+static bench_frame_t *frame_table;
+static imu_fifo_sample_t *expected;
+static uint32_t expected_count;
+static uint32_t expected_skipped;
+static uint32_t expected_configs;
+static uint32_t expected_sensortime;
+
+static uint32_t model_enqueued;
+static uint32_t model_pending;
+static uint32_t model_queued;
+static uint32_t model_results;
+static uint32_t model_nomem;
+static uint32_t model_next;
+static bool model_ok = true;
+
+/*******************************************************************************
+* Function Name: bench_rand
+*******************************************************************************/
+static uint32_t bench_rand(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+/*******************************************************************************
+* Function Name: bench_put_axes
+*******************************************************************************/
+static uint8_t* bench_put_axes(uint8_t *out, int16_t *axes)
+{
+    for (uint32_t i = 0; i < 3u; i++)
+    {
+        axes[i] = (int16_t)bench_rand();
+        *out++ = (uint8_t)((uint16_t)axes[i] & 0xFFu);
+        *out++ = (uint8_t)((uint16_t)axes[i] >> 8);
+    }
+    return out;
+}
+
+/*******************************************************************************
+* Function Name: bench_generate
+********************************************************************************
+* Summary:
+*  Writes one random frame and records the expected parser output.
+*
+* Return:
+*  Size of the frame.
+*
+*******************************************************************************/
+static uint32_t bench_generate(uint8_t *out)
+{
+    uint8_t *start = out;
+    uint32_t kind = bench_rand() % 100u;
+
+    if (kind < 94u)
+    {
+        imu_fifo_sample_t sample = { .flags = 0u };
+        uint8_t header = IMU_FIFO_HEADER_REGULAR | (uint8_t)(bench_rand() & 0x03u);
+
+        if (kind < 86u)
+        {
+            header |= IMU_FIFO_HEADER_ACC;
+        }
+        else if (kind < 90u)
+        {
+            header |= IMU_FIFO_HEADER_ACC | IMU_FIFO_HEADER_GYR;
+        }
+        else if (kind < 92u)
+        {
+            header |= IMU_FIFO_HEADER_GYR;
+        }
+        else
+        {
+            header |= IMU_FIFO_HEADER_ACC | IMU_FIFO_HEADER_AUX;
+        }
+
+        *out++ = header;
+        if (0u != (header & IMU_FIFO_HEADER_AUX))
+        {
+            for (uint32_t i = 0; i < IMU_FIFO_AUX_BYTES; i++)
+            {
+                *out++ = (uint8_t)bench_rand();
+            }
+        }
+        if (0u != (header & IMU_FIFO_HEADER_GYR))
+        {
+            out = bench_put_axes(out, sample.gyr);
+            sample.flags |= IMU_FIFO_SAMPLE_GYR;
+        }
+        if (0u != (header & IMU_FIFO_HEADER_ACC))
+        {
+            out = bench_put_axes(out, sample.acc);
+            sample.flags |= IMU_FIFO_SAMPLE_ACC;
+        }
+        expected[expected_count++] = sample;
+    }
+    else if (kind < 96u)
+    {
+        uint8_t dropped = (uint8_t)(1u + bench_rand() % 20u);
+
+        *out++ = IMU_FIFO_HEADER_SKIP;
+        *out++ = dropped;
+        expected_skipped += dropped;
+    }
+    else if (kind < 99u)
+    {
+        expected_sensortime = bench_rand() & 0xFFFFFFu;
+        *out++ = IMU_FIFO_HEADER_SENSORTIME;
+        *out++ = (uint8_t)expected_sensortime;
+        *out++ = (uint8_t)(expected_sensortime >> 8);
+        *out++ = (uint8_t)(expected_sensortime >> 16);
+    }
+    else
+    {
+        *out++ = IMU_FIFO_HEADER_INPUT_CONFIG;
+        for (uint32_t i = 0; i < IMU_FIFO_INPUT_CONFIG_BYTES; i++)
+        {
+            *out++ = (uint8_t)bench_rand();
+        }
+        expected_configs++;
+    }
+
+    return (uint32_t)(out - start);
+}
+
+/*******************************************************************************
+* Function Name: bench_model_enqueue
+*******************************************************************************/
+static int bench_model_enqueue(const float *data_in)
+{
+    const imu_fifo_sample_t *s;
+
+    if (((model_pending + 1u) == BENCH_MODEL_HOP) && (BENCH_MODEL_QUEUE == model_queued))
+    {
+        model_nomem++;
+        return IMU_MODEL_RET_NOMEM;
+    }
+
+    /* Samples without accelerometer data are not fed */
+    while ((model_next < expected_count) && (0u == (expected[model_next].flags & IMU_FIFO_SAMPLE_ACC)))
+    {
+        model_next++;
+    }
+    s = &expected[model_next++];
+    if ((data_in[0] != (float)s->acc[1]) || (data_in[1] != (float)s->acc[0]) ||
+        (data_in[2] != (float)(-s->acc[2])))
+    {
+        model_ok = false;
+    }
+
+    model_enqueued++;
+    if (++model_pending == BENCH_MODEL_HOP)
+    {
+        model_pending = 0;
+        model_queued++;
+    }
+
+    return IMU_MODEL_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: bench_model_dequeue
+*******************************************************************************/
+static int bench_model_dequeue(int *data_out)
+{
+    if (0u == model_queued)
+    {
+        return IMU_MODEL_RET_NODATA;
+    }
+    model_queued--;
+    data_out[0] = 1;
+    data_out[1] = 0;
+
+    return IMU_MODEL_RET_SUCCESS;
+}
+
+/*******************************************************************************
+* Function Name: bench_model_result
+*******************************************************************************/
+static void bench_model_result(int status, const int *data_out, void *ctx)
+{
+    (void)data_out;
+    (void)ctx;
+
+    if (IMU_MODEL_RET_SUCCESS == status)
+    {
+        model_results++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_elapsed_us
+*******************************************************************************/
+static double bench_elapsed_us(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e6 + (double)(now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+    static uint8_t burst[BENCH_READ_BYTES + 2u];
+    static imu_fifo_sample_t samples[BENCH_MAX_SAMPLES];
+    imu_fifo_parser_t parser;
+    imu_fifo_sink_t sink =
+    {
+        .enqueue = bench_model_enqueue,
+        .dequeue = bench_model_dequeue,
+        .result_cb = bench_model_result,
+        .ctx = NULL,
+        .scale = 1.0f
+    };
+    uint32_t frames = BENCH_DEFAULT_FRAMES;
+    uint32_t stream_bytes = 0;
+    uint32_t parsed = 0;
+    uint32_t mismatches = 0;
+    uint32_t expected_partial = 0;
+    uint32_t acc_samples = 0;
+    uint32_t reads = 0;
+    uint32_t frame = 0;
+    double parse_us = 0.0;
+    struct timespec start;
+
+    rng_state = 1u;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--frames")) && ((i + 1) < argc))
+        {
+            frames = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--seed")) && ((i + 1) < argc))
+        {
+            rng_state = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    stream = malloc((size_t)frames * IMU_FIFO_MAX_FRAME_BYTES);
+    frame_table = malloc((size_t)frames * sizeof(bench_frame_t));
+    expected = malloc((size_t)frames * sizeof(imu_fifo_sample_t));
+    if ((NULL == stream) || (NULL == frame_table) || (NULL == expected))
+    {
+        return 2;
+    }
+
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        frame_table[f].offset = stream_bytes;
+        frame_table[f].bytes = (uint8_t)bench_generate(&stream[stream_bytes]);
+        stream_bytes += frame_table[f].bytes;
+    }
+    for (uint32_t s = 0; s < expected_count; s++)
+    {
+        acc_samples += (0u != (expected[s].flags & IMU_FIFO_SAMPLE_ACC)) ? 1u : 0u;
+    }
+
+    imu_fifo_parser_init(&parser);
+    while (frame < frames)
+    {
+        uint32_t want = 1u + bench_rand() % BENCH_MAX_READ_FRAMES;
+        uint32_t length = 0;
+        uint32_t next = frame;
+        bool cut = (0u == (bench_rand() % 8u));
+
+        /* Whole frames up to the burst size */
+        while ((next < frames) && ((next - frame) < want) &&
+               ((length + frame_table[next].bytes) <= BENCH_READ_BYTES))
+        {
+            length += frame_table[next].bytes;
+            next++;
+        }
+        memcpy(burst, &stream[frame_table[frame].offset], length);
+
+        if (cut && (next < frames) && (frame_table[next].bytes > 1u) &&
+            ((length + frame_table[next].bytes) <= BENCH_READ_BYTES))
+        {
+            /* Part of the next frame, read again with the next burst */
+            uint32_t part = 1u + bench_rand() % (frame_table[next].bytes - 1u);
+
+            memcpy(&burst[length], &stream[frame_table[next].offset], part);
+            length += part;
+            expected_partial++;
+        }
+        else if (next == frames)
+        {
+            /* FIFO drained, the sensor returns the over-read pattern */
+            burst[length++] = 0x80u;
+            burst[length++] = 0x00u;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        uint32_t count = imu_fifo_parse(&parser, burst, length, samples, BENCH_MAX_SAMPLES);
+        parse_us += bench_elapsed_us(&start);
+
+        for (uint32_t s = 0; s < count; s++)
+        {
+            const imu_fifo_sample_t *e = &expected[parsed + s];
+
+            if ((parsed + s >= expected_count) || (e->flags != samples[s].flags) ||
+                ((0u != (e->flags & IMU_FIFO_SAMPLE_ACC)) && (0 != memcmp(e->acc, samples[s].acc, sizeof(e->acc)))) ||
+                ((0u != (e->flags & IMU_FIFO_SAMPLE_GYR)) && (0 != memcmp(e->gyr, samples[s].gyr, sizeof(e->gyr)))))
+            {
+                mismatches++;
+            }
+        }
+        parsed += count;
+        (void)imu_fifo_feed(&sink, samples, count);
+
+        frame = next;
+        reads++;
+    }
+
+    bool pass = (0u == mismatches) && (parsed == expected_count) && model_ok &&
+                (model_enqueued == acc_samples) && (model_results == (acc_samples / BENCH_MODEL_HOP)) &&
+                (parser.stats.skipped == expected_skipped) && (parser.stats.config_changes == expected_configs) &&
+                (parser.stats.partial == expected_partial) && (parser.sensortime == expected_sensortime) &&
+                (0u == parser.stats.invalid) && (0u == parser.stats.overflow);
+
+    printf("%u frames, %u bytes in %u reads, %u samples (%u accelerometer), %u mismatches\n",
+           (unsigned)frames, (unsigned)stream_bytes, (unsigned)reads, (unsigned)parsed,
+           (unsigned)acc_samples, (unsigned)mismatches);
+    printf("skipped %u/%u, config %u/%u, partial %u/%u, invalid %u, overflow %u\n",
+           (unsigned)parser.stats.skipped, (unsigned)expected_skipped,
+           (unsigned)parser.stats.config_changes, (unsigned)expected_configs,
+           (unsigned)parser.stats.partial, (unsigned)expected_partial,
+           (unsigned)parser.stats.invalid, (unsigned)parser.stats.overflow);
+    printf("model: %u enqueued, %u results, %u NOMEM retries\n",
+           (unsigned)model_enqueued, (unsigned)model_results, (unsigned)model_nomem);
+    printf("parse: %.1f MB/s, %.0f samples/s\n", (double)parser.stats.bytes / parse_us,
+           (double)parsed * 1e6 / parse_us);
+    printf("%s\n", pass ? "PASS" : "FAIL");
+
+    free(stream);
+    free(frame_table);
+    free(expected);
+
+    return pass ? 0 : 1;
+}
+
+/* [] END OF FILE */
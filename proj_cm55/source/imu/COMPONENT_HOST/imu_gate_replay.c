@@ -0,0 +1,161 @@
+/******************************************************************************
+* File Name:   imu_gate_replay.c
+*
+* Description: This file implements a host replay of labelled accelerometer
+*              traces through the motion gate. It reports how many samples
+*              the gate withholds from the fall detection model and checks
+*              that every labelled fall reaches the model together with the
+*              rest before it.
+*
+*              Usage: imu_gate_replay <trace.csv> <labels.csv>
+*                                     [--context S] [--coverage S]
+*
+*              See imu_trace.c for the file formats. The exit code is 1 if
+*              a fall was missed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "imu_gate.h"
+#include "imu_trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same rate and range as the motion task */
+#define REPLAY_SAMPLE_RATE_HZ               (50.0)
+#define REPLAY_LSB_PER_G                    (4096.0f)
+
+/* Seconds before the start of a fall which must reach the model */
+#define REPLAY_DEFAULT_CONTEXT_S            (1.0)
+
+/* Seconds from the start of a fall which must reach the model */
+#define REPLAY_DEFAULT_COVERAGE_S           (1.0)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static imu_trace_event_t events[IMU_TRACE_MAX_EVENTS];
+static imu_fifo_sample_t out[1u + IMU_GATE_MAX_PREROLL];
+
+/*******************************************************************************
+* Function Name: replay_index
+*******************************************************************************/
+static uint32_t replay_index(double t_s, uint32_t count)
+{
+    double index = t_s * REPLAY_SAMPLE_RATE_HZ;
+
+    if (index < 0.0)
+    {
+        return 0;
+    }
+    return ((uint32_t)index < count) ? (uint32_t)index : count;
+}
+
+int main(int argc, char *argv[])
+{
+    imu_trace_t trace;
+    imu_gate_t gate;
+    imu_gate_stats_t stats;
+    double context_s = REPLAY_DEFAULT_CONTEXT_S;
+    double coverage_s = REPLAY_DEFAULT_COVERAGE_S;
+    uint8_t *fed;
+    uint32_t event_count;
+    uint32_t fed_samples = 0;
+    uint32_t missed = 0;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <trace.csv> <labels.csv> [--context S] [--coverage S]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 3; (i + 1) < argc; i += 2)
+    {
+        if (0 == strcmp(argv[i], "--context"))
+        {
+            context_s = atof(argv[i + 1]);
+        }
+        else if (0 == strcmp(argv[i], "--coverage"))
+        {
+            coverage_s = atof(argv[i + 1]);
+        }
+    }
+
+    if (!imu_trace_load(&trace, argv[1], REPLAY_LSB_PER_G))
+    {
+        fprintf(stderr, "%s: cannot read the trace\n", argv[1]);
+        return 2;
+    }
+    event_count = imu_trace_load_events(argv[2], events, IMU_TRACE_MAX_EVENTS);
+
+    fed = calloc((trace.count > 0u) ? trace.count : 1u, 1u);
+    if ((NULL == fed) || !imu_gate_init(&gate, NULL))
+    {
+        return 2;
+    }
+
+    /* One sample at a time, the gate decides per sample whatever the batch */
+    for (uint32_t i = 0; i < trace.count; i++)
+    {
+        uint32_t count = imu_gate_process(&gate, &trace.samples[i], 1u, out);
+        bool open = imu_gate_is_open(&gate);
+        uint32_t replayed = count - (open ? 1u : 0u);
+
+        /* Pre-roll samples are the ones right before the current sample */
+        for (uint32_t r = 1; (r <= replayed) && (r <= i); r++)
+        {
+            fed[i - r] = 1u;
+        }
+        fed[i] = open ? 1u : 0u;
+        fed_samples += count;
+    }
+
+    for (uint32_t e = 0; e < event_count; e++)
+    {
+        double end_s = events[e].end_s;
+        uint32_t first;
+        uint32_t last;
+        bool passed = true;
+
+        if ((events[e].start_s + coverage_s) < end_s)
+        {
+            end_s = events[e].start_s + coverage_s;
+        }
+        first = replay_index(events[e].start_s - context_s, trace.count);
+        last = replay_index(end_s, trace.count);
+
+        for (uint32_t i = first; (i <= last) && (i < trace.count); i++)
+        {
+            passed = passed && (0u != fed[i]);
+        }
+        if (!passed)
+        {
+            missed++;
+            printf("missed %s event at %.2f s\n", ('\0' != events[e].label[0]) ? events[e].label : "fall", events[e].start_s);
+        }
+    }
+
+    imu_gate_get_stats(&gate, &stats);
+    printf("%s: %u samples, %u gated (%.1f s), %u opens, %u pre-roll samples\n", argv[1],
+           (unsigned)stats.samples, (unsigned)stats.gated_samples,
+           (double)stats.gated_samples / REPLAY_SAMPLE_RATE_HZ,
+           (unsigned)stats.opens, (unsigned)stats.preroll_samples);
+    printf("model duty cycle %.1f%% (%u of %u samples fed)\n",
+           (0u == stats.samples) ? 0.0 : (100.0 * fed_samples) / stats.samples,
+           (unsigned)fed_samples, (unsigned)stats.samples);
+    printf("%u of %u events reached the model\n", (unsigned)(event_count - missed), (unsigned)event_count);
+
+    free(fed);
+    imu_trace_free(&trace);
+
+    return (0u == missed) ? 0 : 1;
+}
+
+/* [] END OF FILE */
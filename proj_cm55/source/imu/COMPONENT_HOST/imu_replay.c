@@ -0,0 +1,386 @@
+/******************************************************************************
+* File Name:   imu_replay.c
+*
+* Description: This file implements a host replay of accelerometer traces
+*              through the fall detection pipeline of the motion task
+*              (imu_core.c). The samples are fed in FIFO sized batches, as
+*              fast as possible or paced at 50 Hz with --realtime. The tool
+*              prints every detection with its time in the trace, the
+*              model results per second and the cost per sample. With a
+*              labels file the detections are matched against the labelled
+*              falls.
+*
+*              Usage: imu_replay <trace> [--labels labels.csv] [--gate]
+*                                [--realtime] [--batch N] [--tolerance S]
+*                                [--events out.csv]
+*
+*              See imu_trace.c for the file formats. The exit code is 1 if
+*              a labelled fall was not detected or if the initial state of
+*              the model, which the CM33 waits for at startup, was not
+*              reported.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fall_lib.h"
+#include "imu_core.h"
+#include "imu_trace.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define REPLAY_CYCLE_UNIT                   "TSC cycles"
+#else
+#define REPLAY_CYCLE_UNIT                   "ns"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Same rate, range, batch and smoothing as the motion task */
+#define REPLAY_SAMPLE_RATE_HZ               (50u)
+#define REPLAY_LSB_PER_G                    (4096.0f)
+#define REPLAY_DEFAULT_BATCH                (16u)
+#define REPLAY_EXIT_COUNT                   (3u)
+#define REPLAY_COOLDOWN_COUNT               (50u)
+
+/* Seconds a detection may fall outside of the labelled fall */
+#define REPLAY_DEFAULT_TOLERANCE_S          (1.0)
+
+#define REPLAY_MAX_DETECTIONS               (4096u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    const char  *path;
+    FILE        *events;
+    double      detections[REPLAY_MAX_DETECTIONS];
+    uint32_t    detection_count;
+} replay_ctx_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const replay_labels[IMAI_DATA_OUT_COUNT] = IMAI_SYMBOL_MAP;
+
+static const imu_model_t replay_model =
+{
+    .name = "fall",
+    .class_count = IMAI_DATA_OUT_COUNT,
+    .labels = replay_labels,
+    .enqueue = IMAI_FED_enqueue,
+    .dequeue = IMAI_FED_dequeue
+};
+
+static replay_ctx_t replay;
+static imu_core_t core;
+static imu_gate_t gate;
+static imu_trace_event_t labels[IMU_TRACE_MAX_EVENTS];
+
+/*******************************************************************************
+* Function Name: replay_cycles
+********************************************************************************
+* Summary:
+*  Host stand-in for the DWT cycle counter.
+*
+*******************************************************************************/
+static uint32_t replay_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: replay_now_s
+*******************************************************************************/
+static double replay_now_s(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*******************************************************************************
+* Function Name: replay_sleep_until
+*******************************************************************************/
+static void replay_sleep_until(double t_s)
+{
+    double wait_s = t_s - replay_now_s();
+
+    if (wait_s > 0.0)
+    {
+        struct timespec delay =
+        {
+            .tv_sec = (time_t)wait_s,
+            .tv_nsec = (long)((wait_s - (double)(time_t)wait_s) * 1e9)
+        };
+        nanosleep(&delay, NULL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_event
+********************************************************************************
+* Summary:
+*  Prints a detection with the time of the last sample fed before it.
+*
+*******************************************************************************/
+static void replay_event(const imu_core_event_t *event, void *ctx)
+{
+    replay_ctx_t *r = (replay_ctx_t*)ctx;
+    double time_s = (double)event->sample / REPLAY_SAMPLE_RATE_HZ;
+
+    if (0 == event->class_id)
+    {
+        return;
+    }
+
+    printf("%9.3f s  %s\n", time_s, event->label);
+    if (NULL != r->events)
+    {
+        fprintf(r->events, "%s,%.3f,%s\n", r->path, time_s, event->label);
+    }
+    if (r->detection_count < REPLAY_MAX_DETECTIONS)
+    {
+        r->detections[r->detection_count++] = time_s;
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_status
+*******************************************************************************/
+static void replay_status(int status, void *ctx)
+{
+    (void)ctx;
+    fprintf(stderr, "%s model returned %d\n", replay_model.name, status);
+}
+
+/*******************************************************************************
+* Function Name: replay_match
+********************************************************************************
+* Summary:
+*  Matches the detections against the labelled falls and prints the misses.
+*
+* Return:
+*  Number of labelled falls without a detection.
+*
+*******************************************************************************/
+static uint32_t replay_match(uint32_t label_count, double tolerance_s)
+{
+    uint32_t missed = 0;
+    uint32_t false_alarms = 0;
+    double delay_sum = 0.0;
+
+    for (uint32_t l = 0; l < label_count; l++)
+    {
+        bool found = false;
+
+        for (uint32_t d = 0; (d < replay.detection_count) && !found; d++)
+        {
+            double t = replay.detections[d];
+
+            if ((t >= (labels[l].start_s - tolerance_s)) && (t <= (labels[l].end_s + tolerance_s)))
+            {
+                found = true;
+                delay_sum += t - labels[l].start_s;
+            }
+        }
+        if (!found)
+        {
+            missed++;
+            printf("missed %s at %.2f s\n", ('\0' != labels[l].label[0]) ? labels[l].label : "fall", labels[l].start_s);
+        }
+    }
+
+    for (uint32_t d = 0; d < replay.detection_count; d++)
+    {
+        bool labelled = false;
+
+        for (uint32_t l = 0; (l < label_count) && !labelled; l++)
+        {
+            labelled = (replay.detections[d] >= (labels[l].start_s - tolerance_s)) &&
+                       (replay.detections[d] <= (labels[l].end_s + tolerance_s));
+        }
+        false_alarms += labelled ? 0u : 1u;
+    }
+
+    printf("%u of %u falls detected, %u false alarms, %.2f s average delay from the fall start\n",
+           (unsigned)(label_count - missed), (unsigned)label_count, (unsigned)false_alarms,
+           (label_count == missed) ? 0.0 : delay_sum / (label_count - missed));
+
+    return missed;
+}
+
+int main(int argc, char *argv[])
+{
+    imu_trace_t trace;
+    imu_core_stats_t stats;
+    const char *labels_path = NULL;
+    const char *events_path = NULL;
+    bool use_gate = false;
+    bool realtime = false;
+    uint32_t batch = REPLAY_DEFAULT_BATCH;
+    double tolerance_s = REPLAY_DEFAULT_TOLERANCE_S;
+    uint32_t label_count = 0;
+    uint64_t cycles_sum = 0;
+    uint32_t batch_cycles_max = 0;
+    double start_s;
+    double elapsed_s;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--labels")) && ((i + 1) < argc))
+        {
+            labels_path = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "--gate"))
+        {
+            use_gate = true;
+        }
+        else if (0 == strcmp(argv[i], "--realtime"))
+        {
+            realtime = true;
+        }
+        else if ((0 == strcmp(argv[i], "--batch")) && ((i + 1) < argc))
+        {
+            batch = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--tolerance")) && ((i + 1) < argc))
+        {
+            tolerance_s = atof(argv[++i]);
+        }
+        else if ((0 == strcmp(argv[i], "--events")) && ((i + 1) < argc))
+        {
+            events_path = argv[++i];
+        }
+    }
+
+    if ((argc < 2) || (0u == batch))
+    {
+        fprintf(stderr, "usage: %s <trace> [--labels labels.csv] [--gate] [--realtime] [--batch N] "
+                "[--tolerance S] [--events out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    if (!imu_trace_load(&trace, argv[1], REPLAY_LSB_PER_G))
+    {
+        fprintf(stderr, "%s: cannot read the trace\n", argv[1]);
+        return 2;
+    }
+    if (NULL != labels_path)
+    {
+        label_count = imu_trace_load_events(labels_path, labels, IMU_TRACE_MAX_EVENTS);
+    }
+
+    replay.path = argv[1];
+    if (NULL != events_path)
+    {
+        replay.events = fopen(events_path, "w");
+        if (NULL == replay.events)
+        {
+            fprintf(stderr, "%s: cannot create\n", events_path);
+            return 1;
+        }
+        fprintf(replay.events, "file,time_s,label\n");
+    }
+
+    imu_core_cfg_t cfg =
+    {
+        .model = &replay_model,
+        .lsb_per_g = REPLAY_LSB_PER_G,
+        .gate = NULL,
+        .exit_count = REPLAY_EXIT_COUNT,
+        .cooldown_count = REPLAY_COOLDOWN_COUNT,
+        .event_cb = replay_event,
+        .status_cb = replay_status,
+        .cb_ctx = &replay
+    };
+
+    IMAI_FED_init();
+    if (use_gate)
+    {
+        (void)imu_gate_init(&gate, NULL);
+        cfg.gate = &gate;
+    }
+    if (!imu_core_init(&core, &cfg))
+    {
+        fprintf(stderr, "unable to initialize the IMU core\n");
+        return 2;
+    }
+
+    printf("%s:\n", argv[1]);
+    start_s = replay_now_s();
+    for (uint32_t pos = 0; pos < trace.count; pos += batch)
+    {
+        uint32_t count = ((trace.count - pos) < batch) ? (trace.count - pos) : batch;
+        uint32_t cycles;
+
+        if (realtime)
+        {
+            /* The batch is complete once its last sample was measured */
+            replay_sleep_until(start_s + (double)(pos + count) / REPLAY_SAMPLE_RATE_HZ);
+        }
+
+        cycles = replay_cycles();
+        imu_core_process(&core, &trace.samples[pos], count);
+        cycles = replay_cycles() - cycles;
+
+        cycles_sum += cycles;
+        if (cycles > batch_cycles_max)
+        {
+            batch_cycles_max = cycles;
+        }
+    }
+    elapsed_s = replay_now_s() - start_s;
+
+    imu_core_get_stats(&core, &stats);
+    printf("%u samples (%.1f s) in %.3f s, %u model results (%.0f results/s), %u samples fed\n",
+           (unsigned)stats.samples, (double)stats.samples / REPLAY_SAMPLE_RATE_HZ, elapsed_s,
+           (unsigned)stats.results, (elapsed_s > 0.0) ? stats.results / elapsed_s : 0.0,
+           (unsigned)stats.fed);
+    printf("%.1f %s/sample avg, %u max per batch of %u\n",
+           (0u == stats.samples) ? 0.0 : (double)cycles_sum / stats.samples, REPLAY_CYCLE_UNIT,
+           (unsigned)batch_cycles_max, (unsigned)batch);
+    if (use_gate)
+    {
+        imu_gate_stats_t gate_stats;
+        imu_gate_get_stats(&gate, &gate_stats);
+        printf("gate skipped %u of %u samples, %u opens\n", (unsigned)gate_stats.gated_samples,
+               (unsigned)gate_stats.samples, (unsigned)gate_stats.opens);
+    }
+    printf("%s: %u detections\n", replay_labels[IMAI_DATA_OUT_COUNT - 1], (unsigned)stats.detections[IMAI_DATA_OUT_COUNT - 1]);
+    if (0u == stats.events)
+    {
+        printf("the initial state was not reported\n");
+    }
+
+    uint32_t missed = (NULL != labels_path) ? replay_match(label_count, tolerance_s) : 0u;
+
+    if (NULL != replay.events)
+    {
+        fclose(replay.events);
+    }
+    imu_trace_free(&trace);
+
+    return ((0u == missed) && (0u != stats.events)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
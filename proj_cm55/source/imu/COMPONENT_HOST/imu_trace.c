@@ -0,0 +1,214 @@
+/******************************************************************************
+* File Name:   imu_trace.c
+*
+* Description: This file implements the reader of the accelerometer traces
+*              and label files used by the IMU host tools.
+*
+*              A trace is a CSV file with one "x,y,z" sample in g per line,
+*              in the sensor axes and at the 50 Hz of the motion task. A
+*              leading time column, "t,x,y,z", is accepted and ignored.
+*              Lines that do not start with a number, such as a header, are
+*              skipped. The samples are converted to raw LSB like the FIFO
+*              delivers them.
+*
+*              A file ending in ".bin" holds raw samples instead, x, y and z
+*              as little endian 16-bit LSB, e.g. a capture of the FIFO
+*              samples on the target.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "imu_trace.h"
+
+/*******************************************************************************
+* Function Name: imu_trace_raw
+*******************************************************************************/
+static int16_t imu_trace_raw(double g, float lsb_per_g)
+{
+    double raw = round(g * lsb_per_g);
+
+    if (raw > 32767.0)
+    {
+        return 32767;
+    }
+    if (raw < -32768.0)
+    {
+        return -32768;
+    }
+    return (int16_t)raw;
+}
+
+/*******************************************************************************
+* Function Name: imu_trace_append
+********************************************************************************
+* Summary:
+*  Returns the next free sample, growing the trace as needed. NULL when out
+*  of memory, the samples are released then.
+*
+*******************************************************************************/
+static imu_fifo_sample_t* imu_trace_append(imu_trace_t *trace, uint32_t *capacity)
+{
+    imu_fifo_sample_t *s;
+
+    if (trace->count == *capacity)
+    {
+        *capacity *= 2u;
+        s = realloc(trace->samples, *capacity * sizeof(imu_fifo_sample_t));
+        if (NULL == s)
+        {
+            free(trace->samples);
+            trace->samples = NULL;
+            return NULL;
+        }
+        trace->samples = s;
+    }
+
+    s = &trace->samples[trace->count++];
+    memset(s, 0, sizeof(*s));
+    s->flags = IMU_FIFO_SAMPLE_ACC;
+
+    return s;
+}
+
+/*******************************************************************************
+* Function Name: imu_trace_load_bin
+*******************************************************************************/
+static void imu_trace_load_bin(imu_trace_t *trace, FILE *file, uint32_t *capacity)
+{
+    uint8_t raw[6];
+
+    while (1u == fread(raw, sizeof(raw), 1u, file))
+    {
+        imu_fifo_sample_t *s = imu_trace_append(trace, capacity);
+
+        if (NULL == s)
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < 3u; i++)
+        {
+            s->acc[i] = (int16_t)((uint16_t)raw[2u * i] | ((uint16_t)raw[2u * i + 1u] << 8));
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_trace_load
+********************************************************************************
+* Summary:
+*  Reads a whole trace into memory.
+*
+* Parameters:
+*  trace     : receives the samples, release with imu_trace_free()
+*  path      : CSV or ".bin" file
+*  lsb_per_g : raw LSB per g of the simulated sensor range, CSV only
+*
+* Return:
+*  false if the file cannot be read.
+*
+*******************************************************************************/
+bool imu_trace_load(imu_trace_t *trace, const char *path, float lsb_per_g)
+{
+    char line[256];
+    uint32_t capacity = 4096u;
+    size_t length = strlen(path);
+    bool binary = (length > 4u) && (0 == strcmp(&path[length - 4u], ".bin"));
+    FILE *file = fopen(path, binary ? "rb" : "r");
+
+    memset(trace, 0, sizeof(*trace));
+    if (NULL == file)
+    {
+        return false;
+    }
+    trace->samples = malloc(capacity * sizeof(imu_fifo_sample_t));
+
+    if (binary && (NULL != trace->samples))
+    {
+        imu_trace_load_bin(trace, file, &capacity);
+    }
+
+    while (!binary && (NULL != trace->samples) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        double v[4];
+        int fields = sscanf(line, "%lf,%lf,%lf,%lf", &v[0], &v[1], &v[2], &v[3]);
+        const double *acc = (4 == fields) ? &v[1] : &v[0];
+        imu_fifo_sample_t *s;
+
+        if (fields < 3)
+        {
+            continue;
+        }
+        s = imu_trace_append(trace, &capacity);
+        if (NULL == s)
+        {
+            break;
+        }
+        for (uint32_t i = 0; i < 3u; i++)
+        {
+            s->acc[i] = imu_trace_raw(acc[i], lsb_per_g);
+        }
+    }
+    fclose(file);
+
+    return NULL != trace->samples;
+}
+
+/*******************************************************************************
+* Function Name: imu_trace_free
+*******************************************************************************/
+void imu_trace_free(imu_trace_t *trace)
+{
+    free(trace->samples);
+    memset(trace, 0, sizeof(*trace));
+}
+
+/*******************************************************************************
+* Function Name: imu_trace_load_events
+********************************************************************************
+* Summary:
+*  Reads a label file with one "start_s,end_s[,label]" event per line. Lines
+*  starting with '#' are ignored.
+*
+* Return:
+*  Number of events read, 0 if the file cannot be read.
+*
+*******************************************************************************/
+uint32_t imu_trace_load_events(const char *path, imu_trace_event_t *events, uint32_t max_events)
+{
+    char line[256];
+    uint32_t count = 0;
+    FILE *file = fopen(path, "r");
+
+    if (NULL == file)
+    {
+        return 0;
+    }
+
+    while ((count < max_events) && (NULL != fgets(line, sizeof(line), file)))
+    {
+        imu_trace_event_t *e = &events[count];
+
+        if ('#' == line[0])
+        {
+            continue;
+        }
+        e->label[0] = '\0';
+        if (sscanf(line, "%lf,%lf,%31[^\r\n]", &e->start_s, &e->end_s, e->label) >= 2)
+        {
+            count++;
+        }
+    }
+    fclose(file);
+
+    return count;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,52 @@
+/******************************************************************************
+* File Name:   imu_trace.h
+*
+* Description: This file contains the types and function prototypes of the
+*              accelerometer trace and label file reader implemented in
+*              imu_trace.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IMU_TRACE_H_
+#define IMU_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "imu_fifo.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define IMU_TRACE_MAX_EVENTS                (1024u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    imu_fifo_sample_t   *samples;       /* Raw sensor axes, as read from the FIFO */
+    uint32_t            count;
+} imu_trace_t;
+
+typedef struct
+{
+    double      start_s;
+    double      end_s;
+    char        label[32];
+} imu_trace_event_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool imu_trace_load(imu_trace_t *trace, const char *path, float lsb_per_g);
+void imu_trace_free(imu_trace_t *trace);
+uint32_t imu_trace_load_events(const char *path, imu_trace_event_t *events, uint32_t max_events);
+
+#endif /* IMU_TRACE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,213 @@
+/******************************************************************************
+* File Name:   imu_core.c
+*
+* Description: This file implements the fall detection pipeline shared by the
+*              motion task and the host replay: the motion gate, the
+*              conversion and axis remapping of the accelerometer samples,
+*              feeding the model and smoothing its results. It has no
+*              hardware dependencies, the caller forwards the reported
+*              events.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "imu_core.h"
+
+/*******************************************************************************
+* Function Name: imu_core_handle_result
+********************************************************************************
+* Summary:
+*  Smooths one model result and reports changes of the smoothed state.
+*
+*******************************************************************************/
+static void imu_core_handle_result(imu_core_t *core, const int *flags)
+{
+    const imu_model_t *model = core->cfg.model;
+    imu_core_event_t event;
+    int state;
+
+    if (!postprocess_update(&core->pp, postprocess_flags_to_class(flags, model->class_count), &state))
+    {
+        return;
+    }
+
+    if (state != POSTPROCESS_BACKGROUND_CLASS)
+    {
+        core->stats.detections[state]++;
+    }
+    core->stats.events++;
+
+    event.class_id = state;
+    event.label = model->labels[state];
+    event.sample = core->stats.samples;
+    core->cfg.event_cb(&event, core->cfg.cb_ctx);
+}
+
+/*******************************************************************************
+* Function Name: imu_core_result
+********************************************************************************
+* Summary:
+*  Called by imu_fifo_feed() for every dequeue of the model.
+*
+*******************************************************************************/
+static void imu_core_result(int status, const int *data_out, void *ctx)
+{
+    imu_core_t *core = (imu_core_t*)ctx;
+
+    switch (status)
+    {
+        case IMU_MODEL_RET_SUCCESS:
+            core->success = true;
+            core->stats.results++;
+            imu_core_handle_result(core, data_out);
+            break;
+        case IMU_MODEL_RET_TIMEDOUT:
+            if (core->success && (NULL != core->cfg.status_cb))
+            {
+                core->cfg.status_cb(status, core->cfg.cb_ctx);
+            }
+            core->success = false;
+            break;
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_core_gate_closed
+********************************************************************************
+* Summary:
+*  The model gets no more samples once the gate closes. Feeds background
+*  results so a reported fall ends before the wearer rests, and the initial
+*  background state is reported if the model never returned a result.
+*
+*******************************************************************************/
+static void imu_core_gate_closed(imu_core_t *core)
+{
+    static const int background[IMU_FIFO_MAX_CLASSES] = {0};
+
+    for (uint32_t i = 0; i < core->cfg.exit_count; i++)
+    {
+        imu_core_handle_result(core, background);
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_core_init
+********************************************************************************
+* Summary:
+*  Initializes the smoothing of the model. A fall is reported once, ends
+*  after cfg.exit_count results without it and is not reported again for
+*  cfg.cooldown_count results.
+*
+* Parameters:
+*  core : core context
+*  cfg  : configuration, copied. The model and gate must stay valid.
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool imu_core_init(imu_core_t *core, const imu_core_cfg_t *cfg)
+{
+    if ((NULL == cfg->model) || (cfg->model->class_count > IMU_FIFO_MAX_CLASSES) ||
+        (cfg->lsb_per_g <= 0.0f) || (NULL == cfg->event_cb))
+    {
+        return false;
+    }
+
+    memset(core, 0, sizeof(*core));
+    core->cfg = *cfg;
+
+    core->sink.enqueue = cfg->model->enqueue;
+    core->sink.dequeue = cfg->model->dequeue;
+    core->sink.result_cb = imu_core_result;
+    core->sink.ctx = core;
+    core->sink.scale = 1.0f / cfg->lsb_per_g;
+
+    core->pp_classes[0].vote_k = 1u;
+    for (uint32_t c = 1; c < cfg->model->class_count; c++)
+    {
+        core->pp_classes[c].vote_k = 1u;
+        core->pp_classes[c].enter_count = 1u;
+        core->pp_classes[c].exit_count = cfg->exit_count;
+        core->pp_classes[c].cooldown_count = cfg->cooldown_count;
+    }
+    core->pp_cfg.window = 1u;
+    core->pp_cfg.class_count = cfg->model->class_count;
+    core->pp_cfg.classes = core->pp_classes;
+    if (!postprocess_init(&core->pp, &core->pp_cfg))
+    {
+        return false;
+    }
+
+    /* The first time out is reported even without a result before it */
+    core->success = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: imu_core_process
+********************************************************************************
+* Summary:
+*  Runs a batch of FIFO samples through the pipeline. Events are reported
+*  through cfg.event_cb before the function returns.
+*
+* Parameters:
+*  core    : core context
+*  samples : parsed FIFO samples, samples without accelerometer data are skipped
+*  count   : number of samples
+*
+*******************************************************************************/
+void imu_core_process(imu_core_t *core, const imu_fifo_sample_t *samples, uint32_t count)
+{
+    imu_gate_t *gate = core->cfg.gate;
+
+    while (count > 0u)
+    {
+        uint32_t batch = (count < IMU_CORE_MAX_BATCH) ? count : IMU_CORE_MAX_BATCH;
+        const imu_fifo_sample_t *feed = samples;
+        uint32_t feed_count = batch;
+        bool was_open = false;
+
+        /* Results of the batch are stamped with its last sample */
+        for (uint32_t i = 0; i < batch; i++)
+        {
+            core->stats.samples += (0u != (samples[i].flags & IMU_FIFO_SAMPLE_ACC)) ? 1u : 0u;
+        }
+
+        if (NULL != gate)
+        {
+            was_open = imu_gate_is_open(gate);
+            feed_count = imu_gate_process(gate, samples, batch, core->gated);
+            feed = core->gated;
+        }
+
+        core->stats.fed += imu_fifo_feed(&core->sink, feed, feed_count);
+
+        /* A gate closed from the start never lets the model report the initial state */
+        if ((NULL != gate) && !imu_gate_is_open(gate) && (was_open || (0u == core->stats.events)))
+        {
+            imu_core_gate_closed(core);
+        }
+
+        samples += batch;
+        count -= batch;
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_core_get_stats
+*******************************************************************************/
+void imu_core_get_stats(const imu_core_t *core, imu_core_stats_t *stats)
+{
+    *stats = core->stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name:   imu_core.h
+*
+* Description: This file contains the types and function prototypes of the
+*              fall detection pipeline implemented in imu_core.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IMU_CORE_H_
+#define IMU_CORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "postprocess.h"
+#include "imu_fifo.h"
+#include "imu_gate.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Samples passed through the gate at once, longer batches are split */
+#define IMU_CORE_MAX_BATCH                  (64u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Model fed with the remapped accelerometer samples, IMAI queue API */
+typedef struct
+{
+    const char          *name;
+    uint8_t             class_count;    /* Including the background class 0, up to IMU_FIFO_MAX_CLASSES */
+    const char *const   *labels;
+    int                 (*enqueue)(const float *data_in);
+    int                 (*dequeue)(int *data_out);
+} imu_model_t;
+
+/* Change of the smoothed state of the model */
+typedef struct
+{
+    int         class_id;       /* 0 when the event ended */
+    const char  *label;
+    uint32_t    sample;         /* Samples presented before the result, the time in sample periods */
+} imu_core_event_t;
+
+typedef void (*imu_core_event_cb_t)(const imu_core_event_t *event, void *ctx);
+
+/* Invoked when the model times out, i.e. at the end of the evaluation period */
+typedef void (*imu_core_status_cb_t)(int status, void *ctx);
+
+typedef struct
+{
+    const imu_model_t       *model;
+    float                   lsb_per_g;      /* Raw accelerometer LSB per g */
+    imu_gate_t              *gate;          /* Initialized gate, NULL feeds every sample */
+    uint8_t                 exit_count;     /* Results without a fall to end the event */
+    uint16_t                cooldown_count; /* Results before a fall is reported again */
+    imu_core_event_cb_t     event_cb;
+    imu_core_status_cb_t    status_cb;      /* May be NULL */
+    void                    *cb_ctx;
+} imu_core_cfg_t;
+
+typedef struct
+{
+    uint32_t    samples;        /* Accelerometer samples presented */
+    uint32_t    fed;            /* Samples enqueued, including the gate pre-roll */
+    uint32_t    results;        /* Successful model dequeues */
+    uint32_t    events;         /* Smoothed state changes reported */
+    uint32_t    detections[IMU_FIFO_MAX_CLASSES];
+} imu_core_stats_t;
+
+typedef struct
+{
+    imu_core_cfg_t          cfg;
+    imu_fifo_sink_t         sink;
+    postprocess_class_cfg_t pp_classes[IMU_FIFO_MAX_CLASSES];
+    postprocess_cfg_t       pp_cfg;
+    postprocess_ctx_t       pp;
+    bool                    success;
+    imu_core_stats_t        stats;
+    imu_fifo_sample_t       gated[IMU_CORE_MAX_BATCH + IMU_GATE_MAX_PREROLL];
+} imu_core_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool imu_core_init(imu_core_t *core, const imu_core_cfg_t *cfg);
+void imu_core_process(imu_core_t *core, const imu_fifo_sample_t *samples, uint32_t count);
+void imu_core_get_stats(const imu_core_t *core, imu_core_stats_t *stats);
+
+#endif /* IMU_CORE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/******************************************************************************
+* File Name:   imu_fifo.c
+*
+* Description: This file implements the parser of the BMI270 FIFO in header
+*              mode and the batched feed of the parsed samples to the model.
+*              A whole FIFO burst is read in one I2C transaction and handed
+*              to the parser, which has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "imu_fifo.h"
+
+/*******************************************************************************
+* Function Name: imu_fifo_axes
+********************************************************************************
+* Summary:
+*  Reads three little endian 16-bit values.
+*
+*******************************************************************************/
+static void imu_fifo_axes(const uint8_t *data, int16_t *axes)
+{
+    for (uint32_t i = 0; i < 3u; i++)
+    {
+        axes[i] = (int16_t)((uint16_t)data[2u * i] | ((uint16_t)data[2u * i + 1u] << 8));
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_fifo_frame_bytes
+********************************************************************************
+* Summary:
+*  Returns the size of the frame starting with header, 0 for an unknown
+*  header.
+*
+*******************************************************************************/
+static uint32_t imu_fifo_frame_bytes(uint8_t header)
+{
+    uint32_t bytes = 1u;
+
+    if (IMU_FIFO_HEADER_REGULAR == (header & 0xC0u))
+    {
+        bytes += (0u != (header & IMU_FIFO_HEADER_AUX)) ? IMU_FIFO_AUX_BYTES : 0u;
+        bytes += (0u != (header & IMU_FIFO_HEADER_GYR)) ? IMU_FIFO_AXES_BYTES : 0u;
+        bytes += (0u != (header & IMU_FIFO_HEADER_ACC)) ? IMU_FIFO_AXES_BYTES : 0u;
+        return bytes;
+    }
+
+    switch (header)
+    {
+        case IMU_FIFO_HEADER_SKIP:
+            return bytes + IMU_FIFO_SKIP_BYTES;
+        case IMU_FIFO_HEADER_SENSORTIME:
+            return bytes + IMU_FIFO_SENSORTIME_BYTES;
+        case IMU_FIFO_HEADER_INPUT_CONFIG:
+            return bytes + IMU_FIFO_INPUT_CONFIG_BYTES;
+        default:
+            return 0u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_fifo_parser_init
+*******************************************************************************/
+void imu_fifo_parser_init(imu_fifo_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+}
+
+/*******************************************************************************
+* Function Name: imu_fifo_parse
+********************************************************************************
+* Summary:
+*  Parses one FIFO read. The sensor keeps a frame that was not read
+*  completely and returns it again on the next read, so an incomplete frame
+*  at the end is only counted. Parsing stops at the over-read pattern
+*  returned once the FIFO is empty.
+*
+* Parameters:
+*  parser      : parser context
+*  data        : bytes read from the FIFO data register
+*  length      : number of bytes
+*  samples     : receives the accelerometer and gyroscope samples
+*  max_samples : capacity of samples, further samples are counted as overflow
+*
+* Return:
+*  Number of samples written.
+*
+*******************************************************************************/
+uint32_t imu_fifo_parse(imu_fifo_parser_t *parser, const uint8_t *data, uint32_t length,
+                        imu_fifo_sample_t *samples, uint32_t max_samples)
+{
+    uint32_t count = 0;
+    uint32_t pos = 0;
+
+    parser->stats.bytes += length;
+
+    while (pos < length)
+    {
+        uint8_t header = data[pos] & IMU_FIFO_HEADER_TAG_MASK;
+        uint32_t bytes = imu_fifo_frame_bytes(header);
+        const uint8_t *payload = &data[pos + 1u];
+
+        if (IMU_FIFO_HEADER_REGULAR == header)
+        {
+            /* Over-read, no more frames */
+            break;
+        }
+        if (0u == bytes)
+        {
+            parser->stats.invalid++;
+            break;
+        }
+        if ((pos + bytes) > length)
+        {
+            parser->stats.partial++;
+            break;
+        }
+
+        if (IMU_FIFO_HEADER_REGULAR == (header & 0xC0u))
+        {
+            imu_fifo_sample_t sample = { .flags = 0u };
+
+            parser->stats.frames++;
+            if (0u != (header & IMU_FIFO_HEADER_AUX))
+            {
+                payload += IMU_FIFO_AUX_BYTES;
+            }
+            if (0u != (header & IMU_FIFO_HEADER_GYR))
+            {
+                imu_fifo_axes(payload, sample.gyr);
+                sample.flags |= IMU_FIFO_SAMPLE_GYR;
+                payload += IMU_FIFO_AXES_BYTES;
+            }
+            if (0u != (header & IMU_FIFO_HEADER_ACC))
+            {
+                imu_fifo_axes(payload, sample.acc);
+                sample.flags |= IMU_FIFO_SAMPLE_ACC;
+            }
+
+            if (0u != sample.flags)
+            {
+                if (count < max_samples)
+                {
+                    samples[count++] = sample;
+                    parser->stats.samples++;
+                }
+                else
+                {
+                    parser->stats.overflow++;
+                }
+            }
+        }
+        else if (IMU_FIFO_HEADER_SKIP == header)
+        {
+            parser->stats.skipped += payload[0];
+        }
+        else if (IMU_FIFO_HEADER_SENSORTIME == header)
+        {
+            parser->sensortime = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) | ((uint32_t)payload[2] << 16);
+        }
+        else
+        {
+            parser->stats.config_changes++;
+        }
+
+        pos += bytes;
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: imu_fifo_drain
+********************************************************************************
+* Summary:
+*  Dequeues the model results until it has no more data.
+*
+*******************************************************************************/
+static void imu_fifo_drain(const imu_fifo_sink_t *sink)
+{
+    int data_out[IMU_FIFO_MAX_CLASSES];
+    int status;
+
+    while (IMU_MODEL_RET_NODATA != (status = sink->dequeue(data_out)))
+    {
+        sink->result_cb(status, data_out, sink->ctx);
+        if (IMU_MODEL_RET_SUCCESS != status)
+        {
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_fifo_feed
+********************************************************************************
+* Summary:
+*  Enqueues a batch of samples and reports the model results. The axes are
+*  remapped to the orientation the fall detection model was trained with:
+*  model x is sensor y, model y is sensor x, model z is -z.
+*
+* Parameters:
+*  sink    : model and result callback
+*  samples : parsed FIFO samples, samples without accelerometer data are skipped
+*  count   : number of samples
+*
+* Return:
+*  Number of samples enqueued.
+*
+*******************************************************************************/
+uint32_t imu_fifo_feed(const imu_fifo_sink_t *sink, const imu_fifo_sample_t *samples, uint32_t count)
+{
+    uint32_t enqueued = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const imu_fifo_sample_t *s = &samples[i];
+
+        if (0u == (s->flags & IMU_FIFO_SAMPLE_ACC))
+        {
+            continue;
+        }
+
+        float data_in[3] =
+        {
+            (float)s->acc[1] * sink->scale,
+            (float)s->acc[0] * sink->scale,
+            (float)(-s->acc[2]) * sink->scale,
+        };
+
+        if (IMU_MODEL_RET_NOMEM == sink->enqueue(data_in))
+        {
+            /* The model queue is full, make room and try again */
+            imu_fifo_drain(sink);
+            (void)sink->enqueue(data_in);
+        }
+        enqueued++;
+    }
+    imu_fifo_drain(sink);
+
+    return enqueued;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   imu_fifo.h
+*
+* Description: This file contains the types and function prototypes of the
+*              BMI270 FIFO parser and of the batched model feed implemented
+*              in imu_fifo.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IMU_FIFO_H_
+#define IMU_FIFO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* FIFO headers in header mode, the two interrupt tag bits masked out */
+#define IMU_FIFO_HEADER_TAG_MASK            (0xFCu)
+#define IMU_FIFO_HEADER_REGULAR             (0x80u)     /* Followed by the enabled sensors, see below */
+#define IMU_FIFO_HEADER_AUX                 (0x10u)
+#define IMU_FIFO_HEADER_GYR                 (0x08u)
+#define IMU_FIFO_HEADER_ACC                 (0x04u)
+#define IMU_FIFO_HEADER_SKIP                (0x40u)     /* Frames dropped on FIFO overflow */
+#define IMU_FIFO_HEADER_SENSORTIME          (0x44u)
+#define IMU_FIFO_HEADER_INPUT_CONFIG        (0x48u)
+
+/* Payload bytes of the frames */
+#define IMU_FIFO_AUX_BYTES                  (8u)
+#define IMU_FIFO_AXES_BYTES                 (6u)
+#define IMU_FIFO_SKIP_BYTES                 (1u)
+#define IMU_FIFO_SENSORTIME_BYTES           (3u)
+#define IMU_FIFO_INPUT_CONFIG_BYTES         (4u)
+
+/* Largest frame: header, aux, gyr and acc */
+#define IMU_FIFO_MAX_FRAME_BYTES            (1u + IMU_FIFO_AUX_BYTES + 2u * IMU_FIFO_AXES_BYTES)
+
+/* Return codes of the model functions, identical to the IMAI_RET_* values */
+#define IMU_MODEL_RET_SUCCESS               (0)
+#define IMU_MODEL_RET_NODATA                (-1)
+#define IMU_MODEL_RET_NOMEM                 (-2)
+#define IMU_MODEL_RET_TIMEDOUT              (-3)
+
+#define IMU_FIFO_MAX_CLASSES                (8u)
+
+/* imu_fifo_sample_t flags */
+#define IMU_FIFO_SAMPLE_ACC                 (0x01u)
+#define IMU_FIFO_SAMPLE_GYR                 (0x02u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    int16_t     acc[3];         /* Raw x, y, z, valid with IMU_FIFO_SAMPLE_ACC */
+    int16_t     gyr[3];         /* Raw x, y, z, valid with IMU_FIFO_SAMPLE_GYR */
+    uint8_t     flags;
+} imu_fifo_sample_t;
+
+typedef struct
+{
+    uint32_t    bytes;          /* Bytes presented to the parser */
+    uint32_t    frames;         /* Regular frames */
+    uint32_t    samples;        /* Samples returned */
+    uint32_t    skipped;        /* Frames the sensor dropped, from skip frames */
+    uint32_t    config_changes; /* Input configuration frames */
+    uint32_t    partial;        /* Incomplete frames at the end of a read */
+    uint32_t    invalid;        /* Unknown headers, the rest of the read is dropped */
+    uint32_t    overflow;       /* Samples not returned as the output was full */
+} imu_fifo_stats_t;
+
+typedef struct
+{
+    uint32_t            sensortime;     /* Last sensortime frame, 24-bit */
+    imu_fifo_stats_t    stats;
+} imu_fifo_parser_t;
+
+/* Model fed by imu_fifo_feed(), identical to the IMAI queue API */
+typedef struct
+{
+    int     (*enqueue)(const float *data_in);
+    int     (*dequeue)(int *data_out);    /* Up to IMU_FIFO_MAX_CLASSES flags */
+    void    (*result_cb)(int status, const int *data_out, void *ctx);  /* Every dequeue except NODATA */
+    void    *ctx;
+    float   scale;                      /* Raw accelerometer LSB to model units */
+} imu_fifo_sink_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void imu_fifo_parser_init(imu_fifo_parser_t *parser);
+uint32_t imu_fifo_parse(imu_fifo_parser_t *parser, const uint8_t *data, uint32_t length,
+                        imu_fifo_sample_t *samples, uint32_t max_samples);
+uint32_t imu_fifo_feed(const imu_fifo_sink_t *sink, const imu_fifo_sample_t *samples, uint32_t count);
+
+#endif /* IMU_FIFO_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,227 @@
+/******************************************************************************
+* File Name:   imu_gate.c
+*
+* Description: This file implements the motion gate of the fall detection
+*              model. The model is only fed while the accelerometer
+*              magnitude moves away from gravity or varies, so a wearer at
+*              rest costs no inferences. The last samples before the gate
+*              opens are kept and replayed, so the model sees the onset of a
+*              fall together with the rest before it.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <math.h>
+#include <string.h>
+#include "imu_gate.h"
+
+/*******************************************************************************
+* Function Name: imu_gate_store_preroll
+*******************************************************************************/
+static void imu_gate_store_preroll(imu_gate_t *gate, const imu_fifo_sample_t *sample)
+{
+    uint16_t samples = gate->cfg.preroll_samples;
+
+    if (0u == samples)
+    {
+        return;
+    }
+
+    gate->preroll[gate->preroll_pos] = *sample;
+    gate->preroll_pos = (uint16_t)((gate->preroll_pos + 1u) % samples);
+    if (gate->preroll_len < samples)
+    {
+        gate->preroll_len++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_replay_preroll
+*******************************************************************************/
+static uint32_t imu_gate_replay_preroll(imu_gate_t *gate, imu_fifo_sample_t *out)
+{
+    uint16_t samples = gate->cfg.preroll_samples;
+    uint32_t count = gate->preroll_len;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        out[i] = gate->preroll[(gate->preroll_pos + samples - count + i) % samples];
+    }
+    gate->stats.preroll_samples += count;
+    gate->preroll_len = 0;
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_default_config
+********************************************************************************
+* Summary:
+*  Returns conservative defaults for 50 Hz in the 8 g range: the gate opens
+*  0.1 g away from gravity, keeps 2 s of pre-roll and stays open for 3 s,
+*  also after init.
+*
+*******************************************************************************/
+void imu_gate_default_config(imu_gate_cfg_t *cfg)
+{
+    cfg->lsb_per_g = 4096.0f;
+    cfg->delta_g = 0.1f;
+    cfg->std_g = 0.03f;
+    cfg->alpha = 0.04f;
+    cfg->hold_samples = 150u;
+    cfg->preroll_samples = 100u;
+    cfg->warmup_samples = 150u;
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_init
+********************************************************************************
+* Summary:
+*  Initializes the gate. It is open for the first cfg.warmup_samples samples
+*  so the model runs until it reports its first result, also on a board at
+*  rest, and closed afterwards until motion.
+*
+* Parameters:
+*  gate : gate context
+*  cfg  : configuration, NULL for imu_gate_default_config()
+*
+* Return:
+*  false if the configuration is invalid.
+*
+*******************************************************************************/
+bool imu_gate_init(imu_gate_t *gate, const imu_gate_cfg_t *cfg)
+{
+    memset(gate, 0, sizeof(*gate));
+
+    if (NULL != cfg)
+    {
+        gate->cfg = *cfg;
+    }
+    else
+    {
+        imu_gate_default_config(&gate->cfg);
+    }
+
+    gate->warmup = gate->cfg.warmup_samples;
+    gate->open = (gate->warmup > 0u);
+
+    return (gate->cfg.lsb_per_g > 0.0f) && (gate->cfg.preroll_samples <= IMU_GATE_MAX_PREROLL);
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_process
+********************************************************************************
+* Summary:
+*  Scores a batch of samples and copies the ones the model has to see to out.
+*  When the gate opens the pre-roll is copied before the sample that opened
+*  it. Samples without accelerometer data are dropped.
+*
+* Parameters:
+*  gate    : gate context
+*  samples : parsed FIFO samples
+*  count   : number of samples
+*  out     : receives up to count + cfg.preroll_samples samples
+*
+* Return:
+*  Number of samples written to out.
+*
+*******************************************************************************/
+uint32_t imu_gate_process(imu_gate_t *gate, const imu_fifo_sample_t *samples, uint32_t count,
+                          imu_fifo_sample_t *out)
+{
+    const imu_gate_cfg_t *cfg = &gate->cfg;
+    float std_sq = cfg->std_g * cfg->std_g;
+    uint32_t emitted = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const imu_fifo_sample_t *s = &samples[i];
+        float x, y, z, magnitude, delta;
+        bool active;
+
+        if (0u == (s->flags & IMU_FIFO_SAMPLE_ACC))
+        {
+            continue;
+        }
+
+        x = (float)s->acc[0];
+        y = (float)s->acc[1];
+        z = (float)s->acc[2];
+        magnitude = sqrtf((x * x) + (y * y) + (z * z)) / cfg->lsb_per_g;
+
+        if (!gate->gravity_valid)
+        {
+            gate->gravity = magnitude;
+            gate->gravity_valid = true;
+        }
+
+        /* The magnitude does not depend on the orientation, turning the
+         * wrist slowly keeps the gate closed */
+        delta = magnitude - gate->gravity;
+        active = (fabsf(delta) > cfg->delta_g) || (gate->variance > std_sq);
+        gate->gravity += cfg->alpha * delta;
+        gate->variance += cfg->alpha * ((delta * delta) - gate->variance);
+
+        gate->stats.samples++;
+
+        if (active)
+        {
+            gate->hold = cfg->hold_samples;
+            if (!gate->open)
+            {
+                gate->open = true;
+                gate->stats.opens++;
+                emitted += imu_gate_replay_preroll(gate, &out[emitted]);
+            }
+        }
+        else if (gate->open)
+        {
+            if (gate->hold > 0u)
+            {
+                gate->hold--;
+            }
+            else if (0u == gate->warmup)
+            {
+                gate->open = false;
+            }
+        }
+        if (gate->warmup > 0u)
+        {
+            gate->warmup--;
+        }
+
+        if (gate->open)
+        {
+            out[emitted++] = *s;
+        }
+        else
+        {
+            gate->stats.gated_samples++;
+            imu_gate_store_preroll(gate, s);
+        }
+    }
+
+    return emitted;
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_is_open
+*******************************************************************************/
+bool imu_gate_is_open(const imu_gate_t *gate)
+{
+    return gate->open;
+}
+
+/*******************************************************************************
+* Function Name: imu_gate_get_stats
+*******************************************************************************/
+void imu_gate_get_stats(const imu_gate_t *gate, imu_gate_stats_t *stats)
+{
+    *stats = gate->stats;
+}
+
+/* [] END OF FILE */
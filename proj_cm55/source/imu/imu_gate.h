@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name:   imu_gate.h
+*
+* Description: This file contains the types and function prototypes of the
+*              motion gate implemented in imu_gate.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IMU_GATE_H_
+#define IMU_GATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "imu_fifo.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define IMU_GATE_MAX_PREROLL                (128u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    float       lsb_per_g;      /* Raw accelerometer LSB per g */
+    float       delta_g;        /* Magnitude away from the gravity estimate that opens the gate */
+    float       std_g;          /* Magnitude standard deviation that opens the gate */
+    float       alpha;          /* Weight of a sample in the gravity and variance estimates */
+    uint16_t    hold_samples;   /* Samples the gate stays open after the last active sample */
+    uint16_t    preroll_samples;/* Samples replayed when the gate opens, up to IMU_GATE_MAX_PREROLL */
+    uint16_t    warmup_samples; /* Samples the gate stays open after init, so the model reports its first result */
+} imu_gate_cfg_t;
+
+typedef struct
+{
+    uint32_t    samples;        /* Accelerometer samples presented to the gate */
+    uint32_t    gated_samples;  /* Samples withheld from the model */
+    uint32_t    opens;          /* Times the gate opened */
+    uint32_t    preroll_samples;/* Samples replayed from the pre-roll */
+} imu_gate_stats_t;
+
+typedef struct
+{
+    imu_gate_cfg_t      cfg;
+    imu_fifo_sample_t   preroll[IMU_GATE_MAX_PREROLL];
+    uint16_t            preroll_pos;
+    uint16_t            preroll_len;
+    uint16_t            hold;
+    uint16_t            warmup;
+    bool                open;
+    bool                gravity_valid;
+    float               gravity;        /* Magnitude estimate at rest, in g */
+    float               variance;       /* Magnitude variance estimate, in g^2 */
+    imu_gate_stats_t    stats;
+} imu_gate_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void imu_gate_default_config(imu_gate_cfg_t *cfg);
+bool imu_gate_init(imu_gate_t *gate, const imu_gate_cfg_t *cfg);
+uint32_t imu_gate_process(imu_gate_t *gate, const imu_fifo_sample_t *samples, uint32_t count,
+                          imu_fifo_sample_t *out);
+bool imu_gate_is_open(const imu_gate_t *gate);
+void imu_gate_get_stats(const imu_gate_t *gate, imu_gate_stats_t *stats);
+
+#endif /* IMU_GATE_H_ */
+
+/* [] END OF FILE */
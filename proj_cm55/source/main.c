@@ -42,6 +42,7 @@
 #include "cybsp.h"
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
+#include "timebase.h"
 
 #ifdef GESTURE_MODEL
 #include "radar.h"
@@ -117,6 +118,9 @@ int main(void)
 
     Cy_SysLib_Delay(50);
 
+    /* Microsecond time for all sensor tasks, the SysTick stays with FreeRTOS */
+    timebase_init();
+
 #if 0
     printf("\x1b[2J\x1b[;H");
 #endif
@@ -0,0 +1,317 @@
+/******************************************************************************
+* File Name:   postprocess.c
+*
+* Description: This file implements a table-driven post-inference smoothing
+*              engine shared by all sensor tasks. Model predictions go
+*              through k-of-n voting, enter/exit hysteresis, a minimum hold
+*              time and a per-class cooldown. Only changes of the smoothed
+*              state are reported, so callers forward events instead of
+*              every prediction. The engine has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "postprocess.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* State before the first prediction, forces the first state to be reported */
+#define POSTPROCESS_STATE_UNKNOWN           (-1)
+
+#define POSTPROCESS_AT_LEAST_ONE(x)         (((x) == 0u) ? 1u : (uint32_t)(x))
+
+/*******************************************************************************
+* Function Name: postprocess_class_cfg
+*******************************************************************************/
+static const postprocess_class_cfg_t* postprocess_class_cfg(const postprocess_ctx_t *ctx, int class_id)
+{
+    return &ctx->cfg->classes[class_id];
+}
+
+/*******************************************************************************
+* Function Name: postprocess_vote
+********************************************************************************
+* Summary:
+*  Adds a prediction to the voting window.
+*
+*******************************************************************************/
+static void postprocess_vote(postprocess_ctx_t *ctx, int class_id)
+{
+    uint8_t window = ctx->cfg->window;
+
+    if (ctx->history_len == window)
+    {
+        ctx->votes[ctx->history[ctx->history_pos]]--;
+    }
+    else
+    {
+        ctx->history_len++;
+    }
+
+    ctx->history[ctx->history_pos] = (uint8_t)class_id;
+    ctx->votes[class_id]++;
+    ctx->history_pos = (uint8_t)((ctx->history_pos + 1u) % window);
+}
+
+/*******************************************************************************
+* Function Name: postprocess_candidate
+********************************************************************************
+* Summary:
+*  Selects the non-background class with the most votes that reaches its
+*  vote_k and is not cooling down. The current state wins ties.
+*
+* Return:
+*  Candidate class, POSTPROCESS_BACKGROUND_CLASS if there is none.
+*
+*******************************************************************************/
+static int postprocess_candidate(const postprocess_ctx_t *ctx)
+{
+    int candidate = POSTPROCESS_BACKGROUND_CLASS;
+    uint32_t best_votes = 0;
+
+    for (int class_id = 1; class_id < ctx->cfg->class_count; class_id++)
+    {
+        uint32_t votes = ctx->votes[class_id];
+
+        if ((votes < POSTPROCESS_AT_LEAST_ONE(postprocess_class_cfg(ctx, class_id)->vote_k)) ||
+            (ctx->cooldown[class_id] > 0u))
+        {
+            continue;
+        }
+        if ((votes > best_votes) || ((votes == best_votes) && (class_id == ctx->state)))
+        {
+            candidate = class_id;
+            best_votes = votes;
+        }
+    }
+
+    return candidate;
+}
+
+/*******************************************************************************
+* Function Name: postprocess_init
+********************************************************************************
+* Summary:
+*  Initializes the engine with a per-model configuration table. The table
+*  must stay valid while the engine is in use.
+*
+* Parameters:
+*  ctx : engine context
+*  cfg : configuration table
+*
+* Return:
+*  false if the window or the class count exceed the voting and cooldown
+*  arrays, or if a class needs more votes than the window holds.
+*
+*******************************************************************************/
+bool postprocess_init(postprocess_ctx_t *ctx, const postprocess_cfg_t *cfg)
+{
+    if ((NULL == cfg) || (NULL == cfg->classes) ||
+        (0u == cfg->window) || (cfg->window > POSTPROCESS_MAX_WINDOW) ||
+        (0u == cfg->class_count) || (cfg->class_count > POSTPROCESS_MAX_CLASSES))
+    {
+        return false;
+    }
+    for (uint32_t c = 0; c < cfg->class_count; c++)
+    {
+        if (cfg->classes[c].vote_k > cfg->window)
+        {
+            return false;
+        }
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->cfg = cfg;
+    ctx->state = POSTPROCESS_STATE_UNKNOWN;
+    ctx->pending = POSTPROCESS_STATE_UNKNOWN;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: postprocess_update
+********************************************************************************
+* Summary:
+*  Feeds one model prediction into the engine.
+*
+* Parameters:
+*  ctx      : engine context
+*  class_id : predicted class, out of range values count as background
+*  state    : receives the smoothed state, may be NULL
+*
+* Return:
+*  true if the smoothed state changed and should be reported. The first
+*  prediction always reports the initial background state.
+*
+*******************************************************************************/
+bool postprocess_update(postprocess_ctx_t *ctx, int class_id, int *state)
+{
+    bool changed = false;
+
+    if ((class_id < 0) || (class_id >= ctx->cfg->class_count))
+    {
+        class_id = POSTPROCESS_BACKGROUND_CLASS;
+    }
+
+    ctx->stats.predictions++;
+    postprocess_vote(ctx, class_id);
+
+    for (int i = 1; i < ctx->cfg->class_count; i++)
+    {
+        if (ctx->cooldown[i] > 0u)
+        {
+            ctx->cooldown[i]--;
+        }
+    }
+
+    if (POSTPROCESS_STATE_UNKNOWN == ctx->state)
+    {
+        ctx->state = POSTPROCESS_BACKGROUND_CLASS;
+        changed = true;
+    }
+    else
+    {
+        int candidate = postprocess_candidate(ctx);
+
+        if (ctx->held < UINT16_MAX)
+        {
+            ctx->held++;
+        }
+
+        if (candidate == ctx->state)
+        {
+            ctx->exit_run = 0;
+            ctx->pending = POSTPROCESS_STATE_UNKNOWN;
+            ctx->pending_run = 0;
+        }
+        else
+        {
+            bool can_leave = true;
+            bool can_enter = true;
+
+            if (ctx->exit_run < UINT16_MAX)
+            {
+                ctx->exit_run++;
+            }
+            if (candidate == ctx->pending)
+            {
+                if (ctx->pending_run < UINT16_MAX)
+                {
+                    ctx->pending_run++;
+                }
+            }
+            else
+            {
+                ctx->pending = (int16_t)candidate;
+                ctx->pending_run = 1;
+            }
+
+            if (POSTPROCESS_BACKGROUND_CLASS != ctx->state)
+            {
+                const postprocess_class_cfg_t *cur = postprocess_class_cfg(ctx, ctx->state);
+                can_leave = (ctx->held >= cur->hold_count) &&
+                            (ctx->exit_run >= POSTPROCESS_AT_LEAST_ONE(cur->exit_count));
+            }
+            if (POSTPROCESS_BACKGROUND_CLASS != candidate)
+            {
+                can_enter = (ctx->pending_run >= POSTPROCESS_AT_LEAST_ONE(postprocess_class_cfg(ctx, candidate)->enter_count));
+            }
+
+            if (can_leave && can_enter)
+            {
+                if (POSTPROCESS_BACKGROUND_CLASS != ctx->state)
+                {
+                    ctx->cooldown[ctx->state] = postprocess_class_cfg(ctx, ctx->state)->cooldown_count;
+                }
+                ctx->state = (int16_t)candidate;
+                ctx->held = 0;
+                ctx->exit_run = 0;
+                ctx->pending = POSTPROCESS_STATE_UNKNOWN;
+                ctx->pending_run = 0;
+                changed = true;
+            }
+        }
+    }
+
+    if (changed)
+    {
+        ctx->stats.reports++;
+    }
+    if (NULL != state)
+    {
+        *state = ctx->state;
+    }
+
+    return changed;
+}
+
+/*******************************************************************************
+* Function Name: postprocess_get_state
+********************************************************************************
+* Summary:
+*  Returns the current smoothed state, background before the first update.
+*
+*******************************************************************************/
+int postprocess_get_state(const postprocess_ctx_t *ctx)
+{
+    return (POSTPROCESS_STATE_UNKNOWN == ctx->state) ? POSTPROCESS_BACKGROUND_CLASS : ctx->state;
+}
+
+/*******************************************************************************
+* Function Name: postprocess_get_scores
+********************************************************************************
+* Summary:
+*  Returns the share of the voting window each class got, the confidence
+*  behind the smoothed state, scaled to 0..255.
+*
+* Parameters:
+*  ctx       : engine context
+*  scores    : receives one score per class
+*  max_count : capacity of scores
+*
+* Return:
+*  Number of scores written, the smaller of the class count and max_count.
+*
+*******************************************************************************/
+uint32_t postprocess_get_scores(const postprocess_ctx_t *ctx, uint8_t *scores, uint32_t max_count)
+{
+    uint32_t count = (ctx->cfg->class_count < max_count) ? ctx->cfg->class_count : max_count;
+
+    for (uint32_t c = 0; c < count; c++)
+    {
+        scores[c] = (0u == ctx->history_len) ? 0u : (uint8_t)((ctx->votes[c] * 255u) / ctx->history_len);
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: postprocess_flags_to_class
+********************************************************************************
+* Summary:
+*  Converts the trigger flags returned by the IMAI dequeue functions into a
+*  class index. The highest flagged class wins.
+*
+*******************************************************************************/
+int postprocess_flags_to_class(const int *flags, int count)
+{
+    int class_id = POSTPROCESS_BACKGROUND_CLASS;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (flags[i] == 1)
+        {
+            class_id = i;
+        }
+    }
+
+    return class_id;
+}
+
+/* [] END OF FILE */
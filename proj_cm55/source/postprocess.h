@@ -0,0 +1,85 @@
+/******************************************************************************
+* File Name:   postprocess.h
+*
+* Description: This file contains the types and function prototypes of the
+*              table-driven post-inference smoothing engine implemented in
+*              postprocess.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef POSTPROCESS_H_
+#define POSTPROCESS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define POSTPROCESS_MAX_WINDOW              (16u)
+#define POSTPROCESS_MAX_CLASSES             (16u)
+
+/* Class index of the background ("unlabelled") class */
+#define POSTPROCESS_BACKGROUND_CLASS        (0)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Per-class smoothing parameters. All counts are in model predictions.
+ * Zero values for vote_k, enter_count and exit_count are treated as 1. */
+typedef struct
+{
+    uint8_t     vote_k;         /* Votes within the window to become a candidate (k of k-of-n) */
+    uint8_t     enter_count;    /* Consecutive candidate predictions to enter the class */
+    uint8_t     exit_count;     /* Consecutive other predictions to leave the class */
+    uint16_t    hold_count;     /* Minimum predictions the class is held once entered */
+    uint16_t    cooldown_count; /* Predictions after leaving before the class can be entered again */
+} postprocess_class_cfg_t;
+
+/* Per-model configuration table */
+typedef struct
+{
+    uint8_t                         window;         /* Voting window (n of k-of-n), 1..POSTPROCESS_MAX_WINDOW */
+    uint8_t                         class_count;    /* Entries in classes, up to POSTPROCESS_MAX_CLASSES */
+    const postprocess_class_cfg_t   *classes;       /* Indexed by class, index 0 is the background class */
+} postprocess_cfg_t;
+
+typedef struct
+{
+    uint32_t    predictions;    /* Predictions fed into the engine */
+    uint32_t    reports;        /* State changes emitted */
+} postprocess_stats_t;
+
+typedef struct
+{
+    const postprocess_cfg_t *cfg;
+    uint8_t                 history[POSTPROCESS_MAX_WINDOW];
+    uint8_t                 history_pos;
+    uint8_t                 history_len;
+    uint8_t                 votes[POSTPROCESS_MAX_CLASSES];
+    uint16_t                cooldown[POSTPROCESS_MAX_CLASSES];
+    int16_t                 state;
+    int16_t                 pending;
+    uint16_t                pending_run;
+    uint16_t                exit_run;
+    uint16_t                held;
+    postprocess_stats_t     stats;
+} postprocess_ctx_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool postprocess_init(postprocess_ctx_t *ctx, const postprocess_cfg_t *cfg);
+bool postprocess_update(postprocess_ctx_t *ctx, int class_id, int *state);
+int postprocess_get_state(const postprocess_ctx_t *ctx);
+uint32_t postprocess_get_scores(const postprocess_ctx_t *ctx, uint8_t *scores, uint32_t max_count);
+int postprocess_flags_to_class(const int *flags, int count);
+
+#endif /* POSTPROCESS_H_ */
+
+/* [] END OF FILE */
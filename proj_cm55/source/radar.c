@@ -61,11 +61,15 @@
 
 #include "preprocess.h"
 #include "extractions.h"
+#include "radar_mode.h"
+#include "postprocess.h"
+#include "xensiv_radar_presence.h"
 
 
 #include <stdlib.h>
 
 #include "ipc_communication.h"
+#include "timebase.h"
 
 /*******************************************************************************
 * Constants
@@ -107,7 +111,14 @@
 #define GPIO_INTERRUPT_PRIORITY             (6)
 
 #define GESTURE_HOLD_TIME                   (10) /* count value used to hold gesture before evaluating new one */
-#define GESTURE_DETECTION_THRESHOLD         (0)
+#define GESTURE_DETECTION_THRESHOLD         (0)  /* additional consecutive predictions required to report a gesture */
+
+/* Samples of the presence profile (radar_mode.h). The gesture chain is only
+ * run in RADAR_MODE_GESTURE. */
+#define PRESENCE_NUM_SAMPLES                (RADAR_PRESENCE_NUM_CHIRPS * NUM_SAMPLES_PER_CHIRP)
+
+/* Interval at which the radar mode statistics are printed, 0 to disable */
+#define RADAR_MODE_REPORT_INTERVAL_MS       (60000u)
 
 
 /*****************************************************************************
@@ -116,7 +127,7 @@
 static void radar_task(void *pvParameters);
 static void processing_task(void *pvParameters);
 static int32_t radar_init(void);
-void get_time_from_millisec_radar(unsigned long milliseconds, char* output);
+static void radar_presence_init(void);
 
 
 
@@ -149,10 +160,42 @@ mtb_hal_lptimer_t lptimer_obj;
 uint32_t before;
 uint32_t after;
 
-/*System tick variables*/
-uint32_t tick = 0;
 bool radarreset = false;
 
+/* Gesture smoothing: a gesture is held for GESTURE_HOLD_TIME predictions
+ * before a new one is evaluated */
+#define GESTURE_PP_CLASS_CFG    { .vote_k = 1u, .enter_count = (GESTURE_DETECTION_THRESHOLD + 1u), \
+                                  .exit_count = 1u, .hold_count = GESTURE_HOLD_TIME }
+
+static const postprocess_class_cfg_t gesture_pp_classes[IMAI_DATA_OUT_COUNT] =
+{
+    [0] = { .vote_k = 1u },
+    [1] = GESTURE_PP_CLASS_CFG,
+    [2] = GESTURE_PP_CLASS_CFG,
+    [3] = GESTURE_PP_CLASS_CFG,
+    [4] = GESTURE_PP_CLASS_CFG,
+    [5] = GESTURE_PP_CLASS_CFG,
+};
+
+static const postprocess_cfg_t gesture_pp_cfg =
+{
+    .window = 1u,
+    .class_count = IMAI_DATA_OUT_COUNT,
+    .classes = gesture_pp_classes
+};
+
+static postprocess_ctx_t gesture_pp;
+
+static const char *const gesture_labels[IMAI_DATA_OUT_COUNT] = IMAI_DATA_OUT_SYMBOLS;
+
+/* Model ID in the IPC label table */
+static int gesture_model_id;
+
+/* Presence-first mode handling */
+static radar_mode_ctx_t radar_mode_ctx;
+static xensiv_radar_presence_handle_t presence_handle;
+static float32_t presence_frame[PRESENCE_NUM_SAMPLES];
+
 void xensiv_bgt60trxx_interrupt_handler(void);
 
 
@@ -174,24 +217,6 @@ void mSPI_Interrupt(void)
     Cy_SCB_SPI_Interrupt(CYBSP_SPI_CONTROLLER_HW, &SPI_context);
 }
 
-/*******************************************************************************
-* Function Name: systick_isr
-********************************************************************************
-* Summary: This increments every time the SysTick counter decrements to 0.
-*
-* Parameters:
-*   None
-*
-* Return:
-*   None
-*
-*
-*******************************************************************************/
-void systick_isr(void)
-{
-    tick++;
-}
-
 
 /*******************************************************************************
 * Function Name: deinterleave_antennas
@@ -226,6 +251,133 @@ void deinterleave_antennas(uint16_t * buffer_ptr)
 }
 
 
+/*******************************************************************************
+* Function Name: radar_mode_transition
+********************************************************************************
+* Summary:
+* Callback of the radar mode state machine. Clears the gesture model history
+* when the gesture profile is entered and reports the new mode to CM33.
+*
+*******************************************************************************/
+static void radar_mode_transition(radar_mode_t from, radar_mode_t to, uint32_t time_ms, void *ctx)
+{
+    (void)from;
+    (void)time_ms;
+    (void)ctx;
+
+    if (RADAR_MODE_GESTURE == to)
+    {
+        IMAI_AED_init();
+        if (!postprocess_init(&gesture_pp, &gesture_pp_cfg))
+        {
+            CY_ASSERT(0);
+        }
+    }
+    printf("Radar mode: %s\r\n", radar_mode_name(to));
+    cm55_ipc_send_radar_mode((uint32_t)to);
+}
+
+/*******************************************************************************
+* Function Name: radar_presence_callback
+********************************************************************************
+* Summary:
+* Presence algorithm event callback. Macro and micro presence both count as
+* presence for the mode state machine.
+*
+*******************************************************************************/
+static void radar_presence_callback(xensiv_radar_presence_handle_t handle,
+                                    const xensiv_radar_presence_event_t* event,
+                                    void *data)
+{
+    (void)handle;
+    (void)data;
+
+    radar_mode_set_presence(&radar_mode_ctx,
+                            XENSIV_RADAR_PRESENCE_STATE_ABSENCE != event->state,
+                            timebase_get_ms());
+}
+
+/*******************************************************************************
+* Function Name: radar_presence_init
+********************************************************************************
+* Summary:
+* Allocates the presence algorithm for the presence profile and initializes
+* the radar mode state machine.
+*
+*******************************************************************************/
+static void radar_presence_init(void)
+{
+    xensiv_radar_presence_config_t config;
+
+    xensiv_radar_presence_set_malloc_free(pvPortMalloc, vPortFree);
+    xensiv_radar_presence_init_config(&config);
+    config.num_samples_per_chirp = NUM_SAMPLES_PER_CHIRP;
+    config.frame_time_sec = XENSIV_BGT60TRXX_CONF_FRAME_REPETITION_TIME_S * RADAR_PRESENCE_FRAME_DECIMATION;
+
+    if (xensiv_radar_presence_alloc(&presence_handle, &config) != XENSIV_RADAR_PRESENCE_OK)
+    {
+        CY_ASSERT(0);
+    }
+    xensiv_radar_presence_set_callback(presence_handle, radar_presence_callback, NULL);
+
+    radar_mode_init(&radar_mode_ctx, NULL, radar_mode_transition, NULL, timebase_get_ms());
+
+    /* Publish the class and mode names once, the messages only carry the IDs */
+    gesture_model_id = cm55_ipc_add_model("gesture", gesture_labels, IMAI_DATA_OUT_COUNT);
+    if (gesture_model_id < 0)
+    {
+        CY_ASSERT(0);
+    }
+    for (uint32_t mode = 0; mode < (uint32_t)RADAR_MODE_COUNT; mode++)
+    {
+        cm55_ipc_add_mode(radar_mode_name((radar_mode_t)mode));
+    }
+    cm55_ipc_publish_labels();
+
+    /* Report the initial mode, CM33 waits for the first message before connecting */
+    cm55_ipc_send_radar_mode((uint32_t)RADAR_MODE_PRESENCE);
+}
+
+/*******************************************************************************
+* Function Name: radar_presence_process
+********************************************************************************
+* Summary:
+* Runs the presence algorithm on the presence profile subset of the frame.
+*
+*******************************************************************************/
+static void radar_presence_process(uint32_t now_ms)
+{
+    /* Antenna 1 occupies the first block of the de-interleaved frame */
+    arm_scale_f32(gesture_frame, RADAR_PRESENCE_ADC_NORMALIZE, presence_frame, PRESENCE_NUM_SAMPLES);
+    xensiv_radar_presence_process_frame(presence_handle, presence_frame, now_ms);
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_report
+********************************************************************************
+* Summary:
+* Prints the per-mode frame cost and the load relative to running the gesture
+* chain on every frame.
+*
+*******************************************************************************/
+static void radar_mode_report(uint32_t now_ms)
+{
+    radar_mode_stats_t stats;
+
+    radar_mode_get_stats(&radar_mode_ctx, now_ms, &stats);
+    for (uint32_t mode = 0; mode < RADAR_MODE_COUNT; mode++)
+    {
+        printf("Radar %s: %lu frames, %lu cycles/frame, %lu ms\r\n",
+               radar_mode_name((radar_mode_t)mode),
+               (unsigned long)stats.frames[mode],
+               (unsigned long)((stats.frames[mode] > 0u) ? (stats.cycles[mode] / stats.frames[mode]) : 0u),
+               (unsigned long)stats.residency_ms[mode]);
+    }
+    printf("Radar load: %lu%% of always-on gesture processing, %lu transitions\r\n",
+           (unsigned long)radar_mode_load_percent(&stats), (unsigned long)stats.transitions);
+}
+
+
 /*******************************************************************************
 * Function Name: radar_task
 ********************************************************************************
@@ -268,9 +420,8 @@ void radar_task(void *pvParameters)
     /* Init preprocessing */
     work_arrays = new_preproc_work_arrays(&f_cfg);
 
-    /* Inference time measurement */
-    Cy_SysTick_Init(CY_SYSTICK_CLOCK_SOURCE_CLK_IMO , (8000000/1000)-1);
-    Cy_SysTick_SetCallback(0, systick_isr);
+    /* Start in the presence profile */
+    radar_presence_init();
 
     if (xensiv_bgt60trxx_start_frame(&sensor.dev, true) != XENSIV_BGT60TRXX_STATUS_OK)
     {
@@ -320,18 +471,59 @@ void radar_task(void *pvParameters)
 void processing_task(void *pvParameters)
 {
     (void)pvParameters;
-    int model_out[IMAI_DATA_OUT_COUNT] = {0};
-    const char* class_map[] = IMAI_DATA_OUT_SYMBOLS;
+    int model_out_buffer[IMAI_DATA_OUT_COUNT] = {0};
+    const char* const* class_map = gesture_labels;
     const float norm_mean[IMAI_DATA_OUT_COUNT] = {9.26814552650607, 4.391583164927378, 0.27332462978312866, -0.02838213175529301, 0.00026668613549266876};
     const float norm_scale[IMAI_DATA_OUT_COUNT] = {5.801363069954616, 7.547439540930497, 0.5629401789624862, 0.41502512890635995, 0.0007474111364241666};
 
+    uint32_t frame_count = 0;
+    uint32_t last_report_ms = timebase_get_ms();
+
     for(;;)
     {
         /* Wait for frame data available to process */
         ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t frame_us = (uint32_t)timebase_get_us();
+
+        /* Parameters only change between two frames */
+        cm55_ipc_poll_control();
+
+        uint32_t now_ms = timebase_get_ms();
+        uint32_t frame_start = timebase_get_cycles32();
+
+        /* The presence profile runs at a reduced frame rate in every mode so
+         * that absence can be detected while gestures are being recognized. */
+        if ((frame_count++ % RADAR_PRESENCE_FRAME_DECIMATION) == 0u)
+        {
+            radar_presence_process(now_ms);
+        }
+
+        radar_mode_t mode = radar_mode_update(&radar_mode_ctx, now_ms);
+
+        if ((RADAR_MODE_REPORT_INTERVAL_MS > 0u) && ((now_ms - last_report_ms) >= RADAR_MODE_REPORT_INTERVAL_MS))
+        {
+            last_report_ms = now_ms;
+            radar_mode_report(now_ms);
+        }
+
+        if (RADAR_MODE_GESTURE != mode)
+        {
+            radar_mode_account_frame(&radar_mode_ctx, mode, timebase_get_cycles32() - frame_start);
+            continue;
+        }
+
         /* pass on the de-interleaved data on to Algorithmic kernel */
 
-        float model_in[IMAI_DATA_IN_COUNT];
+        /* The model input and output are written straight into the bulk
+         * stream records when they are streamed, without a copy */
+        float model_in_buffer[IMAI_DATA_IN_COUNT];
+        float *model_in = (float *)cm55_ipc_stream_reserve(IPC_STREAM_FEATURES, (uint32_t)gesture_model_id,
+                                                           sizeof(model_in_buffer));
+        bool model_in_streamed = (NULL != model_in);
+        if (!model_in_streamed)
+        {
+            model_in = model_in_buffer;
+        }
         uint16_t min_range_bin = 3;
         slim_algo_output res;
         slim_algo(&res, gesture_frame, &f_cfg, min_range_bin, &work_arrays);
@@ -340,6 +532,10 @@ void processing_task(void *pvParameters)
         model_in[2] = ((float)res.detection.azimuth - norm_mean[2]) / norm_scale[2];
         model_in[3] = ((float)res.detection.elevation - norm_mean[3]) / norm_scale[3];
         model_in[4] = ((float)res.detection.value - norm_mean[4]) / norm_scale[4];
+        if (model_in_streamed)
+        {
+            cm55_ipc_stream_commit(sizeof(model_in_buffer));
+        }
 
         /* Input the processed radar to model */
         int imai_result_enqueue = IMAI_AED_enqueue(model_in);
@@ -349,9 +545,20 @@ void processing_task(void *pvParameters)
         }
 
         /* Get model results */
+        int *model_out = (int *)cm55_ipc_stream_reserve(IPC_STREAM_OUTPUTS, (uint32_t)gesture_model_id,
+                                                        sizeof(model_out_buffer));
+        bool model_out_streamed = (NULL != model_out);
+        if (!model_out_streamed)
+        {
+            model_out = model_out_buffer;
+        }
         int imai_result = IMAI_AED_dequeue(model_out);
+        if (model_out_streamed && (IMAI_RET_SUCCESS == imai_result))
+        {
+            cm55_ipc_stream_commit(sizeof(model_out_buffer));
+        }
         int pred_idx = 0;
-        static int prediction_count = 0;
+        int raw_idx;
 
         /* LED variables */
         static int led_off = 0;
@@ -361,22 +568,24 @@ void processing_task(void *pvParameters)
         {
             static uint8_t success_flag;
             case IMAI_RET_SUCCESS:
-                ipc_payload_t* payload = cm55_ipc_get_payload_ptr();
-
                 success_flag = 1;
-                prediction_count += 1;
 
-                for (uint8_t i = 0; i < IMAI_DATA_OUT_COUNT; i++)
+                raw_idx = postprocess_flags_to_class(model_out, IMAI_DATA_OUT_COUNT);
+                if (raw_idx != 0)
                 {
-                    if (model_out[i] == 1)
-                    {
-                        pred_idx = i;
-                    }
+                    radar_mode_notify_activity(&radar_mode_ctx, now_ms);
                 }
-                
-                payload->label_id = pred_idx;
-                strcpy(payload->label, class_map[pred_idx]);
-                cm55_ipc_send_to_cm33();
+
+                /* Only forward changes of the smoothed state */
+                if (!postprocess_update(&gesture_pp, raw_idx, &pred_idx))
+                {
+                    break;
+                }
+
+                uint8_t scores[IPC_MAX_SCORES];
+                uint32_t score_count = postprocess_get_scores(&gesture_pp, scores, IPC_MAX_SCORES);
+                cm55_ipc_send_result((uint32_t)gesture_model_id, (uint32_t)pred_idx, scores, score_count,
+                                     frame_us, (uint32_t)timebase_get_us());
 
                 if (pred_idx != 0)
                 {
@@ -389,19 +598,12 @@ void processing_task(void *pvParameters)
                     // Do not control the LED:
                     // Cy_GPIO_Write(CYBSP_USER_LED1_PORT, CYBSP_USER_LED1_PIN, CYBSP_LED_STATE_ON);
                     led_off = 0;
-                    ledon_t = tick;
+                    ledon_t = timebase_get_ms();
                 }
                 else
                 {
-                    /* only print non-label class very 10 predictions */
-                    if (prediction_count>9)
-                    {
-                        // printf(".");
-                        //fflush( stdout );
-                        prediction_count = 0;
-                    }
                     /* turn off LED after the LED is on for 500ms */
-                    if((tick - ledon_t) > 500)
+                    if((timebase_get_ms() - ledon_t) > 500)
                     {
                         /* turn on LED */
                         // Do not control the LED:
@@ -425,33 +627,13 @@ void processing_task(void *pvParameters)
                     success_flag = 0;
                 break;
         }
+
+        radar_mode_account_frame(&radar_mode_ctx, mode, timebase_get_cycles32() - frame_start);
     }
 }
 
 
 
-/*******************************************************************************
-* Function Name: get_time_from_millisec_radar
-********************************************************************************
-* Summary: This function prints the time when a output class is detected.
-*
-* Parameters:
-*   milliseconds : time when a output class is detected.
-*   timeString   : time of detected class in hr:m:s format.
-*
-* Return:
-*   None
-*
-*
-*******************************************************************************/
-void get_time_from_millisec_radar(unsigned long milliseconds, char* timeString) {
-  unsigned int seconds = (milliseconds / 1000) % 60;
-  unsigned int minutes = (milliseconds / (1000 * 60)) % 60;
-  unsigned int hours = (milliseconds / (1000 * 60 * 60));
-  sprintf(timeString, "%02u:%02u:%02u", hours, minutes, seconds);
-}
-
-
 /*******************************************************************************
 * Function Name: radar_init
 ********************************************************************************
@@ -0,0 +1,496 @@
+/******************************************************************************
+* File Name:   radar_replay.c
+*
+* Description: This file implements a host replay of recorded radar frames
+*              through the presence-first mode handling of the radar task
+*              (radar_mode.c). Like the task, the presence processing runs
+*              on the presence profile of every RADAR_PRESENCE_FRAME_DECIMATION
+*              frame and the gesture chain only in the gesture mode. The
+*              tool prints every mode change with its time in the recording,
+*              the gesture duty cycle, the cost per frame of both modes and
+*              the cycles saved against running the gesture chain on every
+*              frame.
+*
+*              Usage: radar_replay [frames.bin] [--generate S]
+*                                  [--threshold E] [--absence-ms N]
+*                                  [--idle-ms N] [--presence-cycles N]
+*                                  [--gesture-cycles N]
+*
+*              A recording holds raw little endian 16-bit frames as read
+*              from the BGT60 FIFO, antennas interleaved. Without a file a
+*              scene of S seconds (default 60) is generated with a person
+*              moving in front of the radar from 20% to 50% of the time,
+*              and the exit code is 1 if the mode changes do not follow
+*              the person.
+*
+*              The xensiv-radar-presence library and slim_algo are built for
+*              the CM55 only. The presence processing is stood in for by the
+*              motion energy of the presence profile after removal of the
+*              static reflections, the gesture chain by a range-Doppler map
+*              of all antennas. --presence-cycles and --gesture-cycles
+*              account the costs measured on the board instead, the
+*              "Radar presence/gesture: ... cycles/frame" prints of the
+*              radar task.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "radar_settings.h"
+#include "radar_mode.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define REPLAY_CYCLE_UNIT                   "TSC cycles"
+#else
+#define REPLAY_CYCLE_UNIT                   "ns"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define REPLAY_SAMPLES                      XENSIV_BGT60TRXX_CONF_NUM_SAMPLES_PER_CHIRP
+#define REPLAY_CHIRPS                       XENSIV_BGT60TRXX_CONF_NUM_CHIRPS_PER_FRAME
+#define REPLAY_ANTENNAS                     XENSIV_BGT60TRXX_CONF_NUM_RX_ANTENNAS
+#define REPLAY_FRAME_SAMPLES                (REPLAY_SAMPLES * REPLAY_CHIRPS * REPLAY_ANTENNAS)
+#define REPLAY_RANGE_BINS                   (REPLAY_SAMPLES / 2u)
+#define REPLAY_FRAME_MS                     (XENSIV_BGT60TRXX_CONF_FRAME_REPETITION_TIME_S * 1000.0)
+
+#define REPLAY_PI                           (3.14159265358979)
+
+/* Motion energy of the presence profile, in normalized ADC units squared,
+ * above which a person is taken as present */
+#define REPLAY_DEFAULT_THRESHOLD            (1e-4)
+
+/* Time without motion before the stand-in reports absence */
+#define REPLAY_DEFAULT_ABSENCE_MS           (1000u)
+
+#define REPLAY_DEFAULT_SCENE_S              (60.0)
+
+/* Generated scene, in ADC LSB */
+#define REPLAY_SCENE_OFFSET                 (2048.0)
+#define REPLAY_SCENE_CLUTTER                (300.0)
+#define REPLAY_SCENE_TARGET                 (400.0)
+#define REPLAY_SCENE_NOISE                  (8.0)
+
+/* Latest mode change expected after the person arrives, in frames */
+#define REPLAY_ENTER_FRAMES                 (2u * RADAR_PRESENCE_FRAME_DECIMATION)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    double      threshold;
+    uint32_t    absence_ms;
+    bool        present;
+    uint32_t    last_motion_ms;
+    double      energy;         /* Motion energy of the last processed frame */
+} replay_presence_t;
+
+typedef struct
+{
+    uint32_t    count;
+    uint32_t    time_ms[2];     /* First two mode changes */
+} replay_transitions_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint16_t raw_frame[REPLAY_FRAME_SAMPLES];
+static float frame[REPLAY_FRAME_SAMPLES];
+static float range_re[REPLAY_ANTENNAS][REPLAY_CHIRPS][REPLAY_RANGE_BINS];
+static float range_im[REPLAY_ANTENNAS][REPLAY_CHIRPS][REPLAY_RANGE_BINS];
+static float dft_cos[REPLAY_SAMPLES * REPLAY_SAMPLES];
+static float dft_sin[REPLAY_SAMPLES * REPLAY_SAMPLES];
+
+/* Keeps the result of the gesture stand-in */
+static volatile float gesture_peak;
+
+/*******************************************************************************
+* Function Name: replay_cycles
+********************************************************************************
+* Summary:
+*  Host stand-in for the DWT cycle counter.
+*
+*******************************************************************************/
+static uint32_t replay_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: replay_deinterleave
+********************************************************************************
+* Summary:
+*  Same layout as deinterleave_antennas() of the radar task: the chirps of
+*  each antenna one after the other.
+*
+*******************************************************************************/
+static void replay_deinterleave(const uint16_t *raw)
+{
+    for (uint32_t i = 0; i < REPLAY_FRAME_SAMPLES; i++)
+    {
+        frame[(i / REPLAY_ANTENNAS) + ((i % REPLAY_ANTENNAS) * REPLAY_SAMPLES * REPLAY_CHIRPS)] = (float)raw[i];
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_generate
+********************************************************************************
+* Summary:
+*  Generates one FIFO frame of the scene: a static reflector, and a person
+*  moving in front of the radar while present. The motion shows as a phase
+*  change from chirp to chirp.
+*
+*******************************************************************************/
+static void replay_generate(uint32_t index, bool present)
+{
+    double velocity = 1.0 + 0.5 * sin((double)index * 0.05);
+
+    for (uint32_t c = 0; c < REPLAY_CHIRPS; c++)
+    {
+        for (uint32_t n = 0; n < REPLAY_SAMPLES; n++)
+        {
+            for (uint32_t a = 0; a < REPLAY_ANTENNAS; a++)
+            {
+                double value = REPLAY_SCENE_OFFSET +
+                               REPLAY_SCENE_CLUTTER * cos((2.0 * REPLAY_PI * 5.0 * n) / REPLAY_SAMPLES + a);
+                double u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+                double u2 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+
+                if (present)
+                {
+                    value += REPLAY_SCENE_TARGET * cos((2.0 * REPLAY_PI * 12.0 * n) / REPLAY_SAMPLES + 0.7 * a +
+                                                       (2.0 * REPLAY_PI * velocity * c) / REPLAY_CHIRPS);
+                }
+                value += REPLAY_SCENE_NOISE * sqrt(-2.0 * log(u1)) * cos(2.0 * REPLAY_PI * u2);
+                raw_frame[(((c * REPLAY_SAMPLES) + n) * REPLAY_ANTENNAS) + a] = (uint16_t)value;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_presence_process
+********************************************************************************
+* Summary:
+*  Stand-in for xensiv_radar_presence_process_frame() on the presence
+*  profile. The mean chirp holds the static reflections, what remains after
+*  removing it is motion. Presence is reported on the first frame with
+*  motion, absence after absence_ms without.
+*
+*******************************************************************************/
+static void replay_presence_process(replay_presence_t *presence, radar_mode_ctx_t *mode, uint32_t now_ms)
+{
+    double energy = 0.0;
+
+    for (uint32_t n = 0; n < REPLAY_SAMPLES; n++)
+    {
+        float mean = 0.0f;
+
+        for (uint32_t c = 0; c < RADAR_PRESENCE_NUM_CHIRPS; c++)
+        {
+            mean += frame[(c * REPLAY_SAMPLES) + n];
+        }
+        mean /= (float)RADAR_PRESENCE_NUM_CHIRPS;
+        for (uint32_t c = 0; c < RADAR_PRESENCE_NUM_CHIRPS; c++)
+        {
+            float diff = (frame[(c * REPLAY_SAMPLES) + n] - mean) * RADAR_PRESENCE_ADC_NORMALIZE;
+            energy += (double)(diff * diff);
+        }
+    }
+    presence->energy = energy / (double)(RADAR_PRESENCE_NUM_CHIRPS * REPLAY_SAMPLES);
+
+    if (presence->energy > presence->threshold)
+    {
+        presence->last_motion_ms = now_ms;
+        if (!presence->present)
+        {
+            presence->present = true;
+            radar_mode_set_presence(mode, true, now_ms);
+        }
+    }
+    else if (presence->present && ((now_ms - presence->last_motion_ms) >= presence->absence_ms))
+    {
+        presence->present = false;
+        radar_mode_set_presence(mode, false, now_ms);
+    }
+}
+
+/*******************************************************************************
+* Function Name: replay_gesture_process
+********************************************************************************
+* Summary:
+*  Stand-in for slim_algo(): range DFT of every chirp of every antenna, then
+*  the Doppler DFT of every range bin. Returns the strongest cell.
+*
+*******************************************************************************/
+static float replay_gesture_process(void)
+{
+    float best = 0.0f;
+
+    for (uint32_t a = 0; a < REPLAY_ANTENNAS; a++)
+    {
+        for (uint32_t c = 0; c < REPLAY_CHIRPS; c++)
+        {
+            const float *chirp = &frame[((a * REPLAY_CHIRPS) + c) * REPLAY_SAMPLES];
+
+            for (uint32_t k = 0; k < REPLAY_RANGE_BINS; k++)
+            {
+                float re = 0.0f;
+                float im = 0.0f;
+
+                for (uint32_t n = 0; n < REPLAY_SAMPLES; n++)
+                {
+                    re += chirp[n] * dft_cos[(k * n) % REPLAY_SAMPLES];
+                    im -= chirp[n] * dft_sin[(k * n) % REPLAY_SAMPLES];
+                }
+                range_re[a][c][k] = re;
+                range_im[a][c][k] = im;
+            }
+        }
+
+        for (uint32_t k = 1; k < REPLAY_RANGE_BINS; k++)
+        {
+            for (uint32_t d = 0; d < REPLAY_CHIRPS; d++)
+            {
+                float re = 0.0f;
+                float im = 0.0f;
+
+                for (uint32_t c = 0; c < REPLAY_CHIRPS; c++)
+                {
+                    uint32_t idx = ((d * c) % REPLAY_CHIRPS) * (REPLAY_SAMPLES / REPLAY_CHIRPS);
+
+                    re += range_re[a][c][k] * dft_cos[idx] + range_im[a][c][k] * dft_sin[idx];
+                    im += range_im[a][c][k] * dft_cos[idx] - range_re[a][c][k] * dft_sin[idx];
+                }
+                if ((re * re + im * im) > best)
+                {
+                    best = re * re + im * im;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+/*******************************************************************************
+* Function Name: replay_transition
+*******************************************************************************/
+static void replay_transition(radar_mode_t from, radar_mode_t to, uint32_t time_ms, void *ctx)
+{
+    replay_transitions_t *transitions = (replay_transitions_t*)ctx;
+
+    (void)from;
+    if (transitions->count < 2u)
+    {
+        transitions->time_ms[transitions->count] = time_ms;
+    }
+    transitions->count++;
+    printf("%9.3f s  %s\n", time_ms / 1000.0, radar_mode_name(to));
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    FILE *file = NULL;
+    double scene_s = REPLAY_DEFAULT_SCENE_S;
+    uint32_t idle_ms = RADAR_IDLE_TIMEOUT_MS;
+    uint32_t presence_cycles = 0;
+    uint32_t gesture_cycles = 0;
+    uint32_t frame_count = 0;
+    uint32_t scene_frames;
+    uint32_t scene_start;
+    uint32_t scene_end;
+    uint32_t now_ms = 0;
+    replay_presence_t presence;
+    replay_transitions_t transitions;
+    radar_mode_ctx_t mode_ctx;
+    radar_mode_config_t mode_cfg;
+    radar_mode_stats_t stats;
+    bool ok = true;
+
+    memset(&presence, 0, sizeof(presence));
+    memset(&transitions, 0, sizeof(transitions));
+    presence.threshold = REPLAY_DEFAULT_THRESHOLD;
+    presence.absence_ms = REPLAY_DEFAULT_ABSENCE_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--generate")) && ((i + 1) < argc))
+        {
+            scene_s = strtod(argv[++i], NULL);
+        }
+        else if ((0 == strcmp(argv[i], "--threshold")) && ((i + 1) < argc))
+        {
+            presence.threshold = strtod(argv[++i], NULL);
+        }
+        else if ((0 == strcmp(argv[i], "--absence-ms")) && ((i + 1) < argc))
+        {
+            presence.absence_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--idle-ms")) && ((i + 1) < argc))
+        {
+            idle_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--presence-cycles")) && ((i + 1) < argc))
+        {
+            presence_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--gesture-cycles")) && ((i + 1) < argc))
+        {
+            gesture_cycles = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (('-' != argv[i][0]) && (NULL == path))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [frames.bin] [--generate S] [--threshold E] [--absence-ms N] [--idle-ms N] "
+                    "[--presence-cycles N] [--gesture-cycles N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((NULL == path) && (scene_s <= 0.0))
+    {
+        fprintf(stderr, "--generate needs a positive duration\n");
+        return 2;
+    }
+    if (NULL != path)
+    {
+        file = fopen(path, "rb");
+        if (NULL == file)
+        {
+            fprintf(stderr, "%s: cannot open\n", path);
+            return 2;
+        }
+    }
+
+    for (uint32_t i = 0; i < (REPLAY_SAMPLES * REPLAY_SAMPLES); i++)
+    {
+        dft_cos[i] = (float)cos((2.0 * REPLAY_PI * (double)i) / REPLAY_SAMPLES);
+        dft_sin[i] = (float)sin((2.0 * REPLAY_PI * (double)i) / REPLAY_SAMPLES);
+    }
+
+    scene_frames = (uint32_t)((scene_s * 1000.0) / REPLAY_FRAME_MS);
+    scene_start = (scene_frames * 2u) / 10u;
+    scene_end = scene_frames / 2u;
+
+    mode_cfg.idle_timeout_ms = idle_ms;
+    radar_mode_init(&mode_ctx, &mode_cfg, replay_transition, &transitions, 0u);
+
+    printf("%s:\n", (NULL != path) ? path : "generated scene");
+    while (true)
+    {
+        if (NULL != file)
+        {
+            if (REPLAY_FRAME_SAMPLES != fread(raw_frame, sizeof(uint16_t), REPLAY_FRAME_SAMPLES, file))
+            {
+                break;
+            }
+        }
+        else if (frame_count < scene_frames)
+        {
+            replay_generate(frame_count, (frame_count >= scene_start) && (frame_count < scene_end));
+        }
+        else
+        {
+            break;
+        }
+        replay_deinterleave(raw_frame);
+        now_ms = (uint32_t)((double)frame_count * REPLAY_FRAME_MS);
+
+        /* Same order as processing_task() */
+        uint32_t frame_start = replay_cycles();
+        uint32_t cost = 0;
+        bool decimated = ((frame_count++ % RADAR_PRESENCE_FRAME_DECIMATION) == 0u);
+
+        if (decimated)
+        {
+            replay_presence_process(&presence, &mode_ctx, now_ms);
+        }
+
+        radar_mode_t mode = radar_mode_update(&mode_ctx, now_ms);
+
+        if (RADAR_MODE_GESTURE == mode)
+        {
+            gesture_peak = replay_gesture_process();
+        }
+        cost = replay_cycles() - frame_start;
+        if ((0u != presence_cycles) || (0u != gesture_cycles))
+        {
+            cost = (decimated ? presence_cycles : 0u) + ((RADAR_MODE_GESTURE == mode) ? gesture_cycles : 0u);
+        }
+        radar_mode_account_frame(&mode_ctx, mode, cost);
+    }
+    if (NULL != file)
+    {
+        fclose(file);
+    }
+
+    radar_mode_get_stats(&mode_ctx, now_ms, &stats);
+
+    uint32_t gesture_frames = stats.frames[RADAR_MODE_GESTURE];
+    uint64_t actual = stats.cycles[RADAR_MODE_PRESENCE] + stats.cycles[RADAR_MODE_GESTURE];
+    uint64_t reference = (0u == gesture_frames) ? 0u :
+                         (stats.cycles[RADAR_MODE_GESTURE] / gesture_frames) * frame_count;
+
+    printf("%u frames (%.1f s), %u in the gesture mode (%.1f%% duty cycle), %u mode changes\n",
+           (unsigned)frame_count, (frame_count * REPLAY_FRAME_MS) / 1000.0, (unsigned)gesture_frames,
+           (0u == frame_count) ? 0.0 : (100.0 * gesture_frames) / frame_count, (unsigned)stats.transitions);
+    for (uint32_t mode = 0; mode < RADAR_MODE_COUNT; mode++)
+    {
+        printf("%s: %u frames, %llu %s/frame, %u ms\n", radar_mode_name((radar_mode_t)mode),
+               (unsigned)stats.frames[mode],
+               (unsigned long long)((stats.frames[mode] > 0u) ? (stats.cycles[mode] / stats.frames[mode]) : 0u),
+               ((0u != presence_cycles) || (0u != gesture_cycles)) ? "cycles" : REPLAY_CYCLE_UNIT,
+               (unsigned)stats.residency_ms[mode]);
+    }
+    printf("load: %u%% of always-on gesture processing, %llu of %llu saved (%s)\n",
+           (unsigned)radar_mode_load_percent(&stats),
+           (unsigned long long)((reference > actual) ? (reference - actual) : 0u), (unsigned long long)reference,
+           ((0u != presence_cycles) || (0u != gesture_cycles)) ? "cycles" : REPLAY_CYCLE_UNIT);
+
+    if (NULL == path)
+    {
+        /* The gesture mode starts with the first presence frame after the
+         * person arrived and ends idle_ms after the absence was reported */
+        uint32_t enter_min = (uint32_t)(scene_start * REPLAY_FRAME_MS);
+        uint32_t enter_max = (uint32_t)((scene_start + REPLAY_ENTER_FRAMES) * REPLAY_FRAME_MS);
+        uint32_t leave_min = (uint32_t)(scene_end * REPLAY_FRAME_MS) + idle_ms;
+        uint32_t leave_max = (uint32_t)((scene_end + REPLAY_ENTER_FRAMES) * REPLAY_FRAME_MS) +
+                             presence.absence_ms + idle_ms;
+
+        ok = (2u == transitions.count) &&
+             (transitions.time_ms[0] >= enter_min) && (transitions.time_ms[0] <= enter_max) &&
+             (transitions.time_ms[1] >= leave_min) && (transitions.time_ms[1] <= leave_max) &&
+             (radar_mode_load_percent(&stats) < 100u);
+        printf("person present %.3f s to %.3f s, gesture mode expected from %.3f s to %.3f..%.3f s\n",
+               enter_min / 1000.0, (scene_end * REPLAY_FRAME_MS) / 1000.0, enter_min / 1000.0,
+               leave_min / 1000.0, leave_max / 1000.0);
+        printf("%s\n", ok ? "PASS" : "FAIL");
+    }
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name:   radar_mode.c
+*
+* Description: This file implements the presence-first radar mode state
+*              machine. The radar stays on the low-rate presence profile and
+*              switches to the gesture profile only while presence is
+*              detected, dropping back after a configurable idle period.
+*              The state machine has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "radar_mode.h"
+
+/*******************************************************************************
+* Function Name: radar_mode_enter
+********************************************************************************
+* Summary:
+*  Switches to a new mode, updates the residency accounting and invokes the
+*  transition callback.
+*
+*******************************************************************************/
+static void radar_mode_enter(radar_mode_ctx_t *ctx, radar_mode_t mode, uint32_t now_ms)
+{
+    radar_mode_t from = ctx->mode;
+
+    if (from == mode)
+    {
+        return;
+    }
+
+    ctx->stats.residency_ms[from] += now_ms - ctx->mode_enter_ms;
+    ctx->stats.transitions++;
+    ctx->mode_enter_ms = now_ms;
+    ctx->mode = mode;
+
+    if (NULL != ctx->transition_cb)
+    {
+        ctx->transition_cb(from, mode, now_ms, ctx->transition_ctx);
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_init
+********************************************************************************
+* Summary:
+*  Initializes the state machine in the presence mode.
+*
+* Parameters:
+*  ctx     : state machine context
+*  config  : configuration, NULL selects the defaults
+*  cb      : transition callback, may be NULL
+*  cb_ctx  : user context passed to the callback
+*  now_ms  : current time in milliseconds
+*
+*******************************************************************************/
+void radar_mode_init(radar_mode_ctx_t *ctx, const radar_mode_config_t *config,
+                     radar_mode_transition_cb_t cb, void *cb_ctx, uint32_t now_ms)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->config.idle_timeout_ms = RADAR_IDLE_TIMEOUT_MS;
+    if (NULL != config)
+    {
+        ctx->config = *config;
+    }
+    ctx->mode = RADAR_MODE_PRESENCE;
+    ctx->mode_enter_ms = now_ms;
+    ctx->transition_cb = cb;
+    ctx->transition_ctx = cb_ctx;
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_set_presence
+********************************************************************************
+* Summary:
+*  Feeds a presence state change reported by the presence algorithm. Presence
+*  switches to the gesture mode immediately. Absence starts the idle period
+*  which is evaluated by radar_mode_update().
+*
+*******************************************************************************/
+void radar_mode_set_presence(radar_mode_ctx_t *ctx, bool present, uint32_t now_ms)
+{
+    if (present)
+    {
+        ctx->presence = true;
+        radar_mode_enter(ctx, RADAR_MODE_GESTURE, now_ms);
+    }
+    else if (ctx->presence)
+    {
+        ctx->presence = false;
+        ctx->absence_start_ms = now_ms;
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_notify_activity
+********************************************************************************
+* Summary:
+*  Restarts the idle period, e.g. when a gesture was recognized while the
+*  presence algorithm already reports absence.
+*
+*******************************************************************************/
+void radar_mode_notify_activity(radar_mode_ctx_t *ctx, uint32_t now_ms)
+{
+    if (!ctx->presence)
+    {
+        ctx->absence_start_ms = now_ms;
+    }
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_update
+********************************************************************************
+* Summary:
+*  Evaluates the idle timeout. Must be called once per radar frame.
+*
+* Return:
+*  The mode the current frame should be processed in.
+*
+*******************************************************************************/
+radar_mode_t radar_mode_update(radar_mode_ctx_t *ctx, uint32_t now_ms)
+{
+    if ((RADAR_MODE_GESTURE == ctx->mode) && !ctx->presence &&
+        ((now_ms - ctx->absence_start_ms) >= ctx->config.idle_timeout_ms))
+    {
+        radar_mode_enter(ctx, RADAR_MODE_PRESENCE, now_ms);
+    }
+
+    return ctx->mode;
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_account_frame
+********************************************************************************
+* Summary:
+*  Records the processing cost of one frame handled in the given mode.
+*
+*******************************************************************************/
+void radar_mode_account_frame(radar_mode_ctx_t *ctx, radar_mode_t mode, uint32_t cycles)
+{
+    ctx->stats.frames[mode]++;
+    ctx->stats.cycles[mode] += cycles;
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_get_stats
+********************************************************************************
+* Summary:
+*  Returns a snapshot of the statistics with the residency of the current
+*  mode accounted up to now_ms.
+*
+*******************************************************************************/
+void radar_mode_get_stats(const radar_mode_ctx_t *ctx, uint32_t now_ms, radar_mode_stats_t *stats)
+{
+    *stats = ctx->stats;
+    stats->residency_ms[ctx->mode] += now_ms - ctx->mode_enter_ms;
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_load_percent
+********************************************************************************
+* Summary:
+*  Estimates the processing load relative to running the gesture chain on
+*  every frame, using the average gesture frame cost as the reference.
+*
+* Return:
+*  Load in percent of the always-gesture load, 100 if no gesture frame has
+*  been measured yet.
+*
+*******************************************************************************/
+uint32_t radar_mode_load_percent(const radar_mode_stats_t *stats)
+{
+    uint32_t total_frames = stats->frames[RADAR_MODE_PRESENCE] + stats->frames[RADAR_MODE_GESTURE];
+    uint64_t total_cycles = stats->cycles[RADAR_MODE_PRESENCE] + stats->cycles[RADAR_MODE_GESTURE];
+
+    if ((0u == stats->frames[RADAR_MODE_GESTURE]) || (0u == total_frames))
+    {
+        return 100u;
+    }
+
+    uint64_t gesture_avg = stats->cycles[RADAR_MODE_GESTURE] / stats->frames[RADAR_MODE_GESTURE];
+    uint64_t reference = gesture_avg * total_frames;
+
+    return (0u == reference) ? 100u : (uint32_t)((total_cycles * 100u) / reference);
+}
+
+/*******************************************************************************
+* Function Name: radar_mode_name
+*******************************************************************************/
+const char* radar_mode_name(radar_mode_t mode)
+{
+    return (RADAR_MODE_GESTURE == mode) ? "gesture" : "presence";
+}
+
+/* [] END OF FILE */
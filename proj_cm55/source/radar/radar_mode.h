@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name:   radar_mode.h
+*
+* Description: This file contains the types and function prototypes of the
+*              presence-first radar mode state machine implemented in
+*              radar_mode.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef RADAR_MODE_H_
+#define RADAR_MODE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Time without presence after which the gesture profile is dropped */
+#ifndef RADAR_IDLE_TIMEOUT_MS
+#define RADAR_IDLE_TIMEOUT_MS               (5000u)
+#endif
+
+/* Presence profile: the presence algorithm runs on one of every
+ * RADAR_PRESENCE_FRAME_DECIMATION frames using the first
+ * RADAR_PRESENCE_NUM_CHIRPS chirps of RX antenna 1 */
+#define RADAR_PRESENCE_FRAME_DECIMATION     (3u)
+#define RADAR_PRESENCE_NUM_CHIRPS           (16u)
+#define RADAR_PRESENCE_ADC_NORMALIZE        (1.0f / 4096.0f)
+
+/*******************************************************************************
+* Enumeration
+*******************************************************************************/
+typedef enum
+{
+    RADAR_MODE_PRESENCE = 0,    /* Low-rate presence profile, gesture chain idle */
+    RADAR_MODE_GESTURE,         /* Full rate, slim_algo and gesture model running */
+    RADAR_MODE_COUNT
+} radar_mode_t;
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Invoked on every mode change, from the context calling into the state machine */
+typedef void (*radar_mode_transition_cb_t)(radar_mode_t from, radar_mode_t to,
+                                           uint32_t time_ms, void *ctx);
+
+typedef struct
+{
+    uint32_t idle_timeout_ms;
+} radar_mode_config_t;
+
+/* Per-mode accounting used to estimate the load saved by the presence profile */
+typedef struct
+{
+    uint32_t frames[RADAR_MODE_COUNT];
+    uint64_t cycles[RADAR_MODE_COUNT];
+    uint32_t residency_ms[RADAR_MODE_COUNT];
+    uint32_t transitions;
+} radar_mode_stats_t;
+
+typedef struct
+{
+    radar_mode_config_t         config;
+    radar_mode_t                mode;
+    bool                        presence;
+    uint32_t                    absence_start_ms;
+    uint32_t                    mode_enter_ms;
+    radar_mode_stats_t          stats;
+    radar_mode_transition_cb_t  transition_cb;
+    void                        *transition_ctx;
+} radar_mode_ctx_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void radar_mode_init(radar_mode_ctx_t *ctx, const radar_mode_config_t *config,
+                     radar_mode_transition_cb_t cb, void *cb_ctx, uint32_t now_ms);
+void radar_mode_set_presence(radar_mode_ctx_t *ctx, bool present, uint32_t now_ms);
+void radar_mode_notify_activity(radar_mode_ctx_t *ctx, uint32_t now_ms);
+radar_mode_t radar_mode_update(radar_mode_ctx_t *ctx, uint32_t now_ms);
+void radar_mode_account_frame(radar_mode_ctx_t *ctx, radar_mode_t mode, uint32_t cycles);
+void radar_mode_get_stats(const radar_mode_ctx_t *ctx, uint32_t now_ms, radar_mode_stats_t *stats);
+uint32_t radar_mode_load_percent(const radar_mode_stats_t *stats);
+const char* radar_mode_name(radar_mode_t mode);
+
+#endif /* RADAR_MODE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,64 @@
+/******************************************************************************
+* File Name:   audio_clip.h
+*
+* Description: This file contains the layout of the audio clip descriptor
+*              shared between the CM55, which records and freezes the clip,
+*              and the CM33, which uploads it.
+*
+*              The clip is a sequence of IMA-ADPCM blocks in a ring owned by
+*              the CM55. Every block starts with an audio_clip_block_header_t
+*              holding the coder state, followed by block_samples / 2 bytes
+*              with two 4-bit codes each, low nibble first. Blocks can be
+*              decoded independently of each other.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef AUDIO_CLIP_H_
+#define AUDIO_CLIP_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Enumeration
+*******************************************************************************/
+typedef enum
+{
+    AUDIO_CLIP_STATE_FREE = 0,      /* CM55 is recording, set by the CM33 when done */
+    AUDIO_CLIP_STATE_READY,         /* Clip frozen, set by the CM55 before notifying the CM33 */
+} audio_clip_state_t;
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Coder state at the first sample of a block */
+typedef struct
+{
+    int16_t     predictor;
+    uint8_t     step_index;
+    uint8_t     reserved;
+} audio_clip_block_header_t;
+
+/* Placed in shared memory, its address is sent with IPC_PAYLOAD_AUDIO_CLIP */
+typedef struct
+{
+    volatile uint32_t   state;          /* audio_clip_state_t */
+    uint32_t            clip_id;        /* Incremented for every clip */
+    uint32_t            label_id;       /* Class that triggered the clip */
+    uint32_t            sample_rate;
+    uint32_t            block_samples;
+    uint32_t            block_bytes;    /* Including the block header */
+    uint32_t            ring_addr;      /* System address of the block ring */
+    uint32_t            ring_blocks;
+    uint32_t            first_block;    /* Ring index of the oldest block of the clip */
+    uint32_t            block_count;
+    uint32_t            trigger_block;  /* Clip block in which the event was detected */
+} audio_clip_desc_t;
+
+#endif /* AUDIO_CLIP_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,49 @@
+/******************************************************************************
+* File Name:   ipc_batch.h
+*
+* Description: This file contains the types and function prototypes of the
+*              CM55 result coalescing implemented in ipc_batch.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_BATCH_H_
+#define IPC_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipc_payload.h"
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    /* Configuration */
+    uint32_t    max_count;      /* Messages per doorbell, 1 rings for every message */
+    uint32_t    window_us;      /* Longest a message waits for the rest of its batch */
+    /* State */
+    uint32_t    pending;        /* Messages in the ring the CM33 was not woken for */
+    uint32_t    start_us;       /* Timestamp of the first pending message */
+    bool        due;            /* Batch complete, the doorbell was not rung yet */
+    uint8_t     last_label[IPC_LABEL_MAX_MODELS];
+    /* Statistics */
+    uint32_t    batches;        /* Doorbells requested */
+    uint32_t    messages;       /* Messages covered by them */
+} ipc_batch_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_batch_init(ipc_batch_t *batch, uint32_t max_count, uint32_t window_us);
+bool ipc_batch_add(ipc_batch_t *batch, const ipc_payload_t *payload, bool pushed);
+bool ipc_batch_poll(ipc_batch_t *batch, uint32_t now_us);
+void ipc_batch_sent(ipc_batch_t *batch);
+
+#endif /* IPC_BATCH_H_ */
+
+/* [] END OF FILE */
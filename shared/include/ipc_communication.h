@@ -50,9 +50,18 @@
 * Header Files
 *******************************************************************************/
 #include <stdint.h>
+/* The host backend (COMPONENT_HOST/ipc_communication_posix.c) has no PDL */
+#if !defined(COMPONENT_HOST)
 #include "cybsp.h"
 #include "cy_pdl.h"
 #include "cy_ipc_pipe.h"
+#endif
+#include "ipc_payload.h"
+#include "ipc_ring.h"
+#include "ipc_batch.h"
+#include "ipc_control.h"
+#include "ipc_latency.h"
+#include "ipc_stream.h"
 
 /*******************************************************************************
 * Macros
@@ -84,23 +93,62 @@
 /* Combined Interrupt Mask */
 #define CY_IPC_CYPIPE_INTR_MASK         ( CY_IPC_CYPIPE_CHAN_MASK_EP1 | CY_IPC_CYPIPE_CHAN_MASK_EP2)
 
-/*******************************************************************************
-* Enumeration
-*******************************************************************************/
+/* Exchanges of a clock sync, the one with the shortest round trip is kept */
+#define CM33_IPC_CLOCK_SYNC_ROUNDS      (8UL)
+
+/* Longest wait for the answer of one clock sync exchange */
+#define CM33_IPC_CLOCK_SYNC_TIMEOUT_US  (2000UL)
+
+/* Attempts to ring the doorbell while the CM33 still handles the previous one */
+#define CY_IPC_DOORBELL_RETRIES         (1000UL)
+
+/* Interval at which the CM33 checks for the acknowledgement of a control request */
+#define CM33_IPC_CONTROL_POLL_MS        (10UL)
+
+/* Inference results coalesced into one doorbell, 1 rings for every result.
+ * Detections, class changes and the other messages always ring at once. */
+#ifndef CM55_IPC_BATCH_COUNT
+#define CM55_IPC_BATCH_COUNT            (IPC_RING_SLOTS / 2UL)
+#endif
 
-/* The actual payload being sent via IPC. This will vary b etween applications */
-typedef struct {
-    uint32_t    label_id;
-    char        label[256];
-} ipc_payload_t;
+/* Longest a result waits for the rest of its batch */
+#ifndef CM55_IPC_BATCH_WINDOW_US
+#define CM55_IPC_BATCH_WINDOW_US        (250000UL)
+#endif
 
+/* Bulk stream of model inputs, model outputs and IMU samples to the CM33,
+ * see ipc_stream.h. Off by default, it takes CM55_IPC_STREAM_SIZE bytes of
+ * SOCMEM. The stream control parameter selects the kinds at runtime. */
+#ifndef CM55_IPC_STREAM_ENABLE
+#define CM55_IPC_STREAM_ENABLE          (0)
+#endif
+
+/* Bytes of the stream buffer, a power of two */
+#ifndef CM55_IPC_STREAM_SIZE
+#define CM55_IPC_STREAM_SIZE            (16384UL)
+#endif
+
+/* Kinds streamed from boot, a mask of 1 << ipc_stream_kind_t */
+#ifndef CM55_IPC_STREAM_KINDS
+#define CM55_IPC_STREAM_KINDS           (IPC_STREAM_ALL_KINDS)
+#endif
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
 /* IPC Message structure */
-/* Pointer to this structure will be shared through IPC Pipe */
+/* Pointer to this structure will be shared through IPC Pipe. The message is
+ * only a doorbell, the payloads are in the rings it points to. The CM55 owns
+ * both rings, the doorbell of the CM33 leaves the pointers NULL. */
 typedef struct
 {
     uint8_t         client_id; /* This must be a part of the IPC structure */
     uint16_t        intr_mask; /* This must be a part of the IPC structure */
-    ipc_payload_t   payload;
+    ipc_ring_t      *ring;     /* CM55 to CM33 message ring in shared memory */
+    const ipc_label_table_t *labels; /* Names of the IDs in the messages, in shared memory */
+    ipc_ring_t      *control;  /* CM33 to CM55 control request ring in shared memory */
+    ipc_clock_sync_t *clock;   /* Clock sync exchange in shared memory */
+    ipc_stream_t    *stream;   /* Bulk stream in shared memory, NULL if not built in */
 } ipc_msg_t;
 
 /*******************************************************************************
@@ -111,7 +159,7 @@ void cm33_ipc_pipe_isr(void);
 void cm55_ipc_communication_setup(void);
 void cm55_ipc_pipe_isr(void);
 
-/* App functions for cm33 */
+/* App functions for cm33, to be called from a single task. They copy without masking interrupts. */
 bool cm33_ipc_has_received_message(void);
 void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target);
 
@@ -121,8 +169,82 @@ void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target);
    */
 bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target);
 
+/* Returns the last radar mode report (IPC_PAYLOAD_RADAR_MODE), if any was received. */
+bool cm33_ipc_safe_get_radar_mode(ipc_payload_t* target);
+
+/* Returns and clears the last audio clip notification (IPC_PAYLOAD_AUDIO_CLIP), if any. */
+bool cm33_ipc_safe_get_and_clear_audio_clip(ipc_payload_t* target);
+
+/* Returns the message ring statistics, false until the first message arrived. */
+bool cm33_ipc_get_stats(ipc_ring_stats_t* stats);
+
+/* Names of the IDs in the payloads, from the label table published by the CM55.
+   They return "" for an unknown ID or before the first message arrived. */
+const char* cm33_ipc_get_label(uint32_t label_id);
+const char* cm33_ipc_get_model_name(uint32_t model_id);
+const char* cm33_ipc_get_mode_name(uint32_t mode);
+
+/* Returns the model ID of a model name, -1 if the CM55 did not publish it. */
+int cm33_ipc_find_model(const char* name);
+
+/* Sends a control request to the CM55 and waits up to timeout_ms for its
+   acknowledgement. applied receives the value the CM55 applied, may be NULL.
+   Only one task may send control requests, and as the call blocks that task,
+   not from a callback of another library. */
+ipc_control_status_t cm33_ipc_control(uint32_t param, uint32_t model_id, int32_t value,
+                                      const uint8_t* args, int32_t* applied, uint32_t timeout_ms);
+
+/* Maps the CM55 time onto the CM33 time, needed by the latency stages that
+   cross the cores. Takes a few milliseconds at most, to be repeated now and
+   then as the clocks drift. Returns false if the CM55 did not answer. Called
+   from the task that sends the control requests. */
+bool cm33_ipc_sync_clock(void);
+
+/* Adds the CM33 stages of a message returned by the functions above, once its
+   telemetry was built at built_us and sent at published_us (timebase). */
+void cm33_ipc_latency_add_published(const ipc_payload_t* payload, uint32_t built_us, uint32_t published_us);
+void cm33_ipc_get_latency(ipc_latency_t* latency);
+
+/* Bulk stream records, read in place. cm33_ipc_stream_peek() returns the
+   oldest record, NULL if there is none or the CM55 has no stream, and
+   cm33_ipc_stream_release() hands it back to the CM55. To be called from a
+   single task. cm33_ipc_stream_get_stats() returns false without a stream. */
+const ipc_stream_record_t* cm33_ipc_stream_peek(void);
+void cm33_ipc_stream_release(void);
+bool cm33_ipc_stream_get_stats(ipc_stream_stats_t* stats);
+
 /* App functions for cm55 */
-ipc_payload_t* cm55_ipc_get_payload_ptr(void);
-void cm55_ipc_send_to_cm33(void);
+
+/* Label table setup, before the first message is sent. A model gets the next
+   model ID, its classes other than the background class 0 get consecutive
+   label IDs. cm55_ipc_add_model() returns -1 if the table is full. */
+int cm55_ipc_add_model(const char* name, const char* const* labels, uint32_t class_count);
+void cm55_ipc_add_mode(const char* name);
+void cm55_ipc_publish_labels(void);
+
+/* The send functions never block. They return false if the message was dropped
+   because the CM33 did not keep up and the ring is full. Results that repeat the
+   last class of their model are coalesced, the CM33 is woken once per batch.
+   capture_us is the time the data of a result was captured, inference_us the
+   time the model produced it, both from timebase_get_us(), 0 if unknown. */
+bool cm55_ipc_send_result(uint32_t model_id, uint32_t label_id, const uint8_t* scores, uint32_t score_count,
+                          uint32_t capture_us, uint32_t inference_us);
+bool cm55_ipc_send_radar_mode(uint32_t mode);
+bool cm55_ipc_send_audio_clip(uint32_t label_id, const void* clip);
+
+/* Bulk stream, from the sensor task only. cm55_ipc_stream_reserve() returns
+   where to write up to size bytes of a record of the given ipc_stream_kind_t,
+   NULL if the kind is not streamed or the CM33 did not keep up, in which case
+   the record is simply skipped. cm55_ipc_stream_commit() hands the record to
+   the CM33 with the bytes actually written. */
+void* cm55_ipc_stream_reserve(uint32_t kind, uint32_t model_id, uint32_t size);
+void cm55_ipc_stream_commit(uint32_t size);
+void cm55_ipc_get_stats(ipc_ring_stats_t* stats, uint32_t* doorbells, uint32_t* doorbell_failures);
+
+/* Control requests from the CM33. The sensor task sets the handler for its
+   own parameters and calls cm55_ipc_poll_control() between two frames, the
+   batch and stream parameters are handled by the IPC layer. */
+void cm55_ipc_set_control_handler(ipc_control_handler_t handler, void* ctx);
+void cm55_ipc_poll_control(void);
 
 #endif /* SOURCE_IPC_COMMUNICATION_H */
@@ -0,0 +1,50 @@
+/******************************************************************************
+* File Name:   ipc_control.h
+*
+* Description: This file contains the types and function prototypes of the
+*              CM33 to CM55 control requests implemented in ipc_control.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_CONTROL_H_
+#define IPC_CONTROL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipc_payload.h"
+#include "ipc_ring.h"
+#include "ipc_batch.h"
+#include "ipc_stream.h"
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Applies one request. The value can be adjusted to the value actually
+ * applied, it is returned in the acknowledgement. */
+typedef ipc_control_status_t (*ipc_control_handler_t)(const ipc_payload_t *request, int32_t *value, void *ctx);
+
+/* Sends an acknowledgement to the requester */
+typedef bool (*ipc_control_send_fn_t)(ipc_payload_t *ack, void *ctx);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_control_build_request(ipc_payload_t *request, uint16_t request_id, uint32_t param,
+                               uint32_t model_id, int32_t value, const uint8_t *args);
+uint32_t ipc_control_serve(ipc_ring_t *requests, ipc_control_handler_t handler,
+                           ipc_control_send_fn_t send_ack, void *ctx);
+/* Applies the batch and stream parameters of the IPC layer and passes the
+ * others to handler. stream is NULL if the bulk stream is not built in. */
+ipc_control_status_t ipc_control_apply(const ipc_payload_t *request, int32_t *value, ipc_batch_t *batch,
+                                       ipc_stream_t *stream, ipc_control_handler_t handler, void *ctx);
+int ipc_control_param_from_name(const char *name);
+const char* ipc_control_status_name(uint32_t status);
+
+#endif /* IPC_CONTROL_H_ */
+
+/* [] END OF FILE */
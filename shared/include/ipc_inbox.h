@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   ipc_inbox.h
+*
+* Description: This file contains the types and function prototypes of the
+*              CM33 receiving side implemented in ipc_inbox.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_INBOX_H_
+#define IPC_INBOX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ipc_payload.h"
+#include "ipc_ring.h"
+#include "ipc_mailbox.h"
+#include "ipc_latency.h"
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Waits poll_ms before the acknowledgement is checked again */
+typedef void (*ipc_inbox_delay_fn_t)(uint32_t poll_ms);
+
+/* Last message of each kind. The doorbell handler is the only writer of the
+ * mailboxes, a single task reads them. */
+typedef struct
+{
+    ipc_mailbox_t       result;         /* Last inference result */
+    ipc_mailbox_t       detection;      /* Last inference result with a detection */
+    ipc_mailbox_t       radar_mode;
+    ipc_mailbox_t       audio_clip;
+    ipc_mailbox_t       control_ack;
+    _Atomic uint32_t    message_count;  /* Messages other than acknowledgements received */
+    /* Mailbox versions already handed to the application, only used by the task */
+    uint32_t            message_seen;
+    uint32_t            detection_seen;
+    uint32_t            audio_clip_seen;
+    uint16_t            control_request_id; /* Number of the last control request, 0 is never used */
+    /* Latency stages, the doorbell handler adds the stages up to the arrival
+     * of a message, the task the rest. A copy may mix two updates of a histogram. */
+    ipc_latency_t       latency;
+} ipc_inbox_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_inbox_init(ipc_inbox_t *inbox);
+
+/* Doorbell handler side */
+void ipc_inbox_dispatch(ipc_inbox_t *inbox, const ipc_payload_t *message, uint32_t receive_us);
+
+/* Task side, see the cm33_ipc_ functions of ipc_communication.h */
+bool ipc_inbox_has_received_message(ipc_inbox_t *inbox);
+void ipc_inbox_copy_last_payload(const ipc_inbox_t *inbox, ipc_payload_t *target);
+bool ipc_inbox_get_and_clear_cached_detection(ipc_inbox_t *inbox, ipc_payload_t *target);
+bool ipc_inbox_get_radar_mode(const ipc_inbox_t *inbox, ipc_payload_t *target);
+bool ipc_inbox_get_and_clear_audio_clip(ipc_inbox_t *inbox, ipc_payload_t *target);
+
+/* Control requests. send_control queues the request in the ring of the CM55,
+ * which the caller then wakes; wait_control_ack polls for the answer every
+ * poll_ms. */
+bool ipc_inbox_send_control(ipc_inbox_t *inbox, ipc_ring_t *control, uint32_t param, uint32_t model_id,
+                            int32_t value, const uint8_t *args);
+ipc_control_status_t ipc_inbox_wait_control_ack(ipc_inbox_t *inbox, int32_t *applied, uint32_t timeout_ms,
+                                                uint32_t poll_ms, ipc_inbox_delay_fn_t delay);
+
+#endif /* IPC_INBOX_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,37 @@
+/******************************************************************************
+* File Name:   ipc_labels.h
+*
+* Description: This file contains the function prototypes of the label
+*              table implemented in ipc_labels.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_LABELS_H_
+#define IPC_LABELS_H_
+
+#include <stdint.h>
+#include "ipc_payload.h"
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Writer side, the CM55 before the first message */
+int ipc_labels_add_model(ipc_label_table_t *table, const char *name, const char *const *labels,
+                         uint32_t class_count);
+void ipc_labels_add_mode(ipc_label_table_t *table, const char *name);
+void ipc_labels_publish(ipc_label_table_t *table);
+
+/* Reader side. table may be NULL, an incomplete table reads as empty. */
+const char* ipc_labels_get_label(const ipc_label_table_t *table, uint32_t label_id);
+const char* ipc_labels_get_model_name(const ipc_label_table_t *table, uint32_t model_id);
+const char* ipc_labels_get_mode_name(const ipc_label_table_t *table, uint32_t mode);
+int ipc_labels_find_model(const ipc_label_table_t *table, const char *name);
+
+#endif /* IPC_LABELS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   ipc_latency.h
+*
+* Description: This file contains the types and function prototypes of the
+*              end-to-end latency statistics and the CM55 to CM33 clock
+*              mapping implemented in ipc_latency.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_LATENCY_H_
+#define IPC_LATENCY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ipc_payload.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Bucket b of a stage histogram counts latencies below 2^b us, the last
+ * bucket everything above */
+#define IPC_LATENCY_BUCKETS                 (24u)
+
+/*******************************************************************************
+* Enumeration
+*******************************************************************************/
+/* Stages of a result from the sensor to the cloud */
+typedef enum {
+    IPC_LATENCY_INFERENCE = 0,  /* CM55: capture of the data to the model result */
+    IPC_LATENCY_SEND,           /* CM55: model result to the message in the ring */
+    IPC_LATENCY_RECEIVE,        /* Message in the ring to the CM33 taking it, needs the clock mapping */
+    IPC_LATENCY_QUEUE,          /* CM33: message taken to its telemetry built, mostly the wait for the next report */
+    IPC_LATENCY_PUBLISH,        /* CM33: telemetry built to iotcl_mqtt_send_telemetry() returning */
+    IPC_LATENCY_TOTAL,          /* Capture to iotcl_mqtt_send_telemetry() returning, needs the clock mapping */
+    IPC_LATENCY_STAGE_COUNT
+} ipc_latency_stage_t;
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Clock sync exchange in shared memory. The CM33 advances request and rings
+ * the CM55 doorbell, the CM55 interrupt stores its time and sets response
+ * to request. */
+typedef struct
+{
+    _Atomic uint32_t    request;
+    _Atomic uint32_t    response;
+    uint32_t            cm55_us;
+} ipc_clock_sync_t;
+
+typedef struct
+{
+    uint32_t    count;
+    uint32_t    max_us;
+    uint64_t    total_us;
+    uint32_t    histogram[IPC_LATENCY_BUCKETS];
+} ipc_latency_hist_t;
+
+/* Statistics of the CM33. Each stage has a single writer: the doorbell
+ * callback adds the CM55 and receive stages, the telemetry task the rest and
+ * the clock mapping. */
+typedef struct
+{
+    ipc_latency_hist_t  stages[IPC_LATENCY_STAGE_COUNT];
+    bool                synced;         /* offset_us is valid */
+    int32_t             offset_us;      /* CM55 time minus CM33 time */
+    uint32_t            sync_rtt_us;    /* Round trip of the sample offset_us was taken from */
+    uint32_t            syncs;
+    /* Best sample of the sync in progress */
+    bool                round_valid;
+    int32_t             round_offset_us;
+    uint32_t            round_rtt_us;
+} ipc_latency_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_latency_init(ipc_latency_t *lat);
+void ipc_latency_add(ipc_latency_t *lat, ipc_latency_stage_t stage, uint32_t latency_us);
+uint32_t ipc_latency_percentile(const ipc_latency_t *lat, ipc_latency_stage_t stage, uint32_t permille);
+const char* ipc_latency_stage_name(uint32_t stage);
+
+/* Clock mapping. A sync takes several samples, each a CM33 time before the
+ * request, the CM55 time of the answer and a CM33 time after it, and keeps
+ * the one with the shortest round trip. */
+void ipc_latency_sync_begin(ipc_latency_t *lat);
+void ipc_latency_sync_sample(ipc_latency_t *lat, uint32_t cm33_before_us, uint32_t cm55_us, uint32_t cm33_after_us);
+bool ipc_latency_sync_end(ipc_latency_t *lat);
+uint32_t ipc_latency_to_cm33(const ipc_latency_t *lat, uint32_t cm55_us);
+
+/* Stage accounting of a message, on arrival and once it was published */
+void ipc_latency_add_received(ipc_latency_t *lat, const ipc_payload_t *payload);
+void ipc_latency_add_published(ipc_latency_t *lat, const ipc_payload_t *payload,
+                               uint32_t built_us, uint32_t published_us);
+
+#endif /* IPC_LATENCY_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,52 @@
+/******************************************************************************
+* File Name:   ipc_mailbox.h
+*
+* Description: This file contains the types and function prototypes of the
+*              latest-value mailbox implemented in ipc_mailbox.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_MAILBOX_H_
+#define IPC_MAILBOX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ipc_payload.h"
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Last message of one kind. One writer (the IPC interrupt), any number of
+ * readers. The sequence is odd while the writer updates the payload and
+ * advances by two per message, so sequence / 2 is the number of messages
+ * written. */
+typedef struct
+{
+    _Atomic uint32_t    sequence;
+    ipc_payload_t       payload;
+} ipc_mailbox_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_mailbox_init(ipc_mailbox_t *box);
+
+/* Writer side */
+void ipc_mailbox_write(ipc_mailbox_t *box, const ipc_payload_t *payload);
+
+/* Reader side. try_read fails while the writer is updating the payload,
+ * read retries until it gets a consistent copy. The version is the number
+ * of messages written, 0 if none yet. */
+bool ipc_mailbox_try_read(const ipc_mailbox_t *box, ipc_payload_t *payload, uint32_t *version);
+uint32_t ipc_mailbox_read(const ipc_mailbox_t *box, ipc_payload_t *payload);
+uint32_t ipc_mailbox_version(const ipc_mailbox_t *box);
+
+#endif /* IPC_MAILBOX_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,121 @@
+/******************************************************************************
+* File Name:   ipc_payload.h
+*
+* Description: This file contains the layout of the messages the CM55 sends
+*              to the CM33 and of the label table they refer to. It has no
+*              hardware dependencies, so the message ring can be built and
+*              exercised on a host.
+*
+*              The CM33 sends control requests the other way in the same
+*              layout, the CM55 answers each with an acknowledgement.
+*
+*              Messages only carry numeric IDs. The CM55 publishes the model,
+*              class and radar mode names once at startup in the label
+*              table, which stays in shared memory and is read in place by
+*              the CM33.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_PAYLOAD_H_
+#define IPC_PAYLOAD_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Per-class scores carried by a result */
+#define IPC_MAX_SCORES                      (12u)
+
+/* Label table capacity. Label IDs are unique across the models of the
+ * CM55 application, 0 is the background class of every model. */
+#define IPC_LABEL_MAX_COUNT                 (32u)
+#define IPC_LABEL_MAX_MODELS                (4u)
+#define IPC_LABEL_MAX_MODES                 (4u)
+#define IPC_LABEL_SIZE                      (24u)
+
+#define IPC_LABEL_TABLE_MAGIC               (0x4C424C53u)   /* "SLBL" */
+
+/*******************************************************************************
+* Enumeration
+*******************************************************************************/
+/* Kind of data carried by an IPC payload */
+typedef enum {
+    IPC_PAYLOAD_INFERENCE = 0,  /* label_id/scores carry a model result */
+    IPC_PAYLOAD_RADAR_MODE,     /* label_id carries the new radar mode */
+    IPC_PAYLOAD_AUDIO_CLIP,     /* label_id carries the event, data_addr the audio_clip_desc_t */
+    IPC_PAYLOAD_CONTROL,        /* CM33 to CM55: label_id carries the ipc_control_param_t, model_id the target */
+    IPC_PAYLOAD_CONTROL_ACK,    /* CM55 to CM33: the request with its outcome in control */
+} ipc_payload_type_t;
+
+/* Runtime parameters of the CM55 pipeline a control request can set */
+typedef enum {
+    IPC_CONTROL_BATCH_COUNT = 0,    /* Inference results per doorbell, 1..IPC_RING_SLOTS */
+    IPC_CONTROL_BATCH_WINDOW_MS,    /* Longest a result waits for its batch */
+    IPC_CONTROL_SENSITIVITY,        /* Model post-processing: confidence in percent, args average,
+                                       subsequent, pool, pool selection. 0 restores the defaults */
+    IPC_CONTROL_GATE,               /* 1 skips the models on background audio, 0 feeds every frame */
+    IPC_CONTROL_GATE_OPEN_RATIO,    /* Energy above the noise floor that opens the gate, in percent */
+    IPC_CONTROL_PREPROCESSING,      /* 0 block conversion with CMSIS-DSP, 1 per-sample reference */
+    IPC_CONTROL_STREAM,             /* Mask of the ipc_stream_kind_t in the bulk stream, 0 stops it */
+    IPC_CONTROL_PARAM_COUNT
+} ipc_control_param_t;
+
+/* Outcome of a control request */
+typedef enum {
+    IPC_CONTROL_STATUS_OK = 0,
+    IPC_CONTROL_STATUS_UNSUPPORTED, /* Parameter or model not used by this CM55 application */
+    IPC_CONTROL_STATUS_INVALID,     /* Value out of range */
+    IPC_CONTROL_STATUS_FAILED,      /* The model refused the value */
+    IPC_CONTROL_STATUS_NOT_SENT,    /* CM33 only: no CM55 yet or the request ring is full */
+    IPC_CONTROL_STATUS_TIMEOUT,     /* CM33 only: no acknowledgement in time */
+} ipc_control_status_t;
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* The actual payload being sent via IPC. This will vary between applications */
+typedef struct {
+    uint8_t     type;           /* ipc_payload_type_t */
+    uint8_t     model_id;       /* Index of the model in the label table */
+    uint8_t     label_id;       /* Index of the class in the label table, or the radar mode */
+    uint8_t     score_count;    /* Valid entries in scores */
+    uint32_t    seq;            /* Producer sequence number, gaps indicate dropped messages */
+    uint32_t    timestamp;      /* CM55 time of the send in microseconds, wraps around */
+    uint32_t    capture_us;     /* CM55 time the data behind a result was captured, 0 if unknown */
+    uint32_t    inference_us;   /* CM55 time the model produced the result, 0 if unknown */
+    uint32_t    receive_us;     /* CM33 time the message was taken from the ring, set by the CM33 */
+    union {
+        uint8_t     scores[IPC_MAX_SCORES];     /* Per-class confidence of the model, 0..255 */
+        uint32_t    data_addr;                  /* System address of additional data, 0 if none */
+        struct {
+            uint16_t    request;                /* Request number chosen by the CM33, echoed in the ack */
+            uint8_t     status;                 /* ipc_control_status_t, acknowledgements only */
+            uint8_t     reserved;
+            int32_t     value;                  /* Requested value, the applied value in the ack */
+            uint8_t     args[4];                /* Further arguments of the parameter */
+        } control;
+    };
+} ipc_payload_t;
+
+/* Names of the IDs used by the messages, written once by the CM55 before
+ * the first message and read only afterwards */
+typedef struct {
+    uint32_t    magic;          /* IPC_LABEL_TABLE_MAGIC once the table is complete */
+    uint8_t     label_count;
+    uint8_t     model_count;
+    uint8_t     mode_count;
+    uint8_t     reserved;
+    char        labels[IPC_LABEL_MAX_COUNT][IPC_LABEL_SIZE];
+    char        models[IPC_LABEL_MAX_MODELS][IPC_LABEL_SIZE];
+    char        modes[IPC_LABEL_MAX_MODES][IPC_LABEL_SIZE];
+} ipc_label_table_t;
+
+#endif /* IPC_PAYLOAD_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name:   ipc_ring.h
+*
+* Description: This file contains the types and function prototypes of the
+*              CM55 to CM33 message ring implemented in ipc_ring.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_RING_H_
+#define IPC_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "ipc_payload.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of message slots, a power of two */
+#ifndef IPC_RING_SLOTS
+#define IPC_RING_SLOTS                      (8u)
+#endif
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    /* Written by the producer */
+    uint32_t    sent;           /* Messages handed to the consumer */
+    uint32_t    dropped;        /* Messages refused because the ring was full */
+    uint32_t    high_water;     /* Most messages waiting for the consumer */
+    /* Written by the consumer */
+    uint32_t    received;       /* Messages taken by the consumer */
+    uint32_t    lost;           /* Sequence numbers the consumer never saw */
+} ipc_ring_stats_t;
+
+/* Single producer (CM55), single consumer (CM33) ring in shared memory.
+ * Slots tail..head-1 hold messages for the consumer, all others are free.
+ * Each side only writes its own index and its own statistics, so neither
+ * side needs a lock or has to wait for the other. */
+typedef struct
+{
+    _Atomic uint32_t    head;
+    _Atomic uint32_t    tail;
+    uint32_t            next_seq;       /* Producer */
+    uint32_t            expected_seq;   /* Consumer */
+    ipc_ring_stats_t    stats;
+    ipc_payload_t       slots[IPC_RING_SLOTS];
+} ipc_ring_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_ring_init(ipc_ring_t *ring);
+
+/* Producer side */
+bool ipc_ring_push(ipc_ring_t *ring, const ipc_payload_t *payload);
+bool ipc_ring_try_push(ipc_ring_t *ring, const ipc_payload_t *payload);
+
+/* Consumer side */
+const ipc_payload_t* ipc_ring_peek(ipc_ring_t *ring);
+void ipc_ring_release(ipc_ring_t *ring);
+
+uint32_t ipc_ring_depth(const ipc_ring_t *ring);
+void ipc_ring_get_stats(const ipc_ring_t *ring, ipc_ring_stats_t *stats);
+
+#endif /* IPC_RING_H_ */
+
+/* [] END OF FILE */
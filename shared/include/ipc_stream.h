@@ -0,0 +1,148 @@
+/******************************************************************************
+* File Name:   ipc_stream.h
+*
+* Description: This file contains the types and function prototypes of the
+*              bulk stream ring and of its serial framing implemented in
+*              ipc_stream.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_STREAM_H_
+#define IPC_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Largest record data, the frame decoder buffers one record */
+#define IPC_STREAM_MAX_DATA                 (1024u)
+
+/* Records start on this boundary in the ring */
+#define IPC_STREAM_ALIGN                    (4u)
+
+/* Serial frame: sync bytes, record header, data, CRC-16/CCITT of header and
+ * data, all little endian */
+#define IPC_STREAM_FRAME_SYNC0              (0xA5u)
+#define IPC_STREAM_FRAME_SYNC1              (0x5Au)
+#define IPC_STREAM_FRAME_HEADER_SIZE        (2u + sizeof(ipc_stream_record_t))
+#define IPC_STREAM_FRAME_OVERHEAD           (IPC_STREAM_FRAME_HEADER_SIZE + 2u)
+
+/* Size of one IPC_STREAM_IMU sample */
+#define IPC_STREAM_IMU_SAMPLE_SIZE          (14u)
+
+/*******************************************************************************
+* Enumeration
+*******************************************************************************/
+/* Content of a record, source is the model ID of the producer */
+typedef enum {
+    IPC_STREAM_FEATURES = 0,    /* float32 model input of one frame */
+    IPC_STREAM_OUTPUTS,         /* int32 raw model output of one frame */
+    IPC_STREAM_IMU,             /* Samples of int16 acc[3], int16 gyr[3], uint8 flags, one pad byte */
+    IPC_STREAM_KIND_COUNT,
+    IPC_STREAM_PAD = 0xFF       /* Ring only: the rest of the ring up to the wrap is unused */
+} ipc_stream_kind_t;
+
+#define IPC_STREAM_ALL_KINDS                ((1u << IPC_STREAM_KIND_COUNT) - 1u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    uint8_t     kind;           /* ipc_stream_kind_t */
+    uint8_t     source;         /* Model ID of the producer */
+    uint16_t    size;           /* Bytes of data following the header */
+    uint32_t    seq;            /* Advanced for every record, including the dropped ones */
+    uint32_t    timestamp;      /* Producer time in microseconds */
+} ipc_stream_record_t;
+
+typedef struct
+{
+    /* Written by the producer */
+    uint32_t    records;        /* Records handed to the consumer */
+    uint32_t    dropped;        /* Records refused because the ring was full */
+    uint32_t    bytes;          /* Data bytes handed to the consumer */
+    uint32_t    high_water;     /* Most bytes waiting for the consumer */
+    /* Written by the consumer */
+    uint32_t    received;       /* Records taken by the consumer */
+    uint32_t    lost;           /* Sequence numbers the consumer never saw */
+} ipc_stream_stats_t;
+
+/* Single producer (CM55), single consumer (CM33) ring of variable size
+ * records. Bytes tail..head-1 of the buffer hold records for the consumer.
+ * A record never wraps, the producer pads the end of the buffer instead.
+ * The producer builds a record in place between ipc_stream_reserve() and
+ * ipc_stream_commit(), the consumer reads it in place between
+ * ipc_stream_peek() and ipc_stream_release(). */
+typedef struct
+{
+    _Atomic uint32_t    head;
+    _Atomic uint32_t    tail;
+    _Atomic uint32_t    kinds;          /* Mask of the kinds the producer streams */
+    uint32_t            size;           /* Bytes of the buffer, a power of two */
+    intptr_t            buffer_offset;  /* Buffer address minus stream address, the same in
+                                           every process mapping both, e.g. on a host */
+    /* Producer */
+    uint32_t            next_seq;
+    uint32_t            reserved_head;  /* Head at the start of the reserved record */
+    ipc_stream_record_t *reserved;      /* NULL without a reserved record */
+    /* Consumer */
+    uint32_t            expected_seq;
+    ipc_stream_stats_t  stats;
+} ipc_stream_t;
+
+/* Serial frame decoder state */
+typedef struct
+{
+    uint32_t            state;
+    uint32_t            count;
+    uint16_t            crc;
+    uint8_t             header[sizeof(ipc_stream_record_t)];
+    ipc_stream_record_t record;
+    uint8_t             data[IPC_STREAM_MAX_DATA];
+    /* Statistics */
+    uint32_t            frames;         /* Valid frames */
+    uint32_t            crc_errors;     /* Frames with a wrong CRC or size */
+    uint32_t            skipped;        /* Bytes outside of frames, e.g. console text */
+} ipc_stream_decoder_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void ipc_stream_init(ipc_stream_t *stream, void *buffer, uint32_t size, uint32_t kinds);
+
+/* Producer side */
+void* ipc_stream_reserve(ipc_stream_t *stream, uint32_t kind, uint32_t source, uint32_t size, uint32_t timestamp);
+const ipc_stream_record_t* ipc_stream_commit(ipc_stream_t *stream, uint32_t size);
+
+/* Consumer side */
+const ipc_stream_record_t* ipc_stream_peek(ipc_stream_t *stream);
+void ipc_stream_release(ipc_stream_t *stream);
+void ipc_stream_get_stats(const ipc_stream_t *stream, ipc_stream_stats_t *stats);
+
+static inline const uint8_t* ipc_stream_record_data(const ipc_stream_record_t *record)
+{
+    return (const uint8_t *)(record + 1);
+}
+
+const char* ipc_stream_kind_name(uint32_t kind);
+
+/* Framing */
+uint16_t ipc_stream_crc16(uint16_t crc, const void *data, size_t length);
+uint16_t ipc_stream_frame_header(const ipc_stream_record_t *record, uint8_t *header);
+size_t ipc_stream_frame_encode(const ipc_stream_record_t *record, uint8_t *frame, size_t size);
+void ipc_stream_decoder_init(ipc_stream_decoder_t *decoder);
+bool ipc_stream_decode(ipc_stream_decoder_t *decoder, uint8_t byte);
+
+#endif /* IPC_STREAM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,41 @@
+/******************************************************************************
+* File Name:   timebase.h
+*
+* Description: This file contains the function prototypes of the monotonic
+*              timebase implemented in timebase.c, used by all sensor tasks
+*              and by the IPC of both cores.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Size of the text written by timebase_format_hms(), "hhhh:mm:ss" and the
+ * terminating null. The milliseconds wrap after 1193 hours. */
+#define TIMEBASE_HMS_SIZE                   (11u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void timebase_init(void);
+uint64_t timebase_get_cycles(void);
+uint32_t timebase_get_cycles32(void);
+uint32_t timebase_get_cycles_per_us(void);
+uint64_t timebase_get_us(void);
+uint32_t timebase_get_ms(void);
+void timebase_format_hms(uint32_t milliseconds, char *text, size_t size);
+
+#endif /* TIMEBASE_H_ */
+
+/* [] END OF FILE */
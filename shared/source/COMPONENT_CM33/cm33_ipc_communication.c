@@ -46,8 +46,13 @@
 #include <string.h>
 #include "cybsp.h"
 #include "FreeRTOS.h"
+#include "task.h"
 #include "retarget_io_init.h"
 #include "ipc_communication.h"
+#include "ipc_inbox.h"
+#include "ipc_labels.h"
+#include "ipc_latency.h"
+#include "timebase.h"
 
 
 /*******************************************************************************
@@ -63,32 +68,43 @@ static cy_ipc_pipe_callback_ptr_t ep1_cb_array[CY_IPC_CYPIPE_CLIENT_CNT];
 CY_SECTION_SHAREDMEM
 static uint32_t ipc_sema_array[CY_IPC_SEMA_COUNT / CY_IPC_SEMA_PER_WORD];
 
-/* Local copy of the IPC message received
-   This copy is not safe to be accessed from a task.
-   A task must make its own copy of this structure
-   while guarding the copying with taskENTER_CRITICAL() and taskEXIT_CRITICAL()
+/* Doorbell for the control requests, read by the CM55 pipe interrupt */
+CY_SECTION_SHAREDMEM
+static ipc_msg_t cm33_msg_data;
+
+/* Last IPC messages received, one mailbox per kind (ipc_inbox.c)
+   The doorbell callback is the only writer. Tasks copy a message through the
+   sequence lock of ipc_mailbox.c, which retries instead of masking interrupts.
 */
-static ipc_msg_t ipc_recv_msg = {0};
-static ipc_payload_t ipc_last_detection_payload = {0};
-static bool ipc_has_saved_detection = false; // will be set upon receipt. reset when value is checked
-static bool ipc_has_received_message = false; // will be set upon receipt. reset when value is checked
+static ipc_inbox_t ipc_inbox;
+static ipc_ring_t *ipc_ring = NULL; // CM55 message ring, known once the first doorbell arrives
+static const ipc_label_table_t *ipc_labels = NULL; // CM55 label table, known once the first doorbell arrives
+static ipc_ring_t *ipc_control_ring = NULL; // CM55 control request ring, known once the first doorbell arrives
+static ipc_clock_sync_t *ipc_clock = NULL; // CM55 clock sync exchange, known once the first doorbell arrives
+static ipc_stream_t *ipc_stream = NULL; // CM55 bulk stream if built in, known once the first doorbell arrives
 
 
 /*******************************************************************************
-* Function Name: cm33_ipc_pipe_isr
+* Function Name: cm33_msg_callback
 ********************************************************************************
-* Callback for receipt of message from cm55
+* Callback for the doorbell from cm55. Drains every message in the ring, so a
+* doorbell rung while the previous one was handled loses nothing.
 *******************************************************************************/
 static void cm33_msg_callback(uint32_t * msg_data)
 {
     if (msg_data != NULL) {
-        /* Copy the message received into our own copy IPC structure */
-        memcpy(&ipc_recv_msg, (void *) msg_data, sizeof(ipc_recv_msg));
-        if (ipc_recv_msg.payload.label_id != 0) {
-            memcpy(&ipc_last_detection_payload, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-            ipc_has_saved_detection = true;
+        const ipc_msg_t *msg = (const ipc_msg_t *) msg_data;
+        const ipc_payload_t *payload;
+
+        ipc_ring = msg->ring;
+        ipc_labels = msg->labels;
+        ipc_control_ring = msg->control;
+        ipc_clock = msg->clock;
+        ipc_stream = msg->stream;
+        while (NULL != (payload = ipc_ring_peek(ipc_ring))) {
+            ipc_inbox_dispatch(&ipc_inbox, payload, (uint32_t)timebase_get_us());
+            ipc_ring_release(ipc_ring);
         }
-        ipc_has_received_message = true;
     }
 }
 
@@ -161,6 +177,11 @@ void cm33_ipc_communication_setup(void)
 
     Cy_IPC_Sema_Init(IPC0_SEMA_CH_NUM, CY_IPC_SEMA_COUNT, ipc_sema_array);
 
+    ipc_inbox_init(&ipc_inbox);
+
+    cm33_msg_data.client_id = CM55_IPC_PIPE_CLIENT_ID;
+    cm33_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP1;
+
     Cy_IPC_Pipe_Config(cm33_ipc_pipe_ep_array);
 
     Cy_IPC_Pipe_Init(&cm33_ipc_pipe_config);
@@ -177,32 +198,179 @@ void cm33_ipc_communication_setup(void)
 
 bool cm33_ipc_has_received_message(void)
 {
-    taskENTER_CRITICAL();
-    bool ret = ipc_has_received_message;
-    ipc_has_received_message = false;
-    taskEXIT_CRITICAL();
-    return ret;
+    return ipc_inbox_has_received_message(&ipc_inbox);
 }
 
 void cm33_ipc_safe_copy_last_payload(ipc_payload_t* target)
 {
-    taskENTER_CRITICAL();
-    memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-    taskEXIT_CRITICAL();
+    ipc_inbox_copy_last_payload(&ipc_inbox, target);
 }
 
 bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t* target)
 {
-    taskENTER_CRITICAL();
-    if (ipc_has_saved_detection) {
-        memcpy(target, &ipc_last_detection_payload, sizeof(ipc_payload_t));
-        ipc_has_saved_detection = false;
-        taskEXIT_CRITICAL();
-        return true;
-    } else { 
-        // else use the last payload - it will not have a detection
-        memcpy(target, &ipc_recv_msg.payload, sizeof(ipc_payload_t));
-        taskEXIT_CRITICAL();
+    return ipc_inbox_get_and_clear_cached_detection(&ipc_inbox, target);
+}
+
+bool cm33_ipc_safe_get_radar_mode(ipc_payload_t* target)
+{
+    return ipc_inbox_get_radar_mode(&ipc_inbox, target);
+}
+
+bool cm33_ipc_safe_get_and_clear_audio_clip(ipc_payload_t* target)
+{
+    return ipc_inbox_get_and_clear_audio_clip(&ipc_inbox, target);
+}
+
+bool cm33_ipc_get_stats(ipc_ring_stats_t* stats)
+{
+    if (ipc_ring == NULL) {
+        return false;
+    }
+    ipc_ring_get_stats(ipc_ring, stats);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_get_label
+********************************************************************************
+* Names from the label table once the CM55 completed it, see ipc_labels.c
+*******************************************************************************/
+const char* cm33_ipc_get_label(uint32_t label_id)
+{
+    return ipc_labels_get_label(ipc_labels, label_id);
+}
+
+const char* cm33_ipc_get_model_name(uint32_t model_id)
+{
+    return ipc_labels_get_model_name(ipc_labels, model_id);
+}
+
+const char* cm33_ipc_get_mode_name(uint32_t mode)
+{
+    return ipc_labels_get_mode_name(ipc_labels, mode);
+}
+
+int cm33_ipc_find_model(const char* name)
+{
+    return ipc_labels_find_model(ipc_labels, name);
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_ring_doorbell
+********************************************************************************
+* Wakes the CM55 for a control request or a clock sync
+*******************************************************************************/
+static void cm33_ipc_ring_doorbell(void)
+{
+    cy_en_ipc_pipe_status_t pipe_status = CY_IPC_PIPE_ERROR_SEND_BUSY;
+
+    for (uint32_t i = 0; (i < CY_IPC_DOORBELL_RETRIES) && (CY_IPC_PIPE_SUCCESS != pipe_status); i++) {
+        pipe_status = Cy_IPC_Pipe_SendMessage(CM55_IPC_PIPE_EP_ADDR,
+                                 CM33_IPC_PIPE_EP_ADDR,
+                                 (void *) &cm33_msg_data, 0);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_delay_ms
+*******************************************************************************/
+static void cm33_ipc_delay_ms(uint32_t delay_ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_control
+********************************************************************************
+* Queues a control request for the CM55, rings its doorbell and waits for the
+* acknowledgement, see ipc_inbox_wait_control_ack().
+*******************************************************************************/
+ipc_control_status_t cm33_ipc_control(uint32_t param, uint32_t model_id, int32_t value,
+                                      const uint8_t* args, int32_t* applied, uint32_t timeout_ms)
+{
+    if (ipc_control_ring == NULL ||
+        !ipc_inbox_send_control(&ipc_inbox, ipc_control_ring, param, model_id, value, args)) {
+        return IPC_CONTROL_STATUS_NOT_SENT;
+    }
+
+    /* A failed doorbell shows up as a timeout, the next one still delivers the request */
+    cm33_ipc_ring_doorbell();
+
+    return ipc_inbox_wait_control_ack(&ipc_inbox, applied, timeout_ms, CM33_IPC_CONTROL_POLL_MS,
+                                      cm33_ipc_delay_ms);
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_sync_clock
+********************************************************************************
+* Asks the CM55 for its time a few times and keeps the exchange with the
+* shortest round trip. The CM55 answers in its doorbell interrupt, so an
+* exchange takes a few microseconds unless an interrupt delays one of the
+* cores, and such an exchange is not the one kept. An answer that arrives
+* after its timeout is ignored by the next exchange, it answers an older
+* request.
+*******************************************************************************/
+bool cm33_ipc_sync_clock(void)
+{
+    ipc_clock_sync_t *clock = ipc_clock;
+
+    if (clock == NULL) {
+        return false;
+    }
+    ipc_latency_sync_begin(&ipc_inbox.latency);
+    for (uint32_t round = 0; round < CM33_IPC_CLOCK_SYNC_ROUNDS; round++) {
+        uint32_t request = atomic_load_explicit(&clock->request, memory_order_relaxed) + 1u;
+        uint32_t before_us = (uint32_t)timebase_get_us();
+
+        atomic_store_explicit(&clock->request, request, memory_order_release);
+        cm33_ipc_ring_doorbell();
+        while (atomic_load_explicit(&clock->response, memory_order_acquire) != request) {
+            if (((uint32_t)timebase_get_us() - before_us) > CM33_IPC_CLOCK_SYNC_TIMEOUT_US) {
+                break;
+            }
+        }
+        if (atomic_load_explicit(&clock->response, memory_order_acquire) == request) {
+            ipc_latency_sync_sample(&ipc_inbox.latency, before_us, clock->cm55_us, (uint32_t)timebase_get_us());
+        }
+    }
+    return ipc_latency_sync_end(&ipc_inbox.latency);
+}
+
+void cm33_ipc_latency_add_published(const ipc_payload_t* payload, uint32_t built_us, uint32_t published_us)
+{
+    ipc_latency_add_published(&ipc_inbox.latency, payload, built_us, published_us);
+}
+
+void cm33_ipc_get_latency(ipc_latency_t* latency)
+{
+    memcpy(latency, &ipc_inbox.latency, sizeof(ipc_latency_t));
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_stream_peek
+********************************************************************************
+* Returns the oldest bulk stream record, read in place. The CM55 does not ring
+* the doorbell for the stream, the task polls it.
+*******************************************************************************/
+const ipc_stream_record_t* cm33_ipc_stream_peek(void)
+{
+    ipc_stream_t *stream = ipc_stream;
+
+    return (stream == NULL) ? NULL : ipc_stream_peek(stream);
+}
+
+void cm33_ipc_stream_release(void)
+{
+    if (ipc_stream != NULL) {
+        ipc_stream_release(ipc_stream);
+    }
+}
+
+bool cm33_ipc_stream_get_stats(ipc_stream_stats_t* stats)
+{
+    if (ipc_stream == NULL) {
         return false;
     }
+    ipc_stream_get_stats(ipc_stream, stats);
+    return true;
 }
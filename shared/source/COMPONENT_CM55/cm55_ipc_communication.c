@@ -43,7 +43,11 @@
  * Authors: Nikola Markovic <nikola.markovic@avnet.com>, Shu Liu <shu.liu@avnet.com> et al.
  */
 
+#include <string.h>
 #include "ipc_communication.h"
+#include "timebase.h"
+#include "ipc_latency.h"
+#include "ipc_labels.h"
 
 /*******************************************************************************
 * Global Variable(s)
@@ -54,20 +58,30 @@ static cy_stc_ipc_pipe_ep_t cm55_ipc_pipe_array[CY_IPC_MAX_ENDPOINTS];
 /* CB Array for EP2 */
 static cy_ipc_pipe_callback_ptr_t ep2_cb_array[CY_IPC_CYPIPE_CLIENT_CNT];
 
+/* Doorbell message and the rings and label table it points to, read by the CM33 */
 CY_SECTION_SHAREDMEM static ipc_msg_t cm55_msg_data;
+CY_SECTION_SHAREDMEM static ipc_ring_t cm55_ring;
+CY_SECTION_SHAREDMEM static ipc_label_table_t cm55_labels;
+CY_SECTION_SHAREDMEM static ipc_ring_t cm55_control_ring;
+CY_SECTION_SHAREDMEM static ipc_clock_sync_t cm55_clock;
+#if CM55_IPC_STREAM_ENABLE
+CY_SECTION_SHAREDMEM static ipc_stream_t cm55_stream;
 
+/* Written back from the data cache by ipc_stream_commit() */
+CY_SECTION(".cy_socmem_data") CY_ALIGN(32)
+static uint8_t cm55_stream_buffer[CM55_IPC_STREAM_SIZE];
+#endif
 
-__STATIC_INLINE void handle_app_error(void)
-{
-    /* Disable all interrupts. */
-    __disable_irq();
-
-    CY_ASSERT(0);
+/* Doorbells that could not be rung, the message waits for the next one */
+static uint32_t cm55_doorbell_failures;
 
-    /* Infinite loop */
-    while(true);
+/* Results the CM33 was not woken for yet */
+static ipc_batch_t cm55_batch;
 
-}
+/* Set by the CM33 doorbell, cleared when the control requests are served */
+static volatile bool cm55_control_pending;
+static ipc_control_handler_t cm55_control_handler;
+static void *cm55_control_ctx;
 
 /*******************************************************************************
 * Function Name: Cy_SysIpcPipeIsrCm55
@@ -87,6 +101,26 @@ void Cy_SysIpcPipeIsrCm55(void)
     Cy_IPC_Pipe_ExecuteCallback(CM55_IPC_PIPE_EP_ADDR);
 }
 
+/*******************************************************************************
+* Function Name: cm55_msg_callback
+********************************************************************************
+* Callback for the doorbell from cm33. The requests are applied by the sensor
+* task in cm55_ipc_poll_control(), never in the middle of a frame. A clock
+* sync request is answered here, so its round trip does not depend on the
+* sensor task.
+*******************************************************************************/
+static void cm55_msg_callback(uint32_t * msg_data)
+{
+    uint32_t request = atomic_load_explicit(&cm55_clock.request, memory_order_acquire);
+
+    (void)msg_data;
+    if (request != atomic_load_explicit(&cm55_clock.response, memory_order_relaxed)) {
+        cm55_clock.cm55_us = (uint32_t)timebase_get_us();
+        atomic_store_explicit(&cm55_clock.response, request, memory_order_release);
+    }
+    cm55_control_pending = true;
+}
+
 
 /*******************************************************************************
 * Function Name: cm55_ipc_communication_setup
@@ -136,28 +170,244 @@ void cm55_ipc_communication_setup(void)
     .userPipeIsrHandler            = &Cy_SysIpcPipeIsrCm55
     };
 
+    ipc_ring_init(&cm55_ring);
+    ipc_ring_init(&cm55_control_ring);
+    ipc_batch_init(&cm55_batch, CM55_IPC_BATCH_COUNT, CM55_IPC_BATCH_WINDOW_US);
+    memset(&cm55_labels, 0, sizeof(cm55_labels));
+    atomic_init(&cm55_clock.request, 0u);
+    atomic_init(&cm55_clock.response, 0u);
+    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
+    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+    cm55_msg_data.ring = &cm55_ring;
+    cm55_msg_data.labels = &cm55_labels;
+    cm55_msg_data.control = &cm55_control_ring;
+    cm55_msg_data.clock = &cm55_clock;
+#if CM55_IPC_STREAM_ENABLE
+    ipc_stream_init(&cm55_stream, cm55_stream_buffer, CM55_IPC_STREAM_SIZE, CM55_IPC_STREAM_KINDS);
+    cm55_msg_data.stream = &cm55_stream;
+#else
+    cm55_msg_data.stream = NULL;
+#endif
+
     Cy_IPC_Pipe_Config(cm55_ipc_pipe_array);
 
     Cy_IPC_Pipe_Init(&cm55_ipc_pipe_config);
+
+    /* Register a callback function to handle the control doorbell from the CM33 */
+    if (CY_IPC_PIPE_SUCCESS != Cy_IPC_Pipe_RegisterCallback(CM55_IPC_PIPE_EP_ADDR, &cm55_msg_callback,
+                                                            (uint32_t)CM55_IPC_PIPE_CLIENT_ID)) {
+        CY_ASSERT(0);
+    }
 }
 
 
-ipc_payload_t* cm55_ipc_get_payload_ptr(void)
+/*******************************************************************************
+* Function Name: cm55_ipc_add_model
+********************************************************************************
+* Summary:
+*  Label table setup in shared memory, see ipc_labels.c. The CM33 only uses
+*  the table once cm55_ipc_publish_labels() completed it.
+*
+*******************************************************************************/
+int cm55_ipc_add_model(const char* name, const char* const* labels, uint32_t class_count)
 {
-    return &cm55_msg_data.payload;
+    return ipc_labels_add_model(&cm55_labels, name, labels, class_count);
 }
 
-void cm55_ipc_send_to_cm33(void)
+void cm55_ipc_add_mode(const char* name)
 {
-    cy_en_ipc_pipe_status_t pipe_status;
+    ipc_labels_add_mode(&cm55_labels, name);
+}
 
-    cm55_msg_data.client_id = CM33_IPC_PIPE_CLIENT_ID;
-    cm55_msg_data.intr_mask = CY_IPC_CYPIPE_INTR_MASK_EP2;
+void cm55_ipc_publish_labels(void)
+{
+    ipc_labels_publish(&cm55_labels);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_ring_doorbell
+********************************************************************************
+* Summary:
+*  Wakes the CM33, which then drains every message in the ring. The pipe
+*  channel is busy while the CM33 still handles the previous doorbell, which
+*  only takes a few microseconds, so the send is retried a bounded number of
+*  times instead of failing. A doorbell that is still pending already covers
+*  the new message as well.
+*
+* Return :
+*  false if the doorbell could not be rung.
+*
+*******************************************************************************/
+static bool cm55_ipc_ring_doorbell(void)
+{
+    cy_en_ipc_pipe_status_t pipe_status = CY_IPC_PIPE_ERROR_SEND_BUSY;
 
-    pipe_status = Cy_IPC_Pipe_SendMessage(CM33_IPC_PIPE_EP_ADDR,
-                             CM55_IPC_PIPE_EP_ADDR,
-                             (void *) &cm55_msg_data, 0);
+    for (uint32_t i = 0; (i < CY_IPC_DOORBELL_RETRIES) && (CY_IPC_PIPE_SUCCESS != pipe_status); i++)
+    {
+        pipe_status = Cy_IPC_Pipe_SendMessage(CM33_IPC_PIPE_EP_ADDR,
+                                 CM55_IPC_PIPE_EP_ADDR,
+                                 (void *) &cm55_msg_data, 0);
+    }
     if (CY_IPC_PIPE_SUCCESS != pipe_status) {
-        handle_app_error();
+        cm55_doorbell_failures++;
+        return false;
     }
-}
\ No newline at end of file
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_send_message
+********************************************************************************
+* Summary:
+*  Puts a message in the ring and wakes the CM33 once the batch is complete.
+*  A doorbell that could not be rung leaves the batch pending, so the next
+*  message tries again.
+*
+*******************************************************************************/
+static bool cm55_ipc_send_message(ipc_payload_t* payload)
+{
+    bool sent;
+
+    payload->timestamp = (uint32_t)timebase_get_us();
+    sent = ipc_ring_push(&cm55_ring, payload);
+
+    /* Also rings when full, the CM33 may not have been woken yet */
+    if (ipc_batch_add(&cm55_batch, payload, sent) && cm55_ipc_ring_doorbell()) {
+        ipc_batch_sent(&cm55_batch);
+    }
+
+    return sent;
+}
+
+bool cm55_ipc_send_result(uint32_t model_id, uint32_t label_id, const uint8_t* scores, uint32_t score_count,
+                          uint32_t capture_us, uint32_t inference_us)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_INFERENCE,
+        .model_id = (uint8_t)model_id,
+        .label_id = (uint8_t)label_id,
+        .capture_us = capture_us,
+        .inference_us = inference_us
+    };
+
+    if (score_count > IPC_MAX_SCORES) {
+        score_count = IPC_MAX_SCORES;
+    }
+    if (scores != NULL) {
+        memcpy(payload.scores, scores, score_count);
+        payload.score_count = (uint8_t)score_count;
+    }
+    return cm55_ipc_send_message(&payload);
+}
+
+bool cm55_ipc_send_radar_mode(uint32_t mode)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_RADAR_MODE,
+        .label_id = (uint8_t)mode
+    };
+
+    return cm55_ipc_send_message(&payload);
+}
+
+bool cm55_ipc_send_audio_clip(uint32_t label_id, const void* clip)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_AUDIO_CLIP,
+        .label_id = (uint8_t)label_id,
+        .data_addr = (uint32_t)(uintptr_t)clip
+    };
+
+    return cm55_ipc_send_message(&payload);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_stream_reserve
+********************************************************************************
+* Summary:
+*  Reserves a bulk stream record stamped with the current time. The CM33 is
+*  not woken, it polls the stream.
+*
+*******************************************************************************/
+void* cm55_ipc_stream_reserve(uint32_t kind, uint32_t model_id, uint32_t size)
+{
+#if CM55_IPC_STREAM_ENABLE
+    return ipc_stream_reserve(&cm55_stream, kind, model_id, size, (uint32_t)timebase_get_us());
+#else
+    (void)kind;
+    (void)model_id;
+    (void)size;
+    return NULL;
+#endif
+}
+
+void cm55_ipc_stream_commit(uint32_t size)
+{
+#if CM55_IPC_STREAM_ENABLE
+    (void)ipc_stream_commit(&cm55_stream, size);
+#else
+    (void)size;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_control
+********************************************************************************
+* Summary:
+*  Applies one control request, see ipc_control_apply().
+*
+*******************************************************************************/
+static ipc_control_status_t cm55_ipc_control(const ipc_payload_t* request, int32_t* value, void* ctx)
+{
+    (void)ctx;
+#if CM55_IPC_STREAM_ENABLE
+    return ipc_control_apply(request, value, &cm55_batch, &cm55_stream, cm55_control_handler, cm55_control_ctx);
+#else
+    return ipc_control_apply(request, value, &cm55_batch, NULL, cm55_control_handler, cm55_control_ctx);
+#endif
+}
+
+static bool cm55_ipc_send_control_ack(ipc_payload_t* ack, void* ctx)
+{
+    (void)ctx;
+    return cm55_ipc_send_message(ack);
+}
+
+void cm55_ipc_set_control_handler(ipc_control_handler_t handler, void* ctx)
+{
+    cm55_control_ctx = ctx;
+    cm55_control_handler = handler;
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_poll_control
+********************************************************************************
+* Summary:
+*  Applies the control requests the CM33 sent since the last call. Called by
+*  the sensor task, which is also the only sender of messages, so the
+*  acknowledgements keep the message ring single producer. Also rings for a
+*  batch that waited for its window without being completed.
+*
+*******************************************************************************/
+void cm55_ipc_poll_control(void)
+{
+    if (ipc_batch_poll(&cm55_batch, (uint32_t)timebase_get_us()) && cm55_ipc_ring_doorbell()) {
+        ipc_batch_sent(&cm55_batch);
+    }
+    if (!cm55_control_pending) {
+        return;
+    }
+    cm55_control_pending = false;
+    (void)ipc_control_serve(&cm55_control_ring, cm55_ipc_control, cm55_ipc_send_control_ack, NULL);
+}
+
+void cm55_ipc_get_stats(ipc_ring_stats_t* stats, uint32_t* doorbells, uint32_t* doorbell_failures)
+{
+    ipc_ring_get_stats(&cm55_ring, stats);
+    if (doorbells != NULL) {
+        *doorbells = cm55_batch.batches;
+    }
+    if (doorbell_failures != NULL) {
+        *doorbell_failures = cm55_doorbell_failures;
+    }
+}
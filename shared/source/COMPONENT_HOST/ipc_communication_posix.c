@@ -0,0 +1,689 @@
+/******************************************************************************
+* File Name:   ipc_communication_posix.c
+*
+* Description: This file implements ipc_communication.h on a Linux host, so
+*              the CM55 and the CM33 side can run as two processes. The
+*              rings and the label table the CM55 keeps in shared SRAM are
+*              placed in a POSIX shared memory object instead, and the IPC
+*              pipe doorbells become counters in the same object. The CM33
+*              doorbell is a futex: a receiver thread stands in for the pipe
+*              interrupt, sleeps on it and drains the ring into the same
+*              mailboxes the CM33 uses. The CM55 checks its own counter in
+*              cm55_ipc_poll_control(), as the pipe callback only sets a
+*              flag there. Messages are stamped with CLOCK_MONOTONIC, which
+*              is shared by both processes, so the clock sync needs no
+*              exchange and the receiver keeps the same latency stages as
+*              the CM33 (ipc_latency.h). The bulk stream is always built
+*              in, its buffer follows the stream in the same object.
+*
+*              The CM55 process initialises the shared memory object, the
+*              CM33 process waits for that before it touches the rings, so
+*              the two can be started in any order.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "ipc_posix.h"
+#include "ipc_inbox.h"
+#include "ipc_labels.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define IPC_POSIX_MAGIC                     (0x58534F50u)   /* "POSX" */
+
+/* Longest the receiver sleeps before it checks whether it has to stop */
+#define IPC_POSIX_WAIT_MS                   (100u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Content of the shared memory object, what the CM55 places in shared SRAM */
+typedef struct
+{
+    _Atomic uint32_t    magic;          /* IPC_POSIX_MAGIC once the CM55 initialised the rest */
+    _Atomic uint32_t    cm33_doorbell;  /* Futex word, advanced by the CM55 for every doorbell */
+    _Atomic uint32_t    cm55_doorbell;  /* Advanced by the CM33 for every control request */
+    ipc_ring_t          ring;
+    ipc_ring_t          control;
+    ipc_label_table_t   labels;
+    ipc_stream_t        stream;
+    uint8_t             stream_buffer[CM55_IPC_STREAM_SIZE] __attribute__((aligned(IPC_STREAM_ALIGN)));
+} ipc_posix_shared_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *ipc_posix_name = IPC_POSIX_DEFAULT_NAME;
+static ipc_posix_shared_t *ipc_shared = NULL;
+
+/* CM55 side */
+static ipc_batch_t cm55_batch;
+static uint32_t cm55_doorbell_seen;
+static ipc_control_handler_t cm55_control_handler;
+static void *cm55_control_ctx;
+
+/* CM33 side, the receiver thread is the only writer of the mailboxes */
+static pthread_t cm33_receiver;
+static bool cm33_receiver_started = false;
+static _Atomic bool cm33_receiver_stop;
+static _Atomic bool cm33_attached;      /* The CM55 initialised the shared memory */
+static ipc_posix_latency_t cm33_latency;
+static ipc_inbox_t cm33_inbox;
+
+/*******************************************************************************
+* Function Name: ipc_posix_set_name
+*******************************************************************************/
+void ipc_posix_set_name(const char *name)
+{
+    ipc_posix_name = name;
+}
+
+/*******************************************************************************
+* Function Name: ipc_posix_now_us
+*******************************************************************************/
+uint32_t ipc_posix_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000u) + ((uint64_t)now.tv_nsec / 1000u));
+}
+
+/*******************************************************************************
+* Function Name: ipc_posix_map
+********************************************************************************
+* Summary:
+*  Opens the shared memory object, creating it if the other process did not
+*  yet, and maps it. A new object reads as zeros, so it is not initialised
+*  until the CM55 sets the magic.
+*
+* Return:
+*  false if the object could not be created or mapped.
+*
+*******************************************************************************/
+static bool ipc_posix_map(void)
+{
+    int fd;
+    void *shared;
+
+    if (NULL != ipc_shared)
+    {
+        return true;
+    }
+    fd = shm_open(ipc_posix_name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+    {
+        perror("shm_open");
+        return false;
+    }
+    if (0 != ftruncate(fd, sizeof(ipc_posix_shared_t)))
+    {
+        perror("ftruncate");
+        close(fd);
+        return false;
+    }
+    shared = mmap(NULL, sizeof(ipc_posix_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == shared)
+    {
+        perror("mmap");
+        return false;
+    }
+    ipc_shared = (ipc_posix_shared_t *)shared;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ipc_posix_futex_wait
+********************************************************************************
+* Summary:
+*  Sleeps until the word no longer holds value, a wake up or the timeout.
+*  The shared futex works across processes as the word is in a shared
+*  mapping.
+*
+*******************************************************************************/
+static void ipc_posix_futex_wait(_Atomic uint32_t *word, uint32_t value, uint32_t timeout_ms)
+{
+    struct timespec timeout = {
+        .tv_sec = (time_t)(timeout_ms / 1000u),
+        .tv_nsec = (long)(timeout_ms % 1000u) * 1000000L
+    };
+
+    (void)syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+/*******************************************************************************
+* Function Name: ipc_posix_futex_wake
+*******************************************************************************/
+static void ipc_posix_futex_wake(_Atomic uint32_t *word)
+{
+    (void)syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/*******************************************************************************
+* Function Name: ipc_posix_close
+*******************************************************************************/
+void ipc_posix_close(bool destroy)
+{
+    if (cm33_receiver_started)
+    {
+        atomic_store(&cm33_receiver_stop, true);
+        ipc_posix_futex_wake(&ipc_shared->cm33_doorbell);
+        pthread_join(cm33_receiver, NULL);
+        cm33_receiver_started = false;
+    }
+    if (NULL != ipc_shared)
+    {
+        munmap(ipc_shared, sizeof(ipc_posix_shared_t));
+        ipc_shared = NULL;
+    }
+    if (destroy)
+    {
+        (void)shm_unlink(ipc_posix_name);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_communication_setup
+********************************************************************************
+* Summary:
+*  Initialises the rings and the label table in the shared memory object.
+*  The magic is cleared first, so a CM33 process still attached to an
+*  earlier run stops reading until the object is consistent again.
+*
+*******************************************************************************/
+void cm55_ipc_communication_setup(void)
+{
+    if (!ipc_posix_map())
+    {
+        return;
+    }
+    atomic_store(&ipc_shared->magic, 0u);
+    ipc_ring_init(&ipc_shared->ring);
+    ipc_ring_init(&ipc_shared->control);
+    memset(&ipc_shared->labels, 0, sizeof(ipc_shared->labels));
+    ipc_stream_init(&ipc_shared->stream, ipc_shared->stream_buffer, CM55_IPC_STREAM_SIZE, CM55_IPC_STREAM_KINDS);
+    ipc_batch_init(&cm55_batch, CM55_IPC_BATCH_COUNT, CM55_IPC_BATCH_WINDOW_US);
+    cm55_doorbell_seen = atomic_load(&ipc_shared->cm55_doorbell);
+    atomic_store_explicit(&ipc_shared->magic, IPC_POSIX_MAGIC, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_add_model
+********************************************************************************
+* Summary:
+*  Label table setup in the shared memory object, see ipc_labels.c.
+*
+*******************************************************************************/
+int cm55_ipc_add_model(const char *name, const char *const *labels, uint32_t class_count)
+{
+    if (NULL == ipc_shared)
+    {
+        return -1;
+    }
+    return ipc_labels_add_model(&ipc_shared->labels, name, labels, class_count);
+}
+
+void cm55_ipc_add_mode(const char *name)
+{
+    if (NULL != ipc_shared)
+    {
+        ipc_labels_add_mode(&ipc_shared->labels, name);
+    }
+}
+
+void cm55_ipc_publish_labels(void)
+{
+    if (NULL != ipc_shared)
+    {
+        ipc_labels_publish(&ipc_shared->labels);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_send_message
+********************************************************************************
+* Summary:
+*  Puts a message in the ring and wakes the CM33 once the batch is complete.
+*  The futex wake cannot be busy like the pipe channel, so the doorbell
+*  never fails.
+*
+*******************************************************************************/
+static bool cm55_ipc_send_message(ipc_payload_t *payload)
+{
+    bool sent;
+
+    if (NULL == ipc_shared)
+    {
+        return false;
+    }
+    payload->timestamp = ipc_posix_now_us();
+    sent = ipc_ring_push(&ipc_shared->ring, payload);
+
+    if (ipc_batch_add(&cm55_batch, payload, sent))
+    {
+        atomic_fetch_add_explicit(&ipc_shared->cm33_doorbell, 1u, memory_order_release);
+        ipc_posix_futex_wake(&ipc_shared->cm33_doorbell);
+        ipc_batch_sent(&cm55_batch);
+    }
+
+    return sent;
+}
+
+bool cm55_ipc_send_result(uint32_t model_id, uint32_t label_id, const uint8_t *scores, uint32_t score_count,
+                          uint32_t capture_us, uint32_t inference_us)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_INFERENCE,
+        .model_id = (uint8_t)model_id,
+        .label_id = (uint8_t)label_id,
+        .capture_us = capture_us,
+        .inference_us = inference_us
+    };
+
+    if (score_count > IPC_MAX_SCORES)
+    {
+        score_count = IPC_MAX_SCORES;
+    }
+    if (NULL != scores)
+    {
+        memcpy(payload.scores, scores, score_count);
+        payload.score_count = (uint8_t)score_count;
+    }
+    return cm55_ipc_send_message(&payload);
+}
+
+bool cm55_ipc_send_radar_mode(uint32_t mode)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_RADAR_MODE,
+        .label_id = (uint8_t)mode
+    };
+
+    return cm55_ipc_send_message(&payload);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_send_audio_clip
+********************************************************************************
+* Summary:
+*  Sends the notification only. The clip address means nothing in the other
+*  process, so the CM33 side must not follow it.
+*
+*******************************************************************************/
+bool cm55_ipc_send_audio_clip(uint32_t label_id, const void *clip)
+{
+    ipc_payload_t payload = {
+        .type = IPC_PAYLOAD_AUDIO_CLIP,
+        .label_id = (uint8_t)label_id,
+        .data_addr = (uint32_t)(uintptr_t)clip
+    };
+
+    return cm55_ipc_send_message(&payload);
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_stream_reserve
+*******************************************************************************/
+void* cm55_ipc_stream_reserve(uint32_t kind, uint32_t model_id, uint32_t size)
+{
+    if (NULL == ipc_shared)
+    {
+        return NULL;
+    }
+    return ipc_stream_reserve(&ipc_shared->stream, kind, model_id, size, ipc_posix_now_us());
+}
+
+void cm55_ipc_stream_commit(uint32_t size)
+{
+    if (NULL != ipc_shared)
+    {
+        (void)ipc_stream_commit(&ipc_shared->stream, size);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_control
+********************************************************************************
+* Summary:
+*  Applies one control request, see ipc_control_apply().
+*
+*******************************************************************************/
+static ipc_control_status_t cm55_ipc_control(const ipc_payload_t *request, int32_t *value, void *ctx)
+{
+    (void)ctx;
+    return ipc_control_apply(request, value, &cm55_batch, &ipc_shared->stream, cm55_control_handler,
+                             cm55_control_ctx);
+}
+
+static bool cm55_ipc_send_control_ack(ipc_payload_t *ack, void *ctx)
+{
+    (void)ctx;
+    return cm55_ipc_send_message(ack);
+}
+
+void cm55_ipc_set_control_handler(ipc_control_handler_t handler, void *ctx)
+{
+    cm55_control_ctx = ctx;
+    cm55_control_handler = handler;
+}
+
+/*******************************************************************************
+* Function Name: cm55_ipc_poll_control
+********************************************************************************
+* Summary:
+*  Applies the control requests the CM33 sent since the last call, if its
+*  doorbell counter moved. Also rings for a batch that waited for its window
+*  without being completed.
+*
+*******************************************************************************/
+void cm55_ipc_poll_control(void)
+{
+    uint32_t doorbell;
+
+    if (NULL == ipc_shared)
+    {
+        return;
+    }
+    if (ipc_batch_poll(&cm55_batch, ipc_posix_now_us()))
+    {
+        atomic_fetch_add_explicit(&ipc_shared->cm33_doorbell, 1u, memory_order_release);
+        ipc_posix_futex_wake(&ipc_shared->cm33_doorbell);
+        ipc_batch_sent(&cm55_batch);
+    }
+    doorbell = atomic_load_explicit(&ipc_shared->cm55_doorbell, memory_order_acquire);
+    if (doorbell == cm55_doorbell_seen)
+    {
+        return;
+    }
+    cm55_doorbell_seen = doorbell;
+    (void)ipc_control_serve(&ipc_shared->control, cm55_ipc_control, cm55_ipc_send_control_ack, NULL);
+}
+
+void cm55_ipc_get_stats(ipc_ring_stats_t *stats, uint32_t *doorbells, uint32_t *doorbell_failures)
+{
+    if (NULL == ipc_shared)
+    {
+        memset(stats, 0, sizeof(*stats));
+    }
+    else
+    {
+        ipc_ring_get_stats(&ipc_shared->ring, stats);
+    }
+    if (NULL != doorbells)
+    {
+        *doorbells = cm55_batch.batches;
+    }
+    if (NULL != doorbell_failures)
+    {
+        *doorbell_failures = 0u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_pipe_isr
+********************************************************************************
+* Summary:
+*  Drains every message in the ring, what the doorbell callback does on the
+*  CM33. Called by the receiver thread for every doorbell.
+*
+*******************************************************************************/
+void cm33_ipc_pipe_isr(void)
+{
+    const ipc_payload_t *payload;
+
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return;
+    }
+    cm33_latency.doorbells++;
+    while (NULL != (payload = ipc_ring_peek(&ipc_shared->ring)))
+    {
+        cm33_latency.messages++;
+        ipc_inbox_dispatch(&cm33_inbox, payload, ipc_posix_now_us());
+        ipc_ring_release(&ipc_shared->ring);
+    }
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_receiver
+********************************************************************************
+* Summary:
+*  Stands in for the pipe interrupt: sleeps on the doorbell futex and drains
+*  the ring whenever the counter moved. A doorbell rung before the CM55
+*  initialised the shared memory is ignored, as the pipe would not deliver
+*  it either.
+*
+*******************************************************************************/
+static void* cm33_ipc_receiver(void *arg)
+{
+    uint32_t seen = atomic_load(&ipc_shared->cm33_doorbell);
+    uint32_t doorbell;
+
+    (void)arg;
+    while (!atomic_load(&cm33_receiver_stop))
+    {
+        ipc_posix_futex_wait(&ipc_shared->cm33_doorbell, seen, IPC_POSIX_WAIT_MS);
+        doorbell = atomic_load_explicit(&ipc_shared->cm33_doorbell, memory_order_acquire);
+        if (doorbell == seen)
+        {
+            continue;
+        }
+        seen = doorbell;
+        if (IPC_POSIX_MAGIC == atomic_load_explicit(&ipc_shared->magic, memory_order_acquire))
+        {
+            atomic_store_explicit(&cm33_attached, true, memory_order_release);
+            cm33_ipc_pipe_isr();
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_communication_setup
+*******************************************************************************/
+void cm33_ipc_communication_setup(void)
+{
+    ipc_inbox_init(&cm33_inbox);
+    atomic_init(&cm33_attached, false);
+    atomic_init(&cm33_receiver_stop, false);
+    memset(&cm33_latency, 0, sizeof(cm33_latency));
+
+    if (!ipc_posix_map())
+    {
+        return;
+    }
+    if (0 == pthread_create(&cm33_receiver, NULL, cm33_ipc_receiver, NULL))
+    {
+        cm33_receiver_started = true;
+    }
+}
+
+bool cm33_ipc_has_received_message(void)
+{
+    return ipc_inbox_has_received_message(&cm33_inbox);
+}
+
+void cm33_ipc_safe_copy_last_payload(ipc_payload_t *target)
+{
+    ipc_inbox_copy_last_payload(&cm33_inbox, target);
+}
+
+bool cm33_ipc_safe_get_and_clear_cached_detection(ipc_payload_t *target)
+{
+    return ipc_inbox_get_and_clear_cached_detection(&cm33_inbox, target);
+}
+
+bool cm33_ipc_safe_get_radar_mode(ipc_payload_t *target)
+{
+    return ipc_inbox_get_radar_mode(&cm33_inbox, target);
+}
+
+bool cm33_ipc_safe_get_and_clear_audio_clip(ipc_payload_t *target)
+{
+    return ipc_inbox_get_and_clear_audio_clip(&cm33_inbox, target);
+}
+
+bool cm33_ipc_get_stats(ipc_ring_stats_t *stats)
+{
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return false;
+    }
+    ipc_ring_get_stats(&ipc_shared->ring, stats);
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_stream_peek
+*******************************************************************************/
+const ipc_stream_record_t* cm33_ipc_stream_peek(void)
+{
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return NULL;
+    }
+    return ipc_stream_peek(&ipc_shared->stream);
+}
+
+void cm33_ipc_stream_release(void)
+{
+    if (atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        ipc_stream_release(&ipc_shared->stream);
+    }
+}
+
+bool cm33_ipc_stream_get_stats(ipc_stream_stats_t *stats)
+{
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return false;
+    }
+    ipc_stream_get_stats(&ipc_shared->stream, stats);
+    return true;
+}
+
+void cm33_ipc_posix_get_latency(ipc_posix_latency_t *latency)
+{
+    memcpy(latency, &cm33_latency, sizeof(*latency));
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_sync_clock
+********************************************************************************
+* Summary:
+*  Both processes read CLOCK_MONOTONIC, so one sample without a round trip
+*  gives the exact mapping, an offset of 0.
+*
+*******************************************************************************/
+bool cm33_ipc_sync_clock(void)
+{
+    uint32_t now_us = ipc_posix_now_us();
+
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return false;
+    }
+    ipc_latency_sync_begin(&cm33_inbox.latency);
+    ipc_latency_sync_sample(&cm33_inbox.latency, now_us, now_us, now_us);
+    return ipc_latency_sync_end(&cm33_inbox.latency);
+}
+
+void cm33_ipc_latency_add_published(const ipc_payload_t *payload, uint32_t built_us, uint32_t published_us)
+{
+    ipc_latency_add_published(&cm33_inbox.latency, payload, built_us, published_us);
+}
+
+void cm33_ipc_get_latency(ipc_latency_t *latency)
+{
+    memcpy(latency, &cm33_inbox.latency, sizeof(*latency));
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_get_labels
+*******************************************************************************/
+static const ipc_label_table_t* cm33_ipc_get_labels(void)
+{
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire))
+    {
+        return NULL;
+    }
+    return &ipc_shared->labels;
+}
+
+const char* cm33_ipc_get_label(uint32_t label_id)
+{
+    return ipc_labels_get_label(cm33_ipc_get_labels(), label_id);
+}
+
+const char* cm33_ipc_get_model_name(uint32_t model_id)
+{
+    return ipc_labels_get_model_name(cm33_ipc_get_labels(), model_id);
+}
+
+const char* cm33_ipc_get_mode_name(uint32_t mode)
+{
+    return ipc_labels_get_mode_name(cm33_ipc_get_labels(), mode);
+}
+
+int cm33_ipc_find_model(const char *name)
+{
+    return ipc_labels_find_model(cm33_ipc_get_labels(), name);
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_delay_ms
+*******************************************************************************/
+static void cm33_ipc_delay_ms(uint32_t delay_ms)
+{
+    const struct timespec delay = {
+        .tv_sec = (time_t)(delay_ms / 1000u),
+        .tv_nsec = (long)(delay_ms % 1000u) * 1000000L
+    };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+* Function Name: cm33_ipc_control
+********************************************************************************
+* Summary:
+*  Queues a control request, advances the CM55 doorbell counter and polls
+*  for the acknowledgement like the CM33 does.
+*
+*******************************************************************************/
+ipc_control_status_t cm33_ipc_control(uint32_t param, uint32_t model_id, int32_t value,
+                                      const uint8_t *args, int32_t *applied, uint32_t timeout_ms)
+{
+    if (!atomic_load_explicit(&cm33_attached, memory_order_acquire) ||
+        !ipc_inbox_send_control(&cm33_inbox, &ipc_shared->control, param, model_id, value, args))
+    {
+        return IPC_CONTROL_STATUS_NOT_SENT;
+    }
+    atomic_fetch_add_explicit(&ipc_shared->cm55_doorbell, 1u, memory_order_release);
+
+    return ipc_inbox_wait_control_ack(&cm33_inbox, applied, timeout_ms, CM33_IPC_CONTROL_POLL_MS,
+                                      cm33_ipc_delay_ms);
+}
+
+/* [] END OF FILE */
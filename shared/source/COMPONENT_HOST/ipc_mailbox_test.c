@@ -0,0 +1,292 @@
+/******************************************************************************
+* File Name:   ipc_mailbox_test.c
+*
+* Description: This file implements a host stress test of the latest-value
+*              mailbox (ipc_mailbox.c). A writer thread stands in for the
+*              CM33 IPC interrupt and replaces the message as fast as it
+*              can, reader threads stand in for the application task. Every
+*              message carries its index in the timestamp and IDs and
+*              scores derived from it, so a copy that mixes two messages
+*              shows up as a torn read. The readers also check that the
+*              version never goes back and matches the message index.
+*              --unprotected copies the message without the sequence lock,
+*              which is expected to FAIL and shows that the test catches
+*              torn reads.
+*
+*              --writer-gap N spins N loops between two writes.
+*
+*              Usage: ipc_mailbox_test [--writes N] [--readers N]
+*                                      [--writer-gap N] [--unprotected]
+*
+*              The exit code is 1 if a reader got a torn or stale message.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "ipc_mailbox.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_DEFAULT_WRITES                 (1000000u)
+#define TEST_DEFAULT_READERS                (2u)
+#define TEST_DEFAULT_WRITER_GAP             (100u)
+#define TEST_MAX_READERS                    (16u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    pthread_t   thread;
+    uint32_t    reads;          /* Copies of a message */
+    uint32_t    retries;        /* Copies disturbed by the writer */
+    uint32_t    versions;       /* Distinct versions seen */
+    uint32_t    torn;           /* Copies mixing two messages */
+    uint32_t    stale;          /* Versions going back or not matching the message */
+} test_reader_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static ipc_mailbox_t box;
+static _Atomic bool writer_done;
+static bool unprotected;
+static uint32_t writes = TEST_DEFAULT_WRITES;
+static uint32_t reader_count = TEST_DEFAULT_READERS;
+static uint32_t writer_gap = TEST_DEFAULT_WRITER_GAP;
+static test_reader_t readers[TEST_MAX_READERS];
+
+/*******************************************************************************
+* Function Name: test_fill
+********************************************************************************
+* Summary:
+*  Builds message i: the timestamp is the index, the other fields derive
+*  from it, so no two messages share a field value for long.
+*
+*******************************************************************************/
+static void test_fill(ipc_payload_t *payload, uint32_t i)
+{
+    memset(payload, 0, sizeof(*payload));
+    payload->type = IPC_PAYLOAD_INFERENCE;
+    payload->model_id = (uint8_t)(i % IPC_LABEL_MAX_MODELS);
+    payload->label_id = (uint8_t)(i * 3u);
+    payload->score_count = IPC_MAX_SCORES;
+    payload->seq = ~i;
+    payload->timestamp = i;
+    for (uint32_t c = 0; c < IPC_MAX_SCORES; c++)
+    {
+        payload->scores[c] = (uint8_t)(i * 7u + c);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_check
+*******************************************************************************/
+static bool test_check(const ipc_payload_t *payload)
+{
+    ipc_payload_t expected;
+
+    test_fill(&expected, payload->timestamp);
+    return (0 == memcmp(&expected, payload, sizeof(expected)));
+}
+
+/*******************************************************************************
+* Function Name: test_copy_unprotected
+********************************************************************************
+* Summary:
+*  Copies the message word by word without the sequence lock, as a reader
+*  on a core without the critical section would.
+*
+*******************************************************************************/
+static uint32_t test_copy_unprotected(ipc_payload_t *payload)
+{
+    const volatile uint32_t *src = (const volatile uint32_t *)&box.payload;
+    uint32_t *dst = (uint32_t *)payload;
+
+    for (uint32_t w = 0; w < (sizeof(*payload) / sizeof(uint32_t)); w++)
+    {
+        dst[w] = src[w];
+    }
+
+    return ipc_mailbox_version(&box);
+}
+
+/*******************************************************************************
+* Function Name: test_writer
+********************************************************************************
+* Summary:
+*  Writes every message once. The gap between two writes gives the readers
+*  a chance to complete a copy; with no gap at all nearly every copy of a
+*  reader overlaps a write.
+*
+*******************************************************************************/
+static void* test_writer(void *arg)
+{
+    ipc_payload_t payload;
+    volatile uint32_t spin;
+
+    (void)arg;
+    for (uint32_t i = 0; i < writes; i++)
+    {
+        test_fill(&payload, i);
+        ipc_mailbox_write(&box, &payload);
+        for (spin = 0; spin < writer_gap; spin++)
+        {
+        }
+    }
+    atomic_store(&writer_done, true);
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_reader
+********************************************************************************
+* Summary:
+*  Copies the message until the writer is done and checks every copy.
+*  Message i is version i + 1, a version 0 copy is the empty mailbox.
+*
+*******************************************************************************/
+static void* test_reader(void *arg)
+{
+    test_reader_t *reader = (test_reader_t *)arg;
+    ipc_payload_t payload;
+    uint32_t version;
+    uint32_t last_version = 0u;
+
+    while (!atomic_load(&writer_done))
+    {
+        if (unprotected)
+        {
+            version = test_copy_unprotected(&payload);
+        }
+        else if (!ipc_mailbox_try_read(&box, &payload, &version))
+        {
+            reader->retries++;
+            continue;
+        }
+        if (0u == version)
+        {
+            continue;
+        }
+        reader->reads++;
+        if (!test_check(&payload))
+        {
+            reader->torn++;
+            continue;
+        }
+        if (version < last_version)
+        {
+            reader->stale++;
+        }
+        /* Without the lock the version is read after the copy and may be ahead */
+        if (!unprotected && (payload.timestamp != (version - 1u)))
+        {
+            reader->stale++;
+        }
+        if (version != last_version)
+        {
+            reader->versions++;
+            last_version = version;
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t writer;
+    struct timespec start;
+    struct timespec end;
+    double elapsed_s;
+    test_reader_t total;
+    ipc_payload_t last;
+    bool ok;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--writes")) && ((i + 1) < argc))
+        {
+            writes = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--readers")) && ((i + 1) < argc))
+        {
+            reader_count = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--writer-gap")) && ((i + 1) < argc))
+        {
+            writer_gap = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (0 == strcmp(argv[i], "--unprotected"))
+        {
+            unprotected = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--writes N] [--readers N] [--writer-gap N] [--unprotected]\n", argv[0]);
+            return 2;
+        }
+    }
+    if ((0u == reader_count) || (reader_count > TEST_MAX_READERS))
+    {
+        fprintf(stderr, "--readers must be 1..%u\n", (unsigned)TEST_MAX_READERS);
+        return 2;
+    }
+
+    ipc_mailbox_init(&box);
+    atomic_init(&writer_done, false);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t r = 0; r < reader_count; r++)
+    {
+        pthread_create(&readers[r].thread, NULL, test_reader, &readers[r]);
+    }
+    pthread_create(&writer, NULL, test_writer, NULL);
+    pthread_join(writer, NULL);
+    for (uint32_t r = 0; r < reader_count; r++)
+    {
+        pthread_join(readers[r].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed_s = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    memset(&total, 0, sizeof(total));
+    for (uint32_t r = 0; r < reader_count; r++)
+    {
+        printf("reader %u: %u reads, %u retries, %u versions, %u torn, %u stale\n",
+               (unsigned)r, (unsigned)readers[r].reads, (unsigned)readers[r].retries,
+               (unsigned)readers[r].versions, (unsigned)readers[r].torn, (unsigned)readers[r].stale);
+        total.reads += readers[r].reads;
+        total.retries += readers[r].retries;
+        total.torn += readers[r].torn;
+        total.stale += readers[r].stale;
+    }
+    printf("%u writes in %.3f s, %u readers%s, %u bytes per message\n",
+           (unsigned)writes, elapsed_s, (unsigned)reader_count,
+           unprotected ? " without the sequence lock" : "", (unsigned)sizeof(ipc_payload_t));
+    printf("%u reads, %.3f%% retried\n", (unsigned)total.reads,
+           ((total.reads + total.retries) > 0u) ? 100.0 * total.retries / (total.reads + total.retries) : 0.0);
+
+    /* Once the writer is done the last message has to be there */
+    ok = (0u == total.torn) && (0u == total.stale) &&
+         (ipc_mailbox_read(&box, &last) == writes) &&
+         ((0u == writes) || (test_check(&last) && (last.timestamp == (writes - 1u))));
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
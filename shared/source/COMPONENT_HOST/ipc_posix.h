@@ -0,0 +1,59 @@
+/******************************************************************************
+* File Name:   ipc_posix.h
+*
+* Description: This file contains the host specific functions of the POSIX
+*              backend of ipc_communication.h implemented in
+*              ipc_communication_posix.c.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#ifndef IPC_POSIX_H_
+#define IPC_POSIX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ipc_communication.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Shared memory object used unless ipc_posix_set_name() picks another one */
+#define IPC_POSIX_DEFAULT_NAME              "/ipc_communication"
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+/* Written by the CM33 receiver thread, the latency stages are in
+ * cm33_ipc_get_latency() */
+typedef struct
+{
+    uint32_t    doorbells;      /* Doorbells the receiver woke up for */
+    uint32_t    messages;       /* Messages taken from the ring */
+} ipc_posix_latency_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Selects the shared memory object of the next setup, both processes have to
+ * use the same name. */
+void ipc_posix_set_name(const char *name);
+
+/* Stops the CM33 receiver thread and unmaps the shared memory. destroy also
+ * removes the object, the last process to finish should do it. */
+void ipc_posix_close(bool destroy);
+
+/* CLOCK_MONOTONIC in microseconds, the time base of the message timestamps
+ * and of the latency stamps. It is the same in every process, so the clock
+ * mapping of cm33_ipc_sync_clock() is exact. */
+uint32_t ipc_posix_now_us(void);
+
+void cm33_ipc_posix_get_latency(ipc_posix_latency_t *latency);
+
+#endif /* IPC_POSIX_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,519 @@
+/******************************************************************************
+* File Name:   ipc_ring_test.c
+*
+* Description: This file implements a host check of the CM55 to CM33 message
+*              ring (ipc_ring.c). A producer thread stands in for the CM55
+*              and a consumer thread for the CM33 doorbell callback, which
+*              drains the ring after every doorbell. Every message carries
+*              its index in the timestamp and IDs and scores derived from
+*              it, so a slot read while it is written shows up as a
+*              mismatch. Without --retry the producer drops messages when
+*              the ring is full, as the CM55 tasks do; with --retry it wakes
+*              the consumer and spins until a slot is free, keeping the
+*              sequence number of the message (ipc_ring_try_push()), and
+*              every message has to arrive in order without a gap. --batch N coalesces up to N messages per doorbell
+*              (ipc_batch.c) as the CM55 does; most messages are background
+*              results, every 64th is a detection that rings at once. It
+*              also checks that the first message rings at once even when
+*              it is a background result, as the CM33 waits for it, and
+*              that the periodic poll rings for a batch left waiting.
+*              --control N also sends N control requests the other way
+*              (ipc_control.c), one at a time like the cloud commands of
+*              the CM33, and checks every acknowledgement.
+*
+*              Usage: ipc_ring_test [--messages N] [--retry] [--batch N]
+*                                   [--control N] [--consumer-delay-us N]
+*
+*              The exit code is 1 if a message or a statistic does not
+*              match.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include "ipc_ring.h"
+#include "ipc_batch.h"
+#include "ipc_control.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define TEST_DEFAULT_MESSAGES               (1000000u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static ipc_ring_t ring;
+static ipc_batch_t batch;
+static ipc_ring_t control_ring;
+static _Atomic bool control_done;
+static sem_t doorbell;
+static _Atomic bool producer_done;
+static bool retry;
+static uint32_t batch_count = 1u;
+static uint32_t control_requests;
+static uint32_t messages = TEST_DEFAULT_MESSAGES;
+static uint32_t consumer_delay_us;
+
+/* Consumer results */
+static uint32_t received;
+static uint32_t mismatches;
+static uint32_t next_index;
+static uint32_t skipped;
+static uint32_t control_sent;
+static uint16_t control_outstanding;    /* Request number waiting for its ack, 0 if none */
+static uint32_t acks;
+static uint32_t ack_mismatches;
+
+/* Producer: index of the next message, stamped into the acknowledgements */
+static uint32_t producer_index;
+static uint32_t acks_sent;
+static uint32_t full_waits;             /* Messages that waited for a free slot */
+static uint32_t empty_doorbells;        /* Rung for a full ring without a new message in it */
+
+/*******************************************************************************
+* Function Name: test_fill
+********************************************************************************
+* Summary:
+*  Builds message i: the timestamp is the index, the other fields derive
+*  from it. Every 64th message is a detection, the others are background
+*  results. The sequence number is stamped by the ring.
+*
+*******************************************************************************/
+static void test_fill(ipc_payload_t *payload, uint32_t i)
+{
+    memset(payload, 0, sizeof(*payload));
+    payload->type = IPC_PAYLOAD_INFERENCE;
+    payload->model_id = (uint8_t)(i % IPC_LABEL_MAX_MODELS);
+    payload->label_id = (uint8_t)((0u == (i % 64u)) ? (1u + ((i / 64u) % (IPC_LABEL_MAX_COUNT - 1u))) : 0u);
+    payload->score_count = IPC_MAX_SCORES;
+    payload->timestamp = i;
+    for (uint32_t c = 0; c < IPC_MAX_SCORES; c++)
+    {
+        payload->scores[c] = (uint8_t)(i * 7u + c);
+    }
+}
+
+/*******************************************************************************
+* Function Name: test_check
+*******************************************************************************/
+static bool test_check(const ipc_payload_t *payload)
+{
+    ipc_payload_t expected;
+
+    test_fill(&expected, payload->timestamp);
+    expected.seq = payload->seq;
+    return (0 == memcmp(&expected, payload, sizeof(expected)));
+}
+
+/*******************************************************************************
+* Function Name: test_ring_doorbell
+*******************************************************************************/
+static void test_ring_doorbell(void)
+{
+    if (0u == batch.pending)
+    {
+        empty_doorbells++;
+    }
+    sem_post(&doorbell);
+    ipc_batch_sent(&batch);
+}
+
+/*******************************************************************************
+* Function Name: test_control_handler
+********************************************************************************
+* Summary:
+*  Stands in for the handler of a sensor task: the batch count is applied
+*  doubled, so the test sees the applied value come back.
+*
+*******************************************************************************/
+static ipc_control_status_t test_control_handler(const ipc_payload_t *request, int32_t *value, void *ctx)
+{
+    (void)ctx;
+    if (IPC_CONTROL_BATCH_COUNT != request->label_id)
+    {
+        return IPC_CONTROL_STATUS_UNSUPPORTED;
+    }
+    *value *= 2;
+
+    return IPC_CONTROL_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: test_send_ack
+********************************************************************************
+* Summary:
+*  Sends an acknowledgement through the message ring. It waits for a free
+*  slot so acknowledgements are never dropped, which keeps the sequence
+*  gaps equal to the dropped messages. The timestamp carries the index of
+*  the next message, the consumer checks the order with it.
+*
+*******************************************************************************/
+static bool test_send_ack(ipc_payload_t *ack, void *ctx)
+{
+    (void)ctx;
+    while (ipc_ring_depth(&ring) >= IPC_RING_SLOTS)
+    {
+        sem_post(&doorbell);
+        sched_yield();
+    }
+    ack->timestamp = producer_index;
+    if (ipc_batch_add(&batch, ack, ipc_ring_push(&ring, ack)))
+    {
+        test_ring_doorbell();
+    }
+    acks_sent++;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: test_send_control
+********************************************************************************
+* Summary:
+*  Consumer side: sends the next control request once the previous one was
+*  acknowledged. Even requests set the batch count, odd ones a parameter
+*  the handler does not support.
+*
+*******************************************************************************/
+static void test_send_control(void)
+{
+    ipc_payload_t request;
+    uint32_t param;
+
+    if ((0u != control_outstanding) || (control_sent >= control_requests))
+    {
+        return;
+    }
+    param = (0u == (control_sent % 2u)) ? IPC_CONTROL_BATCH_COUNT : IPC_CONTROL_GATE;
+    control_outstanding = (uint16_t)((control_sent % UINT16_MAX) + 1u);
+    ipc_control_build_request(&request, control_outstanding, param, 0u, (int32_t)control_sent, NULL);
+    if (!ipc_ring_push(&control_ring, &request))
+    {
+        ack_mismatches++;
+    }
+    control_sent++;
+}
+
+/*******************************************************************************
+* Function Name: test_check_ack
+*******************************************************************************/
+static bool test_check_ack(const ipc_payload_t *ack)
+{
+    uint32_t sent = control_sent - 1u;
+    bool supported = (0u == (sent % 2u));
+
+    if ((0u == control_outstanding) || (ack->control.request != control_outstanding))
+    {
+        return false;
+    }
+    control_outstanding = 0u;
+    if (supported)
+    {
+        return (IPC_CONTROL_STATUS_OK == ack->control.status) && (ack->control.value == (int32_t)(2u * sent));
+    }
+
+    return (IPC_CONTROL_STATUS_UNSUPPORTED == ack->control.status) && (ack->control.value == (int32_t)sent);
+}
+
+/*******************************************************************************
+* Function Name: test_producer
+********************************************************************************
+* Summary:
+*  Sends the messages like cm55_ipc_send_message(), the doorbell is rung
+*  once per batch. With --retry a full ring rings once, as it does on the
+*  CM55, and the message waits for a free slot.
+*
+*******************************************************************************/
+static void* test_producer(void *arg)
+{
+    ipc_payload_t payload;
+    bool pushed;
+
+    (void)arg;
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        test_fill(&payload, i);
+        if (!retry)
+        {
+            pushed = ipc_ring_push(&ring, &payload);
+        }
+        else if (!(pushed = ipc_ring_try_push(&ring, &payload)))
+        {
+            full_waits++;
+            test_ring_doorbell();
+            while (!(pushed = ipc_ring_try_push(&ring, &payload)))
+            {
+                sched_yield();
+            }
+        }
+        if (ipc_batch_add(&batch, &payload, pushed))
+        {
+            test_ring_doorbell();
+        }
+        producer_index = i + 1u;
+        (void)ipc_control_serve(&control_ring, test_control_handler, test_send_ack, NULL);
+    }
+    while (!atomic_load(&control_done))
+    {
+        (void)ipc_control_serve(&control_ring, test_control_handler, test_send_ack, NULL);
+        sched_yield();
+    }
+    atomic_store(&producer_done, true);
+    /* Only a doorbell if messages are still waiting, otherwise it just ends the consumer */
+    if (0u != batch.pending)
+    {
+        test_ring_doorbell();
+    }
+    else
+    {
+        sem_post(&doorbell);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_consumer
+********************************************************************************
+* Summary:
+*  Drains the ring after every doorbell, like cm33_msg_callback().
+*
+*******************************************************************************/
+static void* test_consumer(void *arg)
+{
+    const ipc_payload_t *slot;
+
+    (void)arg;
+    test_send_control();
+    for (;;)
+    {
+        bool done;
+
+        sem_wait(&doorbell);
+        done = atomic_load(&producer_done);
+        while (NULL != (slot = ipc_ring_peek(&ring)))
+        {
+            if (IPC_PAYLOAD_CONTROL_ACK == slot->type)
+            {
+                if (!test_check_ack(slot) || (slot->timestamp < next_index))
+                {
+                    ack_mismatches++;
+                }
+                else
+                {
+                    skipped += slot->timestamp - next_index;
+                    next_index = slot->timestamp;
+                }
+                if (++acks >= control_requests)
+                {
+                    atomic_store(&control_done, true);
+                }
+                ipc_ring_release(&ring);
+                continue;
+            }
+            if (!test_check(slot) || (slot->timestamp < next_index))
+            {
+                mismatches++;
+            }
+            else
+            {
+                skipped += slot->timestamp - next_index;
+                next_index = slot->timestamp + 1u;
+            }
+            received++;
+            if (0u != consumer_delay_us)
+            {
+                struct timespec delay = { .tv_sec = 0, .tv_nsec = (long)consumer_delay_us * 1000 };
+                nanosleep(&delay, NULL);
+            }
+            ipc_ring_release(&ring);
+        }
+        test_send_control();
+        if (done)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: test_batch_startup
+********************************************************************************
+* Summary:
+*  A background result that repeats the initial class is not urgent, but as
+*  the first message it has to ring: the sensor tasks only send changes, so
+*  nothing may follow it for a long time.
+*
+* Return:
+*  true if the first message rings and the next one is batched again.
+*
+*******************************************************************************/
+static bool test_batch_startup(void)
+{
+    ipc_batch_t startup;
+    ipc_payload_t payload;
+    bool first;
+    bool second;
+
+    ipc_batch_init(&startup, batch_count, UINT32_MAX);
+    test_fill(&payload, 1u);
+    first = ipc_batch_add(&startup, &payload, true);
+    if (first)
+    {
+        ipc_batch_sent(&startup);
+    }
+    test_fill(&payload, 1u + IPC_LABEL_MAX_MODELS);
+    second = ipc_batch_add(&startup, &payload, true);
+    printf("startup: first background result %s, second %s\n", first ? "rings" : "waits",
+           second ? "rings" : "waits");
+
+    return first && ((batch_count <= 1u) || !second);
+}
+
+/*******************************************************************************
+* Function Name: test_batch_window
+********************************************************************************
+* Summary:
+*  A repeated background result waits for its batch, and the periodic poll
+*  rings for it once it waited for the window even if no message follows.
+*
+* Return:
+*  true if the poll rings at the window and not before.
+*
+*******************************************************************************/
+static bool test_batch_window(void)
+{
+    ipc_batch_t window;
+    ipc_payload_t payload;
+    bool added;
+    bool early;
+    bool late;
+
+    ipc_batch_init(&window, IPC_RING_SLOTS, 1000u);
+    ipc_batch_sent(&window);
+    test_fill(&payload, 1u);
+    payload.timestamp = 5000u;
+    added = ipc_batch_add(&window, &payload, true);
+    early = ipc_batch_poll(&window, 5999u);
+    late = ipc_batch_poll(&window, 6000u);
+    ipc_batch_sent(&window);
+    printf("window: background result %s, poll before the window %s, at the window %s\n",
+           added ? "rings" : "waits", early ? "rings" : "waits", late ? "rings" : "waits");
+
+    return !added && !early && late && !ipc_batch_poll(&window, 100000u);
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t producer;
+    pthread_t consumer;
+    ipc_ring_stats_t stats;
+    struct timespec start;
+    struct timespec end;
+    double elapsed_s;
+    bool ok;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--messages")) && ((i + 1) < argc))
+        {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (0 == strcmp(argv[i], "--retry"))
+        {
+            retry = true;
+        }
+        else if ((0 == strcmp(argv[i], "--control")) && ((i + 1) < argc))
+        {
+            control_requests = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--batch")) && ((i + 1) < argc))
+        {
+            batch_count = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--consumer-delay-us")) && ((i + 1) < argc))
+        {
+            consumer_delay_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--messages N] [--retry] [--batch N] [--control N] [--consumer-delay-us N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ok = test_batch_startup();
+    ok = test_batch_window() && ok;
+
+    ipc_ring_init(&ring);
+    ipc_ring_init(&control_ring);
+    atomic_init(&control_done, 0u == control_requests);
+    /* The timestamps are message indices, only the count ends a batch */
+    ipc_batch_init(&batch, batch_count, UINT32_MAX);
+    sem_init(&doorbell, 0, 0);
+    atomic_init(&producer_done, false);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer, NULL, test_consumer, NULL);
+    pthread_create(&producer, NULL, test_producer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed_s = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+    ipc_ring_get_stats(&ring, &stats);
+    /* The acknowledgements share the ring but are not part of the attempted messages */
+    printf("%u messages attempted in %.3f s (%.0f attempted/s, %.0f sent/s), %u slots of %u bytes\n",
+           (unsigned)messages, elapsed_s, (elapsed_s > 0.0) ? messages / elapsed_s : 0.0,
+           (elapsed_s > 0.0) ? (stats.sent - acks_sent) / elapsed_s : 0.0,
+           (unsigned)IPC_RING_SLOTS, (unsigned)sizeof(ipc_payload_t));
+    printf("sent %u messages and %u acknowledgements, dropped %u, waited for a slot %u, high water %u\n",
+           (unsigned)(stats.sent - acks_sent), (unsigned)acks_sent, (unsigned)stats.dropped,
+           (unsigned)full_waits, (unsigned)stats.high_water);
+    printf("received %u, lost %u, skipped %u, mismatches %u\n",
+           (unsigned)stats.received, (unsigned)stats.lost, (unsigned)skipped, (unsigned)mismatches);
+    if (0u != control_requests)
+    {
+        printf("%u control requests, %u acknowledgements, %u mismatches\n",
+               (unsigned)control_sent, (unsigned)acks, (unsigned)ack_mismatches);
+    }
+    printf("%u doorbells, %u of them for a full ring without a new message, %.2f messages per other doorbell\n",
+           (unsigned)batch.batches, (unsigned)empty_doorbells,
+           (batch.batches > empty_doorbells) ? (double)batch.messages / (batch.batches - empty_doorbells) : 0.0);
+
+    /* The consumer sees every drop before the last message it received as a gap */
+    ok = ok && (0u == mismatches) && (stats.received == (received + acks)) && (stats.sent == (received + acks)) &&
+         (acks == control_requests) && (acks_sent == acks) && (0u == ack_mismatches) &&
+         (stats.lost <= stats.dropped) && (stats.high_water <= IPC_RING_SLOTS) &&
+         (0u == ipc_ring_depth(&ring));
+    if (retry)
+    {
+        ok = ok && (messages == received) && (0u == skipped) && (0u == stats.lost) && (0u == stats.dropped);
+    }
+    else
+    {
+        ok = ok && ((received + stats.dropped) == messages) && (skipped == stats.lost);
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    sem_destroy(&doorbell);
+
+    return ok ? 0 : 1;
+}
+
+/* [] END OF FILE */
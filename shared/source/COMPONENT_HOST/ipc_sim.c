@@ -0,0 +1,461 @@
+/******************************************************************************
+* File Name:   ipc_sim.c
+*
+* Description: This file implements a two process simulation of the IPC
+*              between the cores on the POSIX backend of ipc_communication.h
+*              (ipc_communication_posix.c). The CM55 process sends
+*              inference results at --rate per second for --seconds, every
+*              --detect-every th one a detection, and serves control
+*              requests between two results like a sensor task. The CM33
+*              process polls the latest detection every --poll-ms like the
+*              telemetry loop of app_task.c and sends a sensitivity request
+*              every --control-ms. When the CM55 is done it sends a radar
+*              mode report, after which the CM33 prints the message rate,
+*              the latency stages, the losses and the control round trips.
+*              Every detection the CM33 sees counts as published, so the
+*              stages run from the capture stamp of the CM55 to the poll.
+*              --rate 0 sends as fast as possible. The scores of every
+*              result also go through the bulk stream as a model output
+*              record, which the CM33 drains at every poll.
+*
+*              Without --role the tool forks and runs both sides. With
+*              --role cm55 or --role cm33 the sides run as separate
+*              commands, e.g. to load them differently; both need the same
+*              --name.
+*
+*              Usage: ipc_sim [--role cm55|cm33] [--name /NAME] [--rate N]
+*                             [--seconds N] [--detect-every N]
+*                             [--poll-ms N] [--control-ms N]
+*
+*              The exit code is 1 if the CM33 did not receive every message
+*              the CM55 put in the ring or the stream, or a control request
+*              failed.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "ipc_posix.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SIM_DEFAULT_RATE                    (1000u)
+#define SIM_DEFAULT_SECONDS                 (5u)
+#define SIM_DEFAULT_DETECT_EVERY            (50u)
+#define SIM_DEFAULT_POLL_MS                 (100u)
+#define SIM_DEFAULT_CONTROL_MS              (500u)
+
+#define SIM_CONTROL_TIMEOUT_MS              (1000u)
+
+/* The CM33 gives up this long after the CM55 should have finished */
+#define SIM_END_GRACE_MS                    (5000u)
+
+/* Time for the receiver to release the last message it dispatched */
+#define SIM_SETTLE_MS                       (10u)
+
+/* Radar mode report that ends the run */
+#define SIM_MODE_DONE                       (0u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint32_t rate = SIM_DEFAULT_RATE;
+static uint32_t seconds = SIM_DEFAULT_SECONDS;
+static uint32_t detect_every = SIM_DEFAULT_DETECT_EVERY;
+static uint32_t poll_ms = SIM_DEFAULT_POLL_MS;
+static uint32_t control_ms = SIM_DEFAULT_CONTROL_MS;
+
+static const char *const sim_labels[] = { "background", "event" };
+
+/*******************************************************************************
+* Function Name: sim_now_ms
+*******************************************************************************/
+static uint64_t sim_now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000u) + ((uint64_t)now.tv_nsec / 1000000u);
+}
+
+/*******************************************************************************
+* Function Name: sim_sleep_ms
+*******************************************************************************/
+static void sim_sleep_ms(uint32_t ms)
+{
+    struct timespec delay = {
+        .tv_sec = (time_t)(ms / 1000u),
+        .tv_nsec = (long)(ms % 1000u) * 1000000L
+    };
+
+    nanosleep(&delay, NULL);
+}
+
+/*******************************************************************************
+* Function Name: sim_control_handler
+********************************************************************************
+* Summary:
+*  Stands in for the handler of a sensor task, accepts a sensitivity of
+*  0..100 for the one model.
+*
+*******************************************************************************/
+static ipc_control_status_t sim_control_handler(const ipc_payload_t *request, int32_t *value, void *ctx)
+{
+    (void)ctx;
+    if ((IPC_CONTROL_SENSITIVITY != request->label_id) || (0u != request->model_id))
+    {
+        return IPC_CONTROL_STATUS_UNSUPPORTED;
+    }
+    if ((*value < 0) || (*value > 100))
+    {
+        return IPC_CONTROL_STATUS_INVALID;
+    }
+
+    return IPC_CONTROL_STATUS_OK;
+}
+
+/*******************************************************************************
+* Function Name: sim_cm55
+********************************************************************************
+* Summary:
+*  Sends the results paced at the rate and ends with the radar mode
+*  report, which is retried until the ring takes it.
+*
+*******************************************************************************/
+static int sim_cm55(void)
+{
+    struct timespec next;
+    uint64_t total = (uint64_t)rate * seconds;
+    uint32_t period_ns = (0u != rate) ? (1000000000u / rate) : 0u;
+    uint64_t end_ms = sim_now_ms() + ((uint64_t)seconds * 1000u);
+    uint8_t scores[2];
+    int32_t *outputs;
+    ipc_ring_stats_t stats;
+    uint32_t doorbells;
+
+    cm55_ipc_communication_setup();
+    if (cm55_ipc_add_model("sim", sim_labels, 2u) < 0)
+    {
+        fprintf(stderr, "cm55: no shared memory\n");
+        return 1;
+    }
+    cm55_ipc_add_mode("done");
+    cm55_ipc_publish_labels();
+    cm55_ipc_set_control_handler(sim_control_handler, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (uint64_t i = 0; (0u != rate) ? (i < total) : (sim_now_ms() < end_ms); i++)
+    {
+        uint32_t label_id = ((0u != detect_every) && (0u == (i % detect_every))) ? 1u : 0u;
+        uint32_t capture_us = ipc_posix_now_us();
+
+        scores[1] = (uint8_t)((0u != label_id) ? 255u : (i % 64u));
+        scores[0] = (uint8_t)(255u - scores[1]);
+        outputs = (int32_t *)cm55_ipc_stream_reserve(IPC_STREAM_OUTPUTS, 0u, sizeof(int32_t) * 2u);
+        if (NULL != outputs)
+        {
+            outputs[0] = scores[0];
+            outputs[1] = scores[1];
+            cm55_ipc_stream_commit(sizeof(int32_t) * 2u);
+        }
+        (void)cm55_ipc_send_result(0u, label_id, scores, 2u, capture_us, ipc_posix_now_us());
+        cm55_ipc_poll_control();
+
+        if (0u != period_ns)
+        {
+            next.tv_nsec += (long)period_ns;
+            while (next.tv_nsec >= 1000000000L)
+            {
+                next.tv_nsec -= 1000000000L;
+                next.tv_sec++;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        }
+    }
+    while (!cm55_ipc_send_radar_mode(SIM_MODE_DONE))
+    {
+        sim_sleep_ms(1u);
+    }
+
+    cm55_ipc_get_stats(&stats, &doorbells, NULL);
+    printf("cm55: sent %u, dropped %u, high water %u, %u doorbells\n",
+           (unsigned)stats.sent, (unsigned)stats.dropped, (unsigned)stats.high_water, (unsigned)doorbells);
+    ipc_posix_close(false);
+
+    return 0;
+}
+
+/*******************************************************************************
+* Function Name: sim_print_latency
+*******************************************************************************/
+static void sim_print_latency(const ipc_posix_latency_t *latency, const ipc_latency_t *stages)
+{
+    printf("cm33: %u doorbells, %.2f messages per doorbell\n", (unsigned)latency->doorbells,
+           (latency->doorbells > 0u) ? (double)latency->messages / latency->doorbells : 0.0);
+    printf("cm33: stage      count    avg us    p50 us    p99 us    max us\n");
+    for (uint32_t stage = 0; stage < IPC_LATENCY_STAGE_COUNT; stage++)
+    {
+        const ipc_latency_hist_t *hist = &stages->stages[stage];
+
+        printf("      %-9s %6u %9.1f %9u %9u %9u\n", ipc_latency_stage_name(stage), (unsigned)hist->count,
+               (hist->count > 0u) ? (double)hist->total_us / hist->count : 0.0,
+               (unsigned)ipc_latency_percentile(stages, (ipc_latency_stage_t)stage, 500u),
+               (unsigned)ipc_latency_percentile(stages, (ipc_latency_stage_t)stage, 990u),
+               (unsigned)hist->max_us);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sim_drain_stream
+********************************************************************************
+* Summary:
+*  Takes every record out of the stream like the stream task of the CM33,
+*  checking that each holds the two scores of a result.
+*
+* Return:
+*  Number of records with a wrong kind or size.
+*
+*******************************************************************************/
+static uint32_t sim_drain_stream(void)
+{
+    const ipc_stream_record_t *record;
+    uint32_t errors = 0u;
+
+    while (NULL != (record = cm33_ipc_stream_peek()))
+    {
+        if ((IPC_STREAM_OUTPUTS != record->kind) || ((sizeof(int32_t) * 2u) != record->size))
+        {
+            errors++;
+        }
+        cm33_ipc_stream_release();
+    }
+
+    return errors;
+}
+
+/*******************************************************************************
+* Function Name: sim_cm33
+********************************************************************************
+* Summary:
+*  Polls the latest state like the telemetry loop until the radar mode
+*  report ends the run, sending control requests until the last second, so
+*  every one is answered before the CM55 stops serving them.
+*
+*******************************************************************************/
+static int sim_cm33(void)
+{
+    ipc_payload_t payload;
+    ipc_ring_stats_t stats;
+    ipc_stream_stats_t stream;
+    ipc_posix_latency_t latency;
+    ipc_latency_t stages;
+    uint64_t start_ms = 0u;
+    uint64_t last_control_ms = 0u;
+    uint64_t now_ms;
+    uint32_t polls = 0u;
+    uint32_t detections = 0u;
+    uint32_t controls = 0u;
+    uint32_t stream_errors = 0u;
+    uint32_t control_failures = 0u;
+    uint64_t control_total_ms = 0u;
+    uint64_t control_max_ms = 0u;
+    double elapsed_s;
+    bool done = false;
+    bool ok;
+
+    cm33_ipc_communication_setup();
+
+    /* Like app_task.c, nothing happens before the first message */
+    while (!cm33_ipc_has_received_message())
+    {
+        sim_sleep_ms(1u);
+    }
+    start_ms = sim_now_ms();
+    printf("cm33: first message, model \"%s\"\n", cm33_ipc_get_model_name(0u));
+    if (!cm33_ipc_sync_clock())
+    {
+        printf("cm33: clock sync failed\n");
+    }
+
+    while (!done)
+    {
+        sim_sleep_ms(poll_ms);
+        now_ms = sim_now_ms();
+        polls++;
+        stream_errors += sim_drain_stream();
+        (void)cm33_ipc_has_received_message();
+        if (cm33_ipc_safe_get_and_clear_cached_detection(&payload))
+        {
+            uint32_t built_us = ipc_posix_now_us();
+
+            detections++;
+            cm33_ipc_latency_add_published(&payload, built_us, ipc_posix_now_us());
+        }
+        done = cm33_ipc_safe_get_radar_mode(&payload);
+        if (!done && (now_ms > (start_ms + (uint64_t)seconds * 1000u + SIM_END_GRACE_MS)))
+        {
+            printf("cm33: no end of run from the CM55\n");
+            break;
+        }
+
+        if (!done && (0u != control_ms) && ((now_ms - last_control_ms) >= control_ms) &&
+            ((now_ms + SIM_CONTROL_TIMEOUT_MS) < (start_ms + (uint64_t)seconds * 1000u)))
+        {
+            int32_t applied = 0;
+            ipc_control_status_t status;
+            uint64_t sent_ms = now_ms;
+
+            status = cm33_ipc_control(IPC_CONTROL_SENSITIVITY, 0u, (int32_t)(controls % 101u), NULL,
+                                      &applied, SIM_CONTROL_TIMEOUT_MS);
+            now_ms = sim_now_ms();
+            last_control_ms = now_ms;
+            controls++;
+            if (IPC_CONTROL_STATUS_OK != status)
+            {
+                printf("cm33: control request %u: %s\n", (unsigned)controls, ipc_control_status_name(status));
+                control_failures++;
+            }
+            control_total_ms += now_ms - sent_ms;
+            if ((now_ms - sent_ms) > control_max_ms)
+            {
+                control_max_ms = now_ms - sent_ms;
+            }
+        }
+    }
+    elapsed_s = (double)(sim_now_ms() - start_ms) / 1000.0;
+
+    sim_sleep_ms(SIM_SETTLE_MS);
+    stream_errors += sim_drain_stream();
+    if (!cm33_ipc_get_stats(&stats))
+    {
+        memset(&stats, 0, sizeof(stats));
+    }
+    if (!cm33_ipc_stream_get_stats(&stream))
+    {
+        memset(&stream, 0, sizeof(stream));
+    }
+    cm33_ipc_posix_get_latency(&latency);
+    cm33_ipc_get_latency(&stages);
+
+    printf("cm33: sent %u, dropped %u, received %u, lost %u, %.0f messages/s\n",
+           (unsigned)stats.sent, (unsigned)stats.dropped, (unsigned)stats.received, (unsigned)stats.lost,
+           (elapsed_s > 0.0) ? stats.received / elapsed_s : 0.0);
+    printf("cm33: stream %u records, dropped %u, received %u, lost %u, high water %u bytes\n",
+           (unsigned)stream.records, (unsigned)stream.dropped, (unsigned)stream.received, (unsigned)stream.lost,
+           (unsigned)stream.high_water);
+    sim_print_latency(&latency, &stages);
+    printf("cm33: %u polls saw %u new detections\n", (unsigned)polls, (unsigned)detections);
+    if (0u != controls)
+    {
+        printf("cm33: %u control requests, %u failed, round trip avg %.1f ms, max %u ms\n",
+               (unsigned)controls, (unsigned)control_failures, (double)control_total_ms / controls,
+               (unsigned)control_max_ms);
+    }
+
+    ok = done && (stats.received == stats.sent) && (stats.lost <= stats.dropped) && (0u == control_failures) &&
+         (stream.received == stream.records) && (stream.lost <= stream.dropped) && (0u == stream_errors);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *role = NULL;
+    const char *name = IPC_POSIX_DEFAULT_NAME;
+    pid_t cm55;
+    int status;
+    int ret;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((0 == strcmp(argv[i], "--role")) && ((i + 1) < argc))
+        {
+            role = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "--name")) && ((i + 1) < argc))
+        {
+            name = argv[++i];
+        }
+        else if ((0 == strcmp(argv[i], "--rate")) && ((i + 1) < argc))
+        {
+            rate = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--seconds")) && ((i + 1) < argc))
+        {
+            seconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--detect-every")) && ((i + 1) < argc))
+        {
+            detect_every = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--poll-ms")) && ((i + 1) < argc))
+        {
+            poll_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[i], "--control-ms")) && ((i + 1) < argc))
+        {
+            control_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--role cm55|cm33] [--name /NAME] [--rate N] [--seconds N]\n"
+                            "       [--detect-every N] [--poll-ms N] [--control-ms N]\n", argv[0]);
+            return 2;
+        }
+    }
+    ipc_posix_set_name(name);
+
+    if (NULL != role)
+    {
+        if (0 == strcmp(role, "cm55"))
+        {
+            return sim_cm55();
+        }
+        if (0 == strcmp(role, "cm33"))
+        {
+            ret = sim_cm33();
+            ipc_posix_close(true);
+            return ret;
+        }
+        fprintf(stderr, "unknown role %s\n", role);
+        return 2;
+    }
+
+    /* Start from a fresh object, then fork before the receiver thread exists */
+    (void)shm_unlink(name);
+    fflush(stdout);
+    cm55 = fork();
+    if (cm55 < 0)
+    {
+        perror("fork");
+        return 1;
+    }
+    if (0 == cm55)
+    {
+        return sim_cm55();
+    }
+    ret = sim_cm33();
+    ipc_posix_close(true);
+    if ((waitpid(cm55, &status, 0) != cm55) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        ret = 1;
+    }
+
+    return ret;
+}
+
+/* [] END OF FILE */
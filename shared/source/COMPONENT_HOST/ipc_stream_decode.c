@@ -0,0 +1,461 @@
+/******************************************************************************
+* File Name:   ipc_stream_decode.c
+*
+* Description: This file implements the host decoder of the bulk stream
+*              (ipc_stream.c). It reads what the CM33 sent, finds the frames
+*              in it and prints one CSV line per record, one per sample for
+*              the IMU records:
+*
+*                seq,timestamp_us,kind,source,values...
+*
+*              The input is the raw debug UART capture, console text
+*              included, or with --base64 the stream_data values of the
+*              telemetry messages, one per line. The summary on stderr has
+*              the frames, the CRC errors, the bytes outside of frames and
+*              the records missing from the sequence, i.e. dropped by the
+*              CM55 because the output did not keep up.
+*
+*              --selftest runs records of every size through a small ring
+*              until it wraps and overflows, frames them between console
+*              text with one corrupted byte and checks what comes out.
+*
+*              Usage: ipc_stream_decode [--base64] [FILE]
+*                     ipc_stream_decode --selftest
+*
+*              The exit code is 1 if the self test fails.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ipc_stream.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define DECODE_LINE_SIZE                    (8192u)
+
+/* Self test ring, small so that it wraps often */
+#define TEST_RING_SIZE                      (256u)
+#define TEST_RECORDS                        (2000u)
+
+/*******************************************************************************
+* Structures
+*******************************************************************************/
+typedef struct
+{
+    bool        started;
+    uint32_t    expected_seq;
+    uint32_t    lost;           /* Sequence numbers missing between two records */
+    uint32_t    records[IPC_STREAM_KIND_COUNT];
+} decode_stats_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static ipc_stream_decoder_t decoder;
+static decode_stats_t stats;
+
+/*******************************************************************************
+* Function Name: decode_print_record
+*******************************************************************************/
+static void decode_print_record(const ipc_stream_record_t *record, const uint8_t *data)
+{
+    uint32_t count;
+
+    switch (record->kind)
+    {
+    case IPC_STREAM_FEATURES:
+    case IPC_STREAM_OUTPUTS:
+        printf("%u,%u,%s,%u", (unsigned)record->seq, (unsigned)record->timestamp,
+               ipc_stream_kind_name(record->kind), (unsigned)record->source);
+        count = record->size / 4u;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (IPC_STREAM_FEATURES == record->kind)
+            {
+                float value;
+
+                memcpy(&value, &data[i * 4u], sizeof(value));
+                printf(",%g", (double)value);
+            }
+            else
+            {
+                int32_t value;
+
+                memcpy(&value, &data[i * 4u], sizeof(value));
+                printf(",%d", (int)value);
+            }
+        }
+        printf("\n");
+        break;
+    default:
+        count = record->size / IPC_STREAM_IMU_SAMPLE_SIZE;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            int16_t axes[6];
+
+            memcpy(axes, &data[i * IPC_STREAM_IMU_SAMPLE_SIZE], sizeof(axes));
+            printf("%u,%u,%s,%u,%u,%d,%d,%d,%d,%d,%d,%u\n", (unsigned)record->seq, (unsigned)record->timestamp,
+                   ipc_stream_kind_name(record->kind), (unsigned)record->source, (unsigned)i,
+                   axes[0], axes[1], axes[2], axes[3], axes[4], axes[5],
+                   (unsigned)data[i * IPC_STREAM_IMU_SAMPLE_SIZE + sizeof(axes)]);
+        }
+        break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: decode_bytes
+*******************************************************************************/
+static void decode_bytes(const uint8_t *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (!ipc_stream_decode(&decoder, bytes[i]))
+        {
+            continue;
+        }
+        if (stats.started)
+        {
+            stats.lost += decoder.record.seq - stats.expected_seq;
+        }
+        stats.started = true;
+        stats.expected_seq = decoder.record.seq + 1u;
+        stats.records[decoder.record.kind]++;
+        decode_print_record(&decoder.record, decoder.data);
+    }
+}
+
+/*******************************************************************************
+* Function Name: decode_base64
+********************************************************************************
+* Summary:
+*  Decodes one line of base64 in place, ignoring whitespace and quotes.
+*
+* Return:
+*  Number of bytes, -1 if the line is not base64.
+*
+*******************************************************************************/
+static long decode_base64(char *line)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t *out = (uint8_t *)line;
+    uint32_t bits = 0u;
+    uint32_t count = 0u;
+    long length = 0;
+
+    for (const char *c = line; '\0' != *c; c++)
+    {
+        const char *digit;
+
+        if (('=' == *c) || ('"' == *c) || (' ' == *c) || ('\t' == *c) || ('\r' == *c) || ('\n' == *c))
+        {
+            continue;
+        }
+        digit = strchr(alphabet, *c);
+        if (NULL == digit)
+        {
+            return -1;
+        }
+        bits = (bits << 6) | (uint32_t)(digit - alphabet);
+        count += 6u;
+        if (count >= 8u)
+        {
+            count -= 8u;
+            out[length++] = (uint8_t)(bits >> count);
+        }
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: test_fill
+*******************************************************************************/
+static uint8_t test_fill(uint32_t seq, uint32_t i)
+{
+    return (uint8_t)((seq * 31u) + i);
+}
+
+/*******************************************************************************
+* Function Name: test_ring
+********************************************************************************
+* Summary:
+*  Produces records of changing sizes and consumes them at a slower pace, so
+*  the ring pads, skips short tails and overflows. Every record received has
+*  to be intact and in order, the gaps have to match the drops.
+*
+* Return:
+*  Number of failures.
+*
+*******************************************************************************/
+static uint32_t test_ring(void)
+{
+    static uint32_t buffer[TEST_RING_SIZE / sizeof(uint32_t)];
+    static ipc_stream_t stream;
+    const ipc_stream_record_t *record;
+    ipc_stream_stats_t ring_stats;
+    uint32_t failures = 0u;
+    uint32_t next_seq = 0u;
+    uint32_t received = 0u;
+
+    ipc_stream_init(&stream, buffer, sizeof(buffer), IPC_STREAM_ALL_KINDS & ~(1u << IPC_STREAM_IMU));
+
+    /* A kind that is not streamed is not a drop */
+    if (NULL != ipc_stream_reserve(&stream, IPC_STREAM_IMU, 0u, 14u, 0u))
+    {
+        printf("ring: disabled kind reserved\n");
+        failures++;
+    }
+    for (uint32_t n = 0; n < TEST_RECORDS; n++)
+    {
+        /* 0 to 57 bytes, written with the reserved size, committed with less now and then */
+        uint32_t size = (n * 7u) % 58u;
+        uint32_t used = ((n % 5u) == 0u) ? (size / 2u) : size;
+        uint8_t *data = (uint8_t *)ipc_stream_reserve(&stream, IPC_STREAM_OUTPUTS, n & 0xFFu, size, n);
+
+        if (NULL != data)
+        {
+            for (uint32_t i = 0; i < size; i++)
+            {
+                data[i] = test_fill(n, i);
+            }
+            record = ipc_stream_commit(&stream, used);
+            if ((NULL == record) || (record->seq != n))
+            {
+                printf("ring: record %u committed with a wrong sequence\n", (unsigned)n);
+                failures++;
+            }
+        }
+
+        /* The consumer takes one record for every two produced, all of them now and then */
+        for (uint32_t taken = 0; (taken < TEST_RING_SIZE) && (((n % 50u) == 49u) || (taken < (n % 2u))); taken++)
+        {
+            record = ipc_stream_peek(&stream);
+            if (NULL == record)
+            {
+                break;
+            }
+            if ((record->seq < next_seq) || (record->timestamp != record->seq) ||
+                (record->source != (record->seq & 0xFFu)) || (IPC_STREAM_OUTPUTS != record->kind))
+            {
+                printf("ring: record %u out of order or corrupted\n", (unsigned)record->seq);
+                failures++;
+            }
+            for (uint32_t i = 0; i < record->size; i++)
+            {
+                if (ipc_stream_record_data(record)[i] != test_fill(record->seq, i))
+                {
+                    printf("ring: data of record %u corrupted\n", (unsigned)record->seq);
+                    failures++;
+                    break;
+                }
+            }
+            next_seq = record->seq + 1u;
+            received++;
+            ipc_stream_release(&stream);
+        }
+    }
+    while ((received < TEST_RECORDS) && (NULL != ipc_stream_peek(&stream)))
+    {
+        received++;
+        ipc_stream_release(&stream);
+    }
+
+    ipc_stream_get_stats(&stream, &ring_stats);
+    printf("ring: %u records, %u dropped, %u received, %u lost, high water %u of %u bytes\n",
+           (unsigned)ring_stats.records, (unsigned)ring_stats.dropped, (unsigned)ring_stats.received,
+           (unsigned)ring_stats.lost, (unsigned)ring_stats.high_water, (unsigned)sizeof(buffer));
+    if ((ring_stats.records + ring_stats.dropped) != TEST_RECORDS)
+    {
+        printf("ring: records and drops do not add up\n");
+        failures++;
+    }
+    if ((0u == ring_stats.dropped) || (received != ring_stats.records) || (ring_stats.received != received) ||
+        (ring_stats.lost > ring_stats.dropped) || (ring_stats.high_water > sizeof(buffer)))
+    {
+        printf("ring: statistics inconsistent\n");
+        failures++;
+    }
+
+    return failures;
+}
+
+/*******************************************************************************
+* Function Name: test_framing
+********************************************************************************
+* Summary:
+*  Frames records between lines of console text, including one that looks
+*  like a sync, corrupts one frame and checks that the decoder returns the
+*  others intact.
+*
+* Return:
+*  Number of failures.
+*
+*******************************************************************************/
+static uint32_t test_framing(void)
+{
+    static const char console[] = "cough\r\n\xA5 looks like a sync\r\n";
+    static uint8_t output[64u * (IPC_STREAM_FRAME_OVERHEAD + 64u + sizeof(console))];
+    static uint8_t record_buffer[sizeof(ipc_stream_record_t) + 64u];
+    ipc_stream_record_t *record = (ipc_stream_record_t *)record_buffer;
+    uint32_t failures = 0u;
+    uint32_t expected_seq = 0u;
+    size_t length = 0u;
+    size_t corrupted = 0u;
+
+    for (uint32_t n = 0; n < 64u; n++)
+    {
+        size_t frame_length;
+
+        record->kind = (uint8_t)(n % IPC_STREAM_KIND_COUNT);
+        record->source = (uint8_t)n;
+        record->size = (uint16_t)n;
+        record->seq = n;
+        record->timestamp = n * 1000u;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            record_buffer[sizeof(*record) + i] = (0u != (i % 3u)) ? test_fill(n, i) : IPC_STREAM_FRAME_SYNC0;
+        }
+        memcpy(&output[length], console, sizeof(console) - 1u);
+        length += sizeof(console) - 1u;
+        frame_length = ipc_stream_frame_encode(record, &output[length], sizeof(output) - length);
+        if (20u == n)
+        {
+            corrupted = length + IPC_STREAM_FRAME_HEADER_SIZE + 3u;
+        }
+        length += frame_length;
+    }
+    output[corrupted] ^= 0x10u;
+
+    ipc_stream_decoder_init(&decoder);
+    for (size_t i = 0; i < length; i++)
+    {
+        if (!ipc_stream_decode(&decoder, output[i]))
+        {
+            continue;
+        }
+        if (20u == expected_seq)
+        {
+            expected_seq++;
+        }
+        if ((decoder.record.seq != expected_seq) || (decoder.record.size != expected_seq) ||
+            (decoder.record.timestamp != (expected_seq * 1000u)))
+        {
+            printf("framing: frame %u decoded as %u\n", (unsigned)expected_seq, (unsigned)decoder.record.seq);
+            failures++;
+        }
+        for (uint32_t j = 0; j < decoder.record.size; j++)
+        {
+            uint8_t expected = (0u != (j % 3u)) ? test_fill(decoder.record.seq, j) : IPC_STREAM_FRAME_SYNC0;
+
+            if (decoder.data[j] != expected)
+            {
+                printf("framing: data of frame %u corrupted\n", (unsigned)decoder.record.seq);
+                failures++;
+                break;
+            }
+        }
+        expected_seq = decoder.record.seq + 1u;
+    }
+
+    printf("framing: %u frames, %u CRC errors, %u bytes skipped\n", (unsigned)decoder.frames,
+           (unsigned)decoder.crc_errors, (unsigned)decoder.skipped);
+    if ((63u != decoder.frames) || (1u != decoder.crc_errors) || (64u != expected_seq))
+    {
+        printf("framing: expected 63 frames and 1 CRC error\n");
+        failures++;
+    }
+
+    return failures;
+}
+
+int main(int argc, char *argv[])
+{
+    static char line[DECODE_LINE_SIZE];
+    const char *path = NULL;
+    bool base64 = false;
+    FILE *input = stdin;
+    uint32_t total = 0u;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "--selftest"))
+        {
+            uint32_t failures = test_ring() + test_framing();
+
+            printf("%s\n", (0u == failures) ? "PASS" : "FAIL");
+            return (0u == failures) ? 0 : 1;
+        }
+        else if (0 == strcmp(argv[i], "--base64"))
+        {
+            base64 = true;
+        }
+        else if (('-' != argv[i][0]) && (NULL == path))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--base64] [FILE]\n       %s --selftest\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (NULL != path)
+    {
+        input = fopen(path, base64 ? "r" : "rb");
+        if (NULL == input)
+        {
+            perror(path);
+            return 2;
+        }
+    }
+
+    ipc_stream_decoder_init(&decoder);
+    if (base64)
+    {
+        while (NULL != fgets(line, sizeof(line), input))
+        {
+            long length = decode_base64(line);
+
+            if (length < 0)
+            {
+                fprintf(stderr, "not base64: %.40s\n", line);
+                continue;
+            }
+            decode_bytes((const uint8_t *)line, (size_t)length);
+        }
+    }
+    else
+    {
+        size_t length;
+
+        while (0u != (length = fread(line, 1u, sizeof(line), input)))
+        {
+            decode_bytes((const uint8_t *)line, length);
+        }
+    }
+    if (stdin != input)
+    {
+        fclose(input);
+    }
+
+    for (uint32_t kind = 0; kind < IPC_STREAM_KIND_COUNT; kind++)
+    {
+        total += stats.records[kind];
+        fprintf(stderr, "%s: %u records\n", ipc_stream_kind_name(kind), (unsigned)stats.records[kind]);
+    }
+    fprintf(stderr, "%u frames, %u CRC errors, %u bytes outside of frames, %u records lost\n",
+            (unsigned)total, (unsigned)decoder.crc_errors, (unsigned)decoder.skipped, (unsigned)stats.lost);
+
+    return 0;
+}
+
+/* [] END OF FILE */
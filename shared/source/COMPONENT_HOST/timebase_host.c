@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name:   timebase_host.c
+*
+* Description: This file implements the timebase of timebase.h on a Linux
+*              host, for the host tools. The cycles are nanoseconds of the
+*              monotonic clock.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+#include "timebase.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint64_t timebase_start;
+
+/*******************************************************************************
+* Function Name: timebase_now_ns
+*******************************************************************************/
+static uint64_t timebase_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: timebase_init
+*******************************************************************************/
+void timebase_init(void)
+{
+    if (0u == timebase_start)
+    {
+        timebase_start = timebase_now_ns();
+    }
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles
+*******************************************************************************/
+uint64_t timebase_get_cycles(void)
+{
+    return timebase_now_ns() - timebase_start;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles32
+*******************************************************************************/
+uint32_t timebase_get_cycles32(void)
+{
+    return (uint32_t)timebase_get_cycles();
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles_per_us
+*******************************************************************************/
+uint32_t timebase_get_cycles_per_us(void)
+{
+    return 1000u;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_us
+*******************************************************************************/
+uint64_t timebase_get_us(void)
+{
+    return timebase_get_cycles() / 1000u;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_ms
+*******************************************************************************/
+uint32_t timebase_get_ms(void)
+{
+    return (uint32_t)(timebase_get_us() / 1000u);
+}
+
+/*******************************************************************************
+* Function Name: timebase_format_hms
+*******************************************************************************/
+void timebase_format_hms(uint32_t milliseconds, char *text, size_t size)
+{
+    unsigned int seconds = (milliseconds / 1000u) % 60u;
+    unsigned int minutes = (milliseconds / (1000u * 60u)) % 60u;
+    unsigned int hours = (milliseconds / (1000u * 60u * 60u));
+
+    (void)snprintf(text, size, "%02u:%02u:%02u", hours, minutes, seconds);
+}
+
+/* [] END OF FILE */
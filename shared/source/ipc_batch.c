@@ -0,0 +1,132 @@
+/******************************************************************************
+* File Name:   ipc_batch.c
+*
+* Description: This file implements the coalescing of the CM55 messages into
+*              batches. Every message still gets its own slot in the message
+*              ring, but the CM33 is only woken once per batch and then
+*              drains all of them, so one doorbell delivers N records. A
+*              batch ends when it is full, when its oldest message waited
+*              for the window, or right away for a detection, a class change
+*              of a model or any message that is not an inference result.
+*              The sensor tasks send smoothed state changes only, which all
+*              ring at once, so the coalescing only saves doorbells for a
+*              sender that repeats results. The coalescing has no hardware
+*              dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_batch.h"
+
+/*******************************************************************************
+* Function Name: ipc_batch_init
+********************************************************************************
+* Summary:
+*  Starts with an empty batch. Every model starts in the background class 0.
+*
+* Parameters:
+*  batch     : batch context
+*  max_count : messages per doorbell, 0 and 1 ring for every message
+*  window_us : longest a message waits for the rest of its batch
+*
+*******************************************************************************/
+void ipc_batch_init(ipc_batch_t *batch, uint32_t max_count, uint32_t window_us)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->max_count = (0u == max_count) ? 1u : max_count;
+    batch->window_us = window_us;
+}
+
+/*******************************************************************************
+* Function Name: ipc_batch_add
+********************************************************************************
+* Summary:
+*  Adds a message that was just offered to the ring and decides whether the
+*  doorbell has to be rung now. The caller reports a rung doorbell with
+*  ipc_batch_sent(), until then every further message asks for it again.
+*  Every message rings until the first doorbell got through: the CM33 only
+*  learns where the rings are from a doorbell and waits for the first
+*  message before it starts, and the sensor tasks only send state changes,
+*  so an initial background result may be the only message for a long time.
+*
+* Parameters:
+*  batch   : batch context
+*  payload : message, its timestamp is the time of the send
+*  pushed  : false if the ring was full and the message was dropped
+*
+* Return:
+*  true if the batch is complete and the CM33 has to be woken.
+*
+*******************************************************************************/
+bool ipc_batch_add(ipc_batch_t *batch, const ipc_payload_t *payload, bool pushed)
+{
+    /* A full ring has to be drained whatever the batch holds */
+    bool urgent = !pushed || (IPC_PAYLOAD_INFERENCE != payload->type) || (0u == batch->batches);
+
+    if ((IPC_PAYLOAD_INFERENCE == payload->type) && (payload->model_id < IPC_LABEL_MAX_MODELS))
+    {
+        urgent = urgent || (0u != payload->label_id) ||
+                 (payload->label_id != batch->last_label[payload->model_id]);
+        batch->last_label[payload->model_id] = payload->label_id;
+    }
+
+    if (pushed)
+    {
+        if (0u == batch->pending)
+        {
+            batch->start_us = payload->timestamp;
+        }
+        batch->pending++;
+    }
+
+    batch->due = batch->due || urgent || (batch->pending >= batch->max_count) ||
+                 ((payload->timestamp - batch->start_us) >= batch->window_us);
+
+    return batch->due;
+}
+
+/*******************************************************************************
+* Function Name: ipc_batch_poll
+********************************************************************************
+* Summary:
+*  Ends a batch whose oldest message waited for the window, so the last
+*  results do not wait for a next message that may never come. Called
+*  periodically by the sender.
+*
+* Parameters:
+*  batch  : batch context
+*  now_us : current time, same clock as the message timestamps
+*
+* Return:
+*  true if the batch is complete and the CM33 has to be woken.
+*
+*******************************************************************************/
+bool ipc_batch_poll(ipc_batch_t *batch, uint32_t now_us)
+{
+    batch->due = batch->due ||
+                 ((0u != batch->pending) && ((now_us - batch->start_us) >= batch->window_us));
+
+    return batch->due;
+}
+
+/*******************************************************************************
+* Function Name: ipc_batch_sent
+********************************************************************************
+* Summary:
+*  Records a rung doorbell, the next message starts a new batch.
+*
+*******************************************************************************/
+void ipc_batch_sent(ipc_batch_t *batch)
+{
+    batch->batches++;
+    batch->messages += batch->pending;
+    batch->pending = 0u;
+    batch->due = false;
+}
+
+/* [] END OF FILE */
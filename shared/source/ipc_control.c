@@ -0,0 +1,217 @@
+/******************************************************************************
+* File Name:   ipc_control.c
+*
+* Description: This file implements the control requests the CM33 sends to
+*              the CM55 to tune the inference pipeline at runtime. Requests
+*              travel through a message ring of their own, filled by the
+*              CM33 and drained by the CM55 task between two frames, so a
+*              parameter never changes while a frame is processed. Every
+*              request is answered with an acknowledgement in the regular
+*              CM55 to CM33 ring that echoes the request number and carries
+*              the outcome and the value applied. The requests have no
+*              hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_control.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Names used by the cloud commands, indexed by ipc_control_param_t */
+static const char *const ipc_control_param_names[IPC_CONTROL_PARAM_COUNT] =
+{
+    "batch-count",
+    "batch-window-ms",
+    "sensitivity",
+    "gate",
+    "gate-open-ratio",
+    "preprocessing",
+    "stream",
+};
+
+static const char *const ipc_control_status_names[] =
+{
+    "OK",
+    "Not supported by this application",
+    "Value out of range",
+    "Rejected by the model",
+    "Inference core not ready",
+    "No acknowledgement from the inference core",
+};
+
+/*******************************************************************************
+* Function Name: ipc_control_build_request
+********************************************************************************
+* Summary:
+*  Fills a control request.
+*
+* Parameters:
+*  request    : request to fill
+*  request_id : number echoed in the acknowledgement
+*  param      : ipc_control_param_t
+*  model_id   : model in the label table the parameter applies to
+*  value      : requested value
+*  args       : 4 further arguments, NULL for none
+*
+*******************************************************************************/
+void ipc_control_build_request(ipc_payload_t *request, uint16_t request_id, uint32_t param,
+                               uint32_t model_id, int32_t value, const uint8_t *args)
+{
+    memset(request, 0, sizeof(*request));
+    request->type = IPC_PAYLOAD_CONTROL;
+    request->model_id = (uint8_t)model_id;
+    request->label_id = (uint8_t)param;
+    request->control.request = request_id;
+    request->control.value = value;
+    if (NULL != args)
+    {
+        memcpy(request->control.args, args, sizeof(request->control.args));
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_control_serve
+********************************************************************************
+* Summary:
+*  Applies every waiting request in order and acknowledges each of them.
+*  The slot is released before the acknowledgement is sent, so the
+*  requester can queue the next request as soon as it sees the answer.
+*
+* Parameters:
+*  requests : request ring, this side is the consumer
+*  handler  : applies one request
+*  send_ack : sends the acknowledgement
+*  ctx      : passed to handler and send_ack
+*
+* Return:
+*  Number of requests served.
+*
+*******************************************************************************/
+uint32_t ipc_control_serve(ipc_ring_t *requests, ipc_control_handler_t handler,
+                           ipc_control_send_fn_t send_ack, void *ctx)
+{
+    const ipc_payload_t *request;
+    uint32_t served = 0;
+
+    while (NULL != (request = ipc_ring_peek(requests)))
+    {
+        ipc_payload_t ack = *request;
+
+        ack.type = IPC_PAYLOAD_CONTROL_ACK;
+        if ((IPC_PAYLOAD_CONTROL != request->type) || (request->label_id >= IPC_CONTROL_PARAM_COUNT))
+        {
+            ack.control.status = IPC_CONTROL_STATUS_UNSUPPORTED;
+        }
+        else
+        {
+            ack.control.status = (uint8_t)handler(request, &ack.control.value, ctx);
+        }
+        ipc_ring_release(requests);
+
+        (void)send_ack(&ack, ctx);
+        served++;
+    }
+
+    return served;
+}
+
+/*******************************************************************************
+* Function Name: ipc_control_apply
+********************************************************************************
+* Summary:
+*  Applies one control request on the CM55. The batch and stream parameters
+*  belong to the IPC layer, everything else goes to the handler of the
+*  sensor task.
+*
+* Parameters:
+*  request : control request
+*  value   : requested value, receives the value applied
+*  batch   : result coalescing of the message ring
+*  stream  : bulk stream, NULL if not built in
+*  handler : applies the other parameters, NULL if the task has none
+*  ctx     : passed to handler
+*
+*******************************************************************************/
+ipc_control_status_t ipc_control_apply(const ipc_payload_t *request, int32_t *value, ipc_batch_t *batch,
+                                       ipc_stream_t *stream, ipc_control_handler_t handler, void *ctx)
+{
+    switch (request->label_id)
+    {
+    case IPC_CONTROL_BATCH_COUNT:
+        if ((*value < 1) || (*value > (int32_t)IPC_RING_SLOTS))
+        {
+            return IPC_CONTROL_STATUS_INVALID;
+        }
+        batch->max_count = (uint32_t)*value;
+        return IPC_CONTROL_STATUS_OK;
+    case IPC_CONTROL_BATCH_WINDOW_MS:
+        if ((*value < 0) || (*value > (int32_t)(UINT32_MAX / 1000u)))
+        {
+            return IPC_CONTROL_STATUS_INVALID;
+        }
+        batch->window_us = (uint32_t)*value * 1000u;
+        return IPC_CONTROL_STATUS_OK;
+    case IPC_CONTROL_STREAM:
+        if (NULL == stream)
+        {
+            return IPC_CONTROL_STATUS_UNSUPPORTED;
+        }
+        if ((*value < 0) || (*value > (int32_t)IPC_STREAM_ALL_KINDS))
+        {
+            return IPC_CONTROL_STATUS_INVALID;
+        }
+        atomic_store_explicit(&stream->kinds, (uint32_t)*value, memory_order_relaxed);
+        return IPC_CONTROL_STATUS_OK;
+    default:
+        if (NULL == handler)
+        {
+            return IPC_CONTROL_STATUS_UNSUPPORTED;
+        }
+        return handler(request, value, ctx);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_control_param_from_name
+********************************************************************************
+* Summary:
+*  Looks up a parameter by the name the cloud commands use.
+*
+* Return:
+*  The ipc_control_param_t, -1 for an unknown name.
+*
+*******************************************************************************/
+int ipc_control_param_from_name(const char *name)
+{
+    for (int p = 0; p < (int)IPC_CONTROL_PARAM_COUNT; p++)
+    {
+        if (0 == strcmp(name, ipc_control_param_names[p]))
+        {
+            return p;
+        }
+    }
+
+    return -1;
+}
+
+/*******************************************************************************
+* Function Name: ipc_control_status_name
+*******************************************************************************/
+const char* ipc_control_status_name(uint32_t status)
+{
+    if (status >= (sizeof(ipc_control_status_names) / sizeof(ipc_control_status_names[0])))
+    {
+        return "Unknown status";
+    }
+
+    return ipc_control_status_names[status];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,223 @@
+/******************************************************************************
+* File Name:   ipc_inbox.c
+*
+* Description: This file implements the CM33 receiving side of the IPC
+*              messages: the doorbell handler sorts every message from the
+*              CM55 ring into a mailbox per kind (ipc_mailbox.c), and the
+*              application task copies the latest message of a kind and
+*              remembers the version it handed out instead of clearing
+*              flags. It also numbers the control requests and matches
+*              their acknowledgements. The backends only add the doorbell
+*              and the shared memory; the inbox has no hardware
+*              dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_inbox.h"
+#include "ipc_control.h"
+
+/*******************************************************************************
+* Function Name: ipc_inbox_init
+*******************************************************************************/
+void ipc_inbox_init(ipc_inbox_t *inbox)
+{
+    ipc_mailbox_init(&inbox->result);
+    ipc_mailbox_init(&inbox->detection);
+    ipc_mailbox_init(&inbox->radar_mode);
+    ipc_mailbox_init(&inbox->audio_clip);
+    ipc_mailbox_init(&inbox->control_ack);
+    atomic_init(&inbox->message_count, 0u);
+    inbox->message_seen = 0u;
+    inbox->detection_seen = 0u;
+    inbox->audio_clip_seen = 0u;
+    inbox->control_request_id = 0u;
+    ipc_latency_init(&inbox->latency);
+}
+
+/*******************************************************************************
+* Function Name: ipc_inbox_dispatch
+********************************************************************************
+* Summary:
+*  Stamps one message from the CM55 ring with its arrival and stores it for
+*  the application task.
+*
+* Parameters:
+*  inbox      : inbox of the doorbell handler
+*  message    : message, still in the ring
+*  receive_us : arrival time (timebase)
+*
+*******************************************************************************/
+void ipc_inbox_dispatch(ipc_inbox_t *inbox, const ipc_payload_t *message, uint32_t receive_us)
+{
+    ipc_payload_t stamped;
+    const ipc_payload_t *payload = &stamped;
+
+    memcpy(&stamped, message, sizeof(stamped));
+    stamped.receive_us = receive_us;
+
+    if (IPC_PAYLOAD_CONTROL_ACK == payload->type)
+    {
+        ipc_mailbox_write(&inbox->control_ack, payload);
+        return;
+    }
+    if (IPC_PAYLOAD_RADAR_MODE == payload->type)
+    {
+        ipc_mailbox_write(&inbox->radar_mode, payload);
+    }
+    else if (IPC_PAYLOAD_AUDIO_CLIP == payload->type)
+    {
+        ipc_mailbox_write(&inbox->audio_clip, payload);
+    }
+    else
+    {
+        ipc_mailbox_write(&inbox->result, payload);
+        if (0u != payload->label_id)
+        {
+            ipc_mailbox_write(&inbox->detection, payload);
+        }
+        ipc_latency_add_received(&inbox->latency, payload);
+    }
+    atomic_fetch_add_explicit(&inbox->message_count, 1u, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: ipc_inbox_has_received_message
+*******************************************************************************/
+bool ipc_inbox_has_received_message(ipc_inbox_t *inbox)
+{
+    uint32_t count = atomic_load_explicit(&inbox->message_count, memory_order_acquire);
+    bool ret = (count != inbox->message_seen);
+
+    inbox->message_seen = count;
+    return ret;
+}
+
+void ipc_inbox_copy_last_payload(const ipc_inbox_t *inbox, ipc_payload_t *target)
+{
+    (void)ipc_mailbox_read(&inbox->result, target);
+}
+
+/*******************************************************************************
+* Function Name: ipc_inbox_get_and_clear_cached_detection
+********************************************************************************
+* Summary:
+*  Copies the last detection if it was not handed out yet, the last result
+*  otherwise, which has no detection.
+*
+* Return:
+*  true for a new detection.
+*
+*******************************************************************************/
+bool ipc_inbox_get_and_clear_cached_detection(ipc_inbox_t *inbox, ipc_payload_t *target)
+{
+    uint32_t version = ipc_mailbox_read(&inbox->detection, target);
+
+    if (version != inbox->detection_seen)
+    {
+        inbox->detection_seen = version;
+        return true;
+    }
+    (void)ipc_mailbox_read(&inbox->result, target);
+    return false;
+}
+
+bool ipc_inbox_get_radar_mode(const ipc_inbox_t *inbox, ipc_payload_t *target)
+{
+    ipc_payload_t mode;
+
+    if (0u == ipc_mailbox_read(&inbox->radar_mode, &mode))
+    {
+        return false;
+    }
+    memcpy(target, &mode, sizeof(*target));
+    return true;
+}
+
+bool ipc_inbox_get_and_clear_audio_clip(ipc_inbox_t *inbox, ipc_payload_t *target)
+{
+    ipc_payload_t clip;
+    uint32_t version = ipc_mailbox_read(&inbox->audio_clip, &clip);
+
+    if (version == inbox->audio_clip_seen)
+    {
+        return false;
+    }
+    inbox->audio_clip_seen = version;
+    memcpy(target, &clip, sizeof(*target));
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ipc_inbox_send_control
+********************************************************************************
+* Summary:
+*  Numbers a control request and queues it for the CM55. The caller rings
+*  the doorbell of the CM55 afterwards.
+*
+* Return:
+*  false if the request ring is full.
+*
+*******************************************************************************/
+bool ipc_inbox_send_control(ipc_inbox_t *inbox, ipc_ring_t *control, uint32_t param, uint32_t model_id,
+                            int32_t value, const uint8_t *args)
+{
+    ipc_payload_t request;
+
+    if (0u == ++inbox->control_request_id)
+    {
+        inbox->control_request_id = 1u;
+    }
+    ipc_control_build_request(&request, inbox->control_request_id, param, model_id, value, args);
+
+    return ipc_ring_push(control, &request);
+}
+
+/*******************************************************************************
+* Function Name: ipc_inbox_wait_control_ack
+********************************************************************************
+* Summary:
+*  Waits for the acknowledgement of the last request sent. The CM55 applies
+*  requests between two frames, so the answer takes up to one frame period.
+*  An acknowledgement of an earlier request that timed out is ignored.
+*
+* Parameters:
+*  inbox      : inbox of the requester
+*  applied    : receives the value the CM55 applied, may be NULL
+*  timeout_ms : longest wait
+*  poll_ms    : interval of the checks
+*  delay      : waits poll_ms
+*
+* Return:
+*  The status of the acknowledgement, IPC_CONTROL_STATUS_TIMEOUT without one.
+*
+*******************************************************************************/
+ipc_control_status_t ipc_inbox_wait_control_ack(ipc_inbox_t *inbox, int32_t *applied, uint32_t timeout_ms,
+                                                uint32_t poll_ms, ipc_inbox_delay_fn_t delay)
+{
+    for (uint32_t waited_ms = 0; waited_ms <= timeout_ms; waited_ms += poll_ms)
+    {
+        ipc_payload_t ack;
+
+        /* Request numbers are not reused soon, an older acknowledgement never matches */
+        if ((0u != ipc_mailbox_read(&inbox->control_ack, &ack)) &&
+            (ack.control.request == inbox->control_request_id))
+        {
+            if (NULL != applied)
+            {
+                *applied = ack.control.value;
+            }
+            return (ipc_control_status_t)ack.control.status;
+        }
+        delay(poll_ms);
+    }
+
+    return IPC_CONTROL_STATUS_TIMEOUT;
+}
+
+/* [] END OF FILE */
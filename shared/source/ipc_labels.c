@@ -0,0 +1,179 @@
+/******************************************************************************
+* File Name:   ipc_labels.c
+*
+* Description: This file implements the label table that names the model,
+*              label and mode IDs of the IPC messages. The CM55 fills the
+*              table in shared memory before its first message and sets the
+*              magic last; the CM33 reads it in place once the magic is set,
+*              as the table is not written after that. The table has no
+*              hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#include "ipc_labels.h"
+
+/*******************************************************************************
+* Function Name: ipc_labels_copy_name
+*******************************************************************************/
+static void ipc_labels_copy_name(char *target, const char *name)
+{
+    strncpy(target, name, IPC_LABEL_SIZE - 1u);
+    target[IPC_LABEL_SIZE - 1u] = '\0';
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_add_model
+********************************************************************************
+* Summary:
+*  Adds the names of a model and of its classes to the label table. The
+*  background class 0 of every model shares label ID 0, the other classes
+*  get consecutive label IDs in the order the models are added.
+*
+* Parameters:
+*  table       : label table, not yet published
+*  name        : model name
+*  labels      : class names, index 0 is the background class
+*  class_count : number of classes including the background class
+*
+* Return:
+*  The model ID, -1 if the table is full or already published.
+*
+*******************************************************************************/
+int ipc_labels_add_model(ipc_label_table_t *table, const char *name, const char *const *labels,
+                         uint32_t class_count)
+{
+    if ((IPC_LABEL_TABLE_MAGIC == table->magic) || (0u == class_count) ||
+        (table->model_count >= IPC_LABEL_MAX_MODELS) ||
+        ((table->label_count + class_count - 1u) > IPC_LABEL_MAX_COUNT))
+    {
+        return -1;
+    }
+
+    if (0u == table->label_count)
+    {
+        ipc_labels_copy_name(table->labels[0], labels[0]);
+        table->label_count = 1u;
+    }
+    for (uint32_t c = 1; c < class_count; c++)
+    {
+        ipc_labels_copy_name(table->labels[table->label_count++], labels[c]);
+    }
+    ipc_labels_copy_name(table->models[table->model_count], name);
+
+    return (int)table->model_count++;
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_add_mode
+*******************************************************************************/
+void ipc_labels_add_mode(ipc_label_table_t *table, const char *name)
+{
+    if ((IPC_LABEL_TABLE_MAGIC != table->magic) && (table->mode_count < IPC_LABEL_MAX_MODES))
+    {
+        ipc_labels_copy_name(table->modes[table->mode_count++], name);
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_publish
+********************************************************************************
+* Summary:
+*  Completes the label table. The reader only uses the table once the magic
+*  is set, so the names are written before it.
+*
+*******************************************************************************/
+void ipc_labels_publish(ipc_label_table_t *table)
+{
+    atomic_thread_fence(memory_order_release);
+    table->magic = IPC_LABEL_TABLE_MAGIC;
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_get_published
+*******************************************************************************/
+static const ipc_label_table_t* ipc_labels_get_published(const ipc_label_table_t *table)
+{
+    if ((NULL == table) || (IPC_LABEL_TABLE_MAGIC != table->magic))
+    {
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    return table;
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_get_label
+********************************************************************************
+* Summary:
+*  Returns the name of a label ID, "" for an unknown ID or an incomplete
+*  table. ipc_labels_get_model_name() and ipc_labels_get_mode_name() do the
+*  same for the other IDs.
+*
+*******************************************************************************/
+const char* ipc_labels_get_label(const ipc_label_table_t *table, uint32_t label_id)
+{
+    table = ipc_labels_get_published(table);
+    if ((NULL == table) || (label_id >= table->label_count))
+    {
+        return "";
+    }
+
+    return table->labels[label_id];
+}
+
+const char* ipc_labels_get_model_name(const ipc_label_table_t *table, uint32_t model_id)
+{
+    table = ipc_labels_get_published(table);
+    if ((NULL == table) || (model_id >= table->model_count))
+    {
+        return "";
+    }
+
+    return table->models[model_id];
+}
+
+const char* ipc_labels_get_mode_name(const ipc_label_table_t *table, uint32_t mode)
+{
+    table = ipc_labels_get_published(table);
+    if ((NULL == table) || (mode >= table->mode_count))
+    {
+        return "";
+    }
+
+    return table->modes[mode];
+}
+
+/*******************************************************************************
+* Function Name: ipc_labels_find_model
+********************************************************************************
+* Summary:
+*  Returns the model ID of a model name, -1 if the table does not have it.
+*
+*******************************************************************************/
+int ipc_labels_find_model(const ipc_label_table_t *table, const char *name)
+{
+    table = ipc_labels_get_published(table);
+    if (NULL == table)
+    {
+        return -1;
+    }
+    for (uint32_t m = 0; m < table->model_count; m++)
+    {
+        if (0 == strcmp(name, table->models[m]))
+        {
+            return (int)m;
+        }
+    }
+
+    return -1;
+}
+
+/* [] END OF FILE */
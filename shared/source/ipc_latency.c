@@ -0,0 +1,233 @@
+/******************************************************************************
+* File Name:   ipc_latency.c
+*
+* Description: This file implements the end-to-end latency statistics of a
+*              result, from the capture of its data on the CM55 to the
+*              return of the MQTT publish on the CM33. Every stage has a
+*              histogram with power of two buckets, so a stage from a few
+*              microseconds to several seconds fits without configuration.
+*
+*              Both cores count microseconds since their own boot. The
+*              stages crossing the cores use a mapping of the CM55 time
+*              onto the CM33 time, taken like an NTP exchange: the CM33
+*              notes its time before and after asking the CM55 for its
+*              time, and assumes the answer was taken half way. The sample
+*              with the shortest round trip of a sync is the most exact.
+*              The mapping has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_latency.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const ipc_latency_stage_names[IPC_LATENCY_STAGE_COUNT] =
+{
+    "inference",
+    "send",
+    "receive",
+    "queue",
+    "publish",
+    "total"
+};
+
+/*******************************************************************************
+* Function Name: ipc_latency_init
+*******************************************************************************/
+void ipc_latency_init(ipc_latency_t *lat)
+{
+    memset(lat, 0, sizeof(*lat));
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_add
+*******************************************************************************/
+void ipc_latency_add(ipc_latency_t *lat, ipc_latency_stage_t stage, uint32_t latency_us)
+{
+    ipc_latency_hist_t *hist = &lat->stages[stage];
+    uint32_t bucket = 0u;
+
+    while (((bucket + 1u) < IPC_LATENCY_BUCKETS) && (latency_us >= (1u << bucket)))
+    {
+        bucket++;
+    }
+    hist->histogram[bucket]++;
+    hist->count++;
+    hist->total_us += latency_us;
+    if (latency_us > hist->max_us)
+    {
+        hist->max_us = latency_us;
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_percentile
+********************************************************************************
+* Summary:
+*  Returns the upper bound of the bucket holding the given share of the
+*  latencies of a stage, i.e. at most twice the real percentile.
+*
+* Parameters:
+*  lat      : statistics
+*  stage    : stage
+*  permille : share, 500 for the median
+*
+* Return:
+*  The latency in microseconds, 0 if the stage has no samples.
+*
+*******************************************************************************/
+uint32_t ipc_latency_percentile(const ipc_latency_t *lat, ipc_latency_stage_t stage, uint32_t permille)
+{
+    const ipc_latency_hist_t *hist = &lat->stages[stage];
+    uint64_t target = ((uint64_t)hist->count * permille + 999u) / 1000u;
+    uint64_t seen = 0u;
+
+    if (0u == hist->count)
+    {
+        return 0u;
+    }
+    for (uint32_t b = 0; (b + 1u) < IPC_LATENCY_BUCKETS; b++)
+    {
+        seen += hist->histogram[b];
+        if (seen >= target)
+        {
+            return (1u << b);
+        }
+    }
+
+    return hist->max_us;
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_stage_name
+*******************************************************************************/
+const char* ipc_latency_stage_name(uint32_t stage)
+{
+    return (stage < IPC_LATENCY_STAGE_COUNT) ? ipc_latency_stage_names[stage] : "";
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_sync_begin
+*******************************************************************************/
+void ipc_latency_sync_begin(ipc_latency_t *lat)
+{
+    lat->round_valid = false;
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_sync_sample
+********************************************************************************
+* Summary:
+*  Adds one exchange to the sync in progress.
+*
+* Parameters:
+*  lat            : statistics
+*  cm33_before_us : CM33 time before the request
+*  cm55_us        : CM55 time of the answer
+*  cm33_after_us  : CM33 time after the answer arrived
+*
+*******************************************************************************/
+void ipc_latency_sync_sample(ipc_latency_t *lat, uint32_t cm33_before_us, uint32_t cm55_us, uint32_t cm33_after_us)
+{
+    uint32_t rtt_us = cm33_after_us - cm33_before_us;
+    uint32_t cm33_us = cm33_before_us + (rtt_us / 2u);
+
+    if (!lat->round_valid || (rtt_us < lat->round_rtt_us))
+    {
+        lat->round_offset_us = (int32_t)(cm55_us - cm33_us);
+        lat->round_rtt_us = rtt_us;
+        lat->round_valid = true;
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_sync_end
+********************************************************************************
+* Summary:
+*  Applies the best sample of the sync. A sync without samples keeps the
+*  previous mapping.
+*
+* Return:
+*  false if no sample was taken.
+*
+*******************************************************************************/
+bool ipc_latency_sync_end(ipc_latency_t *lat)
+{
+    if (!lat->round_valid)
+    {
+        return false;
+    }
+    lat->offset_us = lat->round_offset_us;
+    lat->sync_rtt_us = lat->round_rtt_us;
+    lat->syncs++;
+    lat->synced = true;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_to_cm33
+*******************************************************************************/
+uint32_t ipc_latency_to_cm33(const ipc_latency_t *lat, uint32_t cm55_us)
+{
+    return cm55_us - (uint32_t)lat->offset_us;
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_add_received
+********************************************************************************
+* Summary:
+*  Adds the stages up to the arrival of a message on the CM33. Called by the
+*  doorbell callback once receive_us is set. Stamps of 0 are unknown and
+*  skip their stages.
+*
+*******************************************************************************/
+void ipc_latency_add_received(ipc_latency_t *lat, const ipc_payload_t *payload)
+{
+    if ((0u != payload->capture_us) && (0u != payload->inference_us))
+    {
+        ipc_latency_add(lat, IPC_LATENCY_INFERENCE, payload->inference_us - payload->capture_us);
+    }
+    if (0u != payload->inference_us)
+    {
+        ipc_latency_add(lat, IPC_LATENCY_SEND, payload->timestamp - payload->inference_us);
+    }
+    if (lat->synced)
+    {
+        ipc_latency_add(lat, IPC_LATENCY_RECEIVE,
+                        payload->receive_us - ipc_latency_to_cm33(lat, payload->timestamp));
+    }
+}
+
+/*******************************************************************************
+* Function Name: ipc_latency_add_published
+********************************************************************************
+* Summary:
+*  Adds the CM33 stages of a message once its telemetry was published.
+*
+* Parameters:
+*  lat          : statistics
+*  payload      : message as received
+*  built_us     : CM33 time the telemetry was built
+*  published_us : CM33 time the publish returned
+*
+*******************************************************************************/
+void ipc_latency_add_published(ipc_latency_t *lat, const ipc_payload_t *payload,
+                               uint32_t built_us, uint32_t published_us)
+{
+    ipc_latency_add(lat, IPC_LATENCY_QUEUE, built_us - payload->receive_us);
+    ipc_latency_add(lat, IPC_LATENCY_PUBLISH, published_us - built_us);
+    if (lat->synced && (0u != payload->capture_us))
+    {
+        ipc_latency_add(lat, IPC_LATENCY_TOTAL, published_us - ipc_latency_to_cm33(lat, payload->capture_us));
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name:   ipc_mailbox.c
+*
+* Description: This file implements a mailbox holding the last message of
+*              one kind, protected by a sequence lock. The writer makes the
+*              sequence odd, copies the message and makes it even again. A
+*              reader copies the message between two reads of the sequence
+*              and tries again if the writer was active in between. The
+*              writer never waits and the readers never mask interrupts;
+*              with the writer in an interrupt on the same core, a retry
+*              only happens when the interrupt hit the copy. The mailbox
+*              has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_mailbox.h"
+
+/*******************************************************************************
+* Function Name: ipc_mailbox_init
+*******************************************************************************/
+void ipc_mailbox_init(ipc_mailbox_t *box)
+{
+    memset(&box->payload, 0, sizeof(box->payload));
+    atomic_init(&box->sequence, 0u);
+}
+
+/*******************************************************************************
+* Function Name: ipc_mailbox_write
+********************************************************************************
+* Summary:
+*  Replaces the message. Only one writer may use a mailbox.
+*
+*******************************************************************************/
+void ipc_mailbox_write(ipc_mailbox_t *box, const ipc_payload_t *payload)
+{
+    uint32_t sequence = atomic_load_explicit(&box->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&box->sequence, sequence + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&box->payload, payload, sizeof(box->payload));
+    atomic_store_explicit(&box->sequence, sequence + 2u, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: ipc_mailbox_try_read
+********************************************************************************
+* Summary:
+*  Copies the message once.
+*
+* Parameters:
+*  box     : mailbox
+*  payload : receives the message, only valid if true is returned
+*  version : receives the number of messages written, 0 if none yet
+*
+* Return:
+*  false if the writer changed the message during the copy.
+*
+*******************************************************************************/
+bool ipc_mailbox_try_read(const ipc_mailbox_t *box, ipc_payload_t *payload, uint32_t *version)
+{
+    uint32_t before = atomic_load_explicit(&box->sequence, memory_order_acquire);
+    uint32_t after;
+
+    if (0u != (before & 1u))
+    {
+        return false;
+    }
+    memcpy(payload, &box->payload, sizeof(*payload));
+    atomic_thread_fence(memory_order_acquire);
+    after = atomic_load_explicit(&box->sequence, memory_order_relaxed);
+    *version = before / 2u;
+
+    return (before == after);
+}
+
+/*******************************************************************************
+* Function Name: ipc_mailbox_read
+********************************************************************************
+* Summary:
+*  Copies the message, retrying until the copy was not disturbed by the
+*  writer.
+*
+* Return:
+*  The number of messages written, 0 if none yet.
+*
+*******************************************************************************/
+uint32_t ipc_mailbox_read(const ipc_mailbox_t *box, ipc_payload_t *payload)
+{
+    uint32_t version;
+
+    while (!ipc_mailbox_try_read(box, payload, &version))
+    {
+    }
+
+    return version;
+}
+
+/*******************************************************************************
+* Function Name: ipc_mailbox_version
+********************************************************************************
+* Summary:
+*  Returns the number of messages written without copying the message.
+*
+*******************************************************************************/
+uint32_t ipc_mailbox_version(const ipc_mailbox_t *box)
+{
+    return (atomic_load_explicit(&box->sequence, memory_order_acquire) + 1u) / 2u;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,194 @@
+/******************************************************************************
+* File Name:   ipc_ring.c
+*
+* Description: This file implements the ring of message slots the CM55 uses
+*              to send messages to the CM33. The producer copies a message
+*              into the next free slot without waiting for the consumer and
+*              reports a full ring instead of overwriting a message that was
+*              not read yet. Every message carries a sequence number, so the
+*              consumer can count the messages it never saw. The IPC pipe is
+*              only used as a doorbell to wake the consumer. The ring has no
+*              hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_ring.h"
+
+#if (0u != (IPC_RING_SLOTS & (IPC_RING_SLOTS - 1u)))
+#error "IPC_RING_SLOTS must be a power of two"
+#endif
+
+/*******************************************************************************
+* Function Name: ipc_ring_init
+********************************************************************************
+* Summary:
+*  Empties the ring. Called by the producer before the consumer is told
+*  where the ring is.
+*
+*******************************************************************************/
+void ipc_ring_init(ipc_ring_t *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+    atomic_init(&ring->head, 0u);
+    atomic_init(&ring->tail, 0u);
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_store
+********************************************************************************
+* Summary:
+*  Copies a message into the next free slot with the next sequence number
+*  and hands it to the consumer.
+*
+* Return:
+*  false if the ring was full, nothing is changed then.
+*
+*******************************************************************************/
+static bool ipc_ring_store(ipc_ring_t *ring, const ipc_payload_t *payload)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    ipc_payload_t *slot = &ring->slots[head % IPC_RING_SLOTS];
+
+    if ((head - tail) >= IPC_RING_SLOTS)
+    {
+        return false;
+    }
+
+    memcpy(slot, payload, sizeof(*slot));
+    slot->seq = ring->next_seq++;
+    ring->stats.sent++;
+    if ((head + 1u - tail) > ring->stats.high_water)
+    {
+        ring->stats.high_water = head + 1u - tail;
+    }
+    atomic_store_explicit(&ring->head, head + 1u, memory_order_release);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_push
+********************************************************************************
+* Summary:
+*  Copies a message into the next free slot, stamps it with the next
+*  sequence number and hands it to the consumer. If the ring is full the
+*  message is dropped and counted. The sequence number advances in both
+*  cases so the consumer sees the gap.
+*
+* Parameters:
+*  ring    : ring context
+*  payload : message to send
+*
+* Return:
+*  false if the ring was full.
+*
+*******************************************************************************/
+bool ipc_ring_push(ipc_ring_t *ring, const ipc_payload_t *payload)
+{
+    if (!ipc_ring_store(ring, payload))
+    {
+        ring->next_seq++;
+        ring->stats.dropped++;
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_try_push
+********************************************************************************
+* Summary:
+*  Like ipc_ring_push(), but a message that does not fit is not dropped:
+*  neither the sequence number nor the drop count advances, so a producer
+*  that waits for a free slot and sends the message again leaves no gap.
+*
+* Return:
+*  false if the ring was full, the caller still owns the message.
+*
+*******************************************************************************/
+bool ipc_ring_try_push(ipc_ring_t *ring, const ipc_payload_t *payload)
+{
+    return ipc_ring_store(ring, payload);
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_peek
+********************************************************************************
+* Summary:
+*  Returns the oldest message without copying it. The slot stays owned by
+*  the consumer until ipc_ring_release() is called.
+*
+* Return:
+*  The slot, NULL if the ring is empty.
+*
+*******************************************************************************/
+const ipc_payload_t* ipc_ring_peek(ipc_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+
+    return &ring->slots[tail % IPC_RING_SLOTS];
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_release
+********************************************************************************
+* Summary:
+*  Returns the slot obtained by ipc_ring_peek() to the producer.
+*
+*******************************************************************************/
+void ipc_ring_release(ipc_ring_t *ring)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    const ipc_payload_t *slot;
+
+    if (head == tail)
+    {
+        return;
+    }
+
+    slot = &ring->slots[tail % IPC_RING_SLOTS];
+    ring->stats.lost += slot->seq - ring->expected_seq;
+    ring->expected_seq = slot->seq + 1u;
+    ring->stats.received++;
+    atomic_store_explicit(&ring->tail, tail + 1u, memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_depth
+********************************************************************************
+* Summary:
+*  Returns the number of messages waiting for the consumer.
+*
+*******************************************************************************/
+uint32_t ipc_ring_depth(const ipc_ring_t *ring)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    return head - tail;
+}
+
+/*******************************************************************************
+* Function Name: ipc_ring_get_stats
+*******************************************************************************/
+void ipc_ring_get_stats(const ipc_ring_t *ring, ipc_ring_stats_t *stats)
+{
+    memcpy(stats, &ring->stats, sizeof(*stats));
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,461 @@
+/******************************************************************************
+* File Name:   ipc_stream.c
+*
+* Description: This file implements the bulk stream the CM55 uses to hand
+*              per-frame model inputs, raw model outputs and sensor samples
+*              to the CM33 at full rate, and the framing the CM33 sends them
+*              in over a serial line.
+*
+*              The ring holds variable size records in a byte buffer. The
+*              producer reserves a record, lets the sensor task write the
+*              data in place, e.g. the model input while it is computed,
+*              and commits it. It never waits: a record that does not fit
+*              is dropped and counted, and its sequence number is skipped
+*              so the consumer and the host decoder see the gap. There is no
+*              doorbell, the consumer drains the ring at its own pace, so
+*              the producer cost is a few stores per record.
+*
+*              A frame is the record header and data between two sync bytes
+*              and a CRC-16/CCITT, so a decoder finds the frames in a byte
+*              stream that also carries console text.
+*
+*              The buffer can be in cacheable memory of the CM55, every
+*              committed record and pad is written back from the data cache.
+*              Otherwise the stream has no hardware dependencies.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <string.h>
+#include "ipc_stream.h"
+
+#if defined(COMPONENT_CM55)
+#include "cy_pdl.h"
+#define IPC_STREAM_FLUSH(addr, size)        SCB_CleanDCache_by_Addr((void *)(addr), (int32_t)(size))
+#else
+#define IPC_STREAM_FLUSH(addr, size)
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define IPC_STREAM_RECORD_BYTES(size)       \
+    (((uint32_t)sizeof(ipc_stream_record_t) + (size) + IPC_STREAM_ALIGN - 1u) & ~(IPC_STREAM_ALIGN - 1u))
+
+/* Frame decoder states */
+#define IPC_STREAM_DECODE_SYNC0             (0u)
+#define IPC_STREAM_DECODE_SYNC1             (1u)
+#define IPC_STREAM_DECODE_HEADER            (2u)
+#define IPC_STREAM_DECODE_DATA              (3u)
+#define IPC_STREAM_DECODE_CRC0              (4u)
+#define IPC_STREAM_DECODE_CRC1              (5u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char *const ipc_stream_kind_names[IPC_STREAM_KIND_COUNT] =
+{
+    "features",
+    "outputs",
+    "imu",
+};
+
+/*******************************************************************************
+* Function Name: ipc_stream_buffer
+*******************************************************************************/
+static inline uint8_t* ipc_stream_buffer(const ipc_stream_t *stream)
+{
+    return (uint8_t *)((intptr_t)stream + stream->buffer_offset);
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_init
+********************************************************************************
+* Summary:
+*  Empties the stream. Called by the producer before the consumer is told
+*  where the stream is.
+*
+* Parameters:
+*  stream : stream context
+*  buffer : record buffer, IPC_STREAM_ALIGN aligned
+*  size   : bytes of the buffer, a power of two
+*  kinds  : mask of the ipc_stream_kind_t to stream, 0 streams nothing
+*
+*******************************************************************************/
+void ipc_stream_init(ipc_stream_t *stream, void *buffer, uint32_t size, uint32_t kinds)
+{
+    memset(stream, 0, sizeof(*stream));
+    atomic_init(&stream->head, 0u);
+    atomic_init(&stream->tail, 0u);
+    atomic_init(&stream->kinds, kinds);
+    stream->buffer_offset = (intptr_t)buffer - (intptr_t)stream;
+    stream->size = (NULL != buffer) ? size : 0u;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_reserve
+********************************************************************************
+* Summary:
+*  Reserves a record for the caller to fill in place. A record that would
+*  cross the end of the buffer starts at the beginning instead, the end is
+*  marked as a pad. Reserving again before the commit replaces the record.
+*
+* Parameters:
+*  stream    : stream context
+*  kind      : ipc_stream_kind_t
+*  source    : model ID of the producer
+*  size      : most bytes of data the caller writes
+*  timestamp : producer time in microseconds
+*
+* Return:
+*  The data of the record, NULL if the kind is not streamed or the record
+*  was dropped because the consumer did not keep up.
+*
+*******************************************************************************/
+void* ipc_stream_reserve(ipc_stream_t *stream, uint32_t kind, uint32_t source, uint32_t size, uint32_t timestamp)
+{
+    uint8_t *buffer = ipc_stream_buffer(stream);
+    uint32_t head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+    uint32_t bytes = IPC_STREAM_RECORD_BYTES(size);
+    uint32_t offset = head & (stream->size - 1u);
+    uint32_t room = stream->size - offset;
+    uint32_t pad = (room < bytes) ? room : 0u;
+    ipc_stream_record_t *record;
+
+    stream->reserved = NULL;
+    if ((0u == stream->size) ||
+        (0u == (atomic_load_explicit(&stream->kinds, memory_order_relaxed) & (1u << kind))))
+    {
+        return NULL;
+    }
+    if ((size > IPC_STREAM_MAX_DATA) || (((head - tail) + pad + bytes) > stream->size))
+    {
+        stream->next_seq++;
+        stream->stats.dropped++;
+        return NULL;
+    }
+
+    /* The consumer skips the end without a header, it is too short for a record */
+    if (pad >= sizeof(ipc_stream_record_t))
+    {
+        record = (ipc_stream_record_t *)&buffer[offset];
+        record->kind = IPC_STREAM_PAD;
+        IPC_STREAM_FLUSH(record, sizeof(*record));
+    }
+
+    record = (ipc_stream_record_t *)&buffer[(head + pad) & (stream->size - 1u)];
+    record->kind = (uint8_t)kind;
+    record->source = (uint8_t)source;
+    record->size = (uint16_t)size;
+    record->timestamp = timestamp;
+    stream->reserved = record;
+    stream->reserved_head = head + pad;
+
+    return record + 1;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_commit
+********************************************************************************
+* Summary:
+*  Hands the reserved record to the consumer.
+*
+* Parameters:
+*  stream : stream context
+*  size   : bytes of data written, up to the reserved size
+*
+* Return:
+*  The record, NULL if none was reserved.
+*
+*******************************************************************************/
+const ipc_stream_record_t* ipc_stream_commit(ipc_stream_t *stream, uint32_t size)
+{
+    ipc_stream_record_t *record = stream->reserved;
+    uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+    uint32_t head;
+
+    if (NULL == record)
+    {
+        return NULL;
+    }
+    stream->reserved = NULL;
+    if (size < record->size)
+    {
+        record->size = (uint16_t)size;
+    }
+    record->seq = stream->next_seq++;
+    IPC_STREAM_FLUSH(record, sizeof(*record) + record->size);
+
+    head = stream->reserved_head + IPC_STREAM_RECORD_BYTES(record->size);
+    stream->stats.records++;
+    stream->stats.bytes += record->size;
+    if ((head - tail) > stream->stats.high_water)
+    {
+        stream->stats.high_water = head - tail;
+    }
+    atomic_store_explicit(&stream->head, head, memory_order_release);
+
+    return record;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_peek
+********************************************************************************
+* Summary:
+*  Returns the oldest record without copying it, skipping the pad at the end
+*  of the buffer. The record stays owned by the consumer until
+*  ipc_stream_release() is called.
+*
+* Return:
+*  The record, NULL if the stream is empty.
+*
+*******************************************************************************/
+const ipc_stream_record_t* ipc_stream_peek(ipc_stream_t *stream)
+{
+    const uint8_t *buffer = ipc_stream_buffer(stream);
+    uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&stream->head, memory_order_acquire);
+    uint32_t offset = tail & (stream->size - 1u);
+    uint32_t room = stream->size - offset;
+    const ipc_stream_record_t *record;
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+    record = (const ipc_stream_record_t *)&buffer[offset];
+    if ((room < sizeof(ipc_stream_record_t)) || (IPC_STREAM_PAD == record->kind))
+    {
+        tail += room;
+        atomic_store_explicit(&stream->tail, tail, memory_order_release);
+        if (head == tail)
+        {
+            return NULL;
+        }
+        record = (const ipc_stream_record_t *)buffer;
+    }
+
+    return record;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_release
+********************************************************************************
+* Summary:
+*  Returns the record obtained by ipc_stream_peek() to the producer.
+*
+*******************************************************************************/
+void ipc_stream_release(ipc_stream_t *stream)
+{
+    const ipc_stream_record_t *record = ipc_stream_peek(stream);
+    uint32_t tail;
+
+    if (NULL == record)
+    {
+        return;
+    }
+
+    tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    stream->stats.lost += record->seq - stream->expected_seq;
+    stream->expected_seq = record->seq + 1u;
+    stream->stats.received++;
+    atomic_store_explicit(&stream->tail, tail + IPC_STREAM_RECORD_BYTES(record->size), memory_order_release);
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_get_stats
+*******************************************************************************/
+void ipc_stream_get_stats(const ipc_stream_t *stream, ipc_stream_stats_t *stats)
+{
+    memcpy(stats, &stream->stats, sizeof(*stats));
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_kind_name
+*******************************************************************************/
+const char* ipc_stream_kind_name(uint32_t kind)
+{
+    return (kind < IPC_STREAM_KIND_COUNT) ? ipc_stream_kind_names[kind] : "";
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_crc16
+********************************************************************************
+* Summary:
+*  CRC-16/CCITT (polynomial 0x1021), bitwise as the frames are short.
+*
+* Parameters:
+*  crc    : 0xFFFF to start, the previous result to continue
+*  data   : bytes to add
+*  length : number of bytes
+*
+*******************************************************************************/
+uint16_t ipc_stream_crc16(uint16_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)bytes[i] << 8);
+        for (uint32_t bit = 0; bit < 8u; bit++)
+        {
+            crc = (0u != (crc & 0x8000u)) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_frame_header
+********************************************************************************
+* Summary:
+*  Writes the sync bytes and the header of the frame of a record, so the
+*  data can be sent from the ring without a copy.
+*
+* Parameters:
+*  record : record to frame
+*  header : receives IPC_STREAM_FRAME_HEADER_SIZE bytes
+*
+* Return:
+*  The CRC to send after the data, little endian.
+*
+*******************************************************************************/
+uint16_t ipc_stream_frame_header(const ipc_stream_record_t *record, uint8_t *header)
+{
+    uint16_t crc;
+
+    header[0] = IPC_STREAM_FRAME_SYNC0;
+    header[1] = IPC_STREAM_FRAME_SYNC1;
+    memcpy(&header[2], record, sizeof(*record));
+    crc = ipc_stream_crc16(0xFFFFu, &header[2], sizeof(*record));
+
+    return ipc_stream_crc16(crc, ipc_stream_record_data(record), record->size);
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_frame_encode
+********************************************************************************
+* Summary:
+*  Writes the complete frame of a record.
+*
+* Return:
+*  Bytes written, 0 if the frame does not fit.
+*
+*******************************************************************************/
+size_t ipc_stream_frame_encode(const ipc_stream_record_t *record, uint8_t *frame, size_t size)
+{
+    size_t length = IPC_STREAM_FRAME_OVERHEAD + record->size;
+    uint16_t crc;
+
+    if (length > size)
+    {
+        return 0u;
+    }
+    crc = ipc_stream_frame_header(record, frame);
+    memcpy(&frame[IPC_STREAM_FRAME_HEADER_SIZE], ipc_stream_record_data(record), record->size);
+    frame[length - 2u] = (uint8_t)(crc & 0xFFu);
+    frame[length - 1u] = (uint8_t)(crc >> 8);
+
+    return length;
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_decoder_init
+*******************************************************************************/
+void ipc_stream_decoder_init(ipc_stream_decoder_t *decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/*******************************************************************************
+* Function Name: ipc_stream_decode
+********************************************************************************
+* Summary:
+*  Adds one received byte. A frame with a wrong CRC, kind or size is counted
+*  and the decoder looks for the next sync bytes.
+*
+* Return:
+*  true when the byte completed a valid frame, its record and data are in
+*  the decoder until the next call.
+*
+*******************************************************************************/
+bool ipc_stream_decode(ipc_stream_decoder_t *decoder, uint8_t byte)
+{
+    switch (decoder->state)
+    {
+    case IPC_STREAM_DECODE_SYNC0:
+        if (IPC_STREAM_FRAME_SYNC0 == byte)
+        {
+            decoder->state = IPC_STREAM_DECODE_SYNC1;
+        }
+        else
+        {
+            decoder->skipped++;
+        }
+        break;
+    case IPC_STREAM_DECODE_SYNC1:
+        if (IPC_STREAM_FRAME_SYNC1 == byte)
+        {
+            decoder->state = IPC_STREAM_DECODE_HEADER;
+            decoder->count = 0u;
+        }
+        else if (IPC_STREAM_FRAME_SYNC0 != byte)
+        {
+            decoder->skipped += 2u;
+            decoder->state = IPC_STREAM_DECODE_SYNC0;
+        }
+        else
+        {
+            decoder->skipped++;
+        }
+        break;
+    case IPC_STREAM_DECODE_HEADER:
+        decoder->header[decoder->count++] = byte;
+        if (decoder->count == sizeof(decoder->header))
+        {
+            memcpy(&decoder->record, decoder->header, sizeof(decoder->record));
+            if ((decoder->record.kind >= IPC_STREAM_KIND_COUNT) || (decoder->record.size > IPC_STREAM_MAX_DATA))
+            {
+                decoder->crc_errors++;
+                decoder->state = IPC_STREAM_DECODE_SYNC0;
+                break;
+            }
+            decoder->crc = ipc_stream_crc16(0xFFFFu, decoder->header, sizeof(decoder->header));
+            decoder->count = 0u;
+            decoder->state = (0u != decoder->record.size) ? IPC_STREAM_DECODE_DATA : IPC_STREAM_DECODE_CRC0;
+        }
+        break;
+    case IPC_STREAM_DECODE_DATA:
+        decoder->data[decoder->count++] = byte;
+        if (decoder->count == decoder->record.size)
+        {
+            decoder->crc = ipc_stream_crc16(decoder->crc, decoder->data, decoder->count);
+            decoder->state = IPC_STREAM_DECODE_CRC0;
+        }
+        break;
+    case IPC_STREAM_DECODE_CRC0:
+        decoder->crc ^= byte;
+        decoder->state = IPC_STREAM_DECODE_CRC1;
+        break;
+    default:
+        decoder->crc ^= (uint16_t)((uint16_t)byte << 8);
+        decoder->state = IPC_STREAM_DECODE_SYNC0;
+        if (0u != decoder->crc)
+        {
+            decoder->crc_errors++;
+            return false;
+        }
+        decoder->frames++;
+        return true;
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,247 @@
+/******************************************************************************
+* File Name:   timebase.c
+*
+* Description: This file implements the monotonic timebase of a core. The
+*              time is the FreeRTOS tick count extended to 64 bits plus the
+*              part of the current tick elapsed on the SysTick, so it has
+*              the resolution of the core clock and never wraps.
+*
+*              Both cores idle in CPU Sleep or Deep Sleep when the Device
+*              Configurator selects it (configUSE_TICKLESS_IDLE 2 in
+*              FreeRTOSConfig.h). The core clock, the SysTick and the DWT
+*              cycle counter stop there, but the tickless idle advances the
+*              tick count by the time slept, measured on the low power
+*              timer, so the time keeps counting through sleep, to within
+*              one tick around a wake up. Only timebase_get_cycles32() reads
+*              the DWT counter, which counts the cycles the core was awake,
+*              as wanted for profiling.
+*
+*              The tick count wraps after 2^32 ticks, 49 days at 1 kHz.
+*              Every read extends it, and a software timer reads it every
+*              TIMEBASE_REFRESH_MS so no wrap is missed while nothing asks
+*              for the time. Without FreeRTOS there is no tick, and the time
+*              falls back to the DWT counter extended the same way, which
+*              is only correct while the core does not sleep.
+*
+* Related Document: See README.md
+*
+*******************************************************************************/
+/* SPDX-License-Identifier: MIT
+ * Copyright (C) 2026 Avnet
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "cy_pdl.h"
+#include "timebase.h"
+
+#ifdef COMPONENT_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#endif
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Period of the counter extension, well below the wrap time of the counter.
+ * Each refresh wakes a sleeping core, so it is kept long. */
+#ifndef TIMEBASE_REFRESH_MS
+#ifdef COMPONENT_FREERTOS
+#define TIMEBASE_REFRESH_MS                 (3600000u)
+#else
+#define TIMEBASE_REFRESH_MS                 (1000u)
+#endif
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static volatile uint32_t timebase_high;
+static volatile uint32_t timebase_last;
+static uint32_t timebase_cycles_per_us = 1u;
+#ifdef COMPONENT_FREERTOS
+static uint32_t timebase_cycles_per_tick = 1u;
+#endif
+static bool timebase_ready = false;
+
+#ifdef COMPONENT_FREERTOS
+/*******************************************************************************
+* Function Name: timebase_refresh
+********************************************************************************
+* Summary:
+*  Software timer callback, extends the counter at least once per wrap.
+*
+*******************************************************************************/
+static void timebase_refresh(TimerHandle_t timer)
+{
+    (void)timer;
+    (void)timebase_get_cycles();
+}
+#endif
+
+/*******************************************************************************
+* Function Name: timebase_init
+********************************************************************************
+* Summary:
+*  Starts the cycle counter and the software timer extending the time.
+*  Called once from main() before the tasks are created, further calls do
+*  nothing. With FreeRTOS the time stays 0 until the scheduler starts the
+*  tick.
+*
+*******************************************************************************/
+void timebase_init(void)
+{
+    if (timebase_ready)
+    {
+        return;
+    }
+
+    DCB->DEMCR |= DCB_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    timebase_high = 0;
+    timebase_last = 0;
+    timebase_cycles_per_us = (SystemCoreClock >= 1000000u) ? (SystemCoreClock / 1000000u) : 1u;
+#ifdef COMPONENT_FREERTOS
+    timebase_cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+#endif
+    timebase_ready = true;
+
+#ifdef COMPONENT_FREERTOS
+    TimerHandle_t timer = xTimerCreate("timebase", pdMS_TO_TICKS(TIMEBASE_REFRESH_MS), pdTRUE, NULL, timebase_refresh);
+    if ((NULL == timer) || (pdPASS != xTimerStart(timer, 0)))
+    {
+        CY_ASSERT(0);
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles
+********************************************************************************
+* Summary:
+*  Returns the core clock cycles since timebase_init(), including the time
+*  the core slept. Can be called from tasks and interrupts of any priority:
+*  the 32-bit tick count is read without a kernel call, and interrupts are
+*  masked so the tick cannot advance between the two reads. A SysTick that
+*  reloaded while they were masked has its interrupt pending and is counted
+*  here.
+*
+*******************************************************************************/
+uint64_t timebase_get_cycles(void)
+{
+    uint32_t state = Cy_SysLib_EnterCriticalSection();
+#ifdef COMPONENT_FREERTOS
+    uint32_t now = (uint32_t)xTaskGetTickCount();
+    uint32_t load = SysTick->LOAD;
+    uint32_t value = SysTick->VAL;
+    uint64_t ticks;
+    uint64_t cycles;
+
+    if (0u != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+    {
+        now++;
+        value = SysTick->VAL;
+    }
+    if (now < timebase_last)
+    {
+        timebase_high++;
+    }
+    timebase_last = now;
+    ticks = ((uint64_t)timebase_high << 32) | now;
+
+    /* The SysTick counts down from load within a tick, it is not running before the scheduler */
+    cycles = ticks * timebase_cycles_per_tick;
+    if ((0u != load) && (value <= load))
+    {
+        cycles += ((uint64_t)(load - value) * timebase_cycles_per_tick) / (load + 1u);
+    }
+#else
+    uint32_t now = DWT->CYCCNT;
+    uint64_t cycles;
+
+    if (now < timebase_last)
+    {
+        timebase_high++;
+    }
+    timebase_last = now;
+    cycles = ((uint64_t)timebase_high << 32) | now;
+#endif
+
+    Cy_SysLib_ExitCriticalSection(state);
+
+    return cycles;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles32
+********************************************************************************
+* Summary:
+*  Returns the DWT cycle counter, which wraps every 2^32 cycles. Cheap enough
+*  to profile short sections by subtraction. It stops while the core
+*  sleeps, so a section that waits counts only the cycles the core was
+*  awake.
+*
+*******************************************************************************/
+uint32_t timebase_get_cycles32(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_cycles_per_us
+*******************************************************************************/
+uint32_t timebase_get_cycles_per_us(void)
+{
+    return timebase_cycles_per_us;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_us
+********************************************************************************
+* Summary:
+*  Returns the microseconds since timebase_init().
+*
+*******************************************************************************/
+uint64_t timebase_get_us(void)
+{
+    return timebase_get_cycles() / timebase_cycles_per_us;
+}
+
+/*******************************************************************************
+* Function Name: timebase_get_ms
+********************************************************************************
+* Summary:
+*  Returns the milliseconds since timebase_init(). Wraps after 49 days,
+*  compare times by unsigned subtraction.
+*
+*******************************************************************************/
+uint32_t timebase_get_ms(void)
+{
+    return (uint32_t)(timebase_get_us() / 1000u);
+}
+
+/*******************************************************************************
+* Function Name: timebase_format_hms
+********************************************************************************
+* Summary:
+*  Formats a time in milliseconds as hours, minutes and seconds.
+*
+* Parameters:
+*  milliseconds : time to format
+*  text         : receives the text, TIMEBASE_HMS_SIZE characters fit any time
+*  size         : size of text
+*
+*******************************************************************************/
+void timebase_format_hms(uint32_t milliseconds, char *text, size_t size)
+{
+    unsigned int seconds = (milliseconds / 1000u) % 60u;
+    unsigned int minutes = (milliseconds / (1000u * 60u)) % 60u;
+    unsigned int hours = (milliseconds / (1000u * 60u * 60u));
+
+    (void)snprintf(text, size, "%02u:%02u:%02u", hours, minutes, seconds);
+}
+
+/* [] END OF FILE */